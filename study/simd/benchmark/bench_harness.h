@@ -0,0 +1,258 @@
+#pragma once
+
+// ============================================
+// Micro-benchmark harness
+//
+//   - warmup runs (page faults, caches, branch predictors, turbo ramp-up)
+//   - N timed samples, each long enough for the clock to resolve
+//     (short kernels are repeated inside a sample)
+//   - min / median / MAD / mean per call, in ns and TSC cycles
+//   - DoNotOptimize / ClobberMemory so the compiler cannot hoist or drop
+//     the work being measured
+//   - every measurement is recorded for CSV / JSON output
+//
+// TSC cycles are reference cycles at the nominal frequency, not core
+// cycles. With turbo on they understate the core clock, but the ratio
+// between two kernels stays meaningful.
+// ============================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+// ============================================
+// Optimization barriers
+// ============================================
+
+#if defined(_MSC_VER) && !defined(__clang__)
+// MSVC has no inline asm on x64: route the value through a volatile sink
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    static const volatile void* volatile sink;
+    sink = &value;
+    _ReadWriteBarrier();
+}
+
+inline void ClobberMemory() {
+    _ReadWriteBarrier();
+}
+#else
+// The value must be materialized (in a register or memory) at this point
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    __asm__ volatile("" : : "r,m"(value) : "memory");
+}
+
+// Every pending store is treated as observed
+inline void ClobberMemory() {
+    __asm__ volatile("" : : : "memory");
+}
+#endif
+
+// ============================================
+// Cycle counter
+// ============================================
+
+// lfence keeps earlier instructions from drifting past the start read
+inline uint64_t CyclesBegin() {
+    _mm_lfence();
+    return __rdtsc();
+}
+
+// rdtscp waits for earlier instructions; lfence keeps later ones out
+inline uint64_t CyclesEnd() {
+    unsigned int aux;
+    uint64_t t = __rdtscp(&aux);
+    _mm_lfence();
+    return t;
+}
+
+// TSC ticks per nanosecond, measured once against steady_clock
+inline double TscGhz() {
+    static double ghz = 0.0;
+    if (ghz == 0.0) {
+        using clock = std::chrono::steady_clock;
+        auto t0 = clock::now();
+        uint64_t c0 = CyclesBegin();
+        while (clock::now() - t0 < std::chrono::milliseconds(50)) {
+        }
+        uint64_t c1 = CyclesEnd();
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count();
+        ghz = (double)(c1 - c0) / ns;
+    }
+    return ghz;
+}
+
+// ============================================
+// Configuration / results
+// ============================================
+
+struct BenchConfig {
+    int warmup = 3;                 // untimed runs before sampling
+    int repetitions = 15;           // timed samples
+    double minSampleNs = 1e6;       // repeat short kernels until a sample takes this long
+};
+
+struct BenchStats {
+    std::string test;
+    std::string variant;
+    size_t elements = 0;            // work items per call (for per-element numbers)
+    size_t bytes = 0;               // bytes moved per call (0 = not reported)
+    int samples = 0;
+    int iterations = 0;             // calls per sample
+    double minNs = 0, medianNs = 0, madNs = 0, meanNs = 0;
+    double medianCycles = 0;
+
+    double CyclesPerElement() const { return elements ? medianCycles / elements : 0.0; }
+    double NsPerElement() const { return elements ? medianNs / elements : 0.0; }
+    double GBPerSec() const { return (bytes && medianNs > 0) ? bytes / medianNs : 0.0; }
+};
+
+inline double Median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return (values.size() % 2) ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+}
+
+// Median absolute deviation: robust spread, not pulled by one preempted sample
+inline double MedianAbsDeviation(const std::vector<double>& values, double median) {
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (double v : values) deviations.push_back(std::fabs(v - median));
+    return Median(deviations);
+}
+
+// Quotes, backslashes and control characters in names or meta values would break the JSON
+inline std::string JsonEscape(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if ((unsigned char)c < 0x20) {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", (unsigned char)c);
+            escaped += code;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+class BenchHarness {
+public:
+    BenchConfig config;
+    std::vector<BenchStats> results;
+
+    // Times fn() and records the statistics per call. fn should write its
+    // output to memory (or pass it to DoNotOptimize) so the work is observable.
+    // Returns a copy: a reference into results would dangle after the next call.
+    template <typename Fn>
+    BenchStats Measure(const std::string& test, const std::string& variant,
+                       size_t elements, size_t bytes, Fn&& fn) {
+        using clock = std::chrono::steady_clock;
+
+        // Warmup, and find how many calls make one sample long enough
+        int iterations = 1;
+        for (int w = 0; w < config.warmup; w++) {
+            auto t0 = clock::now();
+            for (int i = 0; i < iterations; i++) {
+                fn();
+                ClobberMemory();
+            }
+            double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count();
+            if (ns < config.minSampleNs) {
+                double scale = (ns > 0) ? config.minSampleNs / ns : 1000.0;
+                iterations = (int)std::min(1e7, std::ceil(iterations * scale));
+            }
+        }
+
+        std::vector<double> ns(config.repetitions);
+        std::vector<double> cycles(config.repetitions);
+        for (int r = 0; r < config.repetitions; r++) {
+            auto t0 = clock::now();
+            uint64_t c0 = CyclesBegin();
+            for (int i = 0; i < iterations; i++) {
+                fn();
+                ClobberMemory();
+            }
+            uint64_t c1 = CyclesEnd();
+            auto t1 = clock::now();
+            ns[r] = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / iterations;
+            cycles[r] = (double)(c1 - c0) / iterations;
+        }
+
+        BenchStats stats;
+        stats.test = test;
+        stats.variant = variant;
+        stats.elements = elements;
+        stats.bytes = bytes;
+        stats.samples = config.repetitions;
+        stats.iterations = iterations;
+        stats.minNs = *std::min_element(ns.begin(), ns.end());
+        stats.medianNs = Median(ns);
+        stats.madNs = MedianAbsDeviation(ns, stats.medianNs);
+        double sum = 0.0;
+        for (double v : ns) sum += v;
+        stats.meanNs = sum / ns.size();
+        stats.medianCycles = Median(cycles);
+
+        results.push_back(stats);
+        return stats;
+    }
+
+    bool WriteCsv(const char* path) const {
+        FILE* fp = fopen(path, "w");
+        if (!fp) return false;
+        fprintf(fp, "test,variant,elements,bytes,samples,iterations,min_ns,median_ns,mad_ns,mean_ns,"
+                    "median_cycles,cycles_per_element,ns_per_element,gb_per_sec\n");
+        for (const BenchStats& s : results) {
+            fprintf(fp, "%s,%s,%zu,%zu,%d,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%.4f,%.4f,%.3f\n",
+                    s.test.c_str(), s.variant.c_str(), s.elements, s.bytes, s.samples, s.iterations,
+                    s.minNs, s.medianNs, s.madNs, s.meanNs, s.medianCycles,
+                    s.CyclesPerElement(), s.NsPerElement(), s.GBPerSec());
+        }
+        fclose(fp);
+        return true;
+    }
+
+    // meta: extra top-level string fields (cpu, compiler, ...)
+    bool WriteJson(const char* path, const std::vector<std::pair<std::string, std::string>>& meta) const {
+        FILE* fp = fopen(path, "w");
+        if (!fp) return false;
+        fprintf(fp, "{\n");
+        for (const auto& kv : meta) {
+            fprintf(fp, "  \"%s\": \"%s\",\n", JsonEscape(kv.first).c_str(), JsonEscape(kv.second).c_str());
+        }
+        fprintf(fp, "  \"tsc_ghz\": %.4f,\n", TscGhz());
+        fprintf(fp, "  \"warmup\": %d,\n  \"repetitions\": %d,\n", config.warmup, config.repetitions);
+        fprintf(fp, "  \"results\": [\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchStats& s = results[i];
+            fprintf(fp, "    {\"test\": \"%s\", \"variant\": \"%s\", \"elements\": %zu, \"bytes\": %zu, "
+                        "\"samples\": %d, \"iterations\": %d, \"min_ns\": %.1f, \"median_ns\": %.1f, "
+                        "\"mad_ns\": %.1f, \"mean_ns\": %.1f, \"median_cycles\": %.1f, "
+                        "\"cycles_per_element\": %.4f, \"gb_per_sec\": %.3f}%s\n",
+                    JsonEscape(s.test).c_str(), JsonEscape(s.variant).c_str(),
+                    s.elements, s.bytes, s.samples, s.iterations,
+                    s.minNs, s.medianNs, s.madNs, s.meanNs, s.medianCycles, s.CyclesPerElement(),
+                    s.GBPerSec(), (i + 1 < results.size()) ? "," : "");
+        }
+        fprintf(fp, "  ]\n}\n");
+        fclose(fp);
+        return true;
+    }
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+// ============================================
+// Cache hierarchy characterization
+//
+//   - DetectCacheLevels(): data / unified cache size per level, from sysfs
+//     on Linux (what the kernel reports, including VM overrides), CPUID
+//     leaf 4 / 0x8000001D elsewhere
+//   - BuildPointerChain() / ChasePointers(): one node per 64-byte line,
+//     linked in a random order over the whole buffer. Every load needs the
+//     address from the previous one and the prefetchers cannot guess the
+//     next line, so ns per step is the load-to-use latency of whatever
+//     level the buffer lives in (plus TLB misses on large buffers).
+//   - PlateauMedian() / PlateauEnd(): the flat part of a size sweep that
+//     belongs to one level, and how far it stays flat
+//   - FindPlateaus(): the flat runs of a sweep from the data alone (VMs and
+//     shared LLCs often report sizes the measurement does not show)
+// ============================================
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "simd_platform.h"
+
+struct CacheLevelInfo {
+    int level;
+    size_t bytes;
+    const char* source;     // "sysfs" or "CPUID"
+};
+
+#if defined(__linux__)
+// Reads one token from /sys/devices/system/cpu/cpu0/cache/index<i>/<name>
+inline bool ReadCacheSysfs(int index, const char* name, char* value, size_t size) {
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/%s", index, name);
+    FILE* fp = fopen(path, "r");
+    if (!fp) return false;
+    bool ok = fgets(value, (int)size, fp) != nullptr;
+    fclose(fp);
+    if (ok) value[strcspn(value, "\r\n")] = '\0';
+    return ok;
+}
+#endif
+
+// Levels in ascending order; empty if neither source knows
+inline std::vector<CacheLevelInfo> DetectCacheLevels() {
+    std::vector<CacheLevelInfo> levels;
+#if defined(__linux__)
+    for (int index = 0; index < 16; index++) {
+        char level[16], type[32], size[32];
+        if (!ReadCacheSysfs(index, "level", level, sizeof(level))) break;
+        if (!ReadCacheSysfs(index, "type", type, sizeof(type)) ||
+            !ReadCacheSysfs(index, "size", size, sizeof(size))) continue;
+        if (strcmp(type, "Instruction") == 0) continue;
+
+        char* suffix = nullptr;
+        size_t bytes = (size_t)strtoull(size, &suffix, 10);
+        if (*suffix == 'K') bytes <<= 10;
+        else if (*suffix == 'M') bytes <<= 20;
+        else if (*suffix == 'G') bytes <<= 30;
+        if (bytes) levels.push_back({ atoi(level), bytes, "sysfs" });
+    }
+#endif
+    if (levels.empty()) {
+        for (int level = 1; level <= 4; level++) {
+            size_t bytes = CpuCacheBytes(level);
+            if (bytes) levels.push_back({ level, bytes, "CPUID" });
+        }
+    }
+    std::sort(levels.begin(), levels.end(),
+              [](const CacheLevelInfo& a, const CacheLevelInfo& b) { return a.level < b.level; });
+    return levels;
+}
+
+// ============================================
+// Pointer chasing
+// ============================================
+const size_t CHASE_LINE = 64;
+
+// Links every line of [buffer, buffer + bytes) into one cycle in shuffled
+// order and returns the first node. Overwrites the buffer.
+inline void** BuildPointerChain(void* buffer, size_t bytes, uint64_t seed = 1) {
+    size_t lines = std::max<size_t>(1, bytes / CHASE_LINE);
+    std::vector<uint32_t> order(lines);
+    for (size_t i = 0; i < lines; i++) order[i] = (uint32_t)i;
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(seed));
+
+    char* base = (char*)buffer;
+    for (size_t i = 0; i < lines; i++) {
+        *(void**)(base + order[i] * CHASE_LINE) = base + order[(i + 1) % lines] * CHASE_LINE;
+    }
+    return (void**)(base + order[0] * CHASE_LINE);
+}
+
+// Follows the chain for `steps` loads and returns where it stopped
+inline void** ChasePointers(void** p, size_t steps) {
+    size_t i = 0;
+    for (; i + 4 <= steps; i += 4) {
+        p = (void**)*p;
+        p = (void**)*p;
+        p = (void**)*p;
+        p = (void**)*p;
+    }
+    for (; i < steps; i++) p = (void**)*p;
+    return p;
+}
+
+// ============================================
+// Plateaus of a size sweep (sizes ascending)
+// ============================================
+
+// Median of the values whose size lies in (lo, hi]; 0 if there are none
+inline double PlateauMedian(const std::vector<size_t>& sizes, const std::vector<double>& values,
+                            size_t lo, size_t hi) {
+    std::vector<double> inside;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        if (sizes[i] > lo && sizes[i] <= hi) inside.push_back(values[i]);
+    }
+    if (inside.empty()) return 0.0;
+    std::sort(inside.begin(), inside.end());
+    size_t mid = inside.size() / 2;
+    return (inside.size() % 2) ? inside[mid] : 0.5 * (inside[mid - 1] + inside[mid]);
+}
+
+// Largest size above lo whose value stays within `tolerance` x plateau,
+// walking up until the first one that does not; 0 if none qualifies
+inline size_t PlateauEnd(const std::vector<size_t>& sizes, const std::vector<double>& values,
+                         size_t lo, double plateau, double tolerance) {
+    size_t end = 0;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        if (sizes[i] <= lo) continue;
+        if (values[i] > plateau * tolerance) break;
+        end = sizes[i];
+    }
+    return end;
+}
+
+// Flat runs found from the data alone, independent of what sysfs says:
+// a run ends where a value exceeds `step` x the first value of the run.
+// Runs shorter than minPoints are transitions between levels and dropped.
+struct Plateau {
+    size_t firstBytes, lastBytes;
+    double value;           // median over the run
+};
+
+inline std::vector<Plateau> FindPlateaus(const std::vector<size_t>& sizes, const std::vector<double>& values,
+                                         double step = 1.5, size_t minPoints = 3) {
+    std::vector<Plateau> plateaus;
+    size_t begin = 0;
+    for (size_t i = 1; i <= sizes.size(); i++) {
+        if (i < sizes.size() && values[i] <= values[begin] * step) continue;
+        if (i - begin >= minPoints) {
+            double value = PlateauMedian(sizes, values, begin ? sizes[begin - 1] : 0, sizes[i - 1]);
+            plateaus.push_back({ sizes[begin], sizes[i - 1], value });
+        }
+        begin = i;
+    }
+    return plateaus;
+}
@@ -0,0 +1,314 @@
+#pragma once
+
+// ============================================
+// Entity storage in three layouts, one kernel source for all of them
+//
+//   AoS        struct per entity (what the engine has today)
+//              x y z vx vy vz r [cold...] | x y z vx vy vz r [cold...] | ...
+//   SoA        one array per hot field + an array of the cold parts
+//              x x x x ... | y y y y ... | z z z z ... | ...
+//   AoSoA<W>   blocks of W entities, SoA inside the block
+//              [x*W y*W z*W vx*W vy*W vz*W r*W] [x*W ...] ...
+//
+// Hot fields are the ones the per-frame kernels read (position, velocity,
+// bounding radius). Cold fields (id, health, flags, ...) ride along in the
+// AoS struct and fill its cache line; the other layouts keep them apart.
+//
+// Entities<Layout> gives every layout the same interface:
+//   Get<F>(i)              scalar access to field F of entity i
+//   Load8<F>(i) / Store8   8 consecutive entities (i multiple of 8) as one
+//                          __m256: a plain load for SoA / AoSoA, a gather
+//                          (and lane-by-lane store) for AoS
+// and the kernels below are templates over it. Size() is rounded up to a
+// multiple of 16 (the widest block), so kernels need no remainder loop.
+// ============================================
+
+#include "simd_kernels.h"
+
+enum EntityField {
+    FIELD_X, FIELD_Y, FIELD_Z,
+    FIELD_VX, FIELD_VY, FIELD_VZ,
+    FIELD_RADIUS,
+    HOT_FIELD_COUNT
+};
+
+// What the kernels never touch
+struct EntityCold {
+    uint32_t id;
+    float health;
+    uint32_t flags;
+    float pad[6];
+};
+
+// Layout tags
+struct AoS {};
+struct SoA {};
+template <int W> struct AoSoA {};
+
+inline size_t RoundUpEntities(size_t count) {
+    return (count + 15) & ~(size_t)15;
+}
+
+template <typename Layout> class Entities;
+
+// ============================================
+// AoS: 64 bytes per entity, one cache line
+// ============================================
+struct EntityAoS {
+    float hot[HOT_FIELD_COUNT];
+    EntityCold cold;
+};
+static_assert(sizeof(EntityAoS) == 64, "Load8 gathers with a 64-byte stride");
+
+template <>
+class Entities<AoS> {
+public:
+    static const char* Name() { return "AoS"; }
+
+    explicit Entities(size_t count) : size(RoundUpEntities(count)) {
+        data = AlignedArray<EntityAoS>(size);
+        memset(data, 0, size * sizeof(EntityAoS));
+    }
+    ~Entities() { AlignedFree(data); }
+    Entities(const Entities&) = delete;
+    Entities& operator=(const Entities&) = delete;
+
+    size_t Size() const { return size; }
+
+    // The whole struct comes in with any field; a written line goes back whole
+    static size_t BytesMoved(int fieldsRead, int fieldsWritten) {
+        (void)fieldsRead;
+        return sizeof(EntityAoS) * (fieldsWritten ? 2 : 1);
+    }
+
+    template <int F> float& Get(size_t i) { return data[i].hot[F]; }
+    template <int F> float Get(size_t i) const { return data[i].hot[F]; }
+
+    template <int F>
+    SIMD_TARGET_AVX2 __m256 Load8(size_t i) const {
+        const __m256i stride = _mm256_setr_epi32(0, 16, 32, 48, 64, 80, 96, 112);
+        return _mm256_i32gather_ps(&data[i].hot[F], stride, 4);
+    }
+
+    // AVX2 has no scatter
+    template <int F>
+    SIMD_TARGET_AVX2 void Store8(size_t i, __m256 v) {
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, v);
+        for (int k = 0; k < 8; k++) data[i + k].hot[F] = lanes[k];
+    }
+
+private:
+    size_t size;
+    EntityAoS* data;
+};
+
+// ============================================
+// SoA: one array per hot field
+// ============================================
+template <>
+class Entities<SoA> {
+public:
+    static const char* Name() { return "SoA"; }
+
+    explicit Entities(size_t count) : size(RoundUpEntities(count)) {
+        for (int f = 0; f < HOT_FIELD_COUNT; f++) {
+            hot[f] = AlignedArray<float>(size);
+            memset(hot[f], 0, size * sizeof(float));
+        }
+        cold = AlignedArray<EntityCold>(size);
+        memset(cold, 0, size * sizeof(EntityCold));
+    }
+    ~Entities() {
+        for (int f = 0; f < HOT_FIELD_COUNT; f++) AlignedFree(hot[f]);
+        AlignedFree(cold);
+    }
+    Entities(const Entities&) = delete;
+    Entities& operator=(const Entities&) = delete;
+
+    size_t Size() const { return size; }
+
+    static size_t BytesMoved(int fieldsRead, int fieldsWritten) {
+        return sizeof(float) * (fieldsRead + fieldsWritten);
+    }
+
+    template <int F> float& Get(size_t i) { return hot[F][i]; }
+    template <int F> float Get(size_t i) const { return hot[F][i]; }
+
+    template <int F>
+    SIMD_TARGET_AVX2 __m256 Load8(size_t i) const { return _mm256_load_ps(hot[F] + i); }
+
+    template <int F>
+    SIMD_TARGET_AVX2 void Store8(size_t i, __m256 v) { _mm256_store_ps(hot[F] + i, v); }
+
+private:
+    size_t size;
+    float* hot[HOT_FIELD_COUNT];
+    EntityCold* cold;
+};
+
+// ============================================
+// AoSoA<W>: blocks of W entities (W = 8: one AVX2 register per field,
+// W = 16: one AVX-512 register / one cache line per field)
+// ============================================
+template <int W>
+class Entities<AoSoA<W>> {
+    static_assert(W % 8 == 0 && 16 % W == 0, "block width must be 8 or 16");
+
+public:
+    static const char* Name() { return W == 8 ? "AoSoA8" : "AoSoA16"; }
+
+    explicit Entities(size_t count) : size(RoundUpEntities(count)) {
+        blocks = AlignedArray<Block>(size / W);
+        memset(blocks, 0, (size / W) * sizeof(Block));
+        cold = AlignedArray<EntityCold>(size);
+        memset(cold, 0, size * sizeof(EntityCold));
+    }
+    ~Entities() {
+        AlignedFree(blocks);
+        AlignedFree(cold);
+    }
+    Entities(const Entities&) = delete;
+    Entities& operator=(const Entities&) = delete;
+
+    size_t Size() const { return size; }
+
+    static size_t BytesMoved(int fieldsRead, int fieldsWritten) {
+        return sizeof(float) * (fieldsRead + fieldsWritten);
+    }
+
+    template <int F> float& Get(size_t i) { return blocks[i / W].hot[F][i % W]; }
+    template <int F> float Get(size_t i) const { return blocks[i / W].hot[F][i % W]; }
+
+    template <int F>
+    SIMD_TARGET_AVX2 __m256 Load8(size_t i) const { return _mm256_load_ps(&blocks[i / W].hot[F][i % W]); }
+
+    template <int F>
+    SIMD_TARGET_AVX2 void Store8(size_t i, __m256 v) { _mm256_store_ps(&blocks[i / W].hot[F][i % W], v); }
+
+private:
+    struct Block {
+        alignas(32) float hot[HOT_FIELD_COUNT][W];
+    };
+
+    size_t size;
+    Block* blocks;
+    EntityCold* cold;
+};
+
+// ============================================
+// Kernels over any layout. The SIMD versions use separate mul + add in the
+// same order as the scalar ones (no FMA), so every layout and width produces
+// bit-identical results and can be compared exactly. That relies on FP
+// contraction being off (CMakeLists.txt): by default GCC fuses mul + add into
+// FMA inside the avx2,fma functions.
+// ============================================
+
+// out[i] = distance from (px, py, pz) to entity i
+template <typename Layout>
+SIMD_SCALAR_FN void entity_distance_scalar(const Entities<Layout>& e, float px, float py, float pz, float* out) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < e.Size(); i++) {
+        float dx = e.template Get<FIELD_X>(i) - px;
+        float dy = e.template Get<FIELD_Y>(i) - py;
+        float dz = e.template Get<FIELD_Z>(i) - pz;
+        out[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+}
+
+template <typename Layout>
+SIMD_TARGET_AVX2 void entity_distance_avx2(const Entities<Layout>& e, float px, float py, float pz, float* out) {
+    __m256 vpx = _mm256_set1_ps(px);
+    __m256 vpy = _mm256_set1_ps(py);
+    __m256 vpz = _mm256_set1_ps(pz);
+    for (size_t i = 0; i < e.Size(); i += 8) {
+        __m256 dx = _mm256_sub_ps(e.template Load8<FIELD_X>(i), vpx);
+        __m256 dy = _mm256_sub_ps(e.template Load8<FIELD_Y>(i), vpy);
+        __m256 dz = _mm256_sub_ps(e.template Load8<FIELD_Z>(i), vpz);
+        __m256 distSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                                      _mm256_mul_ps(dz, dz));
+        _mm256_storeu_ps(out + i, _mm256_sqrt_ps(distSq));
+    }
+}
+
+// position += velocity * dt
+template <typename Layout>
+SIMD_SCALAR_FN void entity_integrate_scalar(Entities<Layout>& e, float dt) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < e.Size(); i++) {
+        e.template Get<FIELD_X>(i) = e.template Get<FIELD_X>(i) + e.template Get<FIELD_VX>(i) * dt;
+        e.template Get<FIELD_Y>(i) = e.template Get<FIELD_Y>(i) + e.template Get<FIELD_VY>(i) * dt;
+        e.template Get<FIELD_Z>(i) = e.template Get<FIELD_Z>(i) + e.template Get<FIELD_VZ>(i) * dt;
+    }
+}
+
+template <typename Layout>
+SIMD_TARGET_AVX2 void entity_integrate_avx2(Entities<Layout>& e, float dt) {
+    __m256 vdt = _mm256_set1_ps(dt);
+    for (size_t i = 0; i < e.Size(); i += 8) {
+        e.template Store8<FIELD_X>(i, _mm256_add_ps(e.template Load8<FIELD_X>(i),
+                                                    _mm256_mul_ps(e.template Load8<FIELD_VX>(i), vdt)));
+        e.template Store8<FIELD_Y>(i, _mm256_add_ps(e.template Load8<FIELD_Y>(i),
+                                                    _mm256_mul_ps(e.template Load8<FIELD_VY>(i), vdt)));
+        e.template Store8<FIELD_Z>(i, _mm256_add_ps(e.template Load8<FIELD_Z>(i),
+                                                    _mm256_mul_ps(e.template Load8<FIELD_VZ>(i), vdt)));
+    }
+}
+
+// Bounding sphere vs frustum: visible unless entirely behind one plane.
+// Bit (i % 8) of visibleBits[i / 8] is set for visible entities; returns the count.
+struct Plane {
+    float nx, ny, nz, d;    // inside: nx*x + ny*y + nz*z + d >= 0
+};
+
+template <typename Layout>
+SIMD_SCALAR_FN size_t entity_cull_scalar(const Entities<Layout>& e, const Plane planes[6], uint8_t* visibleBits) {
+    size_t visible = 0;
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < e.Size(); i += 8) {
+        uint8_t bits = 0;
+        for (int k = 0; k < 8; k++) {
+            float x = e.template Get<FIELD_X>(i + k);
+            float y = e.template Get<FIELD_Y>(i + k);
+            float z = e.template Get<FIELD_Z>(i + k);
+            float r = e.template Get<FIELD_RADIUS>(i + k);
+            bool inside = true;
+            for (int p = 0; p < 6; p++) {
+                const Plane& pl = planes[p];
+                inside = inside && (pl.nx * x + pl.ny * y + pl.nz * z + pl.d >= -r);
+            }
+            if (inside) {
+                bits |= (uint8_t)(1 << k);
+                visible++;
+            }
+        }
+        visibleBits[i / 8] = bits;
+    }
+    return visible;
+}
+
+template <typename Layout>
+SIMD_TARGET_AVX2 size_t entity_cull_avx2(const Entities<Layout>& e, const Plane planes[6], uint8_t* visibleBits) {
+    const CompactTable<8>& table = GetCompactTable<8>();
+    size_t visible = 0;
+    for (size_t i = 0; i < e.Size(); i += 8) {
+        __m256 x = e.template Load8<FIELD_X>(i);
+        __m256 y = e.template Load8<FIELD_Y>(i);
+        __m256 z = e.template Load8<FIELD_Z>(i);
+        __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), e.template Load8<FIELD_RADIUS>(i));
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; p++) {
+            const Plane& pl = planes[p];
+            __m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+                              _mm256_mul_ps(_mm256_set1_ps(pl.nx), x),
+                              _mm256_mul_ps(_mm256_set1_ps(pl.ny), y)),
+                              _mm256_mul_ps(_mm256_set1_ps(pl.nz), z)),
+                              _mm256_set1_ps(pl.d));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, negR, _CMP_GE_OQ));
+        }
+        int mask = _mm256_movemask_ps(inside);
+        visibleBits[i / 8] = (uint8_t)mask;
+        visible += table.count[mask];
+    }
+    return visible;
+}
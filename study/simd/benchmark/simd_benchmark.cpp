@@ -1,25 +1,123 @@
 #include <iostream>
-#include <chrono>
+#include <cfloat>
 #include <cmath>
-#include <xmmintrin.h>  // SSE
+#include <cstring>
+#include <cstdlib>
 #include <iomanip>
+#include <string>
+#include <vector>
+#include "simd_kernels.h"
+#include "bench_harness.h"
+#include "thread_pool.h"
+#include "entity_layout.h"
+#include "cache_hierarchy.h"
+#include "transform_kernels.h"
 
 using namespace std;
-using namespace std::chrono;
 
-// Timer helper
-class Timer {
-private:
-    high_resolution_clock::time_point start;
-public:
-    Timer() : start(high_resolution_clock::now()) {}
+// Chosen once in main(): best level the CPU/OS supports, or --isa
+static SimdLevel g_level = SimdLevel::SSE2;
 
-    double elapsed() {
-        auto end = high_resolution_clock::now();
-        return duration_cast<microseconds>(end - start).count() / 1000.0;
-    }
+// Every measurement goes through here (and into the CSV / JSON report)
+static BenchHarness g_bench;
+
+// Largest thread count for test 6 (--threads, default: all hardware threads)
+static int g_maxThreads = 0;
+
+void print_stats_header() {
+    cout << left << setw(11) << "" << right
+         << setw(10) << "median ms" << setw(9) << "+-MAD" << setw(10) << "min ms"
+         << setw(11) << "cyc/elem" << setw(10) << "speedup" << setw(9) << "max ULP" << "\n";
+}
+
+// maxUlp < 0: the check was not element-wise, leave the column empty
+void print_stats(const BenchStats& s, double baselineNs, int64_t maxUlp = -1) {
+    cout << left << setw(11) << (s.variant + ":") << right << fixed
+         << setprecision(3) << setw(10) << s.medianNs / 1e6
+         << setw(9) << s.madNs / 1e6
+         << setw(10) << s.minNs / 1e6
+         << setprecision(2) << setw(11) << s.CyclesPerElement();
+    if (baselineNs > 0.0 && s.medianNs > 0.0) cout << setw(9) << baselineNs / s.medianNs << "x";
+    else if (maxUlp >= 0) cout << setw(10) << "";
+    if (maxUlp >= 0) cout << setw(9) << maxUlp;
+    cout << "\n";
+}
+
+// ============================================
+// Verification
+// ============================================
+
+// Number of representable floats between a and b (0 = identical)
+int64_t ulp_distance(float a, float b) {
+    if (std::isnan(a) || std::isnan(b)) return (std::isnan(a) && std::isnan(b)) ? 0 : INT32_MAX;
+    int32_t ia, ib;
+    memcpy(&ia, &a, sizeof(ia));
+    memcpy(&ib, &b, sizeof(ib));
+    // Sign-magnitude bits -> one monotonic integer line (-0 and +0 meet at 0)
+    int64_t la = ia < 0 ? (int64_t)INT32_MIN - ia : ia;
+    int64_t lb = ib < 0 ? (int64_t)INT32_MIN - ib : ib;
+    return la > lb ? la - lb : lb - la;
+}
+
+// What a verify() callback reports: pass / fail, and for element-wise
+// checks the worst ULP error over the whole array and where it was
+struct VerifyResult {
+    bool ok;
+    int64_t maxUlp;
+    size_t worstIndex;
+
+    VerifyResult(bool ok_, int64_t maxUlp_ = -1, size_t worstIndex_ = 0)
+        : ok(ok_), maxUlp(maxUlp_), worstIndex(worstIndex_) {}
 };
 
+// Every element, not a prefix: tails and block boundaries are where SIMD code breaks
+VerifyResult verify_ulp(const float* expected, const float* actual, size_t n, int64_t ulpLimit) {
+    int64_t maxUlp = 0;
+    size_t worst = 0;
+    for (size_t i = 0; i < n; i++) {
+        int64_t ulp = ulp_distance(expected[i], actual[i]);
+        if (ulp > maxUlp) {
+            maxUlp = ulp;
+            worst = i;
+        }
+    }
+    return VerifyResult(maxUlp <= ulpLimit, maxUlp, worst);
+}
+
+// NaN everywhere, so an element the kernel forgot to write cannot pass
+// with the value a previous level left behind
+void poison(float* data, size_t n) {
+    for (size_t i = 0; i < n; i++) data[i] = NAN;
+}
+
+// Measures run(kernels) for every level up to g_level and prints median time
+// and speedup over the scalar median. verify() checks the output of each level.
+// scalarNsOut (optional) receives the scalar median for extra rows.
+template <typename Run, typename Verify>
+bool run_levels(const char* test, size_t elements, size_t bytes, Run run, Verify verify,
+                double* scalarNsOut = nullptr) {
+    bool allCorrect = true;
+    double scalarNs = 0.0;
+    print_stats_header();
+    for (int l = 0; l <= (int)g_level; l++) {
+        const SimdKernels& kernels = KernelsFor((SimdLevel)l);
+        BenchStats s = g_bench.Measure(test, SimdLevelName(kernels.level), elements, bytes,
+                                              [&]() { run(kernels); });
+        if (l == 0) scalarNs = s.medianNs;
+
+        VerifyResult result = verify();
+        print_stats(s, l > 0 ? scalarNs : 0.0, result.maxUlp);
+        allCorrect = allCorrect && result.ok;
+        if (!result.ok) {
+            cout << "  [FAIL] " << SimdLevelName(kernels.level) << " output mismatch";
+            if (result.maxUlp >= 0) cout << " (" << result.maxUlp << " ULP at [" << result.worstIndex << "])";
+            cout << "\n";
+        }
+    }
+    if (scalarNsOut) *scalarNsOut = scalarNs;
+    return allCorrect;
+}
+
 // ============================================
 // Test 1: Vector Addition (10 million)
 // ============================================
@@ -28,213 +126,1322 @@ void test_vector_addition() {
     cout << "Test 1: Vector Addition (10 million)\n";
     cout << "========================================\n";
 
-    const int SIZE = 10000000;
+    const int SIZE = 10000007;      // not a multiple of any register width
 
-    // Memory allocation (16-byte aligned)
-    float* a = (float*)_aligned_malloc(SIZE * sizeof(float), 16);
-    float* b = (float*)_aligned_malloc(SIZE * sizeof(float), 16);
-    float* result_scalar = (float*)_aligned_malloc(SIZE * sizeof(float), 16);
-    float* result_simd = (float*)_aligned_malloc(SIZE * sizeof(float), 16);
+    float* a = AlignedArray<float>(SIZE);
+    float* b = AlignedArray<float>(SIZE);
+    float* result_scalar = AlignedArray<float>(SIZE);
+    float* result_simd = AlignedArray<float>(SIZE);
 
     // Initialize
     for (int i = 0; i < SIZE; i++) {
         a[i] = (float)i;
         b[i] = (float)i * 2.0f;
     }
+    vector_add_scalar(a, b, result_scalar, SIZE);
+    poison(result_simd, SIZE);
+
+    bool correct = run_levels("vector_add", SIZE, SIZE * 3 * sizeof(float),
+        [&](const SimdKernels& k) { k.vector_add(a, b, result_simd, SIZE); },
+        [&]() {
+            VerifyResult r = verify_ulp(result_scalar, result_simd, SIZE, 0);     // one rounding either way
+            poison(result_simd, SIZE);
+            return r;
+        });
+    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
+
+    AlignedFree(a);
+    AlignedFree(b);
+    AlignedFree(result_scalar);
+    AlignedFree(result_simd);
+}
+
+// ============================================
+// Test 2: Dot Product (1 million vec4 pairs)
+// ============================================
+void test_dot_product() {
+    cout << "\n========================================\n";
+    cout << "Test 2: Dot Product (1 million vec4 pairs)\n";
+    cout << "========================================\n";
+
+    const int COUNT = 1000003;
 
-    // [Scalar] One by one
-    {
-        Timer timer;
-        for (int i = 0; i < SIZE; i++) {
-            result_scalar[i] = a[i] + b[i];
+    float* a = AlignedArray<float>(COUNT * 4);
+    float* b = AlignedArray<float>(COUNT * 4);
+    float* result_scalar = AlignedArray<float>(COUNT);
+    float* result_simd = AlignedArray<float>(COUNT);
+
+    // Pair i = (1,2,3,4) + i and (5,6,7,8) - i
+    for (int i = 0; i < COUNT; i++) {
+        for (int c = 0; c < 4; c++) {
+            a[4 * i + c] = (float)(c + 1) + (float)(i % 64);
+            b[4 * i + c] = (float)(c + 5) - (float)(i % 32);
         }
-        double elapsed = timer.elapsed();
-        cout << "Scalar: " << fixed << setprecision(2) << elapsed << " ms\n";
     }
+    dot4_scalar(a, b, result_scalar, COUNT);
+    poison(result_simd, COUNT);
+    cout << "  Result[0]: " << result_scalar[0] << "\n";
+
+    bool correct = run_levels("dot4_aos", COUNT, COUNT * 9 * sizeof(float),
+        [&](const SimdKernels& k) { k.dot4(a, b, result_simd, COUNT); },
+        [&]() {
+            VerifyResult r = verify_ulp(result_scalar, result_simd, COUNT, 2);    // summation order
+            poison(result_simd, COUNT);
+            return r;
+        });
+    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
+
+    AlignedFree(a);
+    AlignedFree(b);
+    AlignedFree(result_scalar);
+    AlignedFree(result_simd);
+}
+
+// ============================================
+// Test 3: Distance Calculation (1 million monsters)
+// ============================================
+void test_distance_calculation() {
+    cout << "\n========================================\n";
+    cout << "Test 3: Distance Calculation (1M monsters)\n";
+    cout << "========================================\n";
+
+    const int MONSTER_COUNT = 1000003;
+
+    // Player position
+    const float playerX = 0.0f, playerY = 0.0f, playerZ = 0.0f;
+
+    // Monster positions
+    float* monsterX = AlignedArray<float>(MONSTER_COUNT);
+    float* monsterY = AlignedArray<float>(MONSTER_COUNT);
+    float* monsterZ = AlignedArray<float>(MONSTER_COUNT);
+
+    float* dist_scalar = AlignedArray<float>(MONSTER_COUNT);
+    float* dist_simd = AlignedArray<float>(MONSTER_COUNT);
+
+    // Initialize
+    for (int i = 0; i < MONSTER_COUNT; i++) {
+        monsterX[i] = (float)(i % 100);
+        monsterY[i] = (float)(i % 50);
+        monsterZ[i] = (float)(i % 75);
+    }
+    distance_scalar(monsterX, monsterY, monsterZ, playerX, playerY, playerZ, dist_scalar, MONSTER_COUNT);
+    poison(dist_simd, MONSTER_COUNT);
+
+    bool correct = run_levels("distance", MONSTER_COUNT, MONSTER_COUNT * 4 * sizeof(float),
+        [&](const SimdKernels& k) {
+            k.distance(monsterX, monsterY, monsterZ, playerX, playerY, playerZ, dist_simd, MONSTER_COUNT);
+        },
+        [&]() {
+            VerifyResult r = verify_ulp(dist_scalar, dist_simd, MONSTER_COUNT, 1);  // FMA in the sum
+            poison(dist_simd, MONSTER_COUNT);
+            return r;
+        });
+    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
+
+    AlignedFree(monsterX);
+    AlignedFree(monsterY);
+    AlignedFree(monsterZ);
+    AlignedFree(dist_scalar);
+    AlignedFree(dist_simd);
+}
+
+// ============================================
+// Test 4: Batched Dot Product, SoA (1 million vec4 pairs)
+// Same pairs as test 2, stored as x[] y[] z[] w[]: vertical FMAs only.
+// ============================================
+void test_dot_product_soa() {
+    cout << "\n========================================\n";
+    cout << "Test 4: Batched Dot Product SoA (1M pairs)\n";
+    cout << "========================================\n";
+
+    const int COUNT = 1000003;
 
-    // [SIMD] 4 at a time
-    {
-        Timer timer;
-        __m128* pA = (__m128*)a;
-        __m128* pB = (__m128*)b;
-        __m128* pResult = (__m128*)result_simd;
+    float* aos_a = AlignedArray<float>(COUNT * 4);
+    float* aos_b = AlignedArray<float>(COUNT * 4);
+    float* soa_a = AlignedArray<float>(COUNT * 4);
+    float* soa_b = AlignedArray<float>(COUNT * 4);
+    float* result_scalar = AlignedArray<float>(COUNT);
+    float* result_simd = AlignedArray<float>(COUNT);
 
-        int simdCount = SIZE / 4;
-        for (int i = 0; i < simdCount; i++) {
-            pResult[i] = _mm_add_ps(pA[i], pB[i]);
+    // Component c of pair i lives at aos[4 * i + c] and soa[c * COUNT + i]
+    for (int i = 0; i < COUNT; i++) {
+        for (int c = 0; c < 4; c++) {
+            aos_a[4 * i + c] = soa_a[c * COUNT + i] = (float)(c + 1) + (float)(i % 64);
+            aos_b[4 * i + c] = soa_b[c * COUNT + i] = (float)(c + 5) - (float)(i % 32);
         }
-        double elapsed = timer.elapsed();
-        cout << "SIMD:   " << fixed << setprecision(2) << elapsed << " ms\n";
     }
+    Vec4Soa a = { soa_a, soa_a + COUNT, soa_a + 2 * COUNT, soa_a + 3 * COUNT };
+    Vec4Soa b = { soa_b, soa_b + COUNT, soa_b + 2 * COUNT, soa_b + 3 * COUNT };
+    dot4_scalar(aos_a, aos_b, result_scalar, COUNT);
+    poison(result_simd, COUNT);
+
+    bool correct = run_levels("dot4_soa", COUNT, COUNT * 9 * sizeof(float),
+        [&](const SimdKernels& k) { k.dot4_soa(a, b, result_simd, COUNT); },
+        [&]() {
+            VerifyResult r = verify_ulp(result_scalar, result_simd, COUNT, 2);    // FMA, summation order
+            poison(result_simd, COUNT);
+            return r;
+        });
+    double soaNs = g_bench.results.back().medianNs;
+
+    // The AoS kernel at the same level, on the same pairs
+    const SimdKernels& best = KernelsFor(g_level);
+    BenchStats aos = g_bench.Measure("dot4_soa", "AoS", COUNT, COUNT * 9 * sizeof(float),
+        [&]() { best.dot4(aos_a, aos_b, result_simd, COUNT); });
+    print_stats(aos, 0.0);
+    cout << "SoA vs AoS (" << SimdLevelName(g_level) << "): " << setprecision(2)
+         << aos.medianNs / soaNs << "x\n";
+    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
+
+    AlignedFree(aos_a);
+    AlignedFree(aos_b);
+    AlignedFree(soa_a);
+    AlignedFree(soa_b);
+    AlignedFree(result_scalar);
+    AlignedFree(result_simd);
+}
+
+// ============================================
+// Test 5: Dot Product Reduction (sum of a[i] * b[i])
+// In cache the single accumulator chain is the limit; from DRAM it is bandwidth.
+// ============================================
+bool run_dot_reduce(const float* a, const float* b, size_t n) {
+    // Exact reference, and an error bound scaled to the magnitude of the terms
+    double reference = 0.0, magnitude = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        reference += (double)a[i] * b[i];
+        magnitude += fabs((double)a[i] * b[i]);
+    }
+    float sum = 0.0f;
+    double scalarNs = 0.0;
+    bool correct = run_levels("dot_reduce", n, n * 2 * sizeof(float),
+        [&](const SimdKernels& k) { sum = k.dot_reduce(a, b, n); },
+        [&]() { return fabs(sum - reference) <= 1e-6 * magnitude + 1e-3; },
+        &scalarNs);
+
+    if (g_level >= SimdLevel::AVX2) {
+        BenchStats s = g_bench.Measure("dot_reduce", "AVX2-1acc", n, n * 2 * sizeof(float),
+            [&]() { sum = dot_reduce_avx2_1acc(a, b, n); });
+        print_stats(s, scalarNs);
+    }
+    return correct;
+}
+
+void test_dot_reduction() {
+    cout << "\n========================================\n";
+    cout << "Test 5: Dot Product Reduction\n";
+    cout << "========================================\n";
+
+    const size_t SMALL = 16 * 1024 + 5;           // 128 KB for both arrays: L2
+    const size_t LARGE = 16 * 1024 * 1024 + 7;    // 128 MB: DRAM
 
-    // Verify
+    float* a = AlignedArray<float>(LARGE);
+    float* b = AlignedArray<float>(LARGE);
+    for (size_t i = 0; i < LARGE; i++) {
+        a[i] = (float)((int)(i % 17) - 8) * 0.25f;
+        b[i] = (float)((int)(i % 13) - 6) * 0.5f;
+    }
+
+    cout << "16K floats (cache):\n";
+    bool correct = run_dot_reduce(a, b, SMALL);
+    cout << "16M floats (DRAM):\n";
+    correct = run_dot_reduce(a, b, LARGE) && correct;
+    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
+
+    AlignedFree(a);
+    AlignedFree(b);
+}
+
+// ============================================
+// Test 6: Multi-threaded Distance + Bandwidth Roofline (32M monsters)
+//
+// 512 MB of SoA data, larger than any LLC, split across a thread pool.
+// A STREAM triad over the same arrays measures what the memory system can
+// deliver at each thread count; the distance kernel's GB/s against it says
+// whether more threads (compute) or nothing short of less data (bandwidth)
+// would help.
+// ============================================
+
+// STREAM triad: a[i] = b[i] + s * c[i], 12 bytes per element
+void stream_triad(float* a, const float* b, const float* c, float s, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) a[i] = b[i] + s * c[i];
+}
+
+// 1, 2, 4, ... up to maxThreads (always ends with maxThreads itself)
+vector<int> thread_counts(int maxThreads) {
+    vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+struct RooflineRow {
+    int threads;
+    double triadGBs;
+    double distanceGBs;
+    double distanceGFlops;
+};
+
+void test_parallel_distance() {
+    cout << "\n========================================\n";
+    cout << "Test 6: Multi-threaded Distance (32M monsters)\n";
+    cout << "========================================\n";
+
+    const size_t COUNT = 32 * 1024 * 1024;
+    const size_t DISTANCE_BYTES = COUNT * 4 * sizeof(float);   // x, y, z in; distance out
+    const size_t TRIAD_BYTES = COUNT * 3 * sizeof(float);
+    const double FLOPS_PER_ELEMENT = 9.0;                      // 3 sub, 3 mul, 2 add, sqrt
+    const float playerX = 10.0f, playerY = 20.0f, playerZ = 30.0f;
+    const SimdKernels& kernels = KernelsFor(g_level);
+
+    cout << "Kernel: " << SimdLevelName(g_level) << ", data " << DISTANCE_BYTES / (1024 * 1024)
+         << " MB, pinned workers, first-touch init\n";
+    print_stats_header();
+
+    vector<RooflineRow> rows;
     bool correct = true;
-    for (int i = 0; i < 100; i++) {
-        if (abs(result_scalar[i] - result_simd[i]) > 0.001f) {
-            correct = false;
-            break;
+    double oneThreadNs = 0.0;
+    for (int threads : thread_counts(g_maxThreads)) {
+        ThreadPool pool(threads);
+        float* x = AlignedArray<float>(COUNT);
+        float* y = AlignedArray<float>(COUNT);
+        float* z = AlignedArray<float>(COUNT);
+        float* out = AlignedArray<float>(COUNT);
+
+        // First touch: each worker writes the slice it will compute on
+        pool.Run([&](int w) {
+            size_t begin, end;
+            ChunkRange(COUNT, threads, w, begin, end);
+            for (size_t i = begin; i < end; i++) {
+                x[i] = (float)(i % 100);
+                y[i] = (float)(i % 50);
+                z[i] = (float)(i % 75);
+                out[i] = 0.0f;
+            }
+        });
+
+        const function<void(int)> triadJob = [&](int w) {
+            size_t begin, end;
+            ChunkRange(COUNT, threads, w, begin, end);
+            stream_triad(out, x, y, 3.0f, begin, end);
+        };
+        const function<void(int)> distanceJob = [&](int w) {
+            size_t begin, end;
+            ChunkRange(COUNT, threads, w, begin, end);
+            kernels.distance(x + begin, y + begin, z + begin, playerX, playerY, playerZ,
+                             out + begin, end - begin);
+        };
+
+        string variant = to_string(threads) + "T";
+        BenchStats triad = g_bench.Measure("stream_triad", variant, COUNT, TRIAD_BYTES,
+                                                  [&]() { pool.Run(triadJob); });
+        double triadGBs = triad.GBPerSec();
+        BenchStats dist = g_bench.Measure("distance_mt", variant, COUNT, DISTANCE_BYTES,
+                                                 [&]() { pool.Run(distanceJob); });
+        if (threads == 1) oneThreadNs = dist.medianNs;
+        print_stats(dist, threads > 1 ? oneThreadNs : 0.0);
+        rows.push_back({ threads, triadGBs, dist.GBPerSec(), COUNT * FLOPS_PER_ELEMENT / dist.medianNs });
+
+        for (size_t i = 0; i < COUNT; i++) {
+            float dx = x[i] - playerX, dy = y[i] - playerY, dz = z[i] - playerZ;
+            float expected = sqrtf(dx * dx + dy * dy + dz * dz);
+            if (fabs(out[i] - expected) > 1e-5f * expected + 1e-5f) {
+                cout << "  [FAIL] " << variant << " mismatch at " << i << "\n";
+                correct = false;
+                break;
+            }
         }
+
+        AlignedFree(x);
+        AlignedFree(y);
+        AlignedFree(z);
+        AlignedFree(out);
     }
-    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
 
-    _aligned_free(a);
-    _aligned_free(b);
-    _aligned_free(result_scalar);
-    _aligned_free(result_simd);
+    // Roofline: peak = best triad at any thread count. Reaching ~80% of the
+    // triad at the same thread count means the cores wait on memory.
+    double peak = 0.0;
+    for (const RooflineRow& r : rows) peak = max(peak, r.triadGBs);
+    cout << "\nRoofline (peak triad " << setprecision(1) << peak << " GB/s, "
+         << setprecision(2) << FLOPS_PER_ELEMENT / 16.0 << " flop/byte):\n";
+    cout << right << setw(8) << "threads" << setw(12) << "triad GB/s" << setw(11) << "dist GB/s"
+         << setw(10) << "of triad" << setw(9) << "of peak" << setw(9) << "GFLOP/s" << "  bound\n";
+    for (const RooflineRow& r : rows) {
+        double ofTriad = r.distanceGBs / r.triadGBs;
+        cout << setw(8) << r.threads << setprecision(1) << setw(12) << r.triadGBs
+             << setw(11) << r.distanceGBs << setw(9) << ofTriad * 100.0 << "%"
+             << setw(8) << r.distanceGBs / peak * 100.0 << "%" << setprecision(2) << setw(9)
+             << r.distanceGFlops << "  " << (ofTriad >= 0.8 ? "bandwidth" : "compute") << "\n";
+    }
+    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
 }
 
 // ============================================
-// Test 2: Dot Product (1 million times)
+// Test 7: Radius Query + Stream Compaction (1M monsters)
+// Monsters uniform in a 1000^3 box, player at the center; the radius is
+// chosen so the sphere holds the requested fraction of the box.
 // ============================================
-void test_dot_product() {
+
+// True when monster i lies on the sphere of q up to rounding (FMA vs mul+add)
+bool on_radius_boundary(const float* x, const float* y, const float* z, uint32_t i, const RadiusQuery& q) {
+    double dx = (double)x[i] - q.px, dy = (double)y[i] - q.py, dz = (double)z[i] - q.pz;
+    return fabs(dx * dx + dy * dy + dz * dz - q.radiusSq) <= 1e-5 * q.radiusSq;
+}
+
+// Same indices in the same order, except monsters right on the boundary
+bool same_matches(const RadiusQuery& got, const uint32_t* expected, size_t expectedCount,
+                  const float* x, const float* y, const float* z) {
+    size_t i = 0, j = 0;
+    while (i < got.count || j < expectedCount) {
+        if (i < got.count && j < expectedCount && got.indices[i] == expected[j]) {
+            i++;
+            j++;
+        } else if (j == expectedCount || (i < got.count && got.indices[i] < expected[j])) {
+            if (!on_radius_boundary(x, y, z, got.indices[i++], got)) return false;
+        } else {
+            if (!on_radius_boundary(x, y, z, expected[j++], got)) return false;
+        }
+    }
+    return true;
+}
+
+void test_radius_query() {
     cout << "\n========================================\n";
-    cout << "Test 2: Dot Product (1 million times)\n";
+    cout << "Test 7: Radius Query + Compaction (1M monsters)\n";
     cout << "========================================\n";
 
-    const int COUNT = 1000000;
+    const size_t COUNT = 1000003;
+    const size_t CAPACITY = COUNT + RADIUS_QUERY_SLACK;
+    const float BOX = 1000.0f;
+    const double PI = 3.14159265358979;
 
-    alignas(16) float a[4] = {1.0f, 2.0f, 3.0f, 4.0f};
-    alignas(16) float b[4] = {5.0f, 6.0f, 7.0f, 8.0f};
+    float* x = AlignedArray<float>(COUNT);
+    float* y = AlignedArray<float>(COUNT);
+    float* z = AlignedArray<float>(COUNT);
+    uint32_t seed = 12345;
+    auto random01 = [&]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (float)(seed >> 8) / 16777216.0f;
+    };
+    for (size_t i = 0; i < COUNT; i++) {
+        x[i] = random01() * BOX;
+        y[i] = random01() * BOX;
+        z[i] = random01() * BOX;
+    }
+
+    bool correct = true;
+    uint32_t* expected = AlignedArray<uint32_t>(CAPACITY);
+    uint32_t* result = AlignedArray<uint32_t>(CAPACITY);
+    const double selectivities[] = { 0.001, 0.01, 0.1, 0.25, 0.5 };
+    for (double selectivity : selectivities) {
+        double radius = cbrt(selectivity * BOX * BOX * BOX * 3.0 / (4.0 * PI));
+        RadiusQuery reference = { BOX / 2, BOX / 2, BOX / 2, (float)(radius * radius), expected, 0 };
+        radius_query_scalar(x, y, z, COUNT, &reference, 1);
+
+        RadiusQuery query = reference;
+        query.indices = result;
+        char label[32];
+        snprintf(label, sizeof(label), "%.1f%%", selectivity * 100.0);
+        cout << "Selectivity " << label << " (" << reference.count << " matches):\n";
+        string test = string("radius_query_") + label;
+        correct = run_levels(test.c_str(), COUNT, COUNT * 3 * sizeof(float),
+            [&](const SimdKernels& k) { k.radius_query(x, y, z, COUNT, &query, 1); },
+            [&]() { return same_matches(query, expected, reference.count, x, y, z); }) && correct;
+    }
+    AlignedFree(expected);
+    AlignedFree(result);
+
+    // Many players, 1% each: one pass over the monsters vs one pass per player
+    const int PLAYERS = 16;
+    const double radius = cbrt(0.01 * BOX * BOX * BOX * 3.0 / (4.0 * PI));
+    uint32_t* expectedLists = AlignedArray<uint32_t>(CAPACITY * PLAYERS);
+    uint32_t* resultLists = AlignedArray<uint32_t>(CAPACITY * PLAYERS);
+    vector<RadiusQuery> references(PLAYERS), queries(PLAYERS);
+    for (int p = 0; p < PLAYERS; p++) {
+        float px = BOX * (0.25f + 0.5f * random01());
+        float py = BOX * (0.25f + 0.5f * random01());
+        float pz = BOX * (0.25f + 0.5f * random01());
+        references[p] = { px, py, pz, (float)(radius * radius), expectedLists + p * CAPACITY, 0 };
+        queries[p] = references[p];
+        queries[p].indices = resultLists + p * CAPACITY;
+    }
+    radius_query_scalar(x, y, z, COUNT, references.data(), PLAYERS);
 
-    // [Scalar]
-    float result_scalar = 0.0f;
-    {
-        Timer timer;
-        for (int iter = 0; iter < COUNT; iter++) {
-            result_scalar = a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3];
+    auto all_match = [&]() {
+        for (int p = 0; p < PLAYERS; p++) {
+            if (!same_matches(queries[p], references[p].indices, references[p].count, x, y, z)) return false;
         }
-        double elapsed = timer.elapsed();
-        cout << "Scalar: " << fixed << setprecision(2) << elapsed << " ms\n";
-        cout << "  Result: " << result_scalar << "\n";
+        return true;
+    };
+
+    const SimdKernels& best = KernelsFor(g_level);
+    cout << PLAYERS << " players, 1% each (" << SimdLevelName(g_level) << "):\n";
+    print_stats_header();
+    BenchStats separate = g_bench.Measure("radius_query_multi", "16 passes", COUNT, COUNT * 3 * sizeof(float),
+        [&]() {
+            for (int p = 0; p < PLAYERS; p++) best.radius_query(x, y, z, COUNT, &queries[p], 1);
+        });
+    print_stats(separate, 0.0);
+    double separateNs = separate.medianNs;
+    bool multiCorrect = all_match();
+    BenchStats shared = g_bench.Measure("radius_query_multi", "1 pass", COUNT, COUNT * 3 * sizeof(float),
+        [&]() { best.radius_query(x, y, z, COUNT, queries.data(), PLAYERS); });
+    print_stats(shared, separateNs);
+    multiCorrect = all_match() && multiCorrect;
+    if (!multiCorrect) cout << "  [FAIL] multi-player output mismatch\n";
+    correct = correct && multiCorrect;
+    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
+
+    AlignedFree(expectedLists);
+    AlignedFree(resultLists);
+    AlignedFree(x);
+    AlignedFree(y);
+    AlignedFree(z);
+}
+
+// ============================================
+// Test 8: Entity Layouts (AoS / SoA / AoSoA8 / AoSoA16)
+// The same three kernels over each layout: in L2 the cost is instructions
+// (gathers for AoS), from DRAM it is cache lines (AoS pulls in the cold
+// fields with every entity).
+// ============================================
+const size_t LAYOUT_SMALL = 16 * 1024;              // AoS 1 MB: fits in L2
+const size_t LAYOUT_LARGE = 8 * 1024 * 1024;        // AoS 512 MB: DRAM
+const float LAYOUT_DT = 1.0f / 60.0f;
+
+// Axis-aligned view volume [-300, 300]^3: about a fifth of the entities
+const Plane LAYOUT_FRUSTUM[6] = {
+    { 1, 0, 0, 300 }, { -1, 0, 0, 300 },
+    { 0, 1, 0, 300 }, { 0, -1, 0, 300 },
+    { 0, 0, 1, 300 }, { 0, 0, -1, 300 },
+};
+
+template <typename Layout>
+void init_entities(Entities<Layout>& e) {
+    for (size_t i = 0; i < e.Size(); i++) {
+        e.template Get<FIELD_X>(i) = (float)((i * 7) % 1000) - 500.0f;
+        e.template Get<FIELD_Y>(i) = (float)((i * 13) % 1000) - 500.0f;
+        e.template Get<FIELD_Z>(i) = (float)((i * 29) % 1000) - 500.0f;
+        e.template Get<FIELD_VX>(i) = (float)(i % 11) - 5.0f;
+        e.template Get<FIELD_VY>(i) = (float)(i % 7) - 3.0f;
+        e.template Get<FIELD_VZ>(i) = (float)(i % 5) - 2.0f;
+        e.template Get<FIELD_RADIUS>(i) = 1.0f + (float)(i % 8);
+    }
+}
+
+// Everything the three kernels produce, for comparing layouts and widths
+struct LayoutOutput {
+    vector<float> distance;
+    vector<uint8_t> visibleBits;
+    size_t visible = 0;
+    vector<float> position;         // x, y, z after one integration step
+
+    bool operator==(const LayoutOutput& o) const {
+        return distance == o.distance && visibleBits == o.visibleBits && visible == o.visible &&
+               position == o.position;
+    }
+};
+
+template <typename Layout>
+LayoutOutput run_layout_once(size_t count, bool simd) {
+    Entities<Layout> e(count);
+    init_entities(e);
+    LayoutOutput out;
+    out.distance.resize(e.Size());
+    out.visibleBits.resize(e.Size() / 8);
+    if (simd) {
+        entity_distance_avx2(e, 0.0f, 0.0f, 0.0f, out.distance.data());
+        out.visible = entity_cull_avx2(e, LAYOUT_FRUSTUM, out.visibleBits.data());
+        entity_integrate_avx2(e, LAYOUT_DT);
+    } else {
+        entity_distance_scalar(e, 0.0f, 0.0f, 0.0f, out.distance.data());
+        out.visible = entity_cull_scalar(e, LAYOUT_FRUSTUM, out.visibleBits.data());
+        entity_integrate_scalar(e, LAYOUT_DT);
     }
+    for (size_t i = 0; i < e.Size(); i++) {
+        out.position.push_back(e.template Get<FIELD_X>(i));
+        out.position.push_back(e.template Get<FIELD_Y>(i));
+        out.position.push_back(e.template Get<FIELD_Z>(i));
+    }
+    return out;
+}
+
+enum LayoutKernel { LAYOUT_DISTANCE, LAYOUT_INTEGRATE, LAYOUT_CULL, LAYOUT_KERNEL_COUNT };
+const char* const LAYOUT_KERNEL_NAMES[LAYOUT_KERNEL_COUNT] = { "distance", "integrate", "cull" };
+
+struct LayoutRow {
+    string layout;
+    size_t bytes[LAYOUT_KERNEL_COUNT];              // per entity, from DRAM
+    double scalarNs[LAYOUT_KERNEL_COUNT];           // per entity, L2
+    double simdNs[LAYOUT_KERNEL_COUNT];             // per entity, L2
+    double dramNs[LAYOUT_KERNEL_COUNT];             // per entity, DRAM
+    bool correct;
+};
 
-    // [SIMD]
-    float result_simd = 0.0f;
-    {
-        Timer timer;
-        __m128 vecA = _mm_load_ps(a);
-        __m128 vecB = _mm_load_ps(b);
+template <typename Layout>
+LayoutRow bench_layout(const LayoutOutput& reference, bool simd) {
+    typedef Entities<Layout> Container;
+    LayoutRow row;
+    row.layout = Container::Name();
+    row.bytes[LAYOUT_DISTANCE] = Container::BytesMoved(3, 0) + sizeof(float);
+    row.bytes[LAYOUT_INTEGRATE] = Container::BytesMoved(6, 3);
+    row.bytes[LAYOUT_CULL] = Container::BytesMoved(4, 0);
+    row.correct = run_layout_once<Layout>(LAYOUT_SMALL, false) == reference &&
+                  (!simd || run_layout_once<Layout>(LAYOUT_SMALL, true) == reference);
 
-        for (int iter = 0; iter < COUNT; iter++) {
-            __m128 mul = _mm_mul_ps(vecA, vecB);
+    for (size_t count : { LAYOUT_SMALL, LAYOUT_LARGE }) {
+        Container e(count);
+        init_entities(e);
+        vector<float> distance(e.Size());
+        vector<uint8_t> visibleBits(e.Size() / 8);
+        size_t visible = 0;
+        bool large = (count == LAYOUT_LARGE);
 
-            // Horizontal Add
-            alignas(16) float temp[4];
-            _mm_store_ps(temp, mul);
-            result_simd = temp[0] + temp[1] + temp[2] + temp[3];
+        for (int k = 0; k < LAYOUT_KERNEL_COUNT; k++) {
+            string test = string("layout_") + LAYOUT_KERNEL_NAMES[k] + (large ? "_dram" : "_l2");
+            auto run = [&](bool wide) {
+                if (k == LAYOUT_DISTANCE) {
+                    if (wide) entity_distance_avx2(e, 0.0f, 0.0f, 0.0f, distance.data());
+                    else entity_distance_scalar(e, 0.0f, 0.0f, 0.0f, distance.data());
+                } else if (k == LAYOUT_INTEGRATE) {
+                    if (wide) entity_integrate_avx2(e, LAYOUT_DT);
+                    else entity_integrate_scalar(e, LAYOUT_DT);
+                } else {
+                    visible = wide ? entity_cull_avx2(e, LAYOUT_FRUSTUM, visibleBits.data())
+                                   : entity_cull_scalar(e, LAYOUT_FRUSTUM, visibleBits.data());
+                }
+            };
+            if (!large) {
+                row.scalarNs[k] = g_bench.Measure(test, row.layout + "-scalar", e.Size(), e.Size() * row.bytes[k],
+                                                  [&]() { run(false); }).NsPerElement();
+            }
+            double ns = g_bench.Measure(test, row.layout, e.Size(), e.Size() * row.bytes[k],
+                                        [&]() { run(simd); }).NsPerElement();
+            (large ? row.dramNs : row.simdNs)[k] = ns;
         }
-        double elapsed = timer.elapsed();
-        cout << "SIMD:   " << fixed << setprecision(2) << elapsed << " ms\n";
-        cout << "  Result: " << result_simd << "\n";
+        DoNotOptimize(visible);
     }
+    return row;
+}
+
+void test_entity_layouts() {
+    cout << "\n========================================\n";
+    cout << "Test 8: Entity Layouts (16K in L2, 8M in DRAM)\n";
+    cout << "========================================\n";
 
-    cout << "Result: " << (abs(result_scalar - result_simd) < 0.001f ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
+    bool simd = (g_level >= SimdLevel::AVX2);
+    const char* wide = simd ? "AVX2" : "Scalar";
+    cout << "Entity: " << HOT_FIELD_COUNT * sizeof(float) << " B hot + " << sizeof(EntityCold)
+         << " B cold, kernels: " << wide << " (AoS loads are gathers)\n";
+
+    LayoutOutput reference = run_layout_once<AoS>(LAYOUT_SMALL, false);
+    vector<LayoutRow> rows;
+    rows.push_back(bench_layout<AoS>(reference, simd));
+    rows.push_back(bench_layout<SoA>(reference, simd));
+    rows.push_back(bench_layout<AoSoA<8>>(reference, simd));
+    rows.push_back(bench_layout<AoSoA<16>>(reference, simd));
+
+    // ns per entity. DRAM/L2: what the cache misses add on top of the work.
+    bool correct = true;
+    for (int k = 0; k < LAYOUT_KERNEL_COUNT; k++) {
+        cout << "\n" << left << setw(10) << LAYOUT_KERNEL_NAMES[k] << right << setw(7) << "B/ent"
+             << setw(11) << "scalar L2" << setw(6) << wide << " L2" << setw(6) << wide << " DRAM"
+             << setw(9) << "DRAM/L2" << setw(11) << "DRAM GB/s" << "   (ns/entity)\n";
+        for (const LayoutRow& r : rows) {
+            cout << left << setw(10) << r.layout << right << setw(7) << r.bytes[k] << setprecision(2)
+                 << setw(11) << r.scalarNs[k] << setw(9) << r.simdNs[k] << setw(11) << r.dramNs[k]
+                 << setprecision(1) << setw(8) << r.dramNs[k] / r.simdNs[k] << "x"
+                 << setw(11) << r.bytes[k] / r.dramNs[k] << "\n";
+        }
+    }
+    for (const LayoutRow& r : rows) {
+        if (!r.correct) cout << "  [FAIL] " << r.layout << " output differs from AoS scalar\n";
+        correct = correct && r.correct;
+    }
+    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
 }
 
 // ============================================
-// Test 3: Distance Calculation (1 million monsters)
+// Test 9: Arbitrary Length / Alignment
+// Every kernel, every level, lengths 0..100 plus a few odd large ones,
+// pointers offset by 0..3 floats from a 64-byte boundary. Outputs are
+// compared element by element with the scalar kernel, and canaries on
+// both sides of the output catch writes outside [0, n).
 // ============================================
-void test_distance_calculation() {
+struct TailSweep {
+    size_t cases = 0;
+    int64_t maxUlp[6] = {};     // vector_add, dot4, dot4_soa, distance, add stream, add prefetch
+    size_t overruns = 0;
+    size_t failures = 0;
+};
+
+const float CANARY = -12345.0f;
+const size_t SWEEP_GUARD = 32;
+
+// Output region [offset, offset + n) inside a canary-filled buffer
+bool canaries_intact(const float* buffer, size_t offset, size_t n, size_t total) {
+    for (size_t i = 0; i < offset; i++) {
+        if (buffer[i] != CANARY) return false;
+    }
+    for (size_t i = offset + n; i < total; i++) {
+        if (buffer[i] != CANARY) return false;
+    }
+    return true;
+}
+
+void test_tail_handling() {
     cout << "\n========================================\n";
-    cout << "Test 3: Distance Calculation (1M monsters)\n";
+    cout << "Test 9: Arbitrary Length / Alignment\n";
     cout << "========================================\n";
 
-    const int MONSTER_COUNT = 1000000;
+    vector<size_t> lengths;
+    for (size_t n = 0; n <= 100; n++) lengths.push_back(n);
+    for (size_t n : { 255, 1000, 4099, 65537 }) lengths.push_back(n);
+    const size_t MAX_N = 65537;
+    const size_t TOTAL = MAX_N + 3 + SWEEP_GUARD;
+    // ULP limits: add rounds once either way; the dot products sum in a
+    // different order (and with FMA); distance gets FMA in the sum
+    const int64_t ULP_LIMIT[6] = { 0, 4, 4, 2, 0, 0 };
 
-    // Player position
-    alignas(16) float playerX[4] = {0.0f, 0.0f, 0.0f, 0.0f};
-    alignas(16) float playerY[4] = {0.0f, 0.0f, 0.0f, 0.0f};
-    alignas(16) float playerZ[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    // Positive dot product inputs: no cancellation, so ULP error stays bounded
+    uint32_t seed = 777;
+    auto random = [&](float lo, float hi) {
+        seed = seed * 1664525u + 1013904223u;
+        return lo + (hi - lo) * (float)(seed >> 8) / 16777216.0f;
+    };
+    vector<float*> inputs;
+    for (int k = 0; k < 8; k++) {
+        float* in = AlignedArray<float>(4 * TOTAL);
+        for (size_t i = 0; i < 4 * TOTAL; i++) in[i] = (k < 3) ? random(-100.0f, 100.0f) : random(0.5f, 2.0f);
+        inputs.push_back(in);
+    }
+    float* expected = AlignedArray<float>(TOTAL);
+    float* out = AlignedArray<float>(TOTAL);
+    uint32_t* expectedIndices = AlignedArray<uint32_t>(TOTAL + RADIUS_QUERY_SLACK);
+    uint32_t* indices = AlignedArray<uint32_t>(TOTAL + RADIUS_QUERY_SLACK);
 
-    // Monster positions
-    float* monsterX = (float*)_aligned_malloc(MONSTER_COUNT * sizeof(float), 16);
-    float* monsterY = (float*)_aligned_malloc(MONSTER_COUNT * sizeof(float), 16);
-    float* monsterZ = (float*)_aligned_malloc(MONSTER_COUNT * sizeof(float), 16);
+    cout << right << setw(9) << "" << setw(7) << "cases" << setw(6) << "add" << setw(6) << "dot4"
+         << setw(9) << "dot4soa" << setw(6) << "dist" << setw(8) << "add NT" << setw(8) << "add PF"
+         << setw(10) << "overruns" << setw(10) << "failures" << "   (max ULP vs scalar)\n";
 
-    float* dist_scalar = (float*)_aligned_malloc(MONSTER_COUNT * sizeof(float), 16);
-    float* dist_simd = (float*)_aligned_malloc(MONSTER_COUNT * sizeof(float), 16);
+    bool correct = true;
+    for (int l = 1; l <= (int)g_level; l++) {
+        const SimdKernels& k = KernelsFor((SimdLevel)l);
+        TailSweep sweep;
+        for (size_t n : lengths) {
+            for (size_t offset = 0; offset < 4; offset++) {
+                const float* x = inputs[0] + offset;
+                const float* y = inputs[1] + offset;
+                const float* z = inputs[2] + offset;
+                const float* a = inputs[3] + offset;
+                const float* b = inputs[4] + offset;
+                Vec4Soa sa = { inputs[3] + offset, inputs[4] + offset, inputs[5] + offset, inputs[6] + offset };
+                Vec4Soa sb = { inputs[7] + offset, inputs[6] + 1, inputs[5] + 2, inputs[4] + 3 };
 
-    // Initialize
-    for (int i = 0; i < MONSTER_COUNT; i++) {
-        monsterX[i] = (float)(i % 100);
-        monsterY[i] = (float)(i % 50);
-        monsterZ[i] = (float)(i % 75);
+                // Element-wise kernels: scalar result vs this level, canaries around the output
+                for (int kernel = 0; kernel < 6; kernel++) {
+                    for (size_t i = 0; i < TOTAL; i++) out[i] = CANARY;
+                    float* dst = out + offset;
+                    if (kernel == 0) {
+                        vector_add_scalar(a, b, expected, n);
+                        k.vector_add(a, b, dst, n);
+                    } else if (kernel == 1) {
+                        dot4_scalar(a, b, expected, n);
+                        k.dot4(a, b, dst, n);
+                    } else if (kernel == 2) {
+                        dot4_soa_scalar(sa, sb, expected, n);
+                        k.dot4_soa(sa, sb, dst, n);
+                    } else if (kernel == 3) {
+                        distance_scalar(x, y, z, 1.5f, -2.5f, 3.5f, expected, n);
+                        k.distance(x, y, z, 1.5f, -2.5f, 3.5f, dst, n);
+                    } else if (kernel == 4) {
+                        vector_add_scalar(a, b, expected, n);
+                        k.vector_add_stream(a, b, dst, n);
+                    } else {
+                        vector_add_scalar(a, b, expected, n);
+                        k.vector_add_prefetch(a, b, dst, n, 1024);
+                    }
+                    VerifyResult r = verify_ulp(expected, dst, n, ULP_LIMIT[kernel]);
+                    sweep.maxUlp[kernel] = max(sweep.maxUlp[kernel], r.maxUlp);
+                    bool intact = canaries_intact(out, offset, n, TOTAL);
+                    sweep.overruns += intact ? 0 : 1;
+                    sweep.failures += (r.ok && intact) ? 0 : 1;
+                    sweep.cases++;
+                }
+
+                // Reduction: against a double-precision sum
+                double reference = 0.0, magnitude = 0.0;
+                for (size_t i = 0; i < n; i++) {
+                    reference += (double)a[i] * b[i];
+                    magnitude += fabs((double)a[i] * b[i]);
+                }
+                float sum = k.dot_reduce(a, b, n);
+                sweep.failures += (fabs(sum - reference) <= 1e-6 * magnitude + 1e-6) ? 0 : 1;
+                sweep.cases++;
+
+                // Radius query: same list as scalar (slack past n is allowed by contract)
+                RadiusQuery reference_query = { 0.0f, 0.0f, 0.0f, 60.0f * 60.0f, expectedIndices, 0 };
+                radius_query_scalar(x, y, z, n, &reference_query, 1);
+                RadiusQuery query = reference_query;
+                query.indices = indices;
+                k.radius_query(x, y, z, n, &query, 1);
+                sweep.failures += same_matches(query, expectedIndices, reference_query.count, x, y, z) ? 0 : 1;
+                sweep.cases++;
+            }
+        }
+        cout << left << setw(9) << (string(SimdLevelName(k.level)) + ":") << right << setw(7) << sweep.cases
+             << setw(6) << sweep.maxUlp[0] << setw(6) << sweep.maxUlp[1] << setw(9) << sweep.maxUlp[2]
+             << setw(6) << sweep.maxUlp[3] << setw(8) << sweep.maxUlp[4] << setw(8) << sweep.maxUlp[5]
+             << setw(10) << sweep.overruns << setw(10) << sweep.failures << "\n";
+        correct = correct && sweep.failures == 0;
+    }
+    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
+
+    for (float* in : inputs) AlignedFree(in);
+    AlignedFree(expected);
+    AlignedFree(out);
+    AlignedFree(expectedIndices);
+    AlignedFree(indices);
+}
+
+// ============================================
+// Test 10: Store Strategy Sweep (working set 4 KB - 1 GB)
+// Vector addition with plain stores, streaming stores, and software
+// prefetch at three distances, at the dispatched level. GB/s counts the
+// useful traffic (a + b + out); plain stores also pay the RFO read of out.
+// "auto" switches to streaming stores above the LLC size.
+// ============================================
+static size_t g_sweepMaxBytes = (size_t)1 << 30;
+
+string format_bytes(size_t bytes) {
+    char label[32];
+    if (bytes >= ((size_t)1 << 30) && bytes % ((size_t)1 << 30) == 0) snprintf(label, sizeof(label), "%zu GB", bytes >> 30);
+    else if (bytes >= ((size_t)1 << 20) && bytes % ((size_t)1 << 20) == 0) snprintf(label, sizeof(label), "%zu MB", bytes >> 20);
+    else if (bytes >= ((size_t)1 << 20)) snprintf(label, sizeof(label), "%.1f MB", bytes / 1048576.0);
+    else snprintf(label, sizeof(label), "%zu KB", bytes >> 10);
+    return label;
+}
+
+void test_store_strategies() {
+    cout << "\n========================================\n";
+    cout << "Test 10: Store Strategy Sweep (4 KB - " << (g_sweepMaxBytes >> 20) << " MB)\n";
+    cout << "========================================\n";
+
+    const SimdKernels& k = KernelsFor(g_level);
+    const size_t llc = LastLevelCacheBytes();
+    const size_t PREFETCH_DISTANCES[3] = { 256, 1024, 4096 };
+    const char* const VARIANTS[6] = { "plain", "stream", "pf256", "pf1K", "pf4K", "auto" };
+    cout << "Kernel: " << SimdLevelName(g_level) << ", LLC " << (llc >> 10)
+         << " KB (streaming above it), working set = a + b + out\n";
+
+    const size_t MAX_N = g_sweepMaxBytes / (3 * sizeof(float));
+    float* a = AlignedArray<float>(MAX_N);
+    float* b = AlignedArray<float>(MAX_N);
+    float* out = AlignedArray<float>(MAX_N);
+    float* expected = AlignedArray<float>(MAX_N);
+    for (size_t i = 0; i < MAX_N; i++) {
+        a[i] = (float)(i % 1000) * 0.5f;
+        b[i] = (float)(i % 777) * 0.25f;
+        out[i] = 0.0f;
     }
+    vector_add_scalar(a, b, expected, MAX_N);
 
-    // [Scalar] Distance calculation
-    {
-        Timer timer;
-        for (int i = 0; i < MONSTER_COUNT; i++) {
-            float dx = monsterX[i] - 0.0f;
-            float dy = monsterY[i] - 0.0f;
-            float dz = monsterZ[i] - 0.0f;
+    cout << right << setw(10) << "set";
+    for (const char* v : VARIANTS) cout << setw(8) << v;
+    cout << setw(9) << "best" << "   (GB/s)\n";
 
-            float distSq = dx*dx + dy*dy + dz*dz;
-            dist_scalar[i] = sqrt(distSq);
+    bool correct = true;
+    size_t crossover = 0;       // smallest working set from which streaming stays ahead of plain
+    for (size_t bytes = 4096; bytes <= g_sweepMaxBytes; bytes *= 4) {
+        size_t n = bytes / (3 * sizeof(float));
+        string test = "store_sweep_" + to_string(bytes >> 10) + "K";
+        double gbs[6];
+        for (int v = 0; v < 6; v++) {
+            auto run = [&]() {
+                if (v == 0) k.vector_add(a, b, out, n);
+                else if (v == 1) k.vector_add_stream(a, b, out, n);
+                else if (v < 5) k.vector_add_prefetch(a, b, out, n, PREFETCH_DISTANCES[v - 2]);
+                else vector_add_auto(k, a, b, out, n);
+            };
+            poison(out, n);
+            gbs[v] = g_bench.Measure(test, VARIANTS[v], n, n * 3 * sizeof(float), run).GBPerSec();
+            if (!verify_ulp(expected, out, n, 0).ok) {
+                cout << "  [FAIL] " << VARIANTS[v] << " at " << bytes << " bytes\n";
+                correct = false;
+            }
         }
-        double elapsed = timer.elapsed();
-        cout << "Scalar: " << fixed << setprecision(2) << elapsed << " ms\n";
+        int best = (int)(max_element(gbs, gbs + 5) - gbs);     // "auto" is not a strategy of its own
+        if (gbs[1] <= gbs[0]) crossover = 0;
+        else if (crossover == 0) crossover = bytes;
+        cout << setw(10) << format_bytes(bytes) << setprecision(1);
+        for (double g : gbs) cout << setw(8) << g;
+        cout << setw(9) << VARIANTS[best] << (bytes > llc ? "   > LLC" : "") << "\n";
+    }
+    if (crossover) {
+        cout << "Streaming stores win from " << (crossover >> 10) << " KB (auto switches at "
+             << (llc >> 10) << " KB)\n";
+    } else {
+        cout << "Streaming stores never won in this range\n";
+    }
+    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
+
+    AlignedFree(a);
+    AlignedFree(b);
+    AlignedFree(out);
+    AlignedFree(expected);
+}
+
+// ============================================
+// Test 11: Cache Hierarchy (--cache-sweep, working set L1/4 - 4x LLC)
+// Three kernels at the dispatched level and a pointer-chasing probe over
+// working sets in 1x / 1.5x steps. Kernels report TSC cycles per element,
+// the probe ns per dependent load. Each cache level from sysfs then gets
+// the median of the sizes well inside it (above 2x the level below, at
+// most half of its own size) and the largest size that stays within 30 %
+// of that latency.
+// ============================================
+const size_t CHASE_STEPS = (size_t)1 << 18;
+
+struct CacheSweepRow {
+    size_t bytes;
+    double cyclesPerElement[3];     // add, reduce, distance
+    double latencyNs;
+    double latencyCycles;
+};
+
+void test_cache_hierarchy() {
+    cout << "\n========================================\n";
+    cout << "Test 11: Cache Hierarchy\n";
+    cout << "========================================\n";
+
+    const SimdKernels& k = KernelsFor(g_level);
+    vector<CacheLevelInfo> levels = DetectCacheLevels();
+    if (levels.empty()) levels.push_back({ 3, LastLevelCacheBytes(), "default" });
+    for (const CacheLevelInfo& c : levels) {
+        cout << "L" << c.level << " " << format_bytes(c.bytes) << " (" << c.source << ")  ";
     }
+    const size_t llc = levels.back().bytes;
+    size_t minBytes = 4096;
+    while (minBytes * 2 <= levels.front().bytes / 4) minBytes *= 2;
+    const size_t maxBytes = min(4 * llc, g_sweepMaxBytes);
+    cout << "\nKernels: " << SimdLevelName(g_level) << ", sweep " << format_bytes(minBytes) << " - "
+         << format_bytes(maxBytes) << " (capped by --sweep-max-mb)\n";
+
+    float* buffer = AlignedArray<float>(maxBytes / sizeof(float));
+    vector<CacheSweepRow> rows;
+    bool correct = true;
+    for (size_t step = minBytes; step <= maxBytes; step *= 2) {
+        for (size_t bytes : { step, step + step / 2 }) {
+            if (bytes > maxBytes) break;
+            CacheSweepRow row = {};
+            row.bytes = bytes;
+            string test = "cache_sweep_" + to_string(bytes >> 10) + "K";
+            size_t count = bytes / sizeof(float);
+            for (size_t i = 0; i < count; i++) buffer[i] = (float)(i % 1000) * 0.5f;
 
-    // [SIMD] Distance calculation (4 at a time)
-    {
-        Timer timer;
-        __m128 pX = _mm_set1_ps(0.0f);
-        __m128 pY = _mm_set1_ps(0.0f);
-        __m128 pZ = _mm_set1_ps(0.0f);
+            // Each kernel splits the working set evenly over its streams
+            size_t n = count / 3;
+            const float *a = buffer, *b = buffer + n;
+            float* out = buffer + 2 * n;
+            row.cyclesPerElement[0] = g_bench.Measure(test, "add", n, n * 3 * sizeof(float),
+                [&]() { k.vector_add(a, b, out, n); }).CyclesPerElement();
+            for (size_t i = 0; i < n; i++) {
+                if (out[i] != a[i] + b[i]) {
+                    cout << "  [FAIL] add at " << format_bytes(bytes) << ", index " << i << "\n";
+                    correct = false;
+                    break;
+                }
+            }
 
-        int simdCount = MONSTER_COUNT / 4;
-        __m128* mX = (__m128*)monsterX;
-        __m128* mY = (__m128*)monsterY;
-        __m128* mZ = (__m128*)monsterZ;
-        __m128* distResult = (__m128*)dist_simd;
+            n = count / 2;
+            float sum = 0.0f;
+            row.cyclesPerElement[1] = g_bench.Measure(test, "reduce", n, n * 2 * sizeof(float),
+                [&]() { sum = k.dot_reduce(buffer, buffer + n, n); }).CyclesPerElement();
+            double reference = 0.0, magnitude = 0.0;
+            for (size_t i = 0; i < n; i++) {
+                reference += (double)buffer[i] * buffer[n + i];
+                magnitude += fabs((double)buffer[i] * buffer[n + i]);
+            }
+            // n float additions in any order: error below n * 2^-24 * sum |a[i] * b[i]|
+            if (fabs(sum - reference) > n * 6e-8 * magnitude + 1e-3) {
+                cout << "  [FAIL] reduce at " << format_bytes(bytes) << "\n";
+                correct = false;
+            }
 
-        for (int i = 0; i < simdCount; i++) {
-            __m128 dx = _mm_sub_ps(mX[i], pX);
-            __m128 dy = _mm_sub_ps(mY[i], pY);
-            __m128 dz = _mm_sub_ps(mZ[i], pZ);
+            n = count / 4;
+            row.cyclesPerElement[2] = g_bench.Measure(test, "distance", n, n * 4 * sizeof(float),
+                [&]() { k.distance(buffer, buffer + n, buffer + 2 * n, 1.0f, 2.0f, 3.0f, buffer + 3 * n, n); })
+                .CyclesPerElement();
 
-            __m128 dx2 = _mm_mul_ps(dx, dx);
-            __m128 dy2 = _mm_mul_ps(dy, dy);
-            __m128 dz2 = _mm_mul_ps(dz, dz);
+            void** start = BuildPointerChain(buffer, bytes);
+            void** end = start;
+            BenchStats chase = g_bench.Measure(test, "chase", CHASE_STEPS, 0,
+                [&]() { end = ChasePointers(end, CHASE_STEPS); DoNotOptimize(end); });
+            row.latencyNs = chase.NsPerElement();
+            row.latencyCycles = chase.CyclesPerElement();
+            rows.push_back(row);
+        }
+    }
+    AlignedFree(buffer);
 
-            __m128 distSq = _mm_add_ps(_mm_add_ps(dx2, dy2), dz2);
-            distResult[i] = _mm_sqrt_ps(distSq);
+    // Latency on a log scale, marking where each detected level ends
+    double minLatency = rows.front().latencyNs, maxLatency = rows.front().latencyNs;
+    for (const CacheSweepRow& r : rows) {
+        minLatency = min(minLatency, r.latencyNs);
+        maxLatency = max(maxLatency, r.latencyNs);
+    }
+    const int BAR_WIDTH = 30;
+    double scale = (maxLatency > minLatency) ? BAR_WIDTH / log(maxLatency / minLatency) : 0.0;
+
+    cout << right << setw(10) << "set" << setw(8) << "add" << setw(8) << "reduce" << setw(8) << "dist"
+         << setw(9) << "chase ns" << setw(7) << "cyc" << "   (kernels: cycles/element)\n";
+    size_t nextLevel = 0;
+    for (const CacheSweepRow& r : rows) {
+        cout << setw(10) << format_bytes(r.bytes) << fixed << setprecision(2);
+        for (double c : r.cyclesPerElement) cout << setw(8) << c;
+        cout << setw(9) << setprecision(1) << r.latencyNs << setw(7) << setprecision(0) << r.latencyCycles << "  ";
+        cout << string(1 + (int)(scale * log(r.latencyNs / minLatency)), '#');
+        for (; nextLevel < levels.size() && r.bytes >= levels[nextLevel].bytes; nextLevel++) {
+            cout << "  <- L" << levels[nextLevel].level;
         }
-        double elapsed = timer.elapsed();
-        cout << "SIMD:   " << fixed << setprecision(2) << elapsed << " ms\n";
+        cout << "\n";
     }
 
-    // Verify
+    // Plateau per level, then main memory above 2x LLC
+    vector<size_t> sizes;
+    vector<double> latency, kernel[3];
+    for (const CacheSweepRow& r : rows) {
+        sizes.push_back(r.bytes);
+        latency.push_back(r.latencyNs);
+        for (int c = 0; c < 3; c++) kernel[c].push_back(r.cyclesPerElement[c]);
+    }
+    cout << "\n" << setw(8) << "level" << setw(10) << "size" << setw(11) << "flat to" << setw(9) << "chase ns"
+         << setw(8) << "add" << setw(8) << "reduce" << setw(8) << "dist" << "\n";
+    size_t l2Fit = 0;
+    for (size_t i = 0; i <= levels.size(); i++) {
+        bool memory = (i == levels.size());
+        size_t lo = (i == 0) ? 0 : 2 * levels[i - 1].bytes;
+        size_t hi = memory ? maxBytes : levels[i].bytes / 2;
+        double plateau = PlateauMedian(sizes, latency, lo, hi);
+        string name = memory ? "memory" : "L" + to_string(levels[i].level);
+        cout << setw(8) << name << setw(10) << (memory ? "-" : format_bytes(levels[i].bytes));
+        if (plateau == 0.0) {
+            cout << setw(11) << "-" << "   (no sizes inside this level)\n";
+            continue;
+        }
+        size_t end = PlateauEnd(sizes, latency, lo, plateau, 1.3);
+        if (!memory && levels[i].level == 2) l2Fit = end;
+        cout << setw(11) << (end ? format_bytes(end) : "-") << setw(9) << setprecision(1) << plateau << setprecision(2);
+        for (int c = 0; c < 3; c++) cout << setw(8) << PlateauMedian(sizes, kernel[c], lo, hi);
+        cout << "\n";
+    }
+
+    // Steps in the latency curve, wherever they are
+    cout << "\nMeasured latency plateaus:\n";
+    for (const Plateau& p : FindPlateaus(sizes, latency)) {
+        cout << setw(10) << format_bytes(p.firstBytes) << " - " << left << setw(10) << format_bytes(p.lastBytes)
+             << right << setprecision(1) << setw(7) << p.value << " ns\n";
+    }
+
+    // Entity batch that keeps its hot fields in L2 with room for the outputs
+    if (l2Fit) {
+        size_t budget = l2Fit / 2;
+        cout << "Entity batch for L2 (half of " << format_bytes(l2Fit) << "): "
+             << budget / (HOT_FIELD_COUNT * sizeof(float)) << " entities SoA (hot fields), "
+             << budget / sizeof(EntityAoS) << " AoS\n";
+    }
+    cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
+}
+
+// ============================================
+// Test 12: Batched 4x4 Transforms (100,003 per batch)
+// N points x 1 matrix, N points x N matrices and N matrix pairs, each in
+// AoS and SoA, scalar and AVX2 + FMA. The reference is the DirectXMath
+// evaluation (XMVector3Transform / XMMatrixMultiply). FMA rounds once
+// where the reference rounds twice, so the check is against the size of
+// the terms: |error| <= 4 * FLT_EPSILON * sum |term| per element.
+// ============================================
+const size_t TRANSFORM_COUNT = 100003;
+const double TRANSFORM_ERROR_LIMIT = 4.0;
+
+enum TransformKernel { TRANSFORM_ONE, TRANSFORM_EACH, TRANSFORM_MULTIPLY, TRANSFORM_KERNEL_COUNT };
+const char* const TRANSFORM_KERNEL_NAMES[TRANSFORM_KERNEL_COUNT] = {
+    "points x 1 matrix", "points x N matrices", "N matrix pairs" };
+const char* const TRANSFORM_VARIANTS[4] = { "AoS-scalar", "AoS-AVX2", "SoA-scalar", "SoA-AVX2" };
+
+// Rotation about a tilted axis, uniform scale, translation: a typical world matrix
+Matrix4 make_world_matrix(size_t i) {
+    float angle = (float)(i % 360) * 0.0174533f;
+    float c = cosf(angle), s = sinf(angle);
+    float scale = 0.5f + (float)(i % 7) * 0.25f;
+    Matrix4 rz = { { { c, s, 0, 0 }, { -s, c, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } } };
+    Matrix4 rx = { { { 1, 0, 0, 0 }, { 0, c, s, 0 }, { 0, -s, c, 0 }, { 0, 0, 0, 1 } } };
+    Matrix4 m = matrix_multiply_ref(rz, rx);
+    for (int r = 0; r < 3; r++) {
+        for (int k = 0; k < 3; k++) m.m[r][k] *= scale;
+    }
+    m.m[3][0] = (float)(i % 100) - 50.0f;
+    m.m[3][1] = (float)(i % 37) - 18.0f;
+    m.m[3][2] = (float)(i % 53) - 26.0f;
+    return m;
+}
+
+// A world matrix times a perspective projection: output w carries depth
+Matrix4 make_view_projection() {
+    const float n = 0.1f, f = 1000.0f, yScale = 1.7320508f, xScale = yScale / (16.0f / 9.0f);
+    Matrix4 projection = { { { xScale, 0, 0, 0 }, { 0, yScale, 0, 0 },
+                             { 0, 0, f / (f - n), 1 }, { 0, 0, -n * f / (f - n), 0 } } };
+    return matrix_multiply_ref(make_world_matrix(30), projection);
+}
+
+Matrix4 abs_matrix(const Matrix4& m) {
+    Matrix4 r;
+    for (int e = 0; e < 16; e++) r.m[e / 4][e % 4] = fabsf(m.m[e / 4][e % 4]);
+    return r;
+}
+
+Float4 abs_point(const Float4& p) {
+    Float4 r = { fabsf(p.x), fabsf(p.y), fabsf(p.z), fabsf(p.w) };
+    return r;
+}
+
+Points4Soa alloc_points_soa(size_t n) {
+    Points4Soa p = { AlignedArray<float>(n), AlignedArray<float>(n), AlignedArray<float>(n), AlignedArray<float>(n) };
+    return p;
+}
+
+void free_points_soa(Points4Soa& p) {
+    for (float* a : { p.x, p.y, p.z, p.w }) AlignedFree(a);
+}
+
+Matrices4Soa alloc_matrices_soa(size_t n) {
+    Matrices4Soa m;
+    for (float*& e : m.m) e = AlignedArray<float>(n);
+    return m;
+}
+
+void free_matrices_soa(Matrices4Soa& m) {
+    for (float* e : m.m) AlignedFree(e);
+}
+
+// Largest |actual - expected| over all elements, in FLT_EPSILON x magnitude
+double transform_error(const vector<float>& expected, const vector<float>& magnitude, const vector<float>& actual) {
+    double worst = 0.0;
+    for (size_t i = 0; i < expected.size(); i++) {
+        double error = fabs((double)actual[i] - expected[i]);
+        if (std::isnan(actual[i])) return INFINITY;
+        worst = max(worst, error / (FLT_EPSILON * max(magnitude[i], FLT_MIN)));
+    }
+    return worst;
+}
+
+void test_batched_transforms() {
+    cout << "\n========================================\n";
+    cout << "Test 12: Batched 4x4 Transforms (" << TRANSFORM_COUNT << " per batch)\n";
+    cout << "========================================\n";
+
+    const size_t n = TRANSFORM_COUNT;
+    bool simd = (g_level >= SimdLevel::AVX2);
+    cout << "DirectXMath conventions (row vectors, p * M), kernels: " << (simd ? "Scalar + AVX2/FMA" : "Scalar")
+         << ", error in FLT_EPSILON x sum |term|\n";
+
+    Float4* points = AlignedArray<Float4>(n);
+    Float4* pointsOut = AlignedArray<Float4>(n);
+    Matrix4* a = AlignedArray<Matrix4>(n);
+    Matrix4* b = AlignedArray<Matrix4>(n);
+    Matrix4* matricesOut = AlignedArray<Matrix4>(n);
+    Points4Soa pointsSoa = alloc_points_soa(n), pointsOutSoa = alloc_points_soa(n);
+    Matrices4Soa aSoa = alloc_matrices_soa(n), bSoa = alloc_matrices_soa(n);
+    Matrices4Soa matricesOutSoa = alloc_matrices_soa(n);
+    const Matrix4 viewProjection = make_view_projection();
+    for (size_t i = 0; i < n; i++) {
+        points[i] = { (float)((i * 7) % 1000) * 0.1f - 50.0f, (float)((i * 13) % 1000) * 0.1f - 50.0f,
+                      (float)((i * 29) % 1000) * 0.1f - 50.0f, 1.0f };
+        a[i] = make_world_matrix(i);
+        b[i] = make_world_matrix(i * 31 + 7);
+        StorePoint(pointsSoa, i, points[i]);
+        StoreMatrix(aSoa, i, a[i]);
+        StoreMatrix(bSoa, i, b[i]);
+    }
+
+    auto run = [&](int kernel, int variant) {
+        switch (kernel * 4 + variant) {
+        case 0:  transform_points_aos_scalar(viewProjection, points, pointsOut, n); break;
+        case 1:  transform_points_aos_avx2(viewProjection, points, pointsOut, n); break;
+        case 2:  transform_points_soa_scalar(viewProjection, pointsSoa, pointsOutSoa, n); break;
+        case 3:  transform_points_soa_avx2(viewProjection, pointsSoa, pointsOutSoa, n); break;
+        case 4:  transform_points_each_aos_scalar(a, points, pointsOut, n); break;
+        case 5:  transform_points_each_aos_avx2(a, points, pointsOut, n); break;
+        case 6:  transform_points_each_soa_scalar(aSoa, pointsSoa, pointsOutSoa, n); break;
+        case 7:  transform_points_each_soa_avx2(aSoa, pointsSoa, pointsOutSoa, n); break;
+        case 8:  multiply_matrices_aos_scalar(a, b, matricesOut, n); break;
+        case 9:  multiply_matrices_aos_avx2(a, b, matricesOut, n); break;
+        case 10: multiply_matrices_soa_scalar(aSoa, bSoa, matricesOutSoa, n); break;
+        default: multiply_matrices_soa_avx2(aSoa, bSoa, matricesOutSoa, n); break;
+        }
+    };
+    // Output of the last run in AoS element order, for the comparison
+    auto output = [&](int kernel, bool soa) {
+        vector<float> flat;
+        for (size_t i = 0; i < n; i++) {
+            if (kernel == TRANSFORM_MULTIPLY) {
+                Matrix4 m = soa ? LoadMatrix(matricesOutSoa, i) : matricesOut[i];
+                flat.insert(flat.end(), &m.m[0][0], &m.m[0][0] + 16);
+            } else {
+                Float4 p = soa ? LoadPoint(pointsOutSoa, i) : pointsOut[i];
+                flat.insert(flat.end(), { p.x, p.y, p.z, p.w });
+            }
+        }
+        return flat;
+    };
+
+    cout << left << setw(21) << "" << right << setw(11) << TRANSFORM_VARIANTS[0] << setw(10) << TRANSFORM_VARIANTS[1]
+         << setw(12) << TRANSFORM_VARIANTS[2] << setw(10) << TRANSFORM_VARIANTS[3] << setw(9) << "AoS x"
+         << setw(8) << "SoA x" << setw(10) << "max err" << "   (M transforms/s)\n";
     bool correct = true;
-    for (int i = 0; i < 100; i++) {
-        if (abs(dist_scalar[i] - dist_simd[i]) > 0.01f) {
-            correct = false;
-            break;
+    for (int k = 0; k < TRANSFORM_KERNEL_COUNT; k++) {
+        // DirectXMath reference, and the same sum over |terms| for the error scale
+        vector<float> expected, magnitude;
+        for (size_t i = 0; i < n; i++) {
+            if (k == TRANSFORM_MULTIPLY) {
+                Matrix4 r = matrix_multiply_ref(a[i], b[i]);
+                Matrix4 s = matrix_multiply_ref(abs_matrix(a[i]), abs_matrix(b[i]));
+                expected.insert(expected.end(), &r.m[0][0], &r.m[0][0] + 16);
+                magnitude.insert(magnitude.end(), &s.m[0][0], &s.m[0][0] + 16);
+            } else {
+                const Matrix4& m = (k == TRANSFORM_ONE) ? viewProjection : a[i];
+                Float4 r = vector3_transform_ref(points[i], m);
+                Float4 s = vector3_transform_ref(abs_point(points[i]), abs_matrix(m));
+                expected.insert(expected.end(), { r.x, r.y, r.z, r.w });
+                magnitude.insert(magnitude.end(), { s.x, s.y, s.z, s.w });
+            }
         }
+
+        // Bytes per transform actually touched (SoA points never read w)
+        size_t pointBytes = (k == TRANSFORM_MULTIPLY) ? 0 : 2 * sizeof(Float4);
+        size_t matrixBytes = (k == TRANSFORM_ONE) ? 0 : (k == TRANSFORM_EACH ? 1 : 3) * sizeof(Matrix4);
+        string test = string("transform_") + (k == TRANSFORM_ONE ? "one" : k == TRANSFORM_EACH ? "each" : "multiply");
+        double rate[4] = { 0, 0, 0, 0 };
+        double worst = 0.0;
+        for (int v = 0; v < 4; v++) {
+            bool soa = (v >= 2);
+            if (!simd && (v % 2)) continue;
+            poison(&pointsOut[0].x, n * 4);
+            poison(&matricesOut[0].m[0][0], n * 16);
+            for (float* p : { pointsOutSoa.x, pointsOutSoa.y, pointsOutSoa.z, pointsOutSoa.w }) poison(p, n);
+            for (float* e : matricesOutSoa.m) poison(e, n);
+
+            size_t bytes = pointBytes - (soa && pointBytes ? sizeof(float) : 0) + matrixBytes;
+            BenchStats s = g_bench.Measure(test, TRANSFORM_VARIANTS[v], n, n * bytes, [&]() { run(k, v); });
+            rate[v] = n / s.medianNs * 1e3;
+
+            double error = transform_error(expected, magnitude, output(k, soa));
+            worst = max(worst, error);
+            if (!(error <= TRANSFORM_ERROR_LIMIT)) {
+                cout << "  [FAIL] " << TRANSFORM_KERNEL_NAMES[k] << " " << TRANSFORM_VARIANTS[v]
+                     << ": error " << error << " x FLT_EPSILON x |terms|\n";
+                correct = false;
+            }
+        }
+
+        cout << left << setw(21) << TRANSFORM_KERNEL_NAMES[k] << right << setprecision(1)
+             << setw(11) << rate[0] << setw(10) << rate[1] << setw(12) << rate[2] << setw(10) << rate[3];
+        if (simd) cout << setw(8) << rate[1] / rate[0] << "x" << setw(7) << rate[3] / rate[0] << "x";
+        else cout << setw(17) << "";
+        cout << setprecision(2) << setw(10) << worst << "\n";
     }
     cout << "Result: " << (correct ? "[OK] Match" : "[FAIL] Mismatch") << "\n";
 
-    _aligned_free(monsterX);
-    _aligned_free(monsterY);
-    _aligned_free(monsterZ);
-    _aligned_free(dist_scalar);
-    _aligned_free(dist_simd);
+    AlignedFree(points);
+    AlignedFree(pointsOut);
+    AlignedFree(a);
+    AlignedFree(b);
+    AlignedFree(matricesOut);
+    free_points_soa(pointsSoa);
+    free_points_soa(pointsOutSoa);
+    free_matrices_soa(aSoa);
+    free_matrices_soa(bSoa);
+    free_matrices_soa(matricesOutSoa);
 }
 
 // ============================================
 // Main
 // ============================================
-int main() {
+int main(int argc, char* argv[]) {
+    SimdLevel detected = DetectSimdLevel();
+    g_level = detected;
+
+    // --isa scalar|sse2|avx2|avx512 caps the dispatch (never above what the CPU has)
+    const char* csvPath = nullptr;
+    const char* jsonPath = nullptr;
+    bool cacheSweep = false;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        SimdLevel requested;
+        if (strcmp(argv[i], "--isa") == 0 && hasValue && ParseSimdLevel(argv[i + 1], requested)) {
+            if (requested < detected) g_level = requested;
+            i++;
+        } else if (strcmp(argv[i], "--reps") == 0 && hasValue) {
+            g_bench.config.repetitions = max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--warmup") == 0 && hasValue) {
+            g_bench.config.warmup = max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+            g_maxThreads = max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--sweep-max-mb") == 0 && hasValue) {
+            g_sweepMaxBytes = (size_t)max(1, atoi(argv[++i])) << 20;
+        } else if (strcmp(argv[i], "--cache-sweep") == 0) {
+            cacheSweep = true;
+        } else if (strcmp(argv[i], "--csv") == 0 && hasValue) {
+            csvPath = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && hasValue) {
+            jsonPath = argv[++i];
+        } else {
+            cout << "Usage: simd_benchmark [--isa scalar|sse2|avx2|avx512] [--reps n] [--warmup n]\n"
+                 << "                      [--threads n] [--sweep-max-mb n] [--cache-sweep]\n"
+                 << "                      [--csv file] [--json file]\n";
+            return 1;
+        }
+    }
+    if (g_maxThreads == 0) g_maxThreads = HardwareThreads();
+
     cout << "===========================================\n";
     cout << "     SIMD Performance Benchmark\n";
     cout << "===========================================\n";
-    cout << "CPU: SSE supported (128-bit register)\n";
-    cout << "Compiler: MSVC with SSE\n";
+    cout << "CPU: " << SimdLevelName(detected) << " supported (" << SimdLevelBits(detected) << "-bit register)\n";
+    cout << "Dispatch: " << SimdLevelName(g_level) << "\n";
+    cout << "Compiler: " << CompilerName() << "\n";
+    cout << "Harness: " << g_bench.config.warmup << " warmup + " << g_bench.config.repetitions
+         << " samples, TSC " << fixed << setprecision(2) << TscGhz() << " GHz\n";
+    cout << "Threads: up to " << g_maxThreads << " (" << HardwareThreads() << " hardware)\n";
 
-    test_vector_addition();
-    test_dot_product();
-    test_distance_calculation();
+    // --cache-sweep runs only the hierarchy sweep (it takes a while at 4x LLC)
+    if (cacheSweep) {
+        test_cache_hierarchy();
+    } else {
+        test_vector_addition();
+        test_dot_product();
+        test_distance_calculation();
+        test_dot_product_soa();
+        test_dot_reduction();
+        test_parallel_distance();
+        test_radius_query();
+        test_entity_layouts();
+        test_tail_handling();
+        test_store_strategies();
+        test_batched_transforms();
+    }
+
+    if (csvPath) {
+        cout << "\n" << (g_bench.WriteCsv(csvPath) ? "CSV written: " : "CSV write failed: ") << csvPath << "\n";
+    }
+    if (jsonPath) {
+        bool written = g_bench.WriteJson(jsonPath, {
+            { "dispatch", SimdLevelName(g_level) },
+            { "detected", SimdLevelName(detected) },
+            { "compiler", CompilerName() },
+        });
+        cout << (written ? "JSON written: " : "JSON write failed: ") << jsonPath << "\n";
+    }
 
     cout << "\n===========================================\n";
     cout << "     Benchmark Complete!\n";
@@ -0,0 +1,743 @@
+#pragma once
+
+// ============================================
+// Benchmark kernels at every width + runtime dispatch table
+//
+//   Scalar   1 float  / op   (reference)
+//   SSE2     4 floats / op   __m128
+//   AVX2     8 floats / op   __m256 + FMA
+//   AVX-512 16 floats / op   __m512
+//
+// Every kernel takes any element count and any alignment. The remainder
+// that does not fill a register is finished with masked loads / stores
+// (AVX2, AVX-512) or a scalar loop (SSE2, and the AoS dot product whose
+// pairs straddle registers). Loads are unaligned (same speed as aligned on
+// aligned data).
+// ============================================
+
+#include <algorithm>
+#include <cmath>
+#include "simd_platform.h"
+
+// ============================================
+// Tail masks: the first `remaining` lanes on (remaining < register width).
+// Masked-off lanes are neither read nor written, and cannot fault, so a
+// masked load at the very end of an allocation is safe.
+// ============================================
+SIMD_TARGET_AVX2 inline __m256i TailMask8(size_t remaining) {
+    static const int32_t lanes[16] = { -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0 };
+    return _mm256_loadu_si256((const __m256i*)(lanes + 8 - remaining));
+}
+
+inline __mmask16 TailMask16(size_t remaining) {
+    return (__mmask16)((1u << remaining) - 1);
+}
+
+// ============================================
+// Vector addition: out[i] = a[i] + b[i]
+// ============================================
+SIMD_SCALAR_FN inline void vector_add_scalar(const float* a, const float* b, float* out, size_t n) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+inline void vector_add_sse2(const float* a, const float* b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    for (; i < n; i++) out[i] = a[i] + b[i];
+}
+
+SIMD_TARGET_AVX2 inline void vector_add_avx2(const float* a, const float* b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    if (i < n) {
+        __m256i m = TailMask8(n - i);
+        _mm256_maskstore_ps(out + i, m, _mm256_add_ps(_mm256_maskload_ps(a + i, m), _mm256_maskload_ps(b + i, m)));
+    }
+}
+
+SIMD_TARGET_AVX512 inline void vector_add_avx512(const float* a, const float* b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    }
+    if (i < n) {
+        __mmask16 m = TailMask16(n - i);
+        _mm512_mask_storeu_ps(out + i, m, _mm512_add_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i)));
+    }
+}
+
+// ============================================
+// Vector addition, streaming (non-temporal) stores
+//
+// A normal store first reads the destination line into the cache (read
+// for ownership), then writes it back when evicted: 3 arrays cost 4 lines
+// of traffic, and the result pushes everything else out of the LLC.
+// Streaming stores fill a write-combining buffer and go straight to
+// memory: no RFO, no pollution. Only worth it when the result will not
+// be read again soon, i.e. when it would not stay in the cache anyway.
+// They need an aligned destination (head done with plain / masked stores)
+// and are weakly ordered, hence the sfence before returning.
+// ============================================
+SIMD_SCALAR_FN inline void vector_add_stream_scalar(const float* a, const float* b, float* out, size_t n) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) {
+        float sum = a[i] + b[i];
+        int bits;
+        memcpy(&bits, &sum, sizeof(bits));
+        _mm_stream_si32((int*)(out + i), bits);       // movnti: the scalar streaming store
+    }
+    _mm_sfence();
+}
+
+inline void vector_add_stream_sse2(const float* a, const float* b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i < n && ((uintptr_t)(out + i) & 15); i++) out[i] = a[i] + b[i];
+    for (; i + 4 <= n; i += 4) {
+        _mm_stream_ps(out + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    for (; i < n; i++) out[i] = a[i] + b[i];
+    _mm_sfence();
+}
+
+SIMD_TARGET_AVX2 inline void vector_add_stream_avx2(const float* a, const float* b, float* out, size_t n) {
+    size_t head = std::min(n, ((32 - ((uintptr_t)out & 31)) & 31) / sizeof(float));
+    vector_add_avx2(a, b, out, head);
+    size_t i = head;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_stream_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    vector_add_avx2(a + i, b + i, out + i, n - i);
+    _mm_sfence();
+}
+
+SIMD_TARGET_AVX512 inline void vector_add_stream_avx512(const float* a, const float* b, float* out, size_t n) {
+    size_t head = std::min(n, ((64 - ((uintptr_t)out & 63)) & 63) / sizeof(float));
+    vector_add_avx512(a, b, out, head);
+    size_t i = head;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_stream_ps(out + i, _mm512_add_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    }
+    vector_add_avx512(a + i, b + i, out + i, n - i);
+    _mm_sfence();
+}
+
+// ============================================
+// Vector addition, software prefetch
+// One prefetch per input cache line, `distanceBytes` ahead of the loads.
+// Too short and the line is still in flight when it is needed; too long
+// and it is evicted again before use (or wasted past the end of the array:
+// prefetches never fault). Linear streams are what the hardware
+// prefetcher already does well, so expect little gain - the sweep shows it.
+// ============================================
+SIMD_SCALAR_FN inline void vector_add_prefetch_scalar(const float* a, const float* b, float* out, size_t n,
+                                                      size_t distanceBytes) {
+    size_t ahead = distanceBytes / sizeof(float);
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) {
+        if ((i & 15) == 0) {
+            _mm_prefetch((const char*)(a + i + ahead), _MM_HINT_T0);
+            _mm_prefetch((const char*)(b + i + ahead), _MM_HINT_T0);
+        }
+        out[i] = a[i] + b[i];
+    }
+}
+
+inline void vector_add_prefetch_sse2(const float* a, const float* b, float* out, size_t n, size_t distanceBytes) {
+    size_t ahead = distanceBytes / sizeof(float);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm_prefetch((const char*)(a + i + ahead), _MM_HINT_T0);
+        _mm_prefetch((const char*)(b + i + ahead), _MM_HINT_T0);
+        for (size_t k = 0; k < 16; k += 4) {
+            _mm_storeu_ps(out + i + k, _mm_add_ps(_mm_loadu_ps(a + i + k), _mm_loadu_ps(b + i + k)));
+        }
+    }
+    vector_add_sse2(a + i, b + i, out + i, n - i);
+}
+
+SIMD_TARGET_AVX2 inline void vector_add_prefetch_avx2(const float* a, const float* b, float* out, size_t n,
+                                                      size_t distanceBytes) {
+    size_t ahead = distanceBytes / sizeof(float);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm_prefetch((const char*)(a + i + ahead), _MM_HINT_T0);
+        _mm_prefetch((const char*)(b + i + ahead), _MM_HINT_T0);
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        _mm256_storeu_ps(out + i + 8, _mm256_add_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    vector_add_avx2(a + i, b + i, out + i, n - i);
+}
+
+SIMD_TARGET_AVX512 inline void vector_add_prefetch_avx512(const float* a, const float* b, float* out, size_t n,
+                                                          size_t distanceBytes) {
+    size_t ahead = distanceBytes / sizeof(float);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm_prefetch((const char*)(a + i + ahead), _MM_HINT_T0);
+        _mm_prefetch((const char*)(b + i + ahead), _MM_HINT_T0);
+        _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    }
+    vector_add_avx512(a + i, b + i, out + i, n - i);
+}
+
+// ============================================
+// Dot product of 4-component vector pairs (AoS: x y z w x y z w ...)
+// out[i] = dot(a[4i..4i+3], b[4i..4i+3])
+// ============================================
+SIMD_SCALAR_FN inline void dot4_scalar(const float* a, const float* b, float* out, size_t count) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < count; i++) {
+        const float* pa = a + 4 * i;
+        const float* pb = b + 4 * i;
+        out[i] = pa[0] * pb[0] + pa[1] * pb[1] + pa[2] * pb[2] + pa[3] * pb[3];
+    }
+}
+
+// 4 pairs per step: multiply, transpose so each register holds one component
+// of all four products, then add vertically (SSE2 has no horizontal add)
+inline void dot4_sse2(const float* a, const float* b, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const float* pa = a + 4 * i;
+        const float* pb = b + 4 * i;
+        __m128 m0 = _mm_mul_ps(_mm_loadu_ps(pa + 0), _mm_loadu_ps(pb + 0));
+        __m128 m1 = _mm_mul_ps(_mm_loadu_ps(pa + 4), _mm_loadu_ps(pb + 4));
+        __m128 m2 = _mm_mul_ps(_mm_loadu_ps(pa + 8), _mm_loadu_ps(pb + 8));
+        __m128 m3 = _mm_mul_ps(_mm_loadu_ps(pa + 12), _mm_loadu_ps(pb + 12));
+        _MM_TRANSPOSE4_PS(m0, m1, m2, m3);
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_add_ps(m0, m1), _mm_add_ps(m2, m3)));
+    }
+    dot4_scalar(a + 4 * i, b + 4 * i, out + i, count - i);
+}
+
+// 8 pairs per step. hadd works inside 128-bit lanes, so after two rounds the
+// results come out as [p0 p2 p4 p6 | p1 p3 p5 p7] and one permute fixes the order.
+SIMD_TARGET_AVX2 inline void dot4_avx2(const float* a, const float* b, float* out, size_t count) {
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const float* pa = a + 4 * i;
+        const float* pb = b + 4 * i;
+        __m256 m0 = _mm256_mul_ps(_mm256_loadu_ps(pa + 0), _mm256_loadu_ps(pb + 0));
+        __m256 m1 = _mm256_mul_ps(_mm256_loadu_ps(pa + 8), _mm256_loadu_ps(pb + 8));
+        __m256 m2 = _mm256_mul_ps(_mm256_loadu_ps(pa + 16), _mm256_loadu_ps(pb + 16));
+        __m256 m3 = _mm256_mul_ps(_mm256_loadu_ps(pa + 24), _mm256_loadu_ps(pb + 24));
+        __m256 h = _mm256_hadd_ps(_mm256_hadd_ps(m0, m1), _mm256_hadd_ps(m2, m3));
+        _mm256_storeu_ps(out + i, _mm256_permutevar8x32_ps(h, order));
+    }
+    dot4_scalar(a + 4 * i, b + 4 * i, out + i, count - i);
+}
+
+// 16 pairs per step. Two in-lane swaps sum each group of four, leaving the
+// dot product in elements 0/4/8/12 of every register; two-source permutes
+// gather those into one register.
+SIMD_TARGET_AVX512 inline void dot4_avx512(const float* a, const float* b, float* out, size_t count) {
+    const __m512i gather = _mm512_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28, 0, 0, 0, 0, 0, 0, 0, 0);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const float* pa = a + 4 * i;
+        const float* pb = b + 4 * i;
+        __m512 m[4];
+        for (int k = 0; k < 4; k++) {
+            __m512 p = _mm512_mul_ps(_mm512_loadu_ps(pa + 16 * k), _mm512_loadu_ps(pb + 16 * k));
+            p = _mm512_add_ps(p, _mm512_permute_ps(p, _MM_SHUFFLE(2, 3, 0, 1)));
+            m[k] = _mm512_add_ps(p, _mm512_permute_ps(p, _MM_SHUFFLE(1, 0, 3, 2)));
+        }
+        __m512 lo = _mm512_permutex2var_ps(m[0], gather, m[1]);
+        __m512 hi = _mm512_permutex2var_ps(m[2], gather, m[3]);
+        _mm512_storeu_ps(out + i, _mm512_shuffle_f32x4(lo, hi, _MM_SHUFFLE(1, 0, 1, 0)));
+    }
+    dot4_scalar(a + 4 * i, b + 4 * i, out + i, count - i);
+}
+
+// ============================================
+// Batched dot product, SoA: component arrays instead of interleaved vec4s.
+// out[i] = a.x[i]*b.x[i] + a.y[i]*b.y[i] + a.z[i]*b.z[i] + a.w[i]*b.w[i]
+//
+// Lane i of every register belongs to pair i, so the whole product is
+// vertical multiply-adds: no shuffles, no horizontal adds, one full-width
+// store per step. (Lighting N.L, AI scoring: vec3 callers pass a zero w.)
+// ============================================
+struct Vec4Soa {
+    const float* x;
+    const float* y;
+    const float* z;
+    const float* w;
+};
+
+SIMD_SCALAR_FN inline void dot4_soa_scalar(Vec4Soa a, Vec4Soa b, float* out, size_t n) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) {
+        out[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i] + a.w[i] * b.w[i];
+    }
+}
+
+inline void dot4_soa_sse2(Vec4Soa a, Vec4Soa b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 xx = _mm_mul_ps(_mm_loadu_ps(a.x + i), _mm_loadu_ps(b.x + i));
+        __m128 yy = _mm_mul_ps(_mm_loadu_ps(a.y + i), _mm_loadu_ps(b.y + i));
+        __m128 zz = _mm_mul_ps(_mm_loadu_ps(a.z + i), _mm_loadu_ps(b.z + i));
+        __m128 ww = _mm_mul_ps(_mm_loadu_ps(a.w + i), _mm_loadu_ps(b.w + i));
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_add_ps(xx, yy), _mm_add_ps(zz, ww)));
+    }
+    for (; i < n; i++) out[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i] + a.w[i] * b.w[i];
+}
+
+SIMD_TARGET_AVX2 inline void dot4_soa_avx2(Vec4Soa a, Vec4Soa b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 acc = _mm256_mul_ps(_mm256_loadu_ps(a.x + i), _mm256_loadu_ps(b.x + i));
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(a.y + i), _mm256_loadu_ps(b.y + i), acc);
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(a.z + i), _mm256_loadu_ps(b.z + i), acc);
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(a.w + i), _mm256_loadu_ps(b.w + i), acc);
+        _mm256_storeu_ps(out + i, acc);
+    }
+    if (i < n) {
+        __m256i m = TailMask8(n - i);
+        __m256 acc = _mm256_mul_ps(_mm256_maskload_ps(a.x + i, m), _mm256_maskload_ps(b.x + i, m));
+        acc = _mm256_fmadd_ps(_mm256_maskload_ps(a.y + i, m), _mm256_maskload_ps(b.y + i, m), acc);
+        acc = _mm256_fmadd_ps(_mm256_maskload_ps(a.z + i, m), _mm256_maskload_ps(b.z + i, m), acc);
+        acc = _mm256_fmadd_ps(_mm256_maskload_ps(a.w + i, m), _mm256_maskload_ps(b.w + i, m), acc);
+        _mm256_maskstore_ps(out + i, m, acc);
+    }
+}
+
+SIMD_TARGET_AVX512 inline void dot4_soa_avx512(Vec4Soa a, Vec4Soa b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 acc = _mm512_mul_ps(_mm512_loadu_ps(a.x + i), _mm512_loadu_ps(b.x + i));
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(a.y + i), _mm512_loadu_ps(b.y + i), acc);
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(a.z + i), _mm512_loadu_ps(b.z + i), acc);
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(a.w + i), _mm512_loadu_ps(b.w + i), acc);
+        _mm512_storeu_ps(out + i, acc);
+    }
+    if (i < n) {
+        __mmask16 m = TailMask16(n - i);
+        __m512 acc = _mm512_mul_ps(_mm512_maskz_loadu_ps(m, a.x + i), _mm512_maskz_loadu_ps(m, b.x + i));
+        acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, a.y + i), _mm512_maskz_loadu_ps(m, b.y + i), acc);
+        acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, a.z + i), _mm512_maskz_loadu_ps(m, b.z + i), acc);
+        acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, a.w + i), _mm512_maskz_loadu_ps(m, b.w + i), acc);
+        _mm512_mask_storeu_ps(out + i, m, acc);
+    }
+}
+
+// ============================================
+// Long-array dot product (reduction): sum(a[i] * b[i])
+//
+// One accumulator makes every add wait for the previous one (4-cycle
+// latency, 2 FMA ports): at most 1/8 of peak. Four independent
+// accumulators keep both ports busy; they are combined once at the end.
+// ============================================
+inline float hsum_sse2(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+
+SIMD_TARGET_AVX2 inline float hsum_avx2(__m256 v) {
+    return hsum_sse2(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+SIMD_SCALAR_FN inline float dot_reduce_scalar(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+inline float dot_reduce_sse2(const float* a, const float* b, size_t n) {
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i + 0), _mm_loadu_ps(b + i + 0)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(a + i + 8), _mm_loadu_ps(b + i + 8)));
+        acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+    }
+    float sum = hsum_sse2(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+    for (; i < n; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+SIMD_TARGET_AVX2 inline float dot_reduce_avx2(const float* a, const float* b, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 0), _mm256_loadu_ps(b + i + 0), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+        acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), acc2);
+        acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), acc3);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    if (i < n) {
+        __m256i m = TailMask8(n - i);
+        acc1 = _mm256_fmadd_ps(_mm256_maskload_ps(a + i, m), _mm256_maskload_ps(b + i, m), acc1);
+    }
+    return hsum_avx2(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+}
+
+// Same loop with a single accumulator, to show what the dependency chain costs
+SIMD_TARGET_AVX2 inline float dot_reduce_avx2_1acc(const float* a, const float* b, size_t n) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc);
+    }
+    if (i < n) {
+        __m256i m = TailMask8(n - i);
+        acc = _mm256_fmadd_ps(_mm256_maskload_ps(a + i, m), _mm256_maskload_ps(b + i, m), acc);
+    }
+    return hsum_avx2(acc);
+}
+
+SIMD_TARGET_AVX512 inline float dot_reduce_avx512(const float* a, const float* b, size_t n) {
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 0), _mm512_loadu_ps(b + i + 0), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+        acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 32), _mm512_loadu_ps(b + i + 32), acc2);
+        acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 48), _mm512_loadu_ps(b + i + 48), acc3);
+    }
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+    }
+    if (i < n) {
+        __mmask16 m = TailMask16(n - i);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i), acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+
+// ============================================
+// Distance from one point to many (SoA: x[], y[], z[])
+// out[i] = sqrt((x[i]-px)^2 + (y[i]-py)^2 + (z[i]-pz)^2)
+// ============================================
+SIMD_SCALAR_FN inline void distance_scalar(const float* x, const float* y, const float* z,
+                                           float px, float py, float pz, float* out, size_t n) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) {
+        float dx = x[i] - px;
+        float dy = y[i] - py;
+        float dz = z[i] - pz;
+        out[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+}
+
+inline void distance_sse2(const float* x, const float* y, const float* z,
+                          float px, float py, float pz, float* out, size_t n) {
+    __m128 vpx = _mm_set1_ps(px);
+    __m128 vpy = _mm_set1_ps(py);
+    __m128 vpz = _mm_set1_ps(pz);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), vpx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), vpy);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), vpz);
+        __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(distSq));
+    }
+    distance_scalar(x + i, y + i, z + i, px, py, pz, out + i, n - i);
+}
+
+SIMD_TARGET_AVX2 inline void distance_avx2(const float* x, const float* y, const float* z,
+                                           float px, float py, float pz, float* out, size_t n) {
+    __m256 vpx = _mm256_set1_ps(px);
+    __m256 vpy = _mm256_set1_ps(py);
+    __m256 vpz = _mm256_set1_ps(pz);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), vpx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), vpy);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), vpz);
+        __m256 distSq = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+        _mm256_storeu_ps(out + i, _mm256_sqrt_ps(distSq));
+    }
+    if (i < n) {
+        __m256i m = TailMask8(n - i);
+        __m256 dx = _mm256_sub_ps(_mm256_maskload_ps(x + i, m), vpx);
+        __m256 dy = _mm256_sub_ps(_mm256_maskload_ps(y + i, m), vpy);
+        __m256 dz = _mm256_sub_ps(_mm256_maskload_ps(z + i, m), vpz);
+        __m256 distSq = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+        _mm256_maskstore_ps(out + i, m, _mm256_sqrt_ps(distSq));
+    }
+}
+
+SIMD_TARGET_AVX512 inline void distance_avx512(const float* x, const float* y, const float* z,
+                                               float px, float py, float pz, float* out, size_t n) {
+    __m512 vpx = _mm512_set1_ps(px);
+    __m512 vpy = _mm512_set1_ps(py);
+    __m512 vpz = _mm512_set1_ps(pz);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(x + i), vpx);
+        __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(y + i), vpy);
+        __m512 dz = _mm512_sub_ps(_mm512_loadu_ps(z + i), vpz);
+        __m512 distSq = _mm512_fmadd_ps(dx, dx, _mm512_fmadd_ps(dy, dy, _mm512_mul_ps(dz, dz)));
+        _mm512_storeu_ps(out + i, _mm512_sqrt_ps(distSq));
+    }
+    if (i < n) {
+        __mmask16 m = TailMask16(n - i);
+        __m512 dx = _mm512_sub_ps(_mm512_maskz_loadu_ps(m, x + i), vpx);
+        __m512 dy = _mm512_sub_ps(_mm512_maskz_loadu_ps(m, y + i), vpy);
+        __m512 dz = _mm512_sub_ps(_mm512_maskz_loadu_ps(m, z + i), vpz);
+        __m512 distSq = _mm512_fmadd_ps(dx, dx, _mm512_fmadd_ps(dy, dy, _mm512_mul_ps(dz, dz)));
+        _mm512_mask_storeu_ps(out + i, m, _mm512_sqrt_ps(distSq));
+    }
+}
+
+// ============================================
+// Radius query with stream compaction (SoA: x[], y[], z[])
+// "Which monsters are within R of this player": compare squared distance
+// against R^2 (no sqrt) and append the matching indices to a list.
+//
+// Several queries (players) share one pass: monsters are processed in
+// blocks small enough to stay in L1, and every query scans the block
+// before the next one is loaded from memory. Each query keeps its count in
+// a register for the whole block.
+//
+// SIMD kernels store a full vector of indices at indices + count and then
+// advance count by the number of matches, so the list needs
+// RADIUS_QUERY_SLACK entries of room past n. No branch on the compare
+// result, so the speed does not depend on how predictable the matches are.
+// ============================================
+const size_t RADIUS_QUERY_SLACK = 16;
+const size_t RADIUS_QUERY_BLOCK = 1024;     // 12 KB of x/y/z
+
+struct RadiusQuery {
+    float px, py, pz;
+    float radiusSq;
+    uint32_t* indices;      // capacity: n + RADIUS_QUERY_SLACK
+    size_t count;           // out: number of indices written
+};
+
+// Compaction table: entry[mask] lists the set lanes of mask, packed low.
+// The monster indices of a block are base + {0, 1, 2, ...}, so
+// base + entry[mask] is already the compacted index vector. (To compact
+// arbitrary data the entry would instead feed a pshufb / permutevar.)
+template <int LANES>
+struct CompactTable {
+    alignas(32) uint32_t lanes[1 << LANES][8];
+    uint8_t count[1 << LANES];
+
+    CompactTable() {
+        for (int mask = 0; mask < (1 << LANES); mask++) {
+            int k = 0;
+            for (int bit = 0; bit < LANES; bit++) {
+                if (mask & (1 << bit)) lanes[mask][k++] = (uint32_t)bit;
+            }
+            count[mask] = (uint8_t)k;
+            for (; k < 8; k++) lanes[mask][k] = 0;
+        }
+    }
+};
+
+template <int LANES>
+inline const CompactTable<LANES>& GetCompactTable() {
+    static const CompactTable<LANES> table;
+    return table;
+}
+
+// Scalar reference, and the remainder loop of the SSE2 version
+SIMD_SCALAR_FN inline void radius_query_range(const float* x, const float* y, const float* z,
+                                              size_t begin, size_t n, RadiusQuery* queries, int queryCount) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = begin; i < n; i++) {
+        for (int q = 0; q < queryCount; q++) {
+            RadiusQuery& rq = queries[q];
+            float dx = x[i] - rq.px;
+            float dy = y[i] - rq.py;
+            float dz = z[i] - rq.pz;
+            if (dx * dx + dy * dy + dz * dz <= rq.radiusSq) rq.indices[rq.count++] = (uint32_t)i;
+        }
+    }
+}
+
+inline void radius_query_scalar(const float* x, const float* y, const float* z, size_t n,
+                                RadiusQuery* queries, int queryCount) {
+    for (int q = 0; q < queryCount; q++) queries[q].count = 0;
+    radius_query_range(x, y, z, 0, n, queries, queryCount);
+}
+
+// movemask -> 16-entry table
+inline void radius_query_sse2(const float* x, const float* y, const float* z, size_t n,
+                              RadiusQuery* queries, int queryCount) {
+    const CompactTable<4>& table = GetCompactTable<4>();
+    for (int q = 0; q < queryCount; q++) queries[q].count = 0;
+    size_t vectorEnd = n & ~(size_t)3;
+    for (size_t block = 0; block < vectorEnd; block += RADIUS_QUERY_BLOCK) {
+        size_t blockEnd = std::min(block + RADIUS_QUERY_BLOCK, vectorEnd);
+        for (int q = 0; q < queryCount; q++) {
+            RadiusQuery& rq = queries[q];
+            __m128 px = _mm_set1_ps(rq.px), py = _mm_set1_ps(rq.py), pz = _mm_set1_ps(rq.pz);
+            __m128 radiusSq = _mm_set1_ps(rq.radiusSq);
+            uint32_t* out = rq.indices;
+            size_t count = rq.count;
+            for (size_t i = block; i < blockEnd; i += 4) {
+                __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), px);
+                __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), py);
+                __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), pz);
+                __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                int mask = _mm_movemask_ps(_mm_cmple_ps(distSq, radiusSq));
+                __m128i lanes = _mm_load_si128((const __m128i*)table.lanes[mask]);
+                _mm_storeu_si128((__m128i*)(out + count), _mm_add_epi32(_mm_set1_epi32((int)i), lanes));
+                count += table.count[mask];
+            }
+            rq.count = count;
+        }
+    }
+    radius_query_range(x, y, z, vectorEnd, n, queries, queryCount);
+}
+
+// movemask -> 256-entry table (8 KB, stays in L1 next to the block)
+SIMD_TARGET_AVX2 inline void radius_query_avx2(const float* x, const float* y, const float* z, size_t n,
+                                               RadiusQuery* queries, int queryCount) {
+    const CompactTable<8>& table = GetCompactTable<8>();
+    for (int q = 0; q < queryCount; q++) queries[q].count = 0;
+    size_t vectorEnd = n & ~(size_t)7;
+    for (size_t block = 0; block < vectorEnd; block += RADIUS_QUERY_BLOCK) {
+        size_t blockEnd = std::min(block + RADIUS_QUERY_BLOCK, vectorEnd);
+        for (int q = 0; q < queryCount; q++) {
+            RadiusQuery& rq = queries[q];
+            __m256 px = _mm256_set1_ps(rq.px), py = _mm256_set1_ps(rq.py), pz = _mm256_set1_ps(rq.pz);
+            __m256 radiusSq = _mm256_set1_ps(rq.radiusSq);
+            uint32_t* out = rq.indices;
+            size_t count = rq.count;
+            for (size_t i = block; i < blockEnd; i += 8) {
+                __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), px);
+                __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), py);
+                __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), pz);
+                __m256 distSq = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+                int mask = _mm256_movemask_ps(_mm256_cmp_ps(distSq, radiusSq, _CMP_LE_OQ));
+                __m256i lanes = _mm256_load_si256((const __m256i*)table.lanes[mask]);
+                _mm256_storeu_si256((__m256i*)(out + count), _mm256_add_epi32(_mm256_set1_epi32((int)i), lanes));
+                count += table.count[mask];
+            }
+            rq.count = count;
+        }
+    }
+    if (vectorEnd < n) {
+        __m256i m = TailMask8(n - vectorEnd);
+        int tail = (1 << (n - vectorEnd)) - 1;
+        __m256 vx = _mm256_maskload_ps(x + vectorEnd, m);
+        __m256 vy = _mm256_maskload_ps(y + vectorEnd, m);
+        __m256 vz = _mm256_maskload_ps(z + vectorEnd, m);
+        __m256i base = _mm256_set1_epi32((int)vectorEnd);
+        for (int q = 0; q < queryCount; q++) {
+            RadiusQuery& rq = queries[q];
+            __m256 dx = _mm256_sub_ps(vx, _mm256_set1_ps(rq.px));
+            __m256 dy = _mm256_sub_ps(vy, _mm256_set1_ps(rq.py));
+            __m256 dz = _mm256_sub_ps(vz, _mm256_set1_ps(rq.pz));
+            __m256 distSq = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(distSq, _mm256_set1_ps(rq.radiusSq), _CMP_LE_OQ)) & tail;
+            __m256i lanes = _mm256_load_si256((const __m256i*)table.lanes[mask]);
+            _mm256_storeu_si256((__m256i*)(rq.indices + rq.count), _mm256_add_epi32(base, lanes));
+            rq.count += table.count[mask];
+        }
+    }
+}
+
+// Compare straight into a mask register, compress in a register, store the
+// whole vector. (compressstoreu to memory is microcoded and slow on AMD.)
+SIMD_TARGET_AVX512 inline void radius_query_avx512(const float* x, const float* y, const float* z, size_t n,
+                                                   RadiusQuery* queries, int queryCount) {
+    const CompactTable<8>& table = GetCompactTable<8>();
+    const __m512i iota = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    for (int q = 0; q < queryCount; q++) queries[q].count = 0;
+    size_t vectorEnd = n & ~(size_t)15;
+    for (size_t block = 0; block < vectorEnd; block += RADIUS_QUERY_BLOCK) {
+        size_t blockEnd = std::min(block + RADIUS_QUERY_BLOCK, vectorEnd);
+        for (int q = 0; q < queryCount; q++) {
+            RadiusQuery& rq = queries[q];
+            __m512 px = _mm512_set1_ps(rq.px), py = _mm512_set1_ps(rq.py), pz = _mm512_set1_ps(rq.pz);
+            __m512 radiusSq = _mm512_set1_ps(rq.radiusSq);
+            uint32_t* out = rq.indices;
+            size_t count = rq.count;
+            for (size_t i = block; i < blockEnd; i += 16) {
+                __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(x + i), px);
+                __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(y + i), py);
+                __m512 dz = _mm512_sub_ps(_mm512_loadu_ps(z + i), pz);
+                __m512 distSq = _mm512_fmadd_ps(dx, dx, _mm512_fmadd_ps(dy, dy, _mm512_mul_ps(dz, dz)));
+                __mmask16 mask = _mm512_cmp_ps_mask(distSq, radiusSq, _CMP_LE_OQ);
+                __m512i index = _mm512_add_epi32(_mm512_set1_epi32((int)i), iota);
+                _mm512_storeu_si512(out + count, _mm512_maskz_compress_epi32(mask, index));
+                count += table.count[mask & 0xFF] + table.count[mask >> 8];
+            }
+            rq.count = count;
+        }
+    }
+    if (vectorEnd < n) {
+        __mmask16 m = TailMask16(n - vectorEnd);
+        __m512 vx = _mm512_maskz_loadu_ps(m, x + vectorEnd);
+        __m512 vy = _mm512_maskz_loadu_ps(m, y + vectorEnd);
+        __m512 vz = _mm512_maskz_loadu_ps(m, z + vectorEnd);
+        __m512i index = _mm512_add_epi32(_mm512_set1_epi32((int)vectorEnd), iota);
+        for (int q = 0; q < queryCount; q++) {
+            RadiusQuery& rq = queries[q];
+            __m512 dx = _mm512_sub_ps(vx, _mm512_set1_ps(rq.px));
+            __m512 dy = _mm512_sub_ps(vy, _mm512_set1_ps(rq.py));
+            __m512 dz = _mm512_sub_ps(vz, _mm512_set1_ps(rq.pz));
+            __m512 distSq = _mm512_fmadd_ps(dx, dx, _mm512_fmadd_ps(dy, dy, _mm512_mul_ps(dz, dz)));
+            __mmask16 mask = _mm512_mask_cmp_ps_mask(m, distSq, _mm512_set1_ps(rq.radiusSq), _CMP_LE_OQ);
+            _mm512_storeu_si512(rq.indices + rq.count, _mm512_maskz_compress_epi32(mask, index));
+            rq.count += table.count[mask & 0xFF] + table.count[mask >> 8];
+        }
+    }
+}
+
+// ============================================
+// Dispatch table: one entry per level, picked once at startup
+// ============================================
+struct SimdKernels {
+    SimdLevel level;
+    void (*vector_add)(const float* a, const float* b, float* out, size_t n);
+    void (*vector_add_stream)(const float* a, const float* b, float* out, size_t n);
+    void (*vector_add_prefetch)(const float* a, const float* b, float* out, size_t n, size_t distanceBytes);
+    void (*dot4)(const float* a, const float* b, float* out, size_t count);
+    void (*dot4_soa)(Vec4Soa a, Vec4Soa b, float* out, size_t n);
+    float (*dot_reduce)(const float* a, const float* b, size_t n);
+    void (*distance)(const float* x, const float* y, const float* z,
+                     float px, float py, float pz, float* out, size_t n);
+    void (*radius_query)(const float* x, const float* y, const float* z, size_t n,
+                         RadiusQuery* queries, int queryCount);
+};
+
+inline const SimdKernels& KernelsFor(SimdLevel level) {
+    static const SimdKernels table[] = {
+        { SimdLevel::Scalar, vector_add_scalar, vector_add_stream_scalar, vector_add_prefetch_scalar, dot4_scalar, dot4_soa_scalar, dot_reduce_scalar, distance_scalar, radius_query_scalar },
+        { SimdLevel::SSE2,   vector_add_sse2,   vector_add_stream_sse2,   vector_add_prefetch_sse2,   dot4_sse2,   dot4_soa_sse2,   dot_reduce_sse2,   distance_sse2,   radius_query_sse2 },
+        { SimdLevel::AVX2,   vector_add_avx2,   vector_add_stream_avx2,   vector_add_prefetch_avx2,   dot4_avx2,   dot4_soa_avx2,   dot_reduce_avx2,   distance_avx2,   radius_query_avx2 },
+        { SimdLevel::AVX512, vector_add_avx512, vector_add_stream_avx512, vector_add_prefetch_avx512, dot4_avx512, dot4_soa_avx512, dot_reduce_avx512, distance_avx512, radius_query_avx512 },
+    };
+    return table[(int)level];
+}
+
+// ============================================
+// Store strategy picked by working set: plain stores while a + b + out
+// fits in the last-level cache (the result can be read back from it),
+// streaming stores once it does not (it would be evicted anyway).
+// ============================================
+inline bool PreferStreamingStores(size_t workingSetBytes) {
+    return workingSetBytes > LastLevelCacheBytes();
+}
+
+inline void vector_add_auto(const SimdKernels& k, const float* a, const float* b, float* out, size_t n) {
+    if (PreferStreamingStores(3 * n * sizeof(float))) k.vector_add_stream(a, b, out, n);
+    else k.vector_add(a, b, out, n);
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+// ============================================
+// Platform layer: CPU feature detection, per-function ISA targets,
+// aligned allocation. Works with MSVC, GCC and Clang on x86/x64.
+// ============================================
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if !(defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#error "simd_benchmark targets x86/x64 (SSE2 / AVX2 / AVX-512)"
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <malloc.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+
+// GCC/Clang only emit AVX instructions inside functions that ask for them,
+// so the whole file can be built for the SSE2 baseline and still carry the
+// wider kernels. MSVC allows any intrinsic anywhere, so the macros are empty.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX512
+#else
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512bw,avx512vl,avx2,fma")))
+#endif
+
+// Scalar reference kernels must stay scalar, otherwise -O2/-O3 turns them
+// into SSE code and the comparison is SIMD vs SIMD. GCC has no loop pragma
+// for this before GCC 14, so it gets a function attribute instead.
+#if defined(__clang__)
+#define SIMD_SCALAR_FN
+#define SIMD_SCALAR_LOOP _Pragma("clang loop vectorize(disable) interleave(disable)")
+#elif defined(_MSC_VER)
+#define SIMD_SCALAR_FN
+#define SIMD_SCALAR_LOOP __pragma(loop(no_vector))
+#else
+#define SIMD_SCALAR_FN __attribute__((optimize("no-tree-vectorize")))
+#define SIMD_SCALAR_LOOP
+#endif
+
+enum class SimdLevel {
+    Scalar = 0,
+    SSE2 = 1,
+    AVX2 = 2,      // AVX2 + FMA
+    AVX512 = 3,    // F + DQ + BW + VL (Skylake-SP and later)
+};
+
+inline const char* SimdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar: return "Scalar";
+    case SimdLevel::SSE2:   return "SSE2";
+    case SimdLevel::AVX2:   return "AVX2";
+    case SimdLevel::AVX512: return "AVX-512";
+    }
+    return "?";
+}
+
+inline int SimdLevelBits(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::SSE2:   return 128;
+    case SimdLevel::AVX2:   return 256;
+    case SimdLevel::AVX512: return 512;
+    default:                return 32;
+    }
+}
+
+// Accepts "scalar", "sse2", "avx2", "avx512". Returns false for anything else.
+inline bool ParseSimdLevel(const char* text, SimdLevel& level) {
+    if (strcmp(text, "scalar") == 0) level = SimdLevel::Scalar;
+    else if (strcmp(text, "sse2") == 0) level = SimdLevel::SSE2;
+    else if (strcmp(text, "avx2") == 0) level = SimdLevel::AVX2;
+    else if (strcmp(text, "avx512") == 0) level = SimdLevel::AVX512;
+    else return false;
+    return true;
+}
+
+inline void CpuId(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; i++) regs[i] = (uint32_t)r[i];
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// XCR0: which register states the OS saves on a context switch
+inline uint64_t ReadXcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+// Highest level both the CPU and the OS support. A CPU flag alone is not
+// enough: without OS support (XCR0) the upper register halves are not saved.
+inline SimdLevel DetectSimdLevel() {
+    uint32_t regs[4];
+    CpuId(0, 0, regs);
+    uint32_t maxLeaf = regs[0];
+
+    CpuId(1, 0, regs);
+    bool sse2 = (regs[3] & (1u << 26)) != 0;
+    bool fma = (regs[2] & (1u << 12)) != 0;
+    bool osxsave = (regs[2] & (1u << 27)) != 0;
+    bool avx = (regs[2] & (1u << 28)) != 0;
+    if (!sse2) return SimdLevel::Scalar;
+    if (!osxsave || !avx || maxLeaf < 7) return SimdLevel::SSE2;
+
+    uint64_t xcr0 = ReadXcr0();
+    bool osYmm = (xcr0 & 0x6) == 0x6;       // XMM + YMM
+    bool osZmm = (xcr0 & 0xE6) == 0xE6;     // + opmask, ZMM0-15 upper, ZMM16-31
+
+    CpuId(7, 0, regs);
+    bool avx2 = (regs[1] & (1u << 5)) != 0;
+    bool avx512f = (regs[1] & (1u << 16)) != 0;
+    bool avx512dq = (regs[1] & (1u << 17)) != 0;
+    bool avx512bw = (regs[1] & (1u << 30)) != 0;
+    bool avx512vl = (regs[1] & (1u << 31)) != 0;
+
+    if (!osYmm || !avx2 || !fma) return SimdLevel::SSE2;
+    if (!osZmm || !avx512f || !avx512dq || !avx512bw || !avx512vl) return SimdLevel::AVX2;
+    return SimdLevel::AVX512;
+}
+
+// ============================================
+// Cache sizes from CPUID (deterministic cache parameters: leaf 4 on Intel,
+// 0x8000001D on AMD). Data or unified caches only.
+// ============================================
+inline size_t CpuCacheBytes(int level) {
+    uint32_t regs[4];
+    CpuId(0, 0, regs);
+    uint32_t maxLeaf = regs[0];
+    CpuId(0x80000000, 0, regs);
+    uint32_t maxExtLeaf = regs[0];
+
+    uint32_t leaf = 0;
+    if (maxLeaf >= 4) {
+        CpuId(4, 0, regs);
+        if (regs[0] & 0x1F) leaf = 4;
+    }
+    if (leaf == 0 && maxExtLeaf >= 0x8000001D) {
+        CpuId(0x80000001, 0, regs);
+        if (regs[2] & (1u << 22)) leaf = 0x8000001D;     // TOPOEXT
+    }
+    if (leaf == 0) return 0;
+
+    for (uint32_t sub = 0; sub < 16; sub++) {
+        CpuId(leaf, sub, regs);
+        uint32_t type = regs[0] & 0x1F;                 // 0 none, 1 data, 2 instruction, 3 unified
+        if (type == 0) break;
+        if (type == 2 || (int)((regs[0] >> 5) & 0x7) != level) continue;
+        size_t ways = ((regs[1] >> 22) & 0x3FF) + 1;
+        size_t partitions = ((regs[1] >> 12) & 0x3FF) + 1;
+        size_t lineSize = (regs[1] & 0xFFF) + 1;
+        size_t sets = (size_t)regs[2] + 1;
+        return ways * partitions * lineSize * sets;
+    }
+    return 0;
+}
+
+// Largest cache level present (8 MB if the CPU does not say)
+inline size_t LastLevelCacheBytes() {
+    static size_t bytes = 0;
+    if (bytes == 0) {
+        for (int level = 3; level >= 1 && bytes == 0; level--) bytes = CpuCacheBytes(level);
+        if (bytes == 0) bytes = 8u << 20;
+    }
+    return bytes;
+}
+
+inline const char* CompilerName() {
+#if defined(__clang__)
+    return "Clang " __clang_version__;
+#elif defined(_MSC_VER)
+    return "MSVC";
+#elif defined(__GNUC__)
+    return "GCC " __VERSION__;
+#else
+    return "unknown";
+#endif
+}
+
+// ============================================
+// Aligned allocation (_aligned_malloc is MSVC-only)
+// ============================================
+inline void* AlignedAlloc(size_t bytes, size_t alignment = 64) {
+#if defined(_MSC_VER)
+    return _aligned_malloc(bytes, alignment);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, alignment, bytes) != 0) return nullptr;
+    return p;
+#endif
+}
+
+inline void AlignedFree(void* p) {
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+template <typename T>
+T* AlignedArray(size_t count, size_t alignment = 64) {
+    return (T*)AlignedAlloc(count * sizeof(T), alignment);
+}
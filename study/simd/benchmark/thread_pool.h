@@ -0,0 +1,127 @@
+#pragma once
+
+// ============================================
+// Fixed thread pool for the multi-threaded kernels
+//
+//   - N workers, created once and pinned to CPUs 0..N-1, so the timed
+//     loop pays one wake-up per call, not a thread creation
+//   - Run(fn) calls fn(index) on every worker and waits for all of them
+//   - ChunkRange() gives worker i the same slice every time. Initialize the
+//     data through the pool with the same split (first touch): the OS puts
+//     each page on the NUMA node of the thread that writes it first, so
+//     every worker later reads from its local memory controller.
+// ============================================
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+inline int HardwareThreads() {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n ? (int)n : 1;
+}
+
+// Pins the calling thread to one logical CPU (best effort)
+inline void PinCurrentThread(int cpu) {
+    cpu %= HardwareThreads();
+#if defined(_WIN32)
+    if (cpu < 64) SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+// [begin, end) of part `index` out of `parts`. Boundaries are multiples of
+// 16 floats (one cache line), so no two workers write the same line.
+inline void ChunkRange(size_t n, int parts, int index, size_t& begin, size_t& end) {
+    const size_t line = 16;
+    size_t lines = (n + line - 1) / line;
+    begin = std::min(n, lines * index / parts * line);
+    end = std::min(n, lines * (index + 1) / parts * line);
+}
+
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads) : size(threads < 1 ? 1 : threads) {
+        for (int i = 0; i < size; i++) {
+            workers.emplace_back([this, i]() { WorkerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int Size() const { return size; }
+
+    void Run(const std::function<void(int)>& fn) {
+        std::unique_lock<std::mutex> lock(mutex);
+        job = &fn;
+        pending = size;
+        generation++;
+        wake.notify_all();
+        done.wait(lock, [this]() { return pending == 0; });
+        job = nullptr;
+    }
+
+private:
+    void WorkerLoop(int index) {
+        PinCurrentThread(index);
+        unsigned long long seen = 0;
+        for (;;) {
+            const std::function<void(int)>* fn;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                fn = job;
+            }
+            (*fn)(index);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--pending == 0) done.notify_one();
+            }
+        }
+    }
+
+    int size;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(int)>* job = nullptr;
+    unsigned long long generation = 0;
+    int pending = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,283 @@
+#pragma once
+
+// ============================================
+// Batched 4x4 transforms (animation, world transforms, culling)
+//
+//   transform_points         N points x 1 matrix      (world / view transform)
+//   transform_points_each    N points x N matrices    (skinning, instances)
+//   multiply_matrices        N matrix pairs           (local x parent)
+//
+// Conventions follow DirectXMath: row-major matrices, row vectors,
+// p' = p * M with the translation in row 3. Points are (x, y, z, 1) like
+// XMVector3Transform: the input w is ignored and the output w is not
+// divided out.
+//
+// Every kernel comes in AoS form (Float4 / Matrix4 arrays, what the engine
+// stores) and SoA form (one array per component / matrix element), as a
+// scalar version and an AVX2 + FMA version.
+//   AoS AVX2  two points (or two matrix rows) per register, the x / y / z
+//             splat with in-lane permutes
+//   SoA AVX2  eight points (or matrices) per register, vertical FMAs only
+// The scalar versions evaluate in DirectXMath's order with separate mul and
+// add; the AVX2 versions fuse them, so results differ by a few ULP of the
+// terms, not bit for bit.
+// ============================================
+
+#include "simd_kernels.h"
+
+struct alignas(16) Float4 {
+    float x, y, z, w;
+};
+
+struct alignas(64) Matrix4 {
+    float m[4][4];
+};
+
+// Point i is (x[i], y[i], z[i], w[i])
+struct Points4Soa {
+    float *x, *y, *z, *w;
+};
+
+// Element [r][c] of matrix i is m[r * 4 + c][i]
+struct Matrices4Soa {
+    float* m[16];
+};
+
+// ============================================
+// Scalar references (XMVector3Transform / XMMatrixMultiply)
+// ============================================
+
+// z * r2 + r3, then y * r1 + that, then x * r0 + that
+SIMD_SCALAR_FN inline Float4 vector3_transform_ref(const Float4& p, const Matrix4& m) {
+    Float4 r;
+    r.x = p.x * m.m[0][0] + (p.y * m.m[1][0] + (p.z * m.m[2][0] + m.m[3][0]));
+    r.y = p.x * m.m[0][1] + (p.y * m.m[1][1] + (p.z * m.m[2][1] + m.m[3][1]));
+    r.z = p.x * m.m[0][2] + (p.y * m.m[1][2] + (p.z * m.m[2][2] + m.m[3][2]));
+    r.w = p.x * m.m[0][3] + (p.y * m.m[1][3] + (p.z * m.m[2][3] + m.m[3][3]));
+    return r;
+}
+
+// Row i of the result is row i of a times b, summed as
+// (a0 * b0 + a2 * b2) + (a1 * b1 + a3 * b3): two independent chains
+SIMD_SCALAR_FN inline Matrix4 matrix_multiply_ref(const Matrix4& a, const Matrix4& b) {
+    Matrix4 r;
+    SIMD_SCALAR_LOOP
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            r.m[i][j] = (a.m[i][0] * b.m[0][j] + a.m[i][2] * b.m[2][j]) +
+                        (a.m[i][1] * b.m[1][j] + a.m[i][3] * b.m[3][j]);
+        }
+    }
+    return r;
+}
+
+inline Float4 LoadPoint(const Points4Soa& p, size_t i) {
+    Float4 r = { p.x[i], p.y[i], p.z[i], p.w[i] };
+    return r;
+}
+
+inline void StorePoint(const Points4Soa& p, size_t i, const Float4& v) {
+    p.x[i] = v.x;
+    p.y[i] = v.y;
+    p.z[i] = v.z;
+    p.w[i] = v.w;
+}
+
+inline Matrix4 LoadMatrix(const Matrices4Soa& s, size_t i) {
+    Matrix4 r;
+    for (int e = 0; e < 16; e++) r.m[e / 4][e % 4] = s.m[e][i];
+    return r;
+}
+
+inline void StoreMatrix(const Matrices4Soa& s, size_t i, const Matrix4& v) {
+    for (int e = 0; e < 16; e++) s.m[e][i] = v.m[e / 4][e % 4];
+}
+
+// ============================================
+// N points x 1 matrix
+// ============================================
+SIMD_SCALAR_FN inline void transform_points_aos_scalar(const Matrix4& m, const Float4* in, Float4* out, size_t n) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) out[i] = vector3_transform_ref(in[i], m);
+}
+
+SIMD_SCALAR_FN inline void transform_points_soa_scalar(const Matrix4& m, Points4Soa in, Points4Soa out, size_t n) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) StorePoint(out, i, vector3_transform_ref(LoadPoint(in, i), m));
+}
+
+// One point in an XMM register (the odd one out of the AoS loops)
+SIMD_TARGET_AVX2 inline __m128 transform_point_sse(__m128 p, __m128 r0, __m128 r1, __m128 r2, __m128 r3) {
+    __m128 x = _mm_permute_ps(p, 0x00);
+    __m128 y = _mm_permute_ps(p, 0x55);
+    __m128 z = _mm_permute_ps(p, 0xAA);
+    return _mm_fmadd_ps(x, r0, _mm_fmadd_ps(y, r1, _mm_fmadd_ps(z, r2, r3)));
+}
+
+// Two points per register, matrix rows broadcast to both halves
+SIMD_TARGET_AVX2 inline void transform_points_aos_avx2(const Matrix4& m, const Float4* in, Float4* out, size_t n) {
+    __m256 r0 = _mm256_broadcast_ps((const __m128*)m.m[0]);
+    __m256 r1 = _mm256_broadcast_ps((const __m128*)m.m[1]);
+    __m256 r2 = _mm256_broadcast_ps((const __m128*)m.m[2]);
+    __m256 r3 = _mm256_broadcast_ps((const __m128*)m.m[3]);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m256 p = _mm256_loadu_ps(&in[i].x);
+        __m256 x = _mm256_permute_ps(p, 0x00);
+        __m256 y = _mm256_permute_ps(p, 0x55);
+        __m256 z = _mm256_permute_ps(p, 0xAA);
+        _mm256_storeu_ps(&out[i].x, _mm256_fmadd_ps(x, r0, _mm256_fmadd_ps(y, r1, _mm256_fmadd_ps(z, r2, r3))));
+    }
+    if (i < n) {
+        _mm_store_ps(&out[i].x, transform_point_sse(_mm_load_ps(&in[i].x), _mm256_castps256_ps128(r0),
+                                                    _mm256_castps256_ps128(r1), _mm256_castps256_ps128(r2),
+                                                    _mm256_castps256_ps128(r3)));
+    }
+}
+
+// Eight points; MASKED covers the last n % 8 with maskload / maskstore
+template <bool MASKED>
+SIMD_TARGET_AVX2 inline void transform_points_soa_block(const __m256 m[16], const Points4Soa& in,
+                                                        const Points4Soa& out, size_t i, __m256i mask) {
+    __m256 x = MASKED ? _mm256_maskload_ps(in.x + i, mask) : _mm256_loadu_ps(in.x + i);
+    __m256 y = MASKED ? _mm256_maskload_ps(in.y + i, mask) : _mm256_loadu_ps(in.y + i);
+    __m256 z = MASKED ? _mm256_maskload_ps(in.z + i, mask) : _mm256_loadu_ps(in.z + i);
+    float* const dst[4] = { out.x, out.y, out.z, out.w };
+    for (int c = 0; c < 4; c++) {
+        __m256 r = _mm256_fmadd_ps(x, m[c], _mm256_fmadd_ps(y, m[4 + c], _mm256_fmadd_ps(z, m[8 + c], m[12 + c])));
+        if (MASKED) _mm256_maskstore_ps(dst[c] + i, mask, r);
+        else _mm256_storeu_ps(dst[c] + i, r);
+    }
+}
+
+SIMD_TARGET_AVX2 inline void transform_points_soa_avx2(const Matrix4& m, Points4Soa in, Points4Soa out, size_t n) {
+    __m256 e[16];
+    for (int k = 0; k < 16; k++) e[k] = _mm256_set1_ps(m.m[k / 4][k % 4]);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) transform_points_soa_block<false>(e, in, out, i, _mm256_setzero_si256());
+    if (i < n) transform_points_soa_block<true>(e, in, out, i, TailMask8(n - i));
+}
+
+// ============================================
+// N points x N matrices: out[i] = in[i] * m[i]
+// ============================================
+SIMD_SCALAR_FN inline void transform_points_each_aos_scalar(const Matrix4* m, const Float4* in, Float4* out, size_t n) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) out[i] = vector3_transform_ref(in[i], m[i]);
+}
+
+SIMD_SCALAR_FN inline void transform_points_each_soa_scalar(Matrices4Soa m, Points4Soa in, Points4Soa out, size_t n) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) StorePoint(out, i, vector3_transform_ref(LoadPoint(in, i), LoadMatrix(m, i)));
+}
+
+// Row k of matrix i in the low half, of matrix i + 1 in the high half
+SIMD_TARGET_AVX2 inline __m256 LoadRowPair(const Matrix4* m, size_t i, int k) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(m[i].m[k])), _mm_load_ps(m[i + 1].m[k]), 1);
+}
+
+SIMD_TARGET_AVX2 inline void transform_points_each_aos_avx2(const Matrix4* m, const Float4* in, Float4* out, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m256 p = _mm256_loadu_ps(&in[i].x);
+        __m256 x = _mm256_permute_ps(p, 0x00);
+        __m256 y = _mm256_permute_ps(p, 0x55);
+        __m256 z = _mm256_permute_ps(p, 0xAA);
+        __m256 r = _mm256_fmadd_ps(z, LoadRowPair(m, i, 2), LoadRowPair(m, i, 3));
+        r = _mm256_fmadd_ps(y, LoadRowPair(m, i, 1), r);
+        _mm256_storeu_ps(&out[i].x, _mm256_fmadd_ps(x, LoadRowPair(m, i, 0), r));
+    }
+    if (i < n) {
+        _mm_store_ps(&out[i].x, transform_point_sse(_mm_load_ps(&in[i].x), _mm_load_ps(m[i].m[0]),
+                                                    _mm_load_ps(m[i].m[1]), _mm_load_ps(m[i].m[2]),
+                                                    _mm_load_ps(m[i].m[3])));
+    }
+}
+
+template <bool MASKED>
+SIMD_TARGET_AVX2 inline void transform_points_each_soa_block(const Matrices4Soa& m, const Points4Soa& in,
+                                                             const Points4Soa& out, size_t i, __m256i mask) {
+    __m256 x = MASKED ? _mm256_maskload_ps(in.x + i, mask) : _mm256_loadu_ps(in.x + i);
+    __m256 y = MASKED ? _mm256_maskload_ps(in.y + i, mask) : _mm256_loadu_ps(in.y + i);
+    __m256 z = MASKED ? _mm256_maskload_ps(in.z + i, mask) : _mm256_loadu_ps(in.z + i);
+    float* const dst[4] = { out.x, out.y, out.z, out.w };
+    for (int c = 0; c < 4; c++) {
+        __m256 e[4];
+        for (int r = 0; r < 4; r++) {
+            e[r] = MASKED ? _mm256_maskload_ps(m.m[r * 4 + c] + i, mask) : _mm256_loadu_ps(m.m[r * 4 + c] + i);
+        }
+        __m256 v = _mm256_fmadd_ps(x, e[0], _mm256_fmadd_ps(y, e[1], _mm256_fmadd_ps(z, e[2], e[3])));
+        if (MASKED) _mm256_maskstore_ps(dst[c] + i, mask, v);
+        else _mm256_storeu_ps(dst[c] + i, v);
+    }
+}
+
+SIMD_TARGET_AVX2 inline void transform_points_each_soa_avx2(Matrices4Soa m, Points4Soa in, Points4Soa out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) transform_points_each_soa_block<false>(m, in, out, i, _mm256_setzero_si256());
+    if (i < n) transform_points_each_soa_block<true>(m, in, out, i, TailMask8(n - i));
+}
+
+// ============================================
+// N matrix pairs: out[i] = a[i] * b[i]
+// ============================================
+SIMD_SCALAR_FN inline void multiply_matrices_aos_scalar(const Matrix4* a, const Matrix4* b, Matrix4* out, size_t n) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) out[i] = matrix_multiply_ref(a[i], b[i]);
+}
+
+SIMD_SCALAR_FN inline void multiply_matrices_soa_scalar(Matrices4Soa a, Matrices4Soa b, Matrices4Soa out, size_t n) {
+    SIMD_SCALAR_LOOP
+    for (size_t i = 0; i < n; i++) StoreMatrix(out, i, matrix_multiply_ref(LoadMatrix(a, i), LoadMatrix(b, i)));
+}
+
+// Two rows of a per register against the rows of b broadcast to both halves:
+// (a0 * b0 + a2 * b2) + (a1 * b1 + a3 * b3), DirectXMath's order with FMA
+SIMD_TARGET_AVX2 inline __m256 multiply_row_pair(__m256 rows, __m256 b0, __m256 b1, __m256 b2, __m256 b3) {
+    __m256 even = _mm256_mul_ps(_mm256_permute_ps(rows, 0x00), b0);
+    __m256 odd = _mm256_mul_ps(_mm256_permute_ps(rows, 0x55), b1);
+    even = _mm256_fmadd_ps(_mm256_permute_ps(rows, 0xAA), b2, even);
+    odd = _mm256_fmadd_ps(_mm256_permute_ps(rows, 0xFF), b3, odd);
+    return _mm256_add_ps(even, odd);
+}
+
+SIMD_TARGET_AVX2 inline void multiply_matrices_aos_avx2(const Matrix4* a, const Matrix4* b, Matrix4* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        __m256 b0 = _mm256_broadcast_ps((const __m128*)b[i].m[0]);
+        __m256 b1 = _mm256_broadcast_ps((const __m128*)b[i].m[1]);
+        __m256 b2 = _mm256_broadcast_ps((const __m128*)b[i].m[2]);
+        __m256 b3 = _mm256_broadcast_ps((const __m128*)b[i].m[3]);
+        _mm256_store_ps(out[i].m[0], multiply_row_pair(_mm256_load_ps(a[i].m[0]), b0, b1, b2, b3));
+        _mm256_store_ps(out[i].m[2], multiply_row_pair(_mm256_load_ps(a[i].m[2]), b0, b1, b2, b3));
+    }
+}
+
+// Eight matrix pairs, one result row at a time (16 elements of b would not
+// fit next to the row of a in 16 YMM registers; they come from L1 per row)
+template <bool MASKED>
+SIMD_TARGET_AVX2 inline void multiply_matrices_soa_block(const Matrices4Soa& a, const Matrices4Soa& b,
+                                                         const Matrices4Soa& out, size_t i, __m256i mask) {
+    for (int r = 0; r < 4; r++) {
+        __m256 row[4];
+        for (int k = 0; k < 4; k++) {
+            row[k] = MASKED ? _mm256_maskload_ps(a.m[r * 4 + k] + i, mask) : _mm256_loadu_ps(a.m[r * 4 + k] + i);
+        }
+        for (int c = 0; c < 4; c++) {
+            __m256 e[4];
+            for (int k = 0; k < 4; k++) {
+                e[k] = MASKED ? _mm256_maskload_ps(b.m[k * 4 + c] + i, mask) : _mm256_loadu_ps(b.m[k * 4 + c] + i);
+            }
+            __m256 even = _mm256_fmadd_ps(row[2], e[2], _mm256_mul_ps(row[0], e[0]));
+            __m256 odd = _mm256_fmadd_ps(row[3], e[3], _mm256_mul_ps(row[1], e[1]));
+            __m256 v = _mm256_add_ps(even, odd);
+            if (MASKED) _mm256_maskstore_ps(out.m[r * 4 + c] + i, mask, v);
+            else _mm256_storeu_ps(out.m[r * 4 + c] + i, v);
+        }
+    }
+}
+
+SIMD_TARGET_AVX2 inline void multiply_matrices_soa_avx2(Matrices4Soa a, Matrices4Soa b, Matrices4Soa out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) multiply_matrices_soa_block<false>(a, b, out, i, _mm256_setzero_si256());
+    if (i < n) multiply_matrices_soa_block<true>(a, b, out, i, TailMask8(n - i));
+}
@@ -6,6 +6,26 @@
  *  - Only one client at a time
  *  - Simplest implementation
  *  - No scalability (not for production)
+ *
+ *  Thread-pool mode (-pool n):
+ *  - Main thread only accepts and pushes sockets into a bounded queue
+ *  - n blocking worker threads pop a socket and run recv/work/send
+ *  - When the queue is full the accept loop waits (backlog absorbs the rest)
+ *  - Each worker costs one thread stack (reserved POOL_STACK_SIZE)
+ *
+ *  Options:
+ *    -work ms     simulated work per request (default 1000)
+ *    -pool n      worker threads (default 0 = single-client mode)
+ *    -queue n     accept queue capacity in pool mode (default 64)
+ *    -files dir   directory served by FILE / FILECOPY requests (default .)
+ *
+ *  Pipelined clients (pipeline.h): requests ending in '\n' keep the
+ *  connection open; every complete line in the buffer is served in order
+ *  and the "OK\n" replies go out in one send per batch.
+ *
+ *  File requests (file_transfer.h): "FILE <name> [offset] [length]" streams
+ *  the range with TransmitFile (no user-space copy); "FILECOPY ..." sends the
+ *  same reply through a ReadFile + send loop for comparison.
  * ============================================
  */
 
@@ -15,12 +35,18 @@
 #include <ws2tcpip.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <process.h>
+#include <vector>
+#include "pipeline.h"
+#include "file_transfer.h"
 
 #pragma comment(lib, "ws2_32.lib")
 
 #define PORT 9000
 #define BUFFER_SIZE 1024
 #define SIMULATE_WORK_MS 1000
+#define POOL_STACK_SIZE (64 * 1024)
+#define DEFAULT_QUEUE_SIZE 64
 
 void SetColor(int color) {
     SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
@@ -32,6 +58,30 @@ void SetColor(int color) {
 #define COLOR_CYAN 11
 #define COLOR_RED 12
 
+// Overridable with -work <ms> (used by bench_driver)
+static int g_workMs = SIMULATE_WORK_MS;
+static const char* g_fileRoot = ".";
+
+// Thread-pool mode
+static int g_poolSize = 0;
+static int g_queueSize = DEFAULT_QUEUE_SIZE;
+
+struct AcceptQueue {
+    std::vector<SOCKET> sockets;    // ring buffer, capacity = g_queueSize
+    std::vector<int> clientIds;
+    int head;
+    int count;
+    CRITICAL_SECTION cs;
+    CONDITION_VARIABLE notEmpty;
+    CONDITION_VARIABLE notFull;
+};
+
+static AcceptQueue g_queue;
+static CRITICAL_SECTION g_printCs;
+static volatile LONG g_totalProcessed = 0;
+static volatile LONG g_busyWorkers = 0;
+static ULONGLONG g_totalStartTime = 0;
+
 void PrintTime() {
     static ULONGLONG startTick = 0;
     if (startTick == 0) startTick = GetTickCount64();
@@ -59,16 +109,216 @@ void PrintProgress(int clientId, int progress) {
     fflush(stdout);
 }
 
-int main() {
+void PrintStats(int totalProcessed) {
+    ULONGLONG elapsed = GetTickCount64() - g_totalStartTime;
+    double throughput = (elapsed > 0) ? (totalProcessed * 1000.0 / elapsed) : 0;
+
+    printf("\n");
+    SetColor(COLOR_YELLOW);
+    printf("---------------------------------------------------------------\n");
+    printf("  Processed: %d | Time: %.2fs | Throughput: %.2f req/sec\n",
+           totalProcessed, elapsed / 1000.0, throughput);
+    if (g_poolSize > 0) {
+        printf("  Busy workers: %ld/%d | Queued: %d/%d\n",
+               g_busyWorkers, g_poolSize, g_queue.count, g_queueSize);
+    }
+    printf("---------------------------------------------------------------\n");
+    SetColor(COLOR_DEFAULT);
+    printf("\n");
+}
+
+// Pipelined connection: serve every complete line in order, one batched send
+// per batch, and keep reading until the client closes. Returns requests served.
+int ServePipelined(SOCKET clientSocket, int clientId, char* buffer, int length, bool showProgress) {
+    char responses[PIPELINE_RESPONSE_BUFFER];
+    int served = 0;
+    int batches = 0;
+
+    while (1) {
+        PipelineBatch batch = PipelineScan(buffer, length);
+        if (batch.requests > 0) {
+            for (int i = 0; i < batch.requests; i++) Sleep(g_workMs);
+
+            int responseLen = PipelineBuildResponses(responses, batch.requests);
+            if (send(clientSocket, responses, responseLen, 0) == SOCKET_ERROR) break;
+            served += batch.requests;
+            batches++;
+            length = PipelineCompact(buffer, length, batch.consumed);
+            continue;   // more complete lines may already be buffered
+        }
+
+        if (PipelineOverflow(length, BUFFER_SIZE)) break;
+        int bytesReceived = recv(clientSocket, buffer + length, BUFFER_SIZE - 1 - length, 0);
+        if (bytesReceived <= 0) break;
+        length += bytesReceived;
+    }
+
+    if (showProgress) {
+        PrintTime();
+        printf("Client %d pipelined: %d requests in %d batched sends\n", clientId, served, batches);
+    }
+    return served;
+}
+
+// recv -> work -> send on one blocking socket. Returns the number of requests served.
+int ServeClient(SOCKET clientSocket, int clientId, bool showProgress) {
+    char buffer[BUFFER_SIZE];
+    int bytesReceived = recv(clientSocket, buffer, BUFFER_SIZE - 1, 0);
+    if (bytesReceived <= 0) return 0;
+
+    if (PipelineDetect(buffer, bytesReceived)) {
+        return ServePipelined(clientSocket, clientId, buffer, bytesReceived, showProgress);
+    }
+
+    buffer[bytesReceived] = '\0';
+
+    if (showProgress) {
+        PrintTime();
+        printf("Received from Client %d: %s\n", clientId, buffer);
+    }
+
+    for (int progress = 0; progress <= 100; progress += 5) {
+        if (showProgress) PrintProgress(clientId, progress);
+        Sleep(g_workMs / 20);
+    }
+    if (showProgress) printf("\n");
+
+    FileRequest fileRequest;
+    if (FileParseRequest(buffer, fileRequest)) {
+        long long sent = FileServe(clientSocket, g_fileRoot, fileRequest, true,
+                                   [&](const char* data, int len) {
+                                       return send(clientSocket, data, len, 0) == len;
+                                   });
+        if (showProgress) {
+            PrintTime();
+            printf("Client %d: %s %s -> %lld bytes\n", clientId,
+                   fileRequest.mode == FILE_SEND_TRANSMIT ? "TransmitFile" : "ReadFile+send",
+                   fileRequest.name, sent);
+        }
+        return 1;
+    }
+
+    const char* response = "OK";
+    send(clientSocket, response, (int)strlen(response), 0);
+    return 1;
+}
+
+// ============================================
+//  Thread-pool mode
+// ============================================
+
+void QueueInit(AcceptQueue& queue, int capacity) {
+    queue.sockets.assign(capacity, INVALID_SOCKET);
+    queue.clientIds.assign(capacity, 0);
+    queue.head = 0;
+    queue.count = 0;
+    InitializeCriticalSection(&queue.cs);
+    InitializeConditionVariable(&queue.notEmpty);
+    InitializeConditionVariable(&queue.notFull);
+}
+
+// Blocks while the queue is full: the accept loop stops, new connections wait in the listen backlog
+void QueuePush(AcceptQueue& queue, SOCKET socket, int clientId) {
+    EnterCriticalSection(&queue.cs);
+    while (queue.count == (int)queue.sockets.size()) {
+        SleepConditionVariableCS(&queue.notFull, &queue.cs, INFINITE);
+    }
+    int tail = (queue.head + queue.count) % (int)queue.sockets.size();
+    queue.sockets[tail] = socket;
+    queue.clientIds[tail] = clientId;
+    queue.count++;
+    LeaveCriticalSection(&queue.cs);
+    WakeConditionVariable(&queue.notEmpty);
+}
+
+SOCKET QueuePop(AcceptQueue& queue, int& clientId) {
+    EnterCriticalSection(&queue.cs);
+    while (queue.count == 0) {
+        SleepConditionVariableCS(&queue.notEmpty, &queue.cs, INFINITE);
+    }
+    SOCKET socket = queue.sockets[queue.head];
+    clientId = queue.clientIds[queue.head];
+    queue.head = (queue.head + 1) % (int)queue.sockets.size();
+    queue.count--;
+    LeaveCriticalSection(&queue.cs);
+    WakeConditionVariable(&queue.notFull);
+    return socket;
+}
+
+unsigned int __stdcall PoolWorker(void* arg) {
+    int workerId = (int)(intptr_t)arg;
+
+    while (1) {
+        int clientId = 0;
+        SOCKET clientSocket = QueuePop(g_queue, clientId);
+
+        InterlockedIncrement(&g_busyWorkers);
+        int served = ServeClient(clientSocket, clientId, false);
+        closesocket(clientSocket);
+        InterlockedDecrement(&g_busyWorkers);
+
+        if (served > 0) {
+            int totalProcessed = (int)InterlockedExchangeAdd(&g_totalProcessed, served) + served;
+
+            EnterCriticalSection(&g_printCs);
+            PrintTime();
+            SetColor(COLOR_GREEN);
+            printf("Worker %d: Client %d completed!\n", workerId, clientId);
+            SetColor(COLOR_DEFAULT);
+            PrintStats(totalProcessed);
+            LeaveCriticalSection(&g_printCs);
+        }
+    }
+
+    return 0;
+}
+
+bool StartPool() {
+    QueueInit(g_queue, g_queueSize);
+    InitializeCriticalSection(&g_printCs);
+
+    for (int i = 0; i < g_poolSize; i++) {
+        // Reserve only POOL_STACK_SIZE per worker (default is 1 MB) so large pools fit
+        HANDLE thread = (HANDLE)_beginthreadex(NULL, POOL_STACK_SIZE, PoolWorker,
+                                               (void*)(intptr_t)(i + 1),
+                                               STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
+        if (thread == NULL) {
+            SetColor(COLOR_RED);
+            printf("Worker thread creation failed at %d/%d\n", i, g_poolSize);
+            SetColor(COLOR_DEFAULT);
+            return false;
+        }
+        CloseHandle(thread);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "-work") == 0) g_workMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-pool") == 0) g_poolSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-queue") == 0) g_queueSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-files") == 0) g_fileRoot = argv[++i];
+    }
+    if (g_queueSize < 1) g_queueSize = 1;
+
     printf("\n");
     SetColor(COLOR_CYAN);
     printf("===============================================================\n");
     printf("  [SYNC SERVER] Synchronous Socket Server Demo\n");
     printf("===============================================================\n");
     SetColor(COLOR_DEFAULT);
-    printf("  - One client at a time\n");
+    if (g_poolSize > 0) {
+        printf("  - Thread pool: %d blocking workers (stack %d KB reserved each)\n",
+               g_poolSize, POOL_STACK_SIZE / 1024);
+        printf("  - Bounded accept queue: %d sockets\n", g_queueSize);
+    } else {
+        printf("  - One client at a time\n");
+    }
     printf("  - recv/send blocks until complete\n");
     printf("  - Port: %d\n", PORT);
+    printf("  - Work: %d ms\n", g_workMs);
+    printf("  - Files: FILE (TransmitFile) / FILECOPY (ReadFile + send) from %s\n", g_fileRoot);
     printf("===============================================================\n\n");
 
     WSADATA wsaData;
@@ -114,7 +364,28 @@ int main() {
 
     int clientCount = 0;
     int totalProcessed = 0;
-    ULONGLONG totalStartTime = GetTickCount64();
+    g_totalStartTime = GetTickCount64();
+
+    if (g_poolSize > 0) {
+        if (!StartPool()) {
+            closesocket(listenSocket);
+            WSACleanup();
+            return 1;
+        }
+
+        while (1) {
+            sockaddr_in clientAddr;
+            int clientAddrLen = sizeof(clientAddr);
+
+            SOCKET clientSocket = accept(listenSocket, (sockaddr*)&clientAddr, &clientAddrLen);
+            if (clientSocket == INVALID_SOCKET) {
+                continue;
+            }
+
+            clientCount++;
+            QueuePush(g_queue, clientSocket, clientCount);
+        }
+    }
 
     while (1) {
         sockaddr_in clientAddr;
@@ -132,45 +403,18 @@ int main() {
         printf("Client %d connected!\n", clientCount);
         SetColor(COLOR_DEFAULT);
 
-        char buffer[BUFFER_SIZE];
-        int bytesReceived = recv(clientSocket, buffer, BUFFER_SIZE - 1, 0);
-
-        if (bytesReceived > 0) {
-            buffer[bytesReceived] = '\0';
-
-            PrintTime();
-            printf("Received from Client %d: %s\n", clientCount, buffer);
-
-            for (int progress = 0; progress <= 100; progress += 5) {
-                PrintProgress(clientCount, progress);
-                Sleep(SIMULATE_WORK_MS / 20);
-            }
-            printf("\n");
-
-            const char* response = "OK";
-            send(clientSocket, response, (int)strlen(response), 0);
-
+        int served = ServeClient(clientSocket, clientCount, true);
+        if (served > 0) {
             PrintTime();
             SetColor(COLOR_GREEN);
             printf("Client %d completed!\n", clientCount);
             SetColor(COLOR_DEFAULT);
 
-            totalProcessed++;
+            totalProcessed += served;
         }
 
         closesocket(clientSocket);
-
-        ULONGLONG elapsed = GetTickCount64() - totalStartTime;
-        double throughput = (elapsed > 0) ? (totalProcessed * 1000.0 / elapsed) : 0;
-
-        printf("\n");
-        SetColor(COLOR_YELLOW);
-        printf("---------------------------------------------------------------\n");
-        printf("  Processed: %d | Time: %.2fs | Throughput: %.2f req/sec\n",
-               totalProcessed, elapsed / 1000.0, throughput);
-        printf("---------------------------------------------------------------\n");
-        SetColor(COLOR_DEFAULT);
-        printf("\n");
+        PrintStats(totalProcessed);
     }
 
     closesocket(listenSocket);
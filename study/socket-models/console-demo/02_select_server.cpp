@@ -6,6 +6,29 @@
  *  - Process only sockets with data ready
  *  - Single thread handles multiple clients
  *  - Polling overhead as sockets increase
+ *
+ *  Options:
+ *    -work ms         simulated work (default 800)
+ *    -conn-rate rps   per-connection read rate limit (token bucket)
+ *    -conn-burst n    per-connection bucket size (default = rate)
+ *    -ip-rate rps     per-IP read rate limit
+ *    -ip-burst n      per-IP bucket size (default = rate)
+ *    -takeover        zero-downtime restart: take the listen socket and
+ *                     idle connections from the running instance, which
+ *                     then finishes its in-progress requests and exits
+ *    -drain-timeout ms
+ *                     after a takeover, how long the old instance keeps
+ *                     draining before it closes what is left (default 30000)
+ *    -busy-poll us    low-latency mode: pin the loop thread to a core and
+ *                     spin on zero-timeout select() for us before blocking
+ *
+ *  Pipelined clients (pipeline.h): requests ending in '\n' keep the
+ *  connection open. Complete lines in the buffer form a batch that is
+ *  worked through in order, then answered with one send of "OK\n" x n.
+ *
+ *  Receive buffers live in a shared pool (buffer_pool.h). A client holds
+ *  one only while it has bytes buffered or a request in progress, so idle
+ *  connections cost just the small ClientInfo.
  * ============================================
  */
 
@@ -16,6 +39,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <vector>
+#include "rate_limiter.h"
+#include "socket_handoff.h"
+#include "pipeline.h"
+#include "buffer_pool.h"
 
 #pragma comment(lib, "ws2_32.lib")
 
@@ -23,6 +50,7 @@
 #define BUFFER_SIZE 1024
 #define MAX_CLIENTS 64
 #define SIMULATE_WORK_MS 800
+#define DRAIN_TIMEOUT_MS 30000
 
 void SetColor(int color) {
     SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
@@ -42,11 +70,154 @@ struct ClientInfo {
     bool hasData;
     ULONGLONG connectTime;
     ULONGLONG startProcessTime;
-    char buffer[BUFFER_SIZE];
+    uint32_t ip;
+    TokenBucket bucket;          // per-connection rate limit
+    ULONGLONG throttledUntil;    // not polled until this tick
+    bool pipelined;              // requests end in '\n', connection stays open
+    bool closed;                 // peer closed; removed in the completion pass
+    int length;                  // buffered bytes (complete lines + partial tail)
+    int batchRequests;           // lines in the batch being worked on
+    int batchConsumed;           // bytes those lines occupy
+    int requestsLeft;            // lines of the batch still to work through
+    char* buffer;                // borrowed from g_bufferPool while in use (NULL when idle)
 };
 
 static ULONGLONG g_startTick = 0;
 
+// Shared receive buffers, BUFFER_SIZE each
+static BufferPool g_bufferPool;
+
+// Overridable with -work <ms> (used by bench_driver)
+static int g_workMs = SIMULATE_WORK_MS;
+
+// Token-bucket read limits (0 = off)
+static RateLimit g_connLimit = { 0, 0 };
+static RateLimit g_ipLimit = { 0, 0 };
+static IpRateTable g_ipTable;
+static int g_throttledReads = 0;
+
+// A read needs a token from both the connection and the IP bucket.
+// Returns 0 if allowed, otherwise how long to stop polling the socket.
+uint32_t TakeReadToken(ClientInfo& client) {
+    uint32_t nowMs = (uint32_t)GetTickCount64();
+    uint32_t waitMs = TokenBucketTake(client.bucket, g_connLimit, nowMs);
+    if (waitMs > 0 || g_ipLimit.ratePerSec <= 0) return waitMs;
+
+    TokenBucket& ipBucket = IpRateTableLookup(g_ipTable, client.ip, g_ipLimit, nowMs);
+    waitMs = TokenBucketTake(ipBucket, g_ipLimit, nowMs);
+    if (waitMs > 0 && g_connLimit.ratePerSec > 0) TokenBucketRefund(client.bucket);
+    return waitMs;
+}
+
+// Zero-downtime restart (see socket_handoff.h)
+static bool g_takeover = false;
+static HandoffListener g_handoff;
+
+// After a handoff, connections still here get this long to finish their
+// requests. Pipelined clients would otherwise keep sending and never go idle.
+static ULONGLONG g_drainTimeoutMs = DRAIN_TIMEOUT_MS;
+
+struct HandoffHeader {
+    int clientIdCounter;
+    int sessionCount;
+};
+
+// Per-session state that travels with each idle socket
+struct HandoffSession {
+    int id;
+    ULONGLONG connectTime;      // GetTickCount64 is system-wide, so it stays valid
+    uint32_t ip;
+    TokenBucket bucket;
+    ULONGLONG throttledUntil;
+};
+
+// Busy poll (-busy-poll us): a blocking select() parks the thread and the
+// scheduler has to wake it when data arrives. In busy-poll mode the loop
+// thread owns one core and keeps polling with a zero timeout for the budget,
+// trading CPU for wake-up latency; only an idle budget falls back to blocking.
+static ULONGLONG g_busyPollUs = 0;
+static int g_busyPollHits = 0;      // ready sockets found while spinning
+static int g_busyPollSleeps = 0;    // budget ran out, blocked in select()
+static LARGE_INTEGER g_qpcFreq;
+
+ULONGLONG NowUs() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (ULONGLONG)(now.QuadPart * 1000000 / g_qpcFreq.QuadPart);
+}
+
+// select() on readSet, spinning first when busy polling is on
+int SelectWithBusyPoll(fd_set& readSet, long timeoutUs) {
+    if (g_busyPollUs > 0) {
+        fd_set watched = readSet;
+        timeval zero = { 0, 0 };
+        ULONGLONG deadline = NowUs() + g_busyPollUs;
+        do {
+            readSet = watched;
+            int result = select(0, &readSet, NULL, NULL, &zero);
+            if (result != 0) {
+                if (result > 0) g_busyPollHits++;
+                return result;
+            }
+            YieldProcessor();
+        } while (NowUs() < deadline);
+        g_busyPollSleeps++;
+        readSet = watched;
+    }
+
+    timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = timeoutUs;
+    return select(0, &readSet, NULL, NULL, &timeout);
+}
+
+void InitPipelineState(ClientInfo& client) {
+    client.pipelined = false;
+    client.closed = false;
+    client.length = 0;
+    client.batchRequests = 0;
+    client.batchConsumed = 0;
+    client.requestsLeft = 0;
+}
+
+// Start working on the complete lines of a pipelined client.
+// Returns false if only a partial line is buffered.
+bool StartPipelineBatch(ClientInfo& client) {
+    PipelineBatch batch = PipelineScan(client.buffer, client.length);
+    if (batch.requests == 0) return false;
+
+    client.batchRequests = batch.requests;
+    client.batchConsumed = batch.consumed;
+    client.requestsLeft = batch.requests;
+    client.progress = 0;
+    client.hasData = true;
+    client.startProcessTime = GetTickCount64();
+    return true;
+}
+
+// Nothing buffered and no request in progress: give the buffer back to the pool
+void ReturnBufferIfIdle(ClientInfo& client) {
+    if (client.buffer != NULL && client.length == 0 && !client.hasData) {
+        BufferPoolReturn(g_bufferPool, client.buffer);
+        client.buffer = NULL;
+    }
+}
+
+void CloseClient(ClientInfo& client) {
+    closesocket(client.socket);
+    BufferPoolReturn(g_bufferPool, client.buffer);
+    client.buffer = NULL;
+}
+
+// Only connections with nothing in flight or buffered can move to a successor
+bool IsIdle(const ClientInfo& client) {
+    return !client.hasData && client.length == 0;
+}
+
+float DefaultBurst(const RateLimit& limit) {
+    return (limit.ratePerSec < 1.0f) ? 1.0f : limit.ratePerSec;
+}
+
 void PrintTime() {
     if (g_startTick == 0) g_startTick = GetTickCount64();
 
@@ -83,31 +254,31 @@ void PrintAllClients(std::vector<ClientInfo>& clients) {
     fflush(stdout);
 }
 
-int main() {
-    printf("\n");
-    SetColor(COLOR_CYAN);
-    printf("===============================================================\n");
-    printf("  [SELECT SERVER] Asynchronous Socket Server Demo\n");
-    printf("===============================================================\n");
-    SetColor(COLOR_DEFAULT);
-    printf("  - select() monitors multiple sockets\n");
-    printf("  - Single thread handles multiple clients\n");
-    printf("  - Port: %d\n", PORT);
-    printf("===============================================================\n\n");
-
-    WSADATA wsaData;
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-        SetColor(COLOR_RED);
-        printf("WSAStartup failed\n");
-        return 1;
+void PrintStats(int totalProcessed, ULONGLONG totalStartTime, ULONGLONG totalWaitTime) {
+    ULONGLONG elapsed = GetTickCount64() - totalStartTime;
+    double throughput = (elapsed > 0) ? (totalProcessed * 1000.0 / elapsed) : 0;
+    double avgWait = (totalProcessed > 0) ? (totalWaitTime / (double)totalProcessed / 1000.0) : 0;
+
+    SetColor(COLOR_YELLOW);
+    printf("---------------------------------------------------------------\n");
+    printf("  Processed: %d | Time: %.2fs | Throughput: %.2f | AvgWait: %.2fs\n",
+           totalProcessed, elapsed / 1000.0, throughput, avgWait);
+    if (g_busyPollUs > 0) {
+        printf("  Busy poll: hits while spinning %d | blocked after budget %d\n",
+               g_busyPollHits, g_busyPollSleeps);
     }
+    printf("  Buffers: borrowed %d (peak %d) | pool %d x %d B\n",
+           g_bufferPool.borrowed, g_bufferPool.peakBorrowed, g_bufferPool.allocated, BUFFER_SIZE);
+    printf("---------------------------------------------------------------\n");
+    SetColor(COLOR_DEFAULT);
+}
 
+SOCKET OpenListenSocket() {
     SOCKET listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
     if (listenSocket == INVALID_SOCKET) {
         SetColor(COLOR_RED);
         printf("Socket creation failed\n");
-        WSACleanup();
-        return 1;
+        return INVALID_SOCKET;
     }
 
     u_long mode = 1;
@@ -122,46 +293,277 @@ int main() {
         SetColor(COLOR_RED);
         printf("Bind failed\n");
         closesocket(listenSocket);
-        WSACleanup();
-        return 1;
+        return INVALID_SOCKET;
     }
 
     if (listen(listenSocket, SOMAXCONN) == SOCKET_ERROR) {
         SetColor(COLOR_RED);
         printf("Listen failed\n");
         closesocket(listenSocket);
-        WSACleanup();
+        return INVALID_SOCKET;
+    }
+    return listenSocket;
+}
+
+// Old process: give the listen socket and every idle connection to the successor.
+// Connections already being processed stay here and drain: one-shot clients
+// get their reply, pipelined clients are closed once the current batch is sent.
+bool HandOffToSuccessor(HANDLE pipe, SOCKET listenSocket,
+                        std::vector<ClientInfo>& clients, int clientIdCounter) {
+    HandoffHello hello;
+    bool ok = PipeReadAll(pipe, &hello, sizeof(hello));
+
+    HandoffHeader header = { clientIdCounter, 0 };
+    for (auto& client : clients) {
+        if (IsIdle(client)) header.sessionCount++;
+    }
+
+    ok = ok && PipeWriteAll(pipe, &header, sizeof(header));
+    ok = ok && HandoffSendSocket(pipe, listenSocket, hello.pid);
+    for (auto& client : clients) {
+        if (!ok) break;
+        if (!IsIdle(client)) continue;
+
+        HandoffSession session = { client.id, client.connectTime, client.ip,
+                                   client.bucket, client.throttledUntil };
+        ok = HandoffSendSocket(pipe, client.socket, hello.pid) &&
+             PipeWriteAll(pipe, &session, sizeof(session));
+    }
+
+    char ack = 0;
+    ok = ok && PipeReadAll(pipe, &ack, 1) && ack == HANDOFF_ACK;
+    CloseHandle(pipe);
+    if (!ok) return false;
+
+    // The successor owns duplicates now; closing ours does not reset the connections
+    closesocket(listenSocket);
+    for (auto it = clients.begin(); it != clients.end(); ) {
+        if (IsIdle(*it)) {
+            CloseClient(*it);
+            it = clients.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    printf("\n");
+    PrintTime();
+    SetColor(COLOR_MAGENTA);
+    printf("Handed off listen socket + %d idle connections to PID %lu, draining %zu\n",
+           header.sessionCount, hello.pid, clients.size());
+    SetColor(COLOR_DEFAULT);
+    return true;
+}
+
+// New process (-takeover): receive the listen socket and idle sessions
+bool TakeOverFromRunning(SOCKET& listenSocket, std::vector<ClientInfo>& clients, int& clientIdCounter) {
+    HANDLE pipe = HandoffConnect(PORT);
+    if (pipe == INVALID_HANDLE_VALUE) {
+        SetColor(COLOR_RED);
+        printf("No running server to take over (pipe not found)\n");
+        return false;
+    }
+
+    HandoffHeader header;
+    bool ok = PipeReadAll(pipe, &header, sizeof(header));
+    if (ok) {
+        listenSocket = HandoffRecvSocket(pipe);
+        ok = (listenSocket != INVALID_SOCKET);
+    }
+
+    for (int i = 0; ok && i < header.sessionCount; i++) {
+        SOCKET clientSocket = HandoffRecvSocket(pipe);
+        HandoffSession session;
+        ok = (clientSocket != INVALID_SOCKET) && PipeReadAll(pipe, &session, sizeof(session));
+        if (!ok) {
+            if (clientSocket != INVALID_SOCKET) closesocket(clientSocket);
+            break;
+        }
+
+        u_long mode = 1;
+        ioctlsocket(clientSocket, FIONBIO, &mode);
+
+        ClientInfo client;
+        client.socket = clientSocket;
+        client.id = session.id;
+        client.progress = 0;
+        client.hasData = false;
+        client.connectTime = session.connectTime;
+        client.startProcessTime = 0;
+        client.ip = session.ip;
+        client.bucket = session.bucket;
+        client.throttledUntil = session.throttledUntil;
+        InitPipelineState(client);
+        client.buffer = NULL;
+        clients.push_back(client);
+    }
+
+    char ack = HANDOFF_ACK;
+    ok = ok && PipeWriteAll(pipe, &ack, 1);
+    CloseHandle(pipe);
+
+    if (!ok) {
+        if (listenSocket != INVALID_SOCKET) closesocket(listenSocket);
+        listenSocket = INVALID_SOCKET;
+        for (auto& client : clients) CloseClient(client);
+        clients.clear();
+        SetColor(COLOR_RED);
+        printf("Takeover failed (old server keeps running)\n");
+        return false;
+    }
+
+    u_long mode = 1;
+    ioctlsocket(listenSocket, FIONBIO, &mode);
+    clientIdCounter = header.clientIdCounter;
+
+    PrintTime();
+    SetColor(COLOR_MAGENTA);
+    printf("Took over listen socket + %d idle connections\n", header.sessionCount);
+    SetColor(COLOR_DEFAULT);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-takeover") == 0) g_takeover = true;
+    }
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "-work") == 0) g_workMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-conn-rate") == 0) g_connLimit.ratePerSec = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-conn-burst") == 0) g_connLimit.burst = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-ip-rate") == 0) g_ipLimit.ratePerSec = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-ip-burst") == 0) g_ipLimit.burst = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-busy-poll") == 0) g_busyPollUs = _atoi64(argv[++i]);
+        else if (strcmp(argv[i], "-drain-timeout") == 0) g_drainTimeoutMs = _atoi64(argv[++i]);
+    }
+    if (g_connLimit.burst <= 0) g_connLimit.burst = DefaultBurst(g_connLimit);
+    if (g_ipLimit.burst <= 0) g_ipLimit.burst = DefaultBurst(g_ipLimit);
+    IpRateTableInit(g_ipTable, 4096);
+    QueryPerformanceFrequency(&g_qpcFreq);
+    BufferPoolInit(g_bufferPool, BUFFER_SIZE);
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("===============================================================\n");
+    printf("  [SELECT SERVER] Asynchronous Socket Server Demo\n");
+    printf("===============================================================\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  - select() monitors multiple sockets\n");
+    printf("  - Single thread handles multiple clients\n");
+    printf("  - Port: %d\n", PORT);
+    printf("  - Work: %d ms\n", g_workMs);
+    if (g_connLimit.ratePerSec > 0) {
+        printf("  - Conn limit: %.1f req/s (burst %.0f)\n", g_connLimit.ratePerSec, g_connLimit.burst);
+    }
+    if (g_ipLimit.ratePerSec > 0) {
+        printf("  - IP limit: %.1f req/s (burst %.0f)\n", g_ipLimit.ratePerSec, g_ipLimit.burst);
+    }
+    if (g_takeover) {
+        printf("  - Takeover: inherit sockets from the running instance\n");
+    }
+    if (g_busyPollUs > 0) {
+        printf("  - Busy poll: spin %llu us before blocking, loop thread pinned\n", g_busyPollUs);
+    }
+    printf("===============================================================\n\n");
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        SetColor(COLOR_RED);
+        printf("WSAStartup failed\n");
         return 1;
     }
 
+    std::vector<ClientInfo> clients;
+    int clientIdCounter = 0;
+    SOCKET listenSocket = INVALID_SOCKET;
+
+    if (g_takeover) {
+        if (!TakeOverFromRunning(listenSocket, clients, clientIdCounter)) {
+            WSACleanup();
+            return 1;
+        }
+    } else {
+        listenSocket = OpenListenSocket();
+        if (listenSocket == INVALID_SOCKET) {
+            WSACleanup();
+            return 1;
+        }
+    }
+
+    // The spinning loop thread gets a core of its own (core 0 is left to the OS)
+    if (g_busyPollUs > 0) {
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        DWORD cpu = (systemInfo.dwNumberOfProcessors > 1) ? 1 : 0;
+        SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu);
+    }
+
+    // Successors can take over from us the same way
+    HandoffStartListener(g_handoff, PORT);
+    bool draining = false;
+    ULONGLONG drainDeadline = 0;
+
     PrintTime();
     SetColor(COLOR_GREEN);
     printf("Server started! Waiting for clients...\n");
     SetColor(COLOR_DEFAULT);
 
-    std::vector<ClientInfo> clients;
-    int clientIdCounter = 0;
     int totalProcessed = 0;
     ULONGLONG totalStartTime = GetTickCount64();
     ULONGLONG totalWaitTime = 0;
 
     while (1) {
+        if (!draining && g_handoff.connected) {
+            if (HandOffToSuccessor(g_handoff.pipe, listenSocket, clients, clientIdCounter)) {
+                listenSocket = INVALID_SOCKET;
+                draining = true;
+                drainDeadline = GetTickCount64() + g_drainTimeoutMs;
+            } else {
+                HandoffStartListener(g_handoff, PORT);
+            }
+        }
+        if (draining && clients.empty()) break;
+        if (draining && GetTickCount64() >= drainDeadline) {
+            printf("\n");
+            PrintTime();
+            SetColor(COLOR_RED);
+            printf("Drain timeout (%llu ms): closing %zu remaining connections\n",
+                   g_drainTimeoutMs, clients.size());
+            SetColor(COLOR_DEFAULT);
+            for (auto& client : clients) CloseClient(client);
+            clients.clear();
+            break;
+        }
+
         fd_set readSet;
         FD_ZERO(&readSet);
-        FD_SET(listenSocket, &readSet);
+        if (listenSocket != INVALID_SOCKET) FD_SET(listenSocket, &readSet);
 
+        // Throttled sockets are left out of the set until their bucket refills.
+        // Unread data stays in the kernel buffer and TCP flow control pushes back.
+        ULONGLONG now = GetTickCount64();
         for (auto& client : clients) {
+            if (client.throttledUntil > now) continue;
             FD_SET(client.socket, &readSet);
         }
 
-        timeval timeout;
-        timeout.tv_sec = 0;
-        timeout.tv_usec = 10000;
+        // While any client is mid-request the loop only polls, so progress
+        // steps are paced by the work sleep and not by the select timeout
+        bool anyBusy = false;
+        for (auto& client : clients) {
+            if (client.hasData) anyBusy = true;
+        }
 
-        int selectResult = select(0, &readSet, NULL, NULL, &timeout);
+        // select() rejects an empty set (draining with every socket throttled)
+        int selectResult = 0;
+        if (readSet.fd_count > 0) {
+            selectResult = SelectWithBusyPoll(readSet, anyBusy ? 0 : 10000);
+        } else {
+            Sleep(10);
+        }
 
         if (selectResult > 0) {
-            if (FD_ISSET(listenSocket, &readSet)) {
+            if (listenSocket != INVALID_SOCKET && FD_ISSET(listenSocket, &readSet)) {
                 sockaddr_in clientAddr;
                 int clientAddrLen = sizeof(clientAddr);
                 SOCKET clientSocket = accept(listenSocket, (sockaddr*)&clientAddr, &clientAddrLen);
@@ -177,7 +579,11 @@ int main() {
                     newClient.hasData = false;
                     newClient.connectTime = GetTickCount64();
                     newClient.startProcessTime = 0;
-                    memset(newClient.buffer, 0, BUFFER_SIZE);
+                    newClient.ip = clientAddr.sin_addr.s_addr;
+                    TokenBucketInit(newClient.bucket, g_connLimit, (uint32_t)GetTickCount64());
+                    newClient.throttledUntil = 0;
+                    InitPipelineState(newClient);
+                    newClient.buffer = NULL;
 
                     clients.push_back(newClient);
 
@@ -191,9 +597,48 @@ int main() {
 
             for (auto& client : clients) {
                 if (FD_ISSET(client.socket, &readSet) && !client.hasData) {
-                    int bytesReceived = recv(client.socket, client.buffer, BUFFER_SIZE - 1, 0);
-                    if (bytesReceived > 0) {
-                        client.buffer[bytesReceived] = '\0';
+                    uint32_t waitMs = TakeReadToken(client);
+                    if (waitMs > 0) {
+                        client.throttledUntil = GetTickCount64() + waitMs;
+                        g_throttledReads++;
+
+                        printf("\n");
+                        PrintTime();
+                        SetColor(COLOR_RED);
+                        printf("Client %d throttled for %u ms (total throttled: %d)\n",
+                               client.id, waitMs, g_throttledReads);
+                        SetColor(COLOR_DEFAULT);
+                        continue;
+                    }
+
+                    if (client.buffer == NULL) client.buffer = BufferPoolBorrow(g_bufferPool);
+                    int bytesReceived = recv(client.socket, client.buffer + client.length,
+                                             BUFFER_SIZE - 1 - client.length, 0);
+                    if (bytesReceived <= 0) {
+                        if (bytesReceived == 0 || WSAGetLastError() != WSAEWOULDBLOCK) {
+                            client.closed = true;
+                        }
+                        ReturnBufferIfIdle(client);
+                        continue;
+                    }
+
+                    if (client.length == 0 && !client.pipelined) {
+                        client.pipelined = PipelineDetect(client.buffer, bytesReceived);
+                    }
+                    client.length += bytesReceived;
+                    client.buffer[client.length] = '\0';
+
+                    if (client.pipelined) {
+                        if (StartPipelineBatch(client)) {
+                            printf("\n");
+                            PrintTime();
+                            SetColor(COLOR_MAGENTA);
+                            printf("Client %d pipelined batch: %d requests\n", client.id, client.batchRequests);
+                            SetColor(COLOR_DEFAULT);
+                        } else if (PipelineOverflow(client.length, BUFFER_SIZE)) {
+                            client.closed = true;   // one line longer than the buffer
+                        }
+                    } else {
                         client.hasData = true;
                         client.startProcessTime = GetTickCount64();
                         totalWaitTime += (client.startProcessTime - client.connectTime);
@@ -214,19 +659,86 @@ int main() {
                 anyProcessing = true;
                 client.progress += 2;
                 if (client.progress > 100) client.progress = 100;
+
+                // Pipelined batch: each line gets the full work, one after another
+                if (client.progress >= 100 && client.requestsLeft > 1) {
+                    client.requestsLeft--;
+                    client.progress = 0;
+                }
             }
         }
 
         if (anyProcessing) {
             PrintAllClients(clients);
-            Sleep(SIMULATE_WORK_MS / 50);
+            Sleep(g_workMs / 50);
         }
 
         for (auto it = clients.begin(); it != clients.end(); ) {
-            if (it->progress >= 100) {
+            if (it->closed) {
+                CloseClient(*it);
+
+                printf("\n");
+                PrintTime();
+                SetColor(COLOR_CYAN);
+                printf("Client %d disconnected\n", it->id);
+                SetColor(COLOR_DEFAULT);
+
+                it = clients.erase(it);
+            } else if (draining && it->pipelined && !it->hasData) {
+                // Only a partial line here and the successor owns the listen socket:
+                // close so the client reconnects there instead of pinning this process
+                CloseClient(*it);
+
+                printf("\n");
+                PrintTime();
+                SetColor(COLOR_CYAN);
+                printf("Client %d closed while draining (%d bytes unanswered)\n", it->id, it->length);
+                SetColor(COLOR_DEFAULT);
+
+                it = clients.erase(it);
+            } else if (it->progress >= 100 && it->pipelined) {
+                // Whole batch done: one send for all of its replies, keep the connection
+                char responses[PIPELINE_RESPONSE_BUFFER];
+                int responseLen = PipelineBuildResponses(responses, it->batchRequests);
+                if (send(it->socket, responses, responseLen, 0) == SOCKET_ERROR) it->closed = true;
+
+                printf("\n");
+                PrintTime();
+                SetColor(COLOR_GREEN);
+                printf("Client %d batch of %d completed! (1 send)\n", it->id, it->batchRequests);
+                SetColor(COLOR_DEFAULT);
+
+                totalProcessed += it->batchRequests;
+                it->length = PipelineCompact(it->buffer, it->length, it->batchConsumed);
+                it->hasData = false;
+                it->progress = 0;
+                it->requestsLeft = 0;
+                if (!it->closed && !draining) StartPipelineBatch(*it);   // lines queued behind the batch
+                ReturnBufferIfIdle(*it);
+
+                PrintStats(totalProcessed, totalStartTime, totalWaitTime);
+
+                if (draining) {
+                    // Batch flushed; lines queued behind it get no reply here.
+                    // FIN after the replies, the client resends the rest on a new connection.
+                    shutdown(it->socket, SD_SEND);
+                    CloseClient(*it);
+
+                    printf("\n");
+                    PrintTime();
+                    SetColor(COLOR_CYAN);
+                    printf("Client %d closed after its batch (draining, %d bytes unanswered)\n",
+                           it->id, it->length);
+                    SetColor(COLOR_DEFAULT);
+
+                    it = clients.erase(it);
+                } else {
+                    ++it;
+                }
+            } else if (it->progress >= 100) {
                 const char* response = "OK";
                 send(it->socket, response, (int)strlen(response), 0);
-                closesocket(it->socket);
+                CloseClient(*it);
 
                 printf("\n");
                 PrintTime();
@@ -237,23 +749,19 @@ int main() {
                 totalProcessed++;
                 it = clients.erase(it);
 
-                ULONGLONG elapsed = GetTickCount64() - totalStartTime;
-                double throughput = (elapsed > 0) ? (totalProcessed * 1000.0 / elapsed) : 0;
-                double avgWait = (totalProcessed > 0) ? (totalWaitTime / (double)totalProcessed / 1000.0) : 0;
-
-                SetColor(COLOR_YELLOW);
-                printf("---------------------------------------------------------------\n");
-                printf("  Processed: %d | Time: %.2fs | Throughput: %.2f | AvgWait: %.2fs\n",
-                       totalProcessed, elapsed / 1000.0, throughput, avgWait);
-                printf("---------------------------------------------------------------\n");
-                SetColor(COLOR_DEFAULT);
+                PrintStats(totalProcessed, totalStartTime, totalWaitTime);
             } else {
                 ++it;
             }
         }
     }
 
-    closesocket(listenSocket);
+    printf("\n");
+    PrintTime();
+    SetColor(COLOR_GREEN);
+    printf("Drained after handoff, exiting (processed %d)\n", totalProcessed);
+    SetColor(COLOR_DEFAULT);
+
     WSACleanup();
     return 0;
 }
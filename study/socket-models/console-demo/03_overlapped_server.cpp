@@ -6,6 +6,11 @@
  *  - Returns immediately, notified on completion
  *  - True async I/O
  *  - Simpler than IOCP but less scalable
+ *
+ *  Pipelined clients (pipeline.h): requests ending in '\n' keep the
+ *  connection open. Each completed WSARecv may carry many requests; the
+ *  complete lines are worked through in order, answered with one send,
+ *  and the next WSARecv is posted behind any partial line.
  * ============================================
  */
 
@@ -17,6 +22,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <vector>
+#include "pipeline.h"
 
 #pragma comment(lib, "ws2_32.lib")
 
@@ -47,10 +53,19 @@ struct OverlappedEx {
     ULONGLONG startProcessTime;
     HANDLE event;
     bool ioCompleted;
+    bool pipelined;              // requests end in '\n', connection stays open
+    bool closed;                 // peer closed or recv failed; removed in the completion pass
+    int length;                  // buffered bytes (complete lines + partial tail)
+    int batchRequests;           // lines in the batch being worked on
+    int batchConsumed;           // bytes those lines occupy
+    int requestsLeft;            // lines of the batch still to work through
 };
 
 static ULONGLONG g_startTick = 0;
 
+// Overridable with -work <ms> (used by bench_driver)
+static int g_workMs = SIMULATE_WORK_MS;
+
 void PrintTime() {
     if (g_startTick == 0) g_startTick = GetTickCount64();
 
@@ -61,6 +76,47 @@ void PrintTime() {
            elapsed % 1000);
 }
 
+// Overlapped recv into the free part of the buffer (behind a buffered partial line)
+bool PostRecv(OverlappedEx* client) {
+    client->ioCompleted = false;
+    client->wsaBuf.buf = client->buffer + client->length;
+    client->wsaBuf.len = BUFFER_SIZE - 1 - client->length;
+
+    DWORD flags = 0;
+    DWORD bytesReceived = 0;
+    int result = WSARecv(client->socket, &client->wsaBuf, 1,
+                         &bytesReceived, &flags, &client->overlapped, NULL);
+    return result != SOCKET_ERROR || WSAGetLastError() == WSA_IO_PENDING;
+}
+
+// Start working on the complete lines of a pipelined client.
+// Returns false if only a partial line is buffered.
+bool StartPipelineBatch(OverlappedEx* client) {
+    PipelineBatch batch = PipelineScan(client->buffer, client->length);
+    if (batch.requests == 0) return false;
+
+    client->batchRequests = batch.requests;
+    client->batchConsumed = batch.consumed;
+    client->requestsLeft = batch.requests;
+    client->progress = 0;
+    client->ioCompleted = true;
+    client->startProcessTime = GetTickCount64();
+    return true;
+}
+
+void PrintStats(int totalProcessed, ULONGLONG totalStartTime, ULONGLONG totalWaitTime) {
+    ULONGLONG elapsed = GetTickCount64() - totalStartTime;
+    double throughput = (elapsed > 0) ? (totalProcessed * 1000.0 / elapsed) : 0;
+    double avgWait = (totalProcessed > 0) ? (totalWaitTime / (double)totalProcessed / 1000.0) : 0;
+
+    SetColor(COLOR_YELLOW);
+    printf("---------------------------------------------------------------\n");
+    printf("  Processed: %d | Time: %.2fs | Throughput: %.2f | AvgWait: %.2fs\n",
+           totalProcessed, elapsed / 1000.0, throughput, avgWait);
+    printf("---------------------------------------------------------------\n");
+    SetColor(COLOR_DEFAULT);
+}
+
 void PrintAllClients(std::vector<OverlappedEx*>& clients) {
     printf("\r");
     PrintTime();
@@ -87,7 +143,11 @@ void PrintAllClients(std::vector<OverlappedEx*>& clients) {
     fflush(stdout);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "-work") == 0) g_workMs = atoi(argv[++i]);
+    }
+
     printf("\n");
     SetColor(COLOR_CYAN);
     printf("===============================================================\n");
@@ -98,6 +158,7 @@ int main() {
     printf("  - Event notification on I/O completion\n");
     printf("  - OS handles I/O in background\n");
     printf("  - Port: %d\n", PORT);
+    printf("  - Work: %d ms\n", g_workMs);
     printf("===============================================================\n\n");
 
     WSADATA wsaData;
@@ -169,15 +230,7 @@ int main() {
             newClient->event = WSACreateEvent();
             newClient->overlapped.hEvent = newClient->event;
 
-            newClient->wsaBuf.buf = newClient->buffer;
-            newClient->wsaBuf.len = BUFFER_SIZE;
-
-            DWORD flags = 0;
-            DWORD bytesReceived = 0;
-            int result = WSARecv(clientSocket, &newClient->wsaBuf, 1,
-                                 &bytesReceived, &flags, &newClient->overlapped, NULL);
-
-            if (result == SOCKET_ERROR && WSAGetLastError() != WSA_IO_PENDING) {
+            if (!PostRecv(newClient)) {
                 SetColor(COLOR_RED);
                 printf("WSARecv failed\n");
                 closesocket(clientSocket);
@@ -213,20 +266,41 @@ int main() {
                         client->socket, &client->overlapped,
                         &bytesTransferred, FALSE, &flags);
 
+                    // Reset before a pipelined connection posts its next recv
+                    WSAResetEvent(client->event);
+
                     if (result && bytesTransferred > 0) {
-                        client->buffer[bytesTransferred] = '\0';
-                        client->ioCompleted = true;
-                        client->startProcessTime = GetTickCount64();
-                        totalWaitTime += (client->startProcessTime - client->connectTime);
-
-                        printf("\n");
-                        PrintTime();
-                        SetColor(COLOR_MAGENTA);
-                        printf("Client %d I/O complete! (Overlapped notification)\n", client->clientId);
-                        SetColor(COLOR_DEFAULT);
+                        if (client->length == 0 && !client->pipelined) {
+                            client->pipelined = PipelineDetect(client->buffer, (int)bytesTransferred);
+                        }
+                        client->length += bytesTransferred;
+                        client->buffer[client->length] = '\0';
+
+                        if (client->pipelined) {
+                            if (StartPipelineBatch(client)) {
+                                printf("\n");
+                                PrintTime();
+                                SetColor(COLOR_MAGENTA);
+                                printf("Client %d I/O complete! Pipelined batch: %d requests\n",
+                                       client->clientId, client->batchRequests);
+                                SetColor(COLOR_DEFAULT);
+                            } else if (PipelineOverflow(client->length, BUFFER_SIZE) || !PostRecv(client)) {
+                                client->closed = true;   // partial line: keep reading unless it can't fit
+                            }
+                        } else {
+                            client->ioCompleted = true;
+                            client->startProcessTime = GetTickCount64();
+                            totalWaitTime += (client->startProcessTime - client->connectTime);
+
+                            printf("\n");
+                            PrintTime();
+                            SetColor(COLOR_MAGENTA);
+                            printf("Client %d I/O complete! (Overlapped notification)\n", client->clientId);
+                            SetColor(COLOR_DEFAULT);
+                        }
+                    } else {
+                        client->closed = true;   // peer closed (0 bytes) or recv failed
                     }
-
-                    WSAResetEvent(client->event);
                 }
             }
         }
@@ -237,17 +311,65 @@ int main() {
                 anyProcessing = true;
                 client->progress += 3;
                 if (client->progress > 100) client->progress = 100;
+
+                // Pipelined batch: each line gets the full work, one after another
+                if (client->progress >= 100 && client->requestsLeft > 1) {
+                    client->requestsLeft--;
+                    client->progress = 0;
+                }
             }
         }
 
         if (anyProcessing) {
             PrintAllClients(clients);
-            Sleep(SIMULATE_WORK_MS / 33);
+            Sleep(g_workMs / 33);
         }
 
         for (auto it = clients.begin(); it != clients.end(); ) {
             OverlappedEx* client = *it;
-            if (client->progress >= 100) {
+            if (client->progress >= 100 && client->pipelined && !client->closed) {
+                // Whole batch done: one send for all of its replies, keep the connection
+                char responses[PIPELINE_RESPONSE_BUFFER];
+                int responseLen = PipelineBuildResponses(responses, client->batchRequests);
+                bool sent = (send(client->socket, responses, responseLen, 0) != SOCKET_ERROR);
+
+                printf("\n");
+                PrintTime();
+                SetColor(COLOR_GREEN);
+                printf("Client %d batch of %d completed! (1 send)\n", client->clientId, client->batchRequests);
+                SetColor(COLOR_DEFAULT);
+
+                totalProcessed += client->batchRequests;
+                client->length = PipelineCompact(client->buffer, client->length, client->batchConsumed);
+                client->requestsLeft = 0;
+                client->progress = 0;
+
+                // Lines queued behind the batch first, otherwise wait for more
+                if (!sent) {
+                    client->closed = true;
+                } else if (!StartPipelineBatch(client) && !PostRecv(client)) {
+                    client->closed = true;
+                }
+
+                PrintStats(totalProcessed, totalStartTime, totalWaitTime);
+            }
+
+            if (client->closed) {
+                closesocket(client->socket);
+                WSACloseEvent(client->event);
+
+                size_t index = it - clients.begin();
+                events.erase(events.begin() + index);
+
+                printf("\n");
+                PrintTime();
+                SetColor(COLOR_CYAN);
+                printf("Client %d disconnected\n", client->clientId);
+                SetColor(COLOR_DEFAULT);
+
+                delete client;
+                it = clients.erase(it);
+            } else if (client->progress >= 100) {
                 const char* response = "OK";
                 send(client->socket, response, (int)strlen(response), 0);
 
@@ -267,16 +389,7 @@ int main() {
                 delete client;
                 it = clients.erase(it);
 
-                ULONGLONG elapsed = GetTickCount64() - totalStartTime;
-                double throughput = (elapsed > 0) ? (totalProcessed * 1000.0 / elapsed) : 0;
-                double avgWait = (totalProcessed > 0) ? (totalWaitTime / (double)totalProcessed / 1000.0) : 0;
-
-                SetColor(COLOR_YELLOW);
-                printf("---------------------------------------------------------------\n");
-                printf("  Processed: %d | Time: %.2fs | Throughput: %.2f | AvgWait: %.2fs\n",
-                       totalProcessed, elapsed / 1000.0, throughput, avgWait);
-                printf("---------------------------------------------------------------\n");
-                SetColor(COLOR_DEFAULT);
+                PrintStats(totalProcessed, totalStartTime, totalWaitTime);
             } else {
                 ++it;
             }
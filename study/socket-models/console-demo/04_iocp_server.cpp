@@ -7,6 +7,40 @@
  *  - Worker Thread들이 큐에서 작업을 꺼내 처리
  *  - Windows 최고 성능의 네트워크 모델
  *  - 대규모 게임서버의 표준!
+ *
+ *  옵션:
+ *    -work ms          작업 시간 (기본 400)
+ *    -admit            승인 제어 (CoDel 방식 부하 차단) 켜기
+ *    -target ms        허용 큐 대기시간 (기본 5)
+ *    -interval ms      과부하 판정 구간 (기본 100)
+ *    -max-inflight n   동시 진행 요청 상한 (기본 Worker × 16)
+ *    -conn-rate rps    연결별 요청 속도 제한 (토큰 버킷)
+ *    -conn-burst n     연결별 버킷 크기 (기본 = rate)
+ *    -ip-rate rps      IP별 요청 속도 제한
+ *    -ip-burst n       IP별 버킷 크기 (기본 = rate)
+ *    -tls              TLS 1.2 (Schannel, 자체 서명 인증서)
+ *    -aoi              AOI 세션 모드 (연결 유지, 격자 기반 관심 영역 브로드캐스트)
+ *    -busy-poll us     바쁜 폴링: Worker를 코어에 고정하고, 완료를 기다릴 때
+ *                      us 동안 timeout 0 으로 돌다가 그래도 없으면 잠든다 (저지연 모드)
+ *    -files dir        FILE / FILECOPY 요청이 읽는 디렉터리 (기본 현재 디렉터리)
+ *    -eager-buffer     연결마다 수신 버퍼를 accept 때 붙여서 끝까지 쥔다 (분리 전 방식, 메모리 비교용)
+ *
+ *  연결 상태 (buffer_pool.h):
+ *    PerIoData 는 OVERLAPPED + 작은 상태만 갖고 수신 버퍼는 포인터로 둔다.
+ *    놀고 있는 연결에는 버퍼 없이 0바이트 WSARecv 만 걸어 두고, 완료(= 읽을 데이터가 생김)가
+ *    오면 그때 풀에서 버퍼를 빌려 recv → 처리 → 반납. 100만 연결이어도 버퍼는 동시 처리 수만큼.
+ *
+ *  요청 "BULK <bytes>" → 그만큼 데이터를 스트리밍 (TLS 대량 전송 측정용)
+ *  요청 "FILE <이름> [offset] [length]" → TransmitFile 로 파일(범위) 전송, 사용자 공간 복사 없음
+ *       "FILECOPY <이름> ..."           → 같은 응답을 ReadFile + send 로 (file_transfer.h)
+ *  -aoi 모드 요청 ('\n' 으로 끝나는 줄 단위, 연결을 닫지 않음. 잘린 줄은 다음 recv 와 이어 붙임):
+ *    "MOVE x y"  → 위치 등록/이동. 주변 세션에 MOVE, 시야 변화는 ENTER / LEAVE
+ *    "CHAT text" → 주변 세션(3×3 칸)에만 전달
+ *    "SYNC ack"  → 주변 엔티티 스냅샷. "SNAP <len>\n" + 델타/LZ4 패킷 (packet_codec.h)
+ *                  ack = 마지막으로 디코드한 패킷 번호 (0 = 없음) → 서버는 그것을 기준으로 델타
+ *  파이프라인 요청 (pipeline.h, '\n' 으로 끝나는 요청, TLS 제외):
+ *    완료 하나에 요청 여러 개 → 순서대로 처리하고 "OK\n" × n 을 send 한 번으로.
+ *    연결은 유지하고, 잘린 줄 뒤에 다음 WSARecv 를 건다
  * ============================================
  */
 
@@ -19,7 +53,16 @@
 #include <stdlib.h>
 #include <process.h>
 #include <vector>
+#include <string>
 #include <map>
+#include <algorithm>
+#include "rate_limiter.h"
+#include "tls_layer.h"
+#include "aoi_grid.h"
+#include "packet_codec.h"
+#include "pipeline.h"
+#include "file_transfer.h"
+#include "buffer_pool.h"
 
 #pragma comment(lib, "ws2_32.lib")
 
@@ -27,6 +70,10 @@
 #define BUFFER_SIZE 1024
 #define WORKER_THREAD_COUNT 4
 #define SIMULATE_WORK_MS 400
+#define BULK_CHUNK_SIZE 65536
+#define AOI_WORLD_SIZE 2000.0f
+#define AOI_STATS_INTERVAL 10000
+#define AOI_MAX_PENDING 65536        // 세션별 못 보낸 알림 상한 (넘으면 느린 클라이언트로 보고 끊음)
 
 // 콘솔 색상
 void SetColor(int color) {
@@ -47,33 +94,296 @@ enum IOType {
     IO_SEND
 };
 
-// Per-I/O 데이터
+// Per-I/O 데이터 (연결마다 하나, 버퍼는 읽는 동안만 붙는다)
 struct PerIoData {
     OVERLAPPED overlapped;
     WSABUF wsaBuf;
-    char buffer[BUFFER_SIZE];
+    char* buffer;                // g_bufferPool 에서 빌린 BUFFER_SIZE 버퍼 (NULL = 없음)
+    bool zeroByteRead;           // 걸려 있는 WSARecv 가 0바이트 (완료 = 읽을 데이터 있음)
     IOType ioType;
     int clientId;
     int progress;
     ULONGLONG connectTime;
     ULONGLONG startProcessTime;
+    ULONGLONG queuedUs;          // -admit: 디스패처가 Worker 큐에 넣은 시각 (QPC, 큐 대기 측정용)
+    bool failed;                 // -admit: 디스패처가 넘겨준 완료가 실패였음
+    bool admitted;               // -admit: 승인 제어의 진행중 자리를 쥐고 있음
+
+    // 속도 제한에 걸려 미뤄둔 완료 (타이머가 같은 OVERLAPPED로 다시 넣어준다)
+    bool throttled;
+    HANDLE throttleTimer;
+    DWORD recvBytes;
+    ULONG_PTR completionKey;
+
+    // 파이프라인 연결: buffer 앞에 남겨둔 잘린 요청 조각 길이 (다음 recv 는 그 뒤로)
+    bool pipelined;
+    int pipelineLength;
 };
 
 // Per-Socket 데이터
 struct PerSocketData {
     SOCKET socket;
     int clientId;
+    uint32_t ip;
+    TokenBucket bucket;          // 연결별 속도 제한
+    int aoiHandle;               // -aoi: 격자 핸들 (-1 = 아직 위치 없음)
+    CodecSession* codec;         // -aoi: SYNC 로 보낸 스냅샷 이력 / ack 된 기준 (첫 SYNC 때 생성)
+    std::string aoiPending;      // -aoi: 아직 못 보낸 알림 / 응답 (g_aoiCs 안에서만)
+    bool aoiSending;             // -aoi: 어느 Worker가 락 밖에서 aoiPending 을 비우는 중
+    bool aoiCut;                 // -aoi: 못 따라와서 끊기로 함
+    volatile LONG refCount;      // 연결 자신 1 + aoiPending 을 비우는 Worker 1. 0 이면 소켓을 닫고 해제
 };
 
 // 전역 변수
 static HANDLE g_hIocp = NULL;
+static HANDLE g_hWorkQueue = NULL;       // Worker가 꺼내는 포트 (-admit 이면 디스패처 뒤의 별도 포트)
 static ULONGLONG g_startTick = 0;
 static int g_totalProcessed = 0;
+static int g_pipelineRequests = 0;       // 파이프라인으로 처리한 요청 수
+static int g_pipelineBatches = 0;        // 파이프라인 응답 묶음(send) 수
 static ULONGLONG g_totalWaitTime = 0;
 static ULONGLONG g_totalStartTime = 0;
 static CRITICAL_SECTION g_cs;
 static std::map<int, PerIoData*> g_clients;
 static int g_workerStatus[WORKER_THREAD_COUNT] = {0};  // 0=idle, clientId=busy
+static int g_workMs = SIMULATE_WORK_MS;  // -work <ms> 로 덮어쓰기 (bench_driver용)
+static LARGE_INTEGER g_qpcFreq;
+
+// 수신 버퍼 풀 (buffer_pool.h)
+static BufferPool g_bufferPool;
+static bool g_eagerBuffer = false;       // -eager-buffer: accept 때 빌려서 연결 끝까지
+
+// 바쁜 폴링 (-busy-poll)
+//  GQCS(INFINITE) 는 큐가 비면 스레드를 재우고, 완료가 오면 스케줄러가 깨운다
+//  (깨우기 + 컨텍스트 스위치 + 캐시 식음 = 수~수십 us). 지연이 중요한 경로에서는
+//  Worker를 코어 하나씩에 고정하고 budget 동안 timeout 0 으로 큐를 확인하며 돈다.
+//  budget 안에 완료가 오면 잠들지 않고 바로 처리 → 지연 대신 CPU를 태운다.
+static ULONGLONG g_busyPollUs = 0;      // 0 = 끔 (항상 INFINITE)
+static volatile LONG g_busyPollHits = 0;    // 스핀 중에 완료를 받음
+static volatile LONG g_busyPollSleeps = 0;  // budget 소진 → 잠듦
+
+// 승인 제어 (-admit)
+//  CoDel 방식 과부하 감지: INTERVAL 동안 큐 대기시간이 한 번도 TARGET 아래로
+//  내려가지 않았으면 큐가 "서 있는" 상태 = 과부하.
+//  과부하 중에는
+//   - accept 경로: 놀고 있는 Worker가 없으면 큐에 넣지 않고 즉시 BUSY
+//   - Worker 경로: TARGET 넘게 기다린 요청은 작업 없이 BUSY (이미 늦은 응답에 CPU 낭비 X)
+//  평상시에도 INTERVAL 넘게 기다린 요청과 MAX_INFLIGHT 초과분은 거절.
+//  큐 대기시간은 디스패처(DispatcherThread)가 완료를 Worker 큐에 넣은 뒤 Worker가 꺼낼 때까지.
+//  accept 나 연결 시각부터 재면 클라이언트가 늦게 보내거나 망 지연만 있어도 (impair_proxy
+//  -delay 40 이면 매 요청 40ms 이상) 대기로 잡혀서, 부하가 없어도 과부하로 굳어 버린다.
+//  자리(inFlight)는 연결이 아니라 요청 단위:
+//   - 요청 하나 → 응답 → 종료 연결은 연결 = 요청이라 accept 때 잡고 응답 후 놓는다
+//   - 유지 연결(AOI / 파이프라인)은 완료를 꺼낼 때 묶음마다 잡고 처리 후 놓는다
+//     (연결 수명 내내 쥐면 -admit 이 그냥 연결 수 상한이 된다)
+struct AdmissionControl {
+    bool enabled;
+    ULONGLONG targetUs;
+    ULONGLONG intervalUs;
+    LONG maxInFlight;
+
+    LONG inFlight;               // 받아들였고 아직 응답하지 않은 요청(묶음) 수
+    ULONGLONG windowEndUs;
+    ULONGLONG windowMinDelayUs;
+    bool overloaded;
+
+    int rejectedAtAccept;
+    int shedInQueue;
+};
+
+static AdmissionControl g_admission = {
+    false, 5000, 100000, WORKER_THREAD_COUNT * 16,
+    0, 0, ~0ULL, false,
+    0, 0
+};
+
+ULONGLONG NowUs() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (ULONGLONG)(now.QuadPart * 1000000 / g_qpcFreq.QuadPart);
+}
+
+// accept 직후 호출 (g_cs 안에서). true = 받아들임 (첫 요청의 자리를 잡는다)
+bool AdmitConnection(PerIoData* perIoData) {
+    if (!g_admission.enabled) return true;
+
+    bool noIdleWorker = g_admission.inFlight >= WORKER_THREAD_COUNT;
+    if (g_admission.inFlight >= g_admission.maxInFlight ||
+        (g_admission.overloaded && noIdleWorker)) {
+        g_admission.rejectedAtAccept++;
+        return false;
+    }
+    g_admission.inFlight++;
+    perIoData->admitted = true;
+    return true;
+}
+
+// Worker가 요청을 꺼낼 때 호출 (g_cs 안에서). true = 작업 없이 거절
+bool ShouldShed(ULONGLONG delayUs, ULONGLONG nowUs) {
+    if (!g_admission.enabled) return false;
+
+    if (delayUs < g_admission.windowMinDelayUs) g_admission.windowMinDelayUs = delayUs;
+    if (nowUs >= g_admission.windowEndUs) {
+        g_admission.overloaded = (g_admission.windowMinDelayUs > g_admission.targetUs);
+        g_admission.windowMinDelayUs = ~0ULL;
+        g_admission.windowEndUs = nowUs + g_admission.intervalUs;
+    }
+
+    ULONGLONG timeoutUs = g_admission.overloaded ? g_admission.targetUs : g_admission.intervalUs;
+    if (delayUs > timeoutUs) {
+        g_admission.shedInQueue++;
+        return true;
+    }
+    return false;
+}
+
+// 응답을 보냈거나 연결을 닫을 때 (g_cs 안에서). 자리가 없으면 아무것도 안 함
+void ReleaseAdmission(PerIoData* perIoData) {
+    if (!perIoData->admitted) return;
+    g_admission.inFlight--;
+    perIoData->admitted = false;
+}
+
+// 이 완료가 Worker 큐에서 기다린 시간 (파이프라인의 뒤 묶음은 앞 묶음을 기다린 시간까지)
+ULONGLONG QueueDelayUs(const PerIoData* perIoData, ULONGLONG nowUs) {
+    return (nowUs > perIoData->queuedUs) ? nowUs - perIoData->queuedUs : 0;
+}
+
+// 요청(묶음) 하나를 처리하기 직전 (g_cs 안에서). true = 처리, 자리를 쥔 상태
+bool AdmitRequest(PerIoData* perIoData, ULONGLONG delayUs, ULONGLONG nowUs) {
+    if (!g_admission.enabled) return true;
+
+    if (!perIoData->admitted && g_admission.inFlight >= g_admission.maxInFlight) {
+        g_admission.shedInQueue++;
+        return false;
+    }
+    if (ShouldShed(delayUs, nowUs)) {
+        ReleaseAdmission(perIoData);
+        return false;
+    }
+    if (!perIoData->admitted) {
+        g_admission.inFlight++;
+        perIoData->admitted = true;
+    }
+    return true;
+}
+
+// GQCS + 바쁜 폴링. timeout 0 실패(큐 빔)는 overlapped 가 NULL 로 돌아온다
+BOOL GetCompletion(DWORD* bytesTransferred, ULONG_PTR* completionKey, PerIoData** perIoData) {
+    if (g_busyPollUs > 0) {
+        ULONGLONG deadline = NowUs() + g_busyPollUs;
+        do {
+            *perIoData = NULL;
+            BOOL result = GetQueuedCompletionStatus(g_hWorkQueue, bytesTransferred, completionKey,
+                                                    (LPOVERLAPPED*)perIoData, 0);
+            if (result || *perIoData != NULL) {
+                InterlockedIncrement(&g_busyPollHits);
+                return result;
+            }
+            YieldProcessor();
+        } while (NowUs() < deadline);
+        InterlockedIncrement(&g_busyPollSleeps);
+    }
+
+    *perIoData = NULL;
+    return GetQueuedCompletionStatus(g_hWorkQueue, bytesTransferred, completionKey,
+                                     (LPOVERLAPPED*)perIoData, INFINITE);
+}
+
+// 디스패처 (-admit): 커널 완료 큐에서 꺼내자마자 시각을 찍어 Worker 큐로 넘긴다.
+// 디스패처는 일을 하지 않으므로 커널 큐에는 거의 머물지 않고, 기다림은 Worker 큐에서 생긴다.
+// 실패한 완료도 상태를 PerIoData 에 담아 넘긴다 (PostQueuedCompletionStatus 는 성공으로 나옴)
+unsigned int __stdcall DispatcherThread(void* arg) {
+    while (1) {
+        DWORD bytesTransferred = 0;
+        ULONG_PTR completionKey = 0;
+        PerIoData* perIoData = NULL;
+        BOOL result = GetQueuedCompletionStatus(g_hIocp, &bytesTransferred, &completionKey,
+                                                (LPOVERLAPPED*)&perIoData, INFINITE);
+        if (perIoData == NULL) break;   // 포트가 닫힘
+
+        perIoData->failed = !result;
+        perIoData->queuedUs = NowUs();
+        PostQueuedCompletionStatus(g_hWorkQueue, bytesTransferred, completionKey, &perIoData->overlapped);
+    }
+    return 0;
+}
+
+// 속도 제한 (0 = 끔)
+static RateLimit g_connLimit = { 0, 0 };
+static RateLimit g_ipLimit = { 0, 0 };
+static IpRateTable g_ipTable;
+static int g_throttledCount = 0;
+
+// 연결 버킷과 IP 버킷 둘 다 토큰이 있어야 통과 (g_cs 안에서)
+// 반환: 0 = 통과, 그 외 = 기다릴 ms
+uint32_t TakeReadToken(PerSocketData* perSocketData) {
+    uint32_t nowMs = (uint32_t)GetTickCount64();
+    uint32_t waitMs = TokenBucketTake(perSocketData->bucket, g_connLimit, nowMs);
+    if (waitMs > 0 || g_ipLimit.ratePerSec <= 0) return waitMs;
+
+    TokenBucket& ipBucket = IpRateTableLookup(g_ipTable, perSocketData->ip, g_ipLimit, nowMs);
+    waitMs = TokenBucketTake(ipBucket, g_ipLimit, nowMs);
+    if (waitMs > 0 && g_connLimit.ratePerSec > 0) TokenBucketRefund(perSocketData->bucket);
+    return waitMs;
+}
+
+// 타이머 스레드: 토큰이 생길 시각에 미뤄둔 완료를 Completion Port에 다시 넣는다
+VOID CALLBACK ResumeThrottled(PVOID param, BOOLEAN timerFired) {
+    PerIoData* perIoData = (PerIoData*)param;
+    PostQueuedCompletionStatus(g_hIocp, perIoData->recvBytes,
+                               perIoData->completionKey, &perIoData->overlapped);
+}
+
+float DefaultBurst(const RateLimit& limit) {
+    return (limit.ratePerSec < 1.0f) ? 1.0f : limit.ratePerSec;
+}
+
+// TLS (-tls)
+static bool g_tlsEnabled = false;
+static TlsCredentials g_tlsCreds;
+
+bool SendPlainOrTls(SOCKET socket, TlsSession* tls, const char* data, int len) {
+    if (tls) return TlsSend(*tls, socket, data, len);
+    return SendAll(socket, data, len);
+}
+
+// 파일 전송 루트 (-files)
+static const char* g_fileRoot = ".";
+
+// 응답 전송: "BULK <bytes>" 요청이면 그만큼 스트리밍, "FILE ..." 이면 파일 범위, 아니면 "OK"
+void SendResponse(SOCKET socket, TlsSession* tls, const char* request) {
+    // TLS 는 커널이 암호화할 수 없으므로 FILE 도 복사 경로로
+    FileRequest fileRequest;
+    if (FileParseRequest(request, fileRequest)) {
+        FileServe(socket, g_fileRoot, fileRequest, tls == NULL,
+                  [&](const char* data, int len) { return SendPlainOrTls(socket, tls, data, len); });
+        return;
+    }
+
+    long long bulkBytes = 0;
+    if (strncmp(request, "BULK ", 5) == 0) bulkBytes = _atoi64(request + 5);
+
+    if (bulkBytes <= 0) {
+        const char* response = "OK";
+        SendPlainOrTls(socket, tls, response, (int)strlen(response));
+        return;
+    }
+
+    static char chunk[BULK_CHUNK_SIZE];  // 내용은 상관없음 (0으로 채워진 정적 버퍼)
+    while (bulkBytes > 0) {
+        int len = (bulkBytes < BULK_CHUNK_SIZE) ? (int)bulkBytes : BULK_CHUNK_SIZE;
+        if (!SendPlainOrTls(socket, tls, chunk, len)) break;
+        bulkBytes -= len;
+    }
+}
+
+void RejectBusy(SOCKET socket) {
+    const char* response = "BUSY";
+    send(socket, response, (int)strlen(response), 0);
+    shutdown(socket, SD_SEND);
+    closesocket(socket);
+}
 
 void PrintTime() {
     if (g_startTick == 0) g_startTick = GetTickCount64();
@@ -94,6 +404,22 @@ void PrintStats() {
     printf("─────────────────────────────────────────────────────────────\n");
     printf("  처리: %d | 시간: %.2fs | 처리량: %.2f req/sec | 평균대기: %.2fs\n",
            g_totalProcessed, elapsed / 1000.0, throughput, avgWait);
+    if (g_admission.enabled) {
+        printf("  승인제어: %s | 진행중: %ld | 거절(accept): %d | 거절(큐): %d\n",
+               g_admission.overloaded ? "과부하" : "정상", g_admission.inFlight,
+               g_admission.rejectedAtAccept, g_admission.shedInQueue);
+    }
+    if (g_busyPollUs > 0) {
+        printf("  바쁜 폴링: 스핀 중 획득 %ld | budget 소진 후 잠듦 %ld\n",
+               g_busyPollHits, g_busyPollSleeps);
+    }
+    if (g_pipelineBatches > 0) {
+        printf("  파이프라인: 응답 묶음 %d회 (send 한 번에 평균 %.1f건)\n",
+               g_pipelineBatches, g_pipelineRequests / (double)g_pipelineBatches);
+    }
+    printf("  수신 버퍼: 연결 %zu | 빌려 감 %d (최대 %d) | 풀 %d개 = %.1f KB\n",
+           g_clients.size(), g_bufferPool.borrowed, g_bufferPool.peakBorrowed,
+           g_bufferPool.allocated, g_bufferPool.allocated * (double)BUFFER_SIZE / 1024.0);
     printf("─────────────────────────────────────────────────────────────\n");
     SetColor(COLOR_DEFAULT);
 }
@@ -113,6 +439,425 @@ void PrintWorkerStatus() {
     printf("\n");
 }
 
+// AOI 세션 모드 (-aoi)
+//  연결을 닫지 않고 요청 줄을 계속 받는다. 위치를 보낸 세션은 격자(aoi_grid.h)에
+//  등록되고, 이동/채팅은 3×3 칸 안의 세션에게만 퍼진다 (전체 N명 fan-out 대신).
+//  시야 변화(enter / leave)는 칸이 바뀔 때만 계산되고, 양쪽 모두에게 알린다.
+//  격자와 핸들 → 세션 표는 g_aoiCs 하나로 보호. 보낼 내용은 락 안에서 받는 세션의
+//  aoiPending 에 붙이기만 하고, 실제 send 는 락을 놓은 뒤 (AoiFlush). 그래서 느린 클라이언트는
+//  그 세션을 비우는 Worker 하나만 붙잡는다. 세션마다 비우는 Worker는 하나라 순서도 그대로이고,
+//  비우는 동안은 refCount 로 소켓이 닫히지 않는다 (핸들 재사용으로 엉뚱한 연결에 보내지 않게).
+static bool g_aoiEnabled = false;
+static AoiGrid g_aoi;
+static std::vector<PerSocketData*> g_aoiSessions;   // 핸들 → 세션
+static std::vector<int> g_aoiEnter;                 // g_aoiCs 안에서만 쓰는 작업 버퍼
+static std::vector<int> g_aoiLeave;
+static CRITICAL_SECTION g_aoiCs;
+static long long g_aoiUpdates = 0;
+static long long g_aoiDeliveries = 0;
+static long long g_aoiSlowCuts = 0;
+
+// Worker마다 하나: 이번 요청에서 락 밖에서 비우기로 맡은 세션들
+typedef std::vector<PerSocketData*> AoiOutbox;
+static AoiOutbox g_aoiOutboxes[WORKER_THREAD_COUNT];
+
+// SYNC 스냅샷: 엔티티 하나 = 12바이트 (좌표는 cm 정수 → 조금 움직이면 XOR 하위 비트만 바뀜)
+struct SyncEntity {
+    int32_t id;
+    int32_t xCm;
+    int32_t yCm;
+};
+
+// Worker마다 하나: 스냅샷 버퍼 + LZ4 해시 테이블 / 압축 버퍼 (패킷마다 할당하지 않음)
+struct SyncWorkspace {
+    CodecWorkspace codec;
+    std::vector<SyncEntity> entities;
+};
+
+static SyncWorkspace g_syncWorkspaces[WORKER_THREAD_COUNT];
+static long long g_syncPackets = 0;
+static long long g_syncRawBytes = 0;
+static long long g_syncWireBytes = 0;
+
+// 연결의 참조 하나를 놓는다. 마지막이면 소켓을 닫고 해제
+void ReleaseSocketData(PerSocketData* perSocketData) {
+    if (InterlockedDecrement(&perSocketData->refCount) > 0) return;
+    if (perSocketData->socket != INVALID_SOCKET) closesocket(perSocketData->socket);
+    delete perSocketData->codec;
+    delete perSocketData;
+}
+
+// g_aoiCs 안에서: target 에 보낼 내용을 붙인다. 비우는 Worker가 없으면 이 Worker가 맡는다
+void AoiQueue(AoiOutbox& outbox, PerSocketData* target, const char* data, int len) {
+    if (target->aoiCut) return;
+    if ((int)target->aoiPending.size() + len > AOI_MAX_PENDING) {
+        // 계속 쌓이기만 함 → 끊는다. 걸려 있는 WSARecv 가 취소되면서 평소 종료 경로를 탄다
+        target->aoiCut = true;
+        g_aoiSlowCuts++;
+        shutdown(target->socket, SD_BOTH);
+        CancelIoEx((HANDLE)target->socket, NULL);
+        return;
+    }
+    target->aoiPending.append(data, len);
+    if (!target->aoiSending) {
+        target->aoiSending = true;
+        InterlockedIncrement(&target->refCount);
+        outbox.push_back(target);
+    }
+}
+
+// g_aoiCs 밖에서: 맡은 세션들의 aoiPending 을 빌 때까지 보낸다
+void AoiFlush(AoiOutbox& outbox) {
+    std::string chunk;
+    for (PerSocketData* target : outbox) {
+        while (1) {
+            EnterCriticalSection(&g_aoiCs);
+            chunk.clear();
+            chunk.swap(target->aoiPending);
+            if (chunk.empty()) target->aoiSending = false;
+            LeaveCriticalSection(&g_aoiCs);
+            if (chunk.empty()) break;
+            SendAll(target->socket, chunk.data(), (int)chunk.size());
+        }
+        ReleaseSocketData(target);
+    }
+    outbox.clear();
+}
+
+void AoiNotify(AoiOutbox& outbox, PerSocketData* target, const char* message) {
+    AoiQueue(outbox, target, message, (int)strlen(message));
+    g_aoiDeliveries++;
+}
+
+// 서로 보이게 된 (entered) / 안 보이게 된 쌍의 양쪽에 알림
+void AoiNotifyPairs(AoiOutbox& outbox, PerSocketData* session, const std::vector<int>& others, bool entered) {
+    char toPeer[64];
+    char toSelf[64];
+    int self = session->aoiHandle;
+
+    for (int other : others) {
+        PerSocketData* peer = g_aoiSessions[other];
+        if (entered) {
+            sprintf_s(toPeer, "ENTER %d %.1f %.1f\n", session->clientId, g_aoi.entityX[self], g_aoi.entityY[self]);
+            sprintf_s(toSelf, "ENTER %d %.1f %.1f\n", peer->clientId, g_aoi.entityX[other], g_aoi.entityY[other]);
+        } else {
+            sprintf_s(toPeer, "LEAVE %d\n", session->clientId);
+            sprintf_s(toSelf, "LEAVE %d\n", peer->clientId);
+        }
+        AoiNotify(outbox, peer, toPeer);
+        AoiNotify(outbox, session, toSelf);
+    }
+}
+
+// g_aoiCs 안에서
+void AoiMoveSession(AoiOutbox& outbox, PerSocketData* session, float x, float y) {
+    if (session->aoiHandle < 0) {
+        int handle = AoiAdd(g_aoi, x, y, g_aoiEnter);
+        if ((int)g_aoiSessions.size() <= handle) g_aoiSessions.resize(handle + 1, NULL);
+        g_aoiSessions[handle] = session;
+        session->aoiHandle = handle;
+        g_aoiLeave.clear();
+    } else {
+        AoiMove(g_aoi, session->aoiHandle, x, y, g_aoiEnter, g_aoiLeave);
+    }
+
+    AoiNotifyPairs(outbox, session, g_aoiLeave, false);
+    AoiNotifyPairs(outbox, session, g_aoiEnter, true);
+
+    char message[64];
+    sprintf_s(message, "MOVE %d %.1f %.1f\n", session->clientId, x, y);
+    AoiForEachNeighbor(g_aoi, session->aoiHandle, [&](int other) {
+        AoiNotify(outbox, g_aoiSessions[other], message);
+    });
+
+    char reply[32];
+    sprintf_s(reply, "OK %d %d\n", (int)g_aoiEnter.size(), (int)g_aoiLeave.size());
+    AoiQueue(outbox, session, reply, (int)strlen(reply));
+    g_aoiUpdates++;
+}
+
+// g_aoiCs 안에서
+void AoiChat(AoiOutbox& outbox, PerSocketData* session, const char* text) {
+    char message[BUFFER_SIZE + 32];
+    sprintf_s(message, "CHAT %d %s\n", session->clientId, text);
+
+    int receivers = 0;
+    AoiForEachNeighbor(g_aoi, session->aoiHandle, [&](int other) {
+        AoiNotify(outbox, g_aoiSessions[other], message);
+        receivers++;
+    });
+
+    char reply[32];
+    sprintf_s(reply, "OK %d\n", receivers);
+    AoiQueue(outbox, session, reply, (int)strlen(reply));
+}
+
+// "SYNC ack": 주변 엔티티 스냅샷을 ack 된 기준과의 델타(+LZ4)로 보낸다.
+// 격자 읽기와 보낼 내용 붙이기만 g_aoiCs 안에서 하고 인코드와 send 는 밖에서 (Worker별 작업 공간이라 병렬).
+// 세션의 CodecSession 은 그 세션의 recv 완료 경로에서만 쓰므로 (recv 는 하나씩) 락 불필요.
+void AoiSync(int workerId, PerSocketData* session, uint32_t ack) {
+    SyncWorkspace& ws = g_syncWorkspaces[workerId - 1];
+    AoiOutbox& outbox = g_aoiOutboxes[workerId - 1];
+    ws.entities.clear();
+
+    EnterCriticalSection(&g_aoiCs);
+    bool registered = (session->aoiHandle >= 0);
+    if (registered) {
+        AoiForEachNeighbor(g_aoi, session->aoiHandle, [&](int other) {
+            SyncEntity entity = { g_aoiSessions[other]->clientId,
+                                  (int32_t)(g_aoi.entityX[other] * 100), (int32_t)(g_aoi.entityY[other] * 100) };
+            ws.entities.push_back(entity);
+        });
+    } else {
+        const char* reply = "ERR\n";
+        AoiQueue(outbox, session, reply, (int)strlen(reply));
+    }
+    LeaveCriticalSection(&g_aoiCs);
+    if (!registered) {
+        AoiFlush(outbox);
+        return;
+    }
+
+    // id 순으로 정렬 → 보이는 집합이 그대로면 레코드 위치도 그대로 (XOR 이 0에 가까움)
+    int maxEntities = CODEC_MAX_SNAPSHOT / (int)sizeof(SyncEntity);
+    if ((int)ws.entities.size() > maxEntities) ws.entities.resize(maxEntities);
+    std::sort(ws.entities.begin(), ws.entities.end(),
+              [](const SyncEntity& a, const SyncEntity& b) { return a.id < b.id; });
+
+    // 스냅샷 이력(CODEC_HISTORY 개)은 SYNC 를 쓰는 세션만 갖는다
+    if (session->codec == NULL) {
+        session->codec = new CodecSession();
+        CodecSessionInit(*session->codec);
+    }
+
+    int rawLen = (int)(ws.entities.size() * sizeof(SyncEntity));
+    CodecAck(*session->codec, ack);
+    int packetLen = CodecEncode(ws.codec, *session->codec, (const uint8_t*)ws.entities.data(), rawLen);
+
+    char header[32];
+    sprintf_s(header, "SNAP %d\n", packetLen);
+
+    EnterCriticalSection(&g_aoiCs);
+    AoiQueue(outbox, session, header, (int)strlen(header));
+    AoiQueue(outbox, session, (const char*)ws.codec.packet.data(), packetLen);
+    g_syncPackets++;
+    g_syncRawBytes += rawLen;
+    g_syncWireBytes += packetLen;
+    LeaveCriticalSection(&g_aoiCs);
+    AoiFlush(outbox);
+}
+
+// buffer[0..length) 의 요청 줄을 모두 처리. length 는 완성된 줄까지 (PipelineScan 의 consumed):
+// 마지막 '\n' 뒤의 잘린 조각은 호출한 쪽이 버퍼 앞으로 당겨 두고 다음 recv 에 이어 붙인다
+void HandleAoiRequests(int workerId, PerSocketData* session, char* buffer, int length) {
+    AoiOutbox& outbox = g_aoiOutboxes[workerId - 1];
+    char* cursor = buffer;
+    char* end = buffer + length;
+    while (cursor < end) {
+        char* newline = (char*)memchr(cursor, '\n', end - cursor);
+        if (newline == NULL) break;
+        *newline = '\0';
+        if (newline > cursor && newline[-1] == '\r') newline[-1] = '\0';
+        char* line = cursor;
+        cursor = newline + 1;
+        if (line[0] == '\0') continue;   // 빈 줄
+
+        if (strncmp(line, "SYNC ", 5) == 0) {
+            AoiSync(workerId, session, (uint32_t)strtoul(line + 5, NULL, 10));
+            continue;
+        }
+
+        EnterCriticalSection(&g_aoiCs);
+        float x = 0;
+        float y = 0;
+        if (strncmp(line, "MOVE ", 5) == 0 && sscanf_s(line + 5, "%f %f", &x, &y) == 2) {
+            AoiMoveSession(outbox, session, x, y);
+        } else if (strncmp(line, "CHAT ", 5) == 0 && session->aoiHandle >= 0) {
+            AoiChat(outbox, session, line + 5);
+        } else {
+            const char* reply = "ERR\n";
+            AoiQueue(outbox, session, reply, (int)strlen(reply));
+        }
+        bool printStats = (g_aoiUpdates > 0 && g_aoiUpdates % AOI_STATS_INTERVAL == 0);
+        long long updates = g_aoiUpdates;
+        long long deliveries = g_aoiDeliveries;
+        long long syncPackets = g_syncPackets;
+        double syncRatio = (g_syncRawBytes > 0) ? g_syncWireBytes / (double)g_syncRawBytes : 0;
+        long long slowCuts = g_aoiSlowCuts;
+        LeaveCriticalSection(&g_aoiCs);
+        AoiFlush(outbox);
+
+        if (printStats) {
+            EnterCriticalSection(&g_cs);
+            PrintTime();
+            SetColor(COLOR_CYAN);
+            printf("AOI: 이동 %lld회 | 전달 %lld건 (이동당 %.1f)\n",
+                   updates, deliveries, deliveries / (double)updates);
+            if (syncPackets > 0) {
+                printf("     SYNC %lld회 | 전송 바이트 / 원본 = %.3f\n", syncPackets, syncRatio);
+            }
+            if (slowCuts > 0) {
+                printf("     느린 세션 끊음 %lld (못 보낸 알림 > %d B)\n", slowCuts, AOI_MAX_PENDING);
+            }
+            SetColor(COLOR_DEFAULT);
+            LeaveCriticalSection(&g_cs);
+        }
+    }
+}
+
+// 연결 종료: 격자에서 빼고 이 세션을 보던 세션들에 LEAVE
+void AoiLeaveSession(int workerId, PerSocketData* session) {
+    AoiOutbox& outbox = g_aoiOutboxes[workerId - 1];
+    EnterCriticalSection(&g_aoiCs);
+    if (session->aoiHandle >= 0) {
+        AoiRemove(g_aoi, session->aoiHandle, g_aoiLeave);
+        char message[32];
+        sprintf_s(message, "LEAVE %d\n", session->clientId);
+        for (int other : g_aoiLeave) AoiNotify(outbox, g_aoiSessions[other], message);
+        g_aoiSessions[session->aoiHandle] = NULL;
+        session->aoiHandle = -1;
+    }
+    LeaveCriticalSection(&g_aoiCs);
+    AoiFlush(outbox);
+}
+
+// 다음 요청 수신
+//  남겨둔 조각이 없으면 버퍼를 풀에 돌려주고 0바이트 WSARecv 만 건다 (대기 중엔 버퍼 0).
+//  파이프라인 연결이 잘린 조각을 들고 있으면 버퍼를 그대로 쥐고 그 뒤에 이어 받는다.
+bool PostRecv(SOCKET socket, PerIoData* perIoData) {
+    memset(&perIoData->overlapped, 0, sizeof(OVERLAPPED));
+    if (!g_eagerBuffer && perIoData->pipelineLength == 0 && perIoData->buffer != NULL) {
+        BufferPoolReturn(g_bufferPool, perIoData->buffer);
+        perIoData->buffer = NULL;
+    }
+
+    perIoData->zeroByteRead = (perIoData->buffer == NULL);
+    if (perIoData->zeroByteRead) {
+        perIoData->wsaBuf.buf = NULL;
+        perIoData->wsaBuf.len = 0;
+    } else {
+        perIoData->wsaBuf.buf = perIoData->buffer + perIoData->pipelineLength;
+        perIoData->wsaBuf.len = BUFFER_SIZE - 1 - perIoData->pipelineLength;
+    }
+
+    DWORD flags = 0;
+    int result = WSARecv(socket, &perIoData->wsaBuf, 1, NULL, &flags, &perIoData->overlapped, NULL);
+    return !(result == SOCKET_ERROR && WSAGetLastError() != WSA_IO_PENDING);
+}
+
+// 0바이트 수신 완료 → 이제서야 버퍼를 빌려 실제로 읽는다.
+// 데이터가 이미 커널에 와 있으므로 블로킹 recv 도 기다리지 않고 돌아온다.
+// 반환: 읽은 바이트, 0 = 상대가 닫음, -1 = 오류
+int ReadIntoBorrowedBuffer(SOCKET socket, PerIoData* perIoData) {
+    perIoData->zeroByteRead = false;
+    if (perIoData->buffer == NULL) perIoData->buffer = BufferPoolBorrow(g_bufferPool);
+    return recv(socket, perIoData->buffer + perIoData->pipelineLength,
+                BUFFER_SIZE - 1 - perIoData->pipelineLength, 0);
+}
+
+// 연결 상태 해제. 소켓도 여기서 닫힌다 (-aoi 로 다른 Worker가 아직 보내는 중이면 그쪽이 끝낼 때)
+void FreeConnection(PerSocketData* perSocketData, PerIoData* perIoData) {
+    ReleaseSocketData(perSocketData);
+    BufferPoolReturn(g_bufferPool, perIoData->buffer);
+    delete perIoData;
+}
+
+// 상대가 닫았거나 수신 실패
+void CloseConnection(int workerId, PerSocketData* perSocketData, PerIoData* perIoData) {
+    EnterCriticalSection(&g_cs);
+    PrintTime();
+    SetColor(COLOR_RED);
+    printf("Worker %d: Client %d 연결 종료\n", workerId, perIoData->clientId);
+    SetColor(COLOR_DEFAULT);
+    g_clients.erase(perIoData->clientId);
+    ReleaseAdmission(perIoData);
+    LeaveCriticalSection(&g_cs);
+
+    if (g_aoiEnabled) AoiLeaveSession(workerId, perSocketData);
+    FreeConnection(perSocketData, perIoData);
+}
+
+// 유지 연결(AOI / 파이프라인)의 요청 묶음 승인. false 면 호출한 쪽이 BUSY 로 답한다
+bool AdmitBatch(int workerId, PerIoData* perIoData) {
+    ULONGLONG nowUs = NowUs();
+    ULONGLONG delayUs = QueueDelayUs(perIoData, nowUs);
+    EnterCriticalSection(&g_cs);
+    bool admitted = AdmitRequest(perIoData, delayUs, nowUs);
+    if (!admitted) {
+        PrintTime();
+        SetColor(COLOR_RED);
+        printf("Worker %d: Client %d 묶음 대기 %.1fms → BUSY (진행중 %ld)\n",
+               workerId, perIoData->clientId, delayUs / 1000.0, g_admission.inFlight);
+        SetColor(COLOR_DEFAULT);
+    }
+    LeaveCriticalSection(&g_cs);
+    return admitted;
+}
+
+// 파이프라인 연결 (pipeline.h)
+//  recv 완료 하나에 요청이 여러 개 들어 있다. 완성된 줄을 순서대로 처리하고
+//  (요청마다 작업 시간은 그대로) 응답은 묶음마다 send 한 번. 잘린 마지막 줄은
+//  버퍼 앞으로 당겨 두고 그 뒤에 다음 WSARecv 를 건다. 연결은 클라이언트가 닫을 때까지.
+//  같은 소켓엔 WSARecv 가 하나뿐이라 한 연결의 요청은 항상 한 Worker 가 순서대로 처리한다.
+//  묶음마다 승인 제어를 거친다: 대기시간은 완료가 Worker 큐에 들어간 뒤부터라서
+//  뒤 묶음일수록 앞 묶음을 기다린 시간이 더해진다. 거절된 묶음은 "BUSY\n" × n.
+void ServePipelined(int workerId, PerSocketData* perSocketData, PerIoData* perIoData, int length) {
+    char responses[PIPELINE_RESPONSE_BUFFER];
+    bool ok = true;
+
+    while (ok) {
+        PipelineBatch batch = PipelineScan(perIoData->buffer, length);
+        if (batch.requests == 0) break;
+
+        bool admitted = AdmitBatch(workerId, perIoData);
+
+        int responseLen;
+        if (admitted) {
+            EnterCriticalSection(&g_cs);
+            g_workerStatus[workerId - 1] = perIoData->clientId;
+            LeaveCriticalSection(&g_cs);
+
+            for (int i = 0; i < batch.requests; i++) Sleep(g_workMs);
+            responseLen = PipelineBuildResponses(responses, batch.requests);
+        } else {
+            responseLen = PipelineBuildBusy(responses, batch.requests);
+        }
+        ok = SendAll(perSocketData->socket, responses, responseLen);
+        length = PipelineCompact(perIoData->buffer, length, batch.consumed);
+
+        EnterCriticalSection(&g_cs);
+        ReleaseAdmission(perIoData);
+        if (!admitted) {
+            LeaveCriticalSection(&g_cs);
+            continue;
+        }
+        g_workerStatus[workerId - 1] = 0;
+        g_totalProcessed += batch.requests;
+        g_pipelineRequests += batch.requests;
+        g_pipelineBatches++;
+
+        printf("\n");
+        PrintTime();
+        SetColor(COLOR_GREEN);
+        printf("Worker %d: Client %d 파이프라인 %d건 처리 → 응답 send 1회\n",
+               workerId, perIoData->clientId, batch.requests);
+        SetColor(COLOR_DEFAULT);
+        PrintStats();
+        LeaveCriticalSection(&g_cs);
+    }
+
+    // 줄 하나가 버퍼보다 길면 받을 자리가 없다 → 프로토콜 오류로 종료
+    perIoData->pipelineLength = length;
+    if (ok && !PipelineOverflow(length, BUFFER_SIZE) && PostRecv(perSocketData->socket, perIoData)) return;
+
+    EnterCriticalSection(&g_cs);
+    g_clients.erase(perIoData->clientId);
+    ReleaseAdmission(perIoData);
+    LeaveCriticalSection(&g_cs);
+
+    FreeConnection(perSocketData, perIoData);
+}
+
 // Worker Thread
 unsigned int __stdcall WorkerThread(void* arg) {
     int workerId = (int)(intptr_t)arg;
@@ -122,40 +867,138 @@ unsigned int __stdcall WorkerThread(void* arg) {
         ULONG_PTR completionKey = 0;
         PerIoData* perIoData = NULL;
 
-        // Completion Port에서 완료된 작업 꺼내기
-        BOOL result = GetQueuedCompletionStatus(
-            g_hIocp,
-            &bytesTransferred,
-            &completionKey,
-            (LPOVERLAPPED*)&perIoData,
-            INFINITE
-        );
-
-        if (!result || bytesTransferred == 0) {
-            if (perIoData) {
-                EnterCriticalSection(&g_cs);
+        // Completion Port에서 완료된 작업 꺼내기 (-busy-poll 이면 잠들기 전에 스핀)
+        BOOL result = GetCompletion(&bytesTransferred, &completionKey, &perIoData);
+
+        // 0바이트 WSARecv 는 성공해도 0 이 돌아온다 (읽을 데이터가 있다는 뜻)
+        if (!result || perIoData->failed || (bytesTransferred == 0 && !perIoData->zeroByteRead)) {
+            if (perIoData) CloseConnection(workerId, (PerSocketData*)completionKey, perIoData);
+            continue;
+        }
+
+        PerSocketData* perSocketData = (PerSocketData*)completionKey;
+
+        if (perIoData->ioType == IO_RECV) {
+            // 속도 제한: 토큰이 없으면 Worker를 붙잡지 않고 타이머로 미룬다.
+            // 그동안 이 소켓엔 WSARecv도 걸지 않으므로 커널 버퍼에 쌓이고
+            // TCP 흐름 제어가 클라이언트를 늦춘다.
+            EnterCriticalSection(&g_cs);
+            bool resumed = perIoData->throttled;
+            if (resumed) {
+                DeleteTimerQueueTimer(NULL, perIoData->throttleTimer, NULL);
+                perIoData->throttleTimer = NULL;
+                perIoData->throttled = false;
+            }
+            uint32_t waitMs = TakeReadToken(perSocketData);
+            if (waitMs > 0) {
+                g_throttledCount++;
+                perIoData->throttled = true;
+                perIoData->recvBytes = bytesTransferred;
+                perIoData->completionKey = completionKey;
+                if (!CreateTimerQueueTimer(&perIoData->throttleTimer, NULL, ResumeThrottled,
+                                           perIoData, waitMs, 0, WT_EXECUTEONLYONCE)) {
+                    // 타이머가 없으면 아무도 이 완료를 다시 넣지 않는다 (WSARecv 도 안 걸려 있음)
+                    // → 영영 멈춘 연결이 되기 전에 닫는다
+                    perIoData->throttled = false;
+                    perIoData->throttleTimer = NULL;
+                    PrintTime();
+                    SetColor(COLOR_RED);
+                    printf("Worker %d: Client %d 속도 제한 타이머 생성 실패 (%lu) → 연결 종료\n",
+                           workerId, perIoData->clientId, GetLastError());
+                    SetColor(COLOR_DEFAULT);
+                    LeaveCriticalSection(&g_cs);
+                    CloseConnection(workerId, perSocketData, perIoData);
+                    continue;
+                }
                 PrintTime();
                 SetColor(COLOR_RED);
-                printf("Worker %d: Client %d 연결 종료\n", workerId, perIoData->clientId);
+                printf("Worker %d: Client %d 속도 제한 → %ums 후 재개 (누적 %d)\n",
+                       workerId, perIoData->clientId, waitMs, g_throttledCount);
                 SetColor(COLOR_DEFAULT);
-                g_clients.erase(perIoData->clientId);
                 LeaveCriticalSection(&g_cs);
+                continue;
+            }
+            LeaveCriticalSection(&g_cs);
 
-                PerSocketData* perSocketData = (PerSocketData*)completionKey;
-                closesocket(perSocketData->socket);
-                delete perSocketData;
-                delete perIoData;
+            if (perIoData->zeroByteRead) {
+                int received = ReadIntoBorrowedBuffer(perSocketData->socket, perIoData);
+                if (received <= 0) {
+                    CloseConnection(workerId, perSocketData, perIoData);
+                    continue;
+                }
+                bytesTransferred = (DWORD)received;
             }
-            continue;
-        }
 
-        PerSocketData* perSocketData = (PerSocketData*)completionKey;
+            int length = perIoData->pipelineLength + (int)bytesTransferred;
+            perIoData->buffer[length] = '\0';
+
+            // AOI 세션 모드: 처리하고 연결은 그대로 둔 채 다음 요청을 기다린다.
+            // TCP 라 줄이 recv 경계에서 잘릴 수 있다 → 완성된 줄만 처리하고 잘린 조각은
+            // 파이프라인 연결처럼 버퍼 앞으로 당겨 두고 그 뒤에 다음 WSARecv 를 건다
+            if (g_aoiEnabled) {
+                PipelineBatch lines = PipelineScan(perIoData->buffer, length, BUFFER_SIZE);
+                if (lines.requests > 0) {
+                    if (AdmitBatch(workerId, perIoData)) {
+                        HandleAoiRequests(workerId, perSocketData, perIoData->buffer, lines.consumed);
+                    } else {
+                        // 줄마다 BUSY. 다른 Worker가 이 세션에 알림을 보내는 중일 수 있으므로 같은 줄에 세운다
+                        EnterCriticalSection(&g_aoiCs);
+                        for (int i = 0; i < lines.requests; i++) {
+                            AoiQueue(g_aoiOutboxes[workerId - 1], perSocketData, PIPELINE_BUSY, PIPELINE_BUSY_LEN);
+                        }
+                        LeaveCriticalSection(&g_aoiCs);
+                        AoiFlush(g_aoiOutboxes[workerId - 1]);
+                    }
+                }
+                EnterCriticalSection(&g_cs);
+                ReleaseAdmission(perIoData);
+                LeaveCriticalSection(&g_cs);
+
+                length = PipelineCompact(perIoData->buffer, length, lines.consumed);
+                perIoData->pipelineLength = length;
+
+                // 줄 하나가 버퍼보다 길면 받을 자리가 없다 → 프로토콜 오류로 종료
+                if (PipelineOverflow(length, BUFFER_SIZE) || !PostRecv(perSocketData->socket, perIoData)) {
+                    AoiLeaveSession(workerId, perSocketData);
+                    EnterCriticalSection(&g_cs);
+                    g_clients.erase(perIoData->clientId);
+                    ReleaseAdmission(perIoData);
+                    LeaveCriticalSection(&g_cs);
+
+                    FreeConnection(perSocketData, perIoData);
+                }
+                continue;
+            }
+
+            // 파이프라인 연결: 연결을 유지하며 버퍼 안의 요청을 묶어서 처리
+            if (!g_tlsEnabled && (perIoData->pipelined || PipelineDetect(perIoData->buffer, length))) {
+                perIoData->pipelined = true;
+                ServePipelined(workerId, perSocketData, perIoData, length);
+                continue;
+            }
 
-        if (perIoData->ioType == IO_RECV) {
-            perIoData->buffer[bytesTransferred] = '\0';
             perIoData->startProcessTime = GetTickCount64();
 
+            // 큐에서 너무 오래 기다린 요청은 처리하지 않고 바로 거절
+            ULONGLONG nowUs = NowUs();
+            ULONGLONG delayUs = QueueDelayUs(perIoData, nowUs);
             EnterCriticalSection(&g_cs);
+            if (!AdmitRequest(perIoData, delayUs, nowUs)) {
+                PrintTime();
+                SetColor(COLOR_RED);
+                printf("Worker %d: Client %d 큐 대기 %.1fms → BUSY (부하 차단)\n",
+                       workerId, perIoData->clientId, delayUs / 1000.0);
+                SetColor(COLOR_DEFAULT);
+                g_clients.erase(perIoData->clientId);
+                ReleaseAdmission(perIoData);
+                LeaveCriticalSection(&g_cs);
+
+                RejectBusy(perSocketData->socket);
+                perSocketData->socket = INVALID_SOCKET;     // RejectBusy 가 닫았다
+                FreeConnection(perSocketData, perIoData);
+                continue;
+            }
+
             g_totalWaitTime += (perIoData->startProcessTime - perIoData->connectTime);
             g_workerStatus[workerId - 1] = perIoData->clientId;
 
@@ -168,17 +1011,46 @@ unsigned int __stdcall WorkerThread(void* arg) {
             PrintWorkerStatus();
             LeaveCriticalSection(&g_cs);
 
+            // TLS: 첫 WSARecv로 받은 건 ClientHello → 핸드셰이크를 마치고 요청 평문을 읽는다
+            // (핸드셰이크 왕복은 이 Worker에서 블로킹으로 처리 = 암호화 비용이 Worker 시간에 그대로 잡힘)
+            TlsSession tls;
+            TlsSession* tlsSession = NULL;
+            if (g_tlsEnabled) {
+                TlsSessionInit(tls);
+                int requestLen = -1;
+                if (TlsAccept(tls, g_tlsCreds, perSocketData->socket, perIoData->buffer, bytesTransferred)) {
+                    requestLen = TlsRecv(tls, perSocketData->socket, perIoData->buffer, BUFFER_SIZE - 1);
+                }
+                if (requestLen <= 0) {
+                    EnterCriticalSection(&g_cs);
+                    PrintTime();
+                    SetColor(COLOR_RED);
+                    printf("Worker %d: Client %d TLS 핸드셰이크 실패\n", workerId, perIoData->clientId);
+                    SetColor(COLOR_DEFAULT);
+                    g_workerStatus[workerId - 1] = 0;
+                    g_clients.erase(perIoData->clientId);
+                    ReleaseAdmission(perIoData);
+                    LeaveCriticalSection(&g_cs);
+
+                    TlsSessionClose(tls);
+                    FreeConnection(perSocketData, perIoData);
+                    continue;
+                }
+                perIoData->buffer[requestLen] = '\0';
+                tlsSession = &tls;
+            }
+
             // 작업 처리 시뮬레이션
             for (int progress = 0; progress <= 100; progress += 5) {
                 EnterCriticalSection(&g_cs);
                 perIoData->progress = progress;
                 LeaveCriticalSection(&g_cs);
-                Sleep(SIMULATE_WORK_MS / 20);
+                Sleep(g_workMs / 20);
             }
 
             // 응답 전송
-            const char* response = "OK";
-            send(perSocketData->socket, response, (int)strlen(response), 0);
+            SendResponse(perSocketData->socket, tlsSession, perIoData->buffer);
+            if (tlsSession) TlsSessionClose(tls);
 
             EnterCriticalSection(&g_cs);
             g_workerStatus[workerId - 1] = 0;
@@ -193,20 +1065,42 @@ unsigned int __stdcall WorkerThread(void* arg) {
             PrintStats();
 
             g_clients.erase(perIoData->clientId);
+            ReleaseAdmission(perIoData);
             LeaveCriticalSection(&g_cs);
 
-            closesocket(perSocketData->socket);
-            delete perSocketData;
-            delete perIoData;
+            FreeConnection(perSocketData, perIoData);
         }
     }
 
     return 0;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     SetConsoleOutputCP(CP_UTF8);
 
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(argv[i], "-work") == 0 && hasValue) g_workMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-admit") == 0) g_admission.enabled = true;
+        else if (strcmp(argv[i], "-target") == 0 && hasValue) g_admission.targetUs = atoi(argv[++i]) * 1000ULL;
+        else if (strcmp(argv[i], "-interval") == 0 && hasValue) g_admission.intervalUs = atoi(argv[++i]) * 1000ULL;
+        else if (strcmp(argv[i], "-max-inflight") == 0 && hasValue) g_admission.maxInFlight = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-conn-rate") == 0 && hasValue) g_connLimit.ratePerSec = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-conn-burst") == 0 && hasValue) g_connLimit.burst = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-ip-rate") == 0 && hasValue) g_ipLimit.ratePerSec = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-ip-burst") == 0 && hasValue) g_ipLimit.burst = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "-tls") == 0) g_tlsEnabled = true;
+        else if (strcmp(argv[i], "-aoi") == 0) g_aoiEnabled = true;
+        else if (strcmp(argv[i], "-busy-poll") == 0 && hasValue) g_busyPollUs = _atoi64(argv[++i]);
+        else if (strcmp(argv[i], "-files") == 0 && hasValue) g_fileRoot = argv[++i];
+        else if (strcmp(argv[i], "-eager-buffer") == 0) g_eagerBuffer = true;
+    }
+    if (g_connLimit.burst <= 0) g_connLimit.burst = DefaultBurst(g_connLimit);
+    if (g_ipLimit.burst <= 0) g_ipLimit.burst = DefaultBurst(g_ipLimit);
+    IpRateTableInit(g_ipTable, 4096);
+    QueryPerformanceFrequency(&g_qpcFreq);
+    BufferPoolInit(g_bufferPool, BUFFER_SIZE);
+
     printf("\n");
     SetColor(COLOR_CYAN);
     printf("═══════════════════════════════════════════════════════════════\n");
@@ -217,9 +1111,44 @@ int main() {
     printf("  - Worker Thread %d개가 큐에서 작업을 꺼내 처리\n", WORKER_THREAD_COUNT);
     printf("  - Windows 최고 성능의 네트워크 모델!\n");
     printf("  - Port: %d\n", PORT);
+    printf("  - 작업 시간: %d ms\n", g_workMs);
+    if (g_admission.enabled) {
+        printf("  - 승인 제어: target %llums / interval %llums / 최대 진행 %ld\n",
+               g_admission.targetUs / 1000, g_admission.intervalUs / 1000, g_admission.maxInFlight);
+    }
+    if (g_connLimit.ratePerSec > 0) {
+        printf("  - 연결별 제한: %.1f req/s (burst %.0f)\n", g_connLimit.ratePerSec, g_connLimit.burst);
+    }
+    if (g_ipLimit.ratePerSec > 0) {
+        printf("  - IP별 제한: %.1f req/s (burst %.0f)\n", g_ipLimit.ratePerSec, g_ipLimit.burst);
+    }
+    if (g_tlsEnabled) {
+        printf("  - TLS: Schannel TLS 1.2 (자체 서명 CN=%s, 사용자 공간 암호화)\n", TLS_SERVER_NAME);
+    }
+    if (g_aoiEnabled) {
+        printf("  - AOI: 세션 유지, 월드 %.0fm, 칸 %.0fm → 3×3 칸 안에만 브로드캐스트\n",
+               AOI_WORLD_SIZE, AOI_CELL_SIZE);
+    }
+    if (g_busyPollUs > 0) {
+        printf("  - 바쁜 폴링: %llu us 스핀 후 잠듦, Worker 코어 고정\n", g_busyPollUs);
+    }
+    printf("  - 파일 전송: FILE (TransmitFile) / FILECOPY (ReadFile + send), 루트 %s\n", g_fileRoot);
+    printf("  - 연결 상태: PerIoData %zu B + PerSocketData %zu B, 수신 버퍼 %d B 는 %s\n",
+           sizeof(PerIoData), sizeof(PerSocketData), BUFFER_SIZE,
+           g_eagerBuffer ? "연결마다 (-eager-buffer)" : "읽는 동안만 풀에서");
     printf("═══════════════════════════════════════════════════════════════\n\n");
 
     InitializeCriticalSection(&g_cs);
+    InitializeCriticalSection(&g_aoiCs);
+    AoiInit(g_aoi, AOI_WORLD_SIZE, AOI_WORLD_SIZE, AOI_CELL_SIZE);
+    for (int i = 0; i < WORKER_THREAD_COUNT; i++) CodecWorkspaceInit(g_syncWorkspaces[i].codec);
+
+    if (g_tlsEnabled && !TlsCreateServerCredentials(g_tlsCreds)) {
+        SetColor(COLOR_RED);
+        printf("TLS 인증서/자격 증명 생성 실패\n");
+        SetColor(COLOR_DEFAULT);
+        return 1;
+    }
 
     WSADATA wsaData;
     if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
@@ -237,6 +1166,21 @@ int main() {
         return 1;
     }
 
+    // -admit: Worker는 디스패처 뒤의 별도 포트에서 꺼낸다 (큐 대기 측정, DispatcherThread 참고)
+    g_hWorkQueue = g_hIocp;
+    HANDLE dispatcherThread = NULL;
+    if (g_admission.enabled) {
+        g_hWorkQueue = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 0);
+        if (g_hWorkQueue == NULL) {
+            SetColor(COLOR_RED);
+            printf("Worker 큐 생성 실패\n");
+            CloseHandle(g_hIocp);
+            WSACleanup();
+            return 1;
+        }
+        dispatcherThread = (HANDLE)_beginthreadex(NULL, 0, DispatcherThread, NULL, 0, NULL);
+    }
+
     PrintTime();
     SetColor(COLOR_GREEN);
     printf("Completion Port 생성 완료!\n");
@@ -249,6 +1193,17 @@ int main() {
             NULL, 0, WorkerThread, (void*)(intptr_t)(i + 1), 0, NULL);
     }
 
+    // 바쁜 폴링 Worker는 코어 하나씩 전담 (코어 0은 accept 스레드와 OS 몫으로 남김)
+    if (g_busyPollUs > 0) {
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        DWORD cpuCount = systemInfo.dwNumberOfProcessors;
+        for (int i = 0; i < WORKER_THREAD_COUNT; i++) {
+            DWORD cpu = (cpuCount > 1) ? 1 + (i % (cpuCount - 1)) : 0;
+            SetThreadAffinityMask(workerThreads[i], (DWORD_PTR)1 << cpu);
+        }
+    }
+
     PrintTime();
     SetColor(COLOR_GREEN);
     printf("Worker Thread %d개 생성 완료!\n", WORKER_THREAD_COUNT);
@@ -310,6 +1265,25 @@ int main() {
 
         clientIdCounter++;
 
+        // 과부하면 큐에 넣기 전에 바로 거절 (빠른 실패)
+        EnterCriticalSection(&g_cs);
+        PerIoData* perIoData = new PerIoData();
+        memset(perIoData, 0, sizeof(PerIoData));
+        bool admitted = AdmitConnection(perIoData);
+        if (!admitted) {
+            PrintTime();
+            SetColor(COLOR_RED);
+            printf("Client %d 접속 → BUSY (진행중 %ld, %s)\n", clientIdCounter,
+                   g_admission.inFlight, g_admission.overloaded ? "과부하" : "상한 초과");
+            SetColor(COLOR_DEFAULT);
+        }
+        LeaveCriticalSection(&g_cs);
+        if (!admitted) {
+            RejectBusy(clientSocket);
+            delete perIoData;
+            continue;
+        }
+
         EnterCriticalSection(&g_cs);
         printf("\n");
         PrintTime();
@@ -322,16 +1296,20 @@ int main() {
         PerSocketData* perSocketData = new PerSocketData();
         perSocketData->socket = clientSocket;
         perSocketData->clientId = clientIdCounter;
+        perSocketData->ip = clientAddr.sin_addr.s_addr;
+        TokenBucketInit(perSocketData->bucket, g_connLimit, (uint32_t)GetTickCount64());
+        perSocketData->aoiHandle = -1;
+        perSocketData->codec = NULL;
+        perSocketData->aoiSending = false;
+        perSocketData->aoiCut = false;
+        perSocketData->refCount = 1;
 
         // 소켓을 IOCP에 연결
         CreateIoCompletionPort((HANDLE)clientSocket, g_hIocp,
                                (ULONG_PTR)perSocketData, 0);
 
-        // Per-I/O 데이터 생성
-        PerIoData* perIoData = new PerIoData();
-        memset(perIoData, 0, sizeof(PerIoData));
-        perIoData->wsaBuf.buf = perIoData->buffer;
-        perIoData->wsaBuf.len = BUFFER_SIZE;
+        // Per-I/O 데이터 (accept 직전에 만듦, 승인 자리를 거기 기록). 버퍼는 첫 데이터가 올 때 빌린다, -eager-buffer 면 지금
+        if (g_eagerBuffer) perIoData->buffer = BufferPoolBorrow(g_bufferPool);
         perIoData->ioType = IO_RECV;
         perIoData->clientId = clientIdCounter;
         perIoData->progress = 0;
@@ -341,24 +1319,17 @@ int main() {
         g_clients[clientIdCounter] = perIoData;
         LeaveCriticalSection(&g_cs);
 
-        // Overlapped Recv 시작
-        DWORD flags = 0;
-        DWORD bytesReceived = 0;
-        int result = WSARecv(clientSocket, &perIoData->wsaBuf, 1,
-                             &bytesReceived, &flags,
-                             &perIoData->overlapped, NULL);
-
-        if (result == SOCKET_ERROR && WSAGetLastError() != WSA_IO_PENDING) {
+        // Overlapped Recv 시작 (버퍼가 없으면 0바이트)
+        if (!PostRecv(clientSocket, perIoData)) {
             EnterCriticalSection(&g_cs);
             SetColor(COLOR_RED);
             printf("WSARecv 실패: %d\n", WSAGetLastError());
             SetColor(COLOR_DEFAULT);
             g_clients.erase(clientIdCounter);
+            ReleaseAdmission(perIoData);
             LeaveCriticalSection(&g_cs);
 
-            closesocket(clientSocket);
-            delete perSocketData;
-            delete perIoData;
+            FreeConnection(perSocketData, perIoData);
         } else {
             EnterCriticalSection(&g_cs);
             PrintTime();
@@ -371,8 +1342,11 @@ int main() {
     for (int i = 0; i < WORKER_THREAD_COUNT; i++) {
         CloseHandle(workerThreads[i]);
     }
+    if (dispatcherThread != NULL) CloseHandle(dispatcherThread);
     closesocket(listenSocket);
+    if (g_hWorkQueue != g_hIocp) CloseHandle(g_hWorkQueue);
     CloseHandle(g_hIocp);
+    DeleteCriticalSection(&g_aoiCs);
     DeleteCriticalSection(&g_cs);
     WSACleanup();
 
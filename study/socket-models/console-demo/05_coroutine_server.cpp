@@ -0,0 +1,509 @@
+/*
+ * ============================================
+ *  C++20 코루틴 서버 데모 (IOCP 실행기)
+ * ============================================
+ *  특징:
+ *  - 연결 하나 = 코루틴 하나: recv → 작업 → send 가 위에서 아래로 읽힌다
+ *    (03/04의 ioType/progress 상태 플래그와 완료 switch가 사라짐)
+ *  - co_await AsyncRecv / AsyncSend → WSARecv/WSASend를 걸고 일시 중단
+ *    완료 패킷을 꺼낸 Worker가 그 코루틴을 resume
+ *  - 실행기는 04와 같은 IOCP + Worker Thread 4개 (성능 비교 기준 동일)
+ *  - 코루틴 프레임은 고정 크기 블록 풀에서 (lock-free SList)
+ *    awaitable은 프레임 안에 들어가므로 co_await 마다 힙 할당 없음
+ *
+ *  - 파이프라인 요청 (pipeline.h, '\n' 으로 끝남): 같은 코루틴 안에서
+ *    recv → 완성된 줄 묶음 처리 → 응답 send 한 번 → 다시 recv 를 반복 (연결 유지)
+ *
+ *  옵션:
+ *    -work ms    작업 시간 (기본 400, 04와 같이 Worker를 점유)
+ *
+ *  빌드: cl /std:c++20 /EHsc 05_coroutine_server.cpp ws2_32.lib
+ *  비교: bench_driver.exe -models iocp,coroutine -work 0
+ * ============================================
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <process.h>
+#include <coroutine>
+#include <exception>
+#include <new>
+#include "pipeline.h"
+
+#pragma comment(lib, "ws2_32.lib")
+
+#define PORT 9004
+#define BUFFER_SIZE 1024
+#define WORKER_THREAD_COUNT 4
+#define SIMULATE_WORK_MS 400
+#define FRAME_BLOCK_SIZE 2048   // 코루틴 프레임 (버퍼 1KB 포함) 이 들어가는 크기
+
+// 콘솔 색상
+void SetColor(int color) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+}
+
+#define COLOR_DEFAULT 7
+#define COLOR_GREEN 10
+#define COLOR_YELLOW 14
+#define COLOR_CYAN 11
+#define COLOR_RED 12
+#define COLOR_MAGENTA 13
+#define COLOR_WHITE 15
+
+// 전역 변수
+static HANDLE g_hIocp = NULL;
+static ULONGLONG g_startTick = 0;
+static int g_totalProcessed = 0;
+static int g_pipelineRequests = 0;   // 파이프라인으로 처리한 요청 수
+static int g_pipelineBatches = 0;    // 파이프라인 응답 묶음(send) 수
+static ULONGLONG g_totalWaitTime = 0;
+static ULONGLONG g_totalStartTime = 0;
+static CRITICAL_SECTION g_cs;
+static int g_workerStatus[WORKER_THREAD_COUNT] = {0};  // 0=idle, clientId=busy
+static int g_workMs = SIMULATE_WORK_MS;  // -work <ms> 로 덮어쓰기 (bench_driver용)
+static __declspec(thread) int t_workerId = 0;  // 0 = accept 스레드
+
+void PrintTime() {
+    if (g_startTick == 0) g_startTick = GetTickCount64();
+
+    ULONGLONG elapsed = GetTickCount64() - g_startTick;
+    printf("[%02llu:%02llu.%03llu] ",
+           elapsed / 60000,
+           (elapsed / 1000) % 60,
+           elapsed % 1000);
+}
+
+// ============================================
+//  코루틴 프레임 풀
+// ============================================
+//  연결 코루틴의 프레임은 전부 같은 크기 → 고정 블록 하나로 충분.
+//  반납된 블록은 SList에 쌓였다가 다음 연결이 재사용한다.
+//  (새로 할당되는 블록 수 = 최대 동시 연결 수)
+
+static SLIST_HEADER g_framePool;
+static volatile LONG g_frameBlocks = 0;        // 풀이 OS에서 받아온 블록 수
+static volatile LONG g_frameHeapFallbacks = 0; // FRAME_BLOCK_SIZE를 넘어서 힙으로 간 프레임
+
+void* FramePoolAlloc(size_t size) {
+    if (size > FRAME_BLOCK_SIZE) {
+        InterlockedIncrement(&g_frameHeapFallbacks);
+        return ::operator new(size);
+    }
+
+    void* block = InterlockedPopEntrySList(&g_framePool);
+    if (block == NULL) {
+        block = _aligned_malloc(FRAME_BLOCK_SIZE, MEMORY_ALLOCATION_ALIGNMENT);
+        if (block == NULL) throw std::bad_alloc();
+        InterlockedIncrement(&g_frameBlocks);
+    }
+    return block;
+}
+
+void FramePoolFree(void* block, size_t size) {
+    if (size > FRAME_BLOCK_SIZE) {
+        ::operator delete(block);
+        return;
+    }
+    InterlockedPushEntrySList(&g_framePool, (PSLIST_ENTRY)block);
+}
+
+void PrintStats() {
+    ULONGLONG elapsed = GetTickCount64() - g_totalStartTime;
+    double throughput = (elapsed > 0) ? (g_totalProcessed * 1000.0 / elapsed) : 0;
+    double avgWait = (g_totalProcessed > 0) ? (g_totalWaitTime / (double)g_totalProcessed / 1000.0) : 0;
+
+    SetColor(COLOR_YELLOW);
+    printf("─────────────────────────────────────────────────────────────\n");
+    printf("  처리: %d | 시간: %.2fs | 처리량: %.2f req/sec | 평균대기: %.2fs\n",
+           g_totalProcessed, elapsed / 1000.0, throughput, avgWait);
+    printf("  프레임 풀: 블록 %ld개 × %d bytes | 힙 폴백: %ld\n",
+           g_frameBlocks, FRAME_BLOCK_SIZE, g_frameHeapFallbacks);
+    if (g_pipelineBatches > 0) {
+        printf("  파이프라인: 응답 묶음 %d회 (send 한 번에 평균 %.1f건)\n",
+               g_pipelineBatches, g_pipelineRequests / (double)g_pipelineBatches);
+    }
+    printf("─────────────────────────────────────────────────────────────\n");
+    SetColor(COLOR_DEFAULT);
+}
+
+void PrintWorkerStatus() {
+    printf("  Workers: ");
+    for (int i = 0; i < WORKER_THREAD_COUNT; i++) {
+        if (g_workerStatus[i] == 0) {
+            SetColor(COLOR_DEFAULT);
+            printf("[W%d:idle] ", i + 1);
+        } else {
+            SetColor(COLOR_YELLOW);
+            printf("[W%d:C%d] ", i + 1, g_workerStatus[i]);
+        }
+    }
+    SetColor(COLOR_DEFAULT);
+    printf("\n");
+}
+
+// ============================================
+//  코루틴 타입 / awaitable
+// ============================================
+
+// 연결 코루틴: 시작하면 바로 실행, 끝나면 프레임 스스로 해제 (fire-and-forget)
+struct ConnectionTask {
+    struct promise_type {
+        ConnectionTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t size) { return FramePoolAlloc(size); }
+        static void operator delete(void* block, size_t size) { FramePoolFree(block, size); }
+    };
+};
+
+// 완료 패킷 하나 = 중단된 코루틴 하나
+struct IoOperation {
+    OVERLAPPED overlapped;
+    std::coroutine_handle<> handle;
+    DWORD bytes;
+    DWORD error;
+};
+
+struct IoResult {
+    DWORD bytes;
+    DWORD error;    // 0 = 성공
+};
+
+enum IOType {
+    IO_RECV,
+    IO_SEND
+};
+
+// co_await 대상. 코루틴 프레임 안에 임시 객체로 놓이므로 별도 할당 없음
+struct SocketIo {
+    IoOperation op;
+    SOCKET socket;
+    WSABUF wsaBuf;
+    IOType ioType;
+
+    bool await_ready() { return false; }
+
+    // false 반환 = 중단하지 않고 바로 재개 (즉시 실패: 완료 패킷이 오지 않음)
+    bool await_suspend(std::coroutine_handle<> handle) {
+        memset(&op.overlapped, 0, sizeof(op.overlapped));
+        op.handle = handle;
+        op.bytes = 0;
+        op.error = 0;
+
+        // 성공 즉시 완료여도 완료 패킷은 IOCP로 온다 → 다른 Worker가 곧바로
+        // resume 할 수 있으므로 WSARecv/WSASend 이후에는 this를 건드리지 않는다
+        DWORD flags = 0;
+        int result = (ioType == IO_RECV)
+            ? WSARecv(socket, &wsaBuf, 1, NULL, &flags, &op.overlapped, NULL)
+            : WSASend(socket, &wsaBuf, 1, NULL, 0, &op.overlapped, NULL);
+        if (result == SOCKET_ERROR) {
+            int error = WSAGetLastError();
+            if (error != WSA_IO_PENDING) {
+                op.error = error;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    IoResult await_resume() { return { op.bytes, op.error }; }
+};
+
+SocketIo AsyncRecv(SOCKET socket, char* buffer, int len) {
+    SocketIo io;
+    io.socket = socket;
+    io.wsaBuf.buf = buffer;
+    io.wsaBuf.len = len;
+    io.ioType = IO_RECV;
+    return io;
+}
+
+SocketIo AsyncSend(SOCKET socket, const char* data, int len) {
+    SocketIo io;
+    io.socket = socket;
+    io.wsaBuf.buf = (char*)data;
+    io.wsaBuf.len = len;
+    io.ioType = IO_SEND;
+    return io;
+}
+
+// ============================================
+//  연결 하나의 전체 흐름
+// ============================================
+
+ConnectionTask HandleClient(SOCKET clientSocket, int clientId) {
+    char buffer[BUFFER_SIZE];
+    ULONGLONG connectTime = GetTickCount64();
+
+    IoResult received = co_await AsyncRecv(clientSocket, buffer, BUFFER_SIZE - 1);
+    if (received.error != 0 || received.bytes == 0) {
+        EnterCriticalSection(&g_cs);
+        PrintTime();
+        SetColor(COLOR_RED);
+        printf("Worker %d: Client %d 연결 종료\n", t_workerId, clientId);
+        SetColor(COLOR_DEFAULT);
+        LeaveCriticalSection(&g_cs);
+
+        closesocket(clientSocket);
+        co_return;
+    }
+    buffer[received.bytes] = '\0';
+
+    // 파이프라인 연결: 루프 하나로 읽힌다 (04의 ServePipelined + 재등록 PostRecv 와 같은 흐름)
+    // 응답 버퍼도 프레임 안에 있어서 co_await 사이에 살아 있다
+    if (PipelineDetect(buffer, received.bytes)) {
+        char responses[PIPELINE_RESPONSE_BUFFER];
+        int length = received.bytes;
+
+        while (1) {
+            PipelineBatch batch = PipelineScan(buffer, length);
+            if (batch.requests > 0) {
+                for (int i = 0; i < batch.requests; i++) Sleep(g_workMs);
+
+                int responseLen = PipelineBuildResponses(responses, batch.requests);
+                IoResult sent = co_await AsyncSend(clientSocket, responses, responseLen);
+                if (sent.error != 0) break;
+                length = PipelineCompact(buffer, length, batch.consumed);
+
+                EnterCriticalSection(&g_cs);
+                g_totalProcessed += batch.requests;
+                g_pipelineRequests += batch.requests;
+                g_pipelineBatches++;
+
+                printf("\n");
+                PrintTime();
+                SetColor(COLOR_GREEN);
+                printf("Worker %d: Client %d 파이프라인 %d건 처리 → 응답 send 1회\n",
+                       t_workerId, clientId, batch.requests);
+                SetColor(COLOR_DEFAULT);
+                PrintStats();
+                LeaveCriticalSection(&g_cs);
+                continue;   // 버퍼에 완성된 줄이 더 남았을 수 있다
+            }
+
+            if (PipelineOverflow(length, BUFFER_SIZE)) break;
+            IoResult more = co_await AsyncRecv(clientSocket, buffer + length, BUFFER_SIZE - 1 - length);
+            if (more.error != 0 || more.bytes == 0) break;
+            length += more.bytes;
+        }
+
+        closesocket(clientSocket);
+        co_return;
+    }
+
+    // 여기부터는 완료 패킷을 꺼낸 Worker 스레드 위에서 실행된다
+    int workerId = t_workerId;
+    ULONGLONG startProcessTime = GetTickCount64();
+
+    EnterCriticalSection(&g_cs);
+    g_totalWaitTime += (startProcessTime - connectTime);
+    g_workerStatus[workerId - 1] = clientId;
+
+    printf("\n");
+    PrintTime();
+    SetColor(COLOR_MAGENTA);
+    printf("Worker %d: Client %d 작업 시작 (co_await recv 재개)\n", workerId, clientId);
+    SetColor(COLOR_DEFAULT);
+    PrintWorkerStatus();
+    LeaveCriticalSection(&g_cs);
+
+    // 작업 처리 시뮬레이션 (04와 동일하게 Worker 점유)
+    for (int progress = 0; progress <= 100; progress += 5) {
+        Sleep(g_workMs / 20);
+    }
+
+    EnterCriticalSection(&g_cs);
+    g_workerStatus[workerId - 1] = 0;
+    LeaveCriticalSection(&g_cs);
+
+    // 응답 전송: 완료되면 다른 Worker에서 재개될 수 있음
+    const char* response = "OK";
+    IoResult sent = co_await AsyncSend(clientSocket, response, (int)strlen(response));
+
+    EnterCriticalSection(&g_cs);
+    g_totalProcessed++;
+
+    printf("\n");
+    PrintTime();
+    SetColor(sent.error == 0 ? COLOR_GREEN : COLOR_RED);
+    printf("Worker %d: Client %d %s\n", t_workerId, clientId,
+           sent.error == 0 ? "처리 완료!" : "응답 전송 실패");
+    SetColor(COLOR_DEFAULT);
+    PrintWorkerStatus();
+    PrintStats();
+    LeaveCriticalSection(&g_cs);
+
+    closesocket(clientSocket);
+}
+
+// Worker Thread: 완료 패킷 → 해당 코루틴 resume (상태 분기 없음)
+unsigned int __stdcall WorkerThread(void* arg) {
+    t_workerId = (int)(intptr_t)arg;
+
+    while (1) {
+        DWORD bytesTransferred = 0;
+        ULONG_PTR completionKey = 0;
+        OVERLAPPED* overlapped = NULL;
+
+        BOOL result = GetQueuedCompletionStatus(
+            g_hIocp,
+            &bytesTransferred,
+            &completionKey,
+            &overlapped,
+            INFINITE
+        );
+        if (overlapped == NULL) continue;  // 포트 자체 오류 (완료된 I/O 없음)
+
+        IoOperation* op = CONTAINING_RECORD(overlapped, IoOperation, overlapped);
+        op->bytes = bytesTransferred;
+        op->error = result ? 0 : GetLastError();
+        op->handle.resume();
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(argv[i], "-work") == 0 && hasValue) g_workMs = atoi(argv[++i]);
+    }
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("  [코루틴 서버] C++20 Coroutine Server Demo\n");
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  - 연결마다 코루틴 하나: co_await recv → 작업 → co_await send\n");
+    printf("  - 실행기: IOCP + Worker Thread %d개 (04와 동일)\n", WORKER_THREAD_COUNT);
+    printf("  - 프레임 풀: %d bytes 블록 재사용 (co_await 당 힙 할당 없음)\n", FRAME_BLOCK_SIZE);
+    printf("  - Port: %d\n", PORT);
+    printf("  - 작업 시간: %d ms\n", g_workMs);
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    InitializeCriticalSection(&g_cs);
+    InitializeSListHead(&g_framePool);
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        SetColor(COLOR_RED);
+        printf("WSAStartup 실패\n");
+        return 1;
+    }
+
+    // IOCP 생성
+    g_hIocp = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 0);
+    if (g_hIocp == NULL) {
+        SetColor(COLOR_RED);
+        printf("IOCP 생성 실패\n");
+        WSACleanup();
+        return 1;
+    }
+
+    // Worker Thread 생성
+    HANDLE workerThreads[WORKER_THREAD_COUNT];
+    for (int i = 0; i < WORKER_THREAD_COUNT; i++) {
+        workerThreads[i] = (HANDLE)_beginthreadex(
+            NULL, 0, WorkerThread, (void*)(intptr_t)(i + 1), 0, NULL);
+    }
+
+    PrintTime();
+    SetColor(COLOR_GREEN);
+    printf("Completion Port + Worker Thread %d개 생성 완료!\n", WORKER_THREAD_COUNT);
+    SetColor(COLOR_DEFAULT);
+    PrintWorkerStatus();
+
+    // Listen 소켓 생성
+    SOCKET listenSocket = WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP,
+                                     NULL, 0, WSA_FLAG_OVERLAPPED);
+    if (listenSocket == INVALID_SOCKET) {
+        SetColor(COLOR_RED);
+        printf("소켓 생성 실패\n");
+        CloseHandle(g_hIocp);
+        WSACleanup();
+        return 1;
+    }
+
+    sockaddr_in serverAddr;
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_addr.s_addr = INADDR_ANY;
+    serverAddr.sin_port = htons(PORT);
+
+    if (bind(listenSocket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
+        SetColor(COLOR_RED);
+        printf("바인딩 실패\n");
+        closesocket(listenSocket);
+        CloseHandle(g_hIocp);
+        WSACleanup();
+        return 1;
+    }
+
+    if (listen(listenSocket, SOMAXCONN) == SOCKET_ERROR) {
+        SetColor(COLOR_RED);
+        printf("리슨 실패\n");
+        closesocket(listenSocket);
+        CloseHandle(g_hIocp);
+        WSACleanup();
+        return 1;
+    }
+
+    printf("\n");
+    PrintTime();
+    SetColor(COLOR_GREEN);
+    printf("서버 시작! 클라이언트 대기중...\n");
+    SetColor(COLOR_DEFAULT);
+
+    int clientIdCounter = 0;
+    g_totalStartTime = GetTickCount64();
+
+    while (1) {
+        sockaddr_in clientAddr;
+        int clientAddrLen = sizeof(clientAddr);
+
+        // 클라이언트 접속 대기
+        SOCKET clientSocket = accept(listenSocket, (sockaddr*)&clientAddr, &clientAddrLen);
+        if (clientSocket == INVALID_SOCKET) {
+            continue;
+        }
+
+        clientIdCounter++;
+
+        EnterCriticalSection(&g_cs);
+        printf("\n");
+        PrintTime();
+        SetColor(COLOR_CYAN);
+        printf("Client %d 접속! → 코루틴 시작\n", clientIdCounter);
+        SetColor(COLOR_DEFAULT);
+        LeaveCriticalSection(&g_cs);
+
+        // 소켓을 IOCP에 연결 (completion key는 쓰지 않음: OVERLAPPED → 코루틴)
+        CreateIoCompletionPort((HANDLE)clientSocket, g_hIocp, 0, 0);
+
+        // 첫 co_await(recv)까지 여기서 실행되고 돌아온다
+        HandleClient(clientSocket, clientIdCounter);
+    }
+
+    // 정리
+    for (int i = 0; i < WORKER_THREAD_COUNT; i++) {
+        CloseHandle(workerThreads[i]);
+    }
+    closesocket(listenSocket);
+    CloseHandle(g_hIocp);
+    DeleteCriticalSection(&g_cs);
+    WSACleanup();
+
+    return 0;
+}
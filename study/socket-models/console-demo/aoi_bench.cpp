@@ -0,0 +1,299 @@
+/*
+ * ============================================
+ *  AOI (관심 영역) 브로드캐스트 벤치마크
+ * ============================================
+ *  엔티티 N개가 월드 안에서 무작위로 걷는다. 한 틱마다 모든 엔티티가
+ *  한 번씩 움직이고, 그 위치 갱신을 "받아야 할 세션"의 송신 버퍼에 쓴다.
+ *  소켓 없이 서버 안쪽 비용(대상 찾기 + 대상마다 버퍼 쓰기)만 잰다.
+ *
+ *  방식:
+ *    naive-all     전원에게 전송 (관심 관리 없음, 지금 서버들이 브로드캐스트하면 이렇게 됨)
+ *    naive-radius  모든 쌍 거리 검사 후 반경 안에만 전송 (대상은 줄지만 찾기가 O(N²))
+ *    grid          aoi_grid.h: 3×3 칸 안에만 전송 + 칸이 바뀔 때만 enter / leave
+ *
+ *  측정: updates/s (엔티티 이동 처리 수), 이동당 전달 수, 이동당 enter+leave 수
+ *  세 방식 모두 같은 시드로 같은 궤적을 걷는다.
+ *
+ *  사용법:
+ *    aoi_bench.exe [-entities n] [-world m] [-speed m] [-duration sec]
+ *
+ *  옵션:
+ *    -entities n    엔티티 수 (기본 10000)
+ *    -world m       월드 한 변 (기본 2000m, 칸 크기는 AOI_CELL_SIZE)
+ *    -speed m       틱당 최대 이동 거리 (기본 3m)
+ *    -duration sec  방식마다 측정 시간 (기본 3초, 최소 1틱)
+ * ============================================
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "aoi_grid.h"
+
+#define OUTBOX_SIZE 4096        // 세션당 송신 버퍼 (링, 내용은 덮어씀)
+#define UPDATE_SIZE 16          // 위치 갱신 메시지 하나 (id, x, y, flags)
+#define NAIVE_RADIUS (AOI_CELL_SIZE * 1.5f)
+
+// 콘솔 색상
+void SetColor(int color) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+}
+
+#define COLOR_DEFAULT 7
+#define COLOR_GREEN 10
+#define COLOR_YELLOW 14
+#define COLOR_CYAN 11
+#define COLOR_RED 12
+
+enum AoiMode {
+    MODE_NAIVE_ALL,
+    MODE_NAIVE_RADIUS,
+    MODE_GRID
+};
+
+struct ModeInfo {
+    const char* name;
+    AoiMode mode;
+};
+
+struct AoiResult {
+    const char* mode;
+    int ticks;
+    double seconds;
+    double updatesPerSec;
+    double deliveriesPerUpdate;
+    double enterLeavePerUpdate;
+};
+
+// 세션 송신 버퍼: 실제 서버처럼 대상마다 메시지를 복사해 넣는다
+struct Outbox {
+    char data[OUTBOX_SIZE];
+    int offset;
+};
+
+struct Entity {
+    float x;
+    float y;
+    int handle;
+};
+
+static int g_entities = 10000;
+static float g_world = 2000.0f;
+static float g_speed = 3.0f;
+static double g_duration = 3.0;
+static LARGE_INTEGER g_qpcFreq;
+
+static std::vector<Outbox> g_outboxes;
+static long long g_deliveries = 0;
+static long long g_enterLeave = 0;
+
+double NowSec() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart / (double)g_qpcFreq.QuadPart;
+}
+
+// xorshift32: 방식마다 같은 시드로 다시 시작 → 같은 궤적
+static unsigned int g_rng = 1;
+
+float RandomFloat(float range) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return (g_rng & 0xFFFFFF) / (float)0x1000000 * range;
+}
+
+void Deliver(int target, const char* message) {
+    Outbox& box = g_outboxes[target];
+    if (box.offset + UPDATE_SIZE > OUTBOX_SIZE) box.offset = 0;
+    memcpy(box.data + box.offset, message, UPDATE_SIZE);
+    box.offset += UPDATE_SIZE;
+    g_deliveries++;
+}
+
+void MakeUpdate(char* message, int id, float x, float y, int flags) {
+    memcpy(message, &id, 4);
+    memcpy(message + 4, &x, 4);
+    memcpy(message + 8, &y, 4);
+    memcpy(message + 12, &flags, 4);
+}
+
+float Clamp(float v) {
+    if (v < 0) return 0;
+    if (v > g_world) return g_world;
+    return v;
+}
+
+AoiResult RunMode(const ModeInfo& info) {
+    AoiResult result = {};
+    result.mode = info.name;
+
+    g_rng = 12345;
+    g_deliveries = 0;
+    g_enterLeave = 0;
+    g_outboxes.assign(g_entities, Outbox());
+
+    AoiGrid grid;
+    AoiInit(grid, g_world, g_world, AOI_CELL_SIZE);
+    std::vector<int> enter;
+    std::vector<int> leave;
+
+    std::vector<Entity> entities(g_entities);
+    for (int i = 0; i < g_entities; i++) {
+        entities[i].x = RandomFloat(g_world);
+        entities[i].y = RandomFloat(g_world);
+        entities[i].handle = -1;
+        if (info.mode == MODE_GRID) {
+            entities[i].handle = AoiAdd(grid, entities[i].x, entities[i].y, enter);
+        }
+    }
+    // AoiAdd 는 0 부터 순서대로 핸들을 준다 → 핸들 == 엔티티 번호
+
+    char message[UPDATE_SIZE];
+    const float radiusSq = NAIVE_RADIUS * NAIVE_RADIUS;
+    double start = NowSec();
+    double elapsed = 0;
+
+    while (result.ticks == 0 || elapsed < g_duration) {
+        for (int i = 0; i < g_entities; i++) {
+            Entity& e = entities[i];
+            e.x = Clamp(e.x + RandomFloat(2 * g_speed) - g_speed);
+            e.y = Clamp(e.y + RandomFloat(2 * g_speed) - g_speed);
+            MakeUpdate(message, i, e.x, e.y, 0);
+
+            if (info.mode == MODE_NAIVE_ALL) {
+                for (int j = 0; j < g_entities; j++) {
+                    if (j != i) Deliver(j, message);
+                }
+            } else if (info.mode == MODE_NAIVE_RADIUS) {
+                for (int j = 0; j < g_entities; j++) {
+                    float dx = entities[j].x - e.x;
+                    float dy = entities[j].y - e.y;
+                    if (j != i && dx * dx + dy * dy <= radiusSq) Deliver(j, message);
+                }
+            } else {
+                AoiMove(grid, e.handle, e.x, e.y, enter, leave);
+                g_enterLeave += enter.size() + leave.size();
+
+                // 시야 변화는 양쪽에 (서버의 ENTER / LEAVE 와 같음)
+                char notice[UPDATE_SIZE];
+                for (int other : enter) {
+                    MakeUpdate(notice, other, entities[other].x, entities[other].y, 1);
+                    Deliver(i, notice);
+                    MakeUpdate(notice, i, e.x, e.y, 1);
+                    Deliver(other, notice);
+                }
+                for (int other : leave) {
+                    MakeUpdate(notice, other, 0, 0, 2);
+                    Deliver(i, notice);
+                    MakeUpdate(notice, i, 0, 0, 2);
+                    Deliver(other, notice);
+                }
+                AoiForEachNeighbor(grid, e.handle, [&](int other) { Deliver(other, message); });
+            }
+        }
+        result.ticks++;
+        elapsed = NowSec() - start;
+    }
+
+    long long updates = (long long)result.ticks * g_entities;
+    result.seconds = elapsed;
+    result.updatesPerSec = updates / elapsed;
+    result.deliveriesPerUpdate = g_deliveries / (double)updates;
+    result.enterLeavePerUpdate = g_enterLeave / (double)updates;
+    return result;
+}
+
+bool ParseArgs(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (strcmp(arg, "-entities") == 0) {
+            g_entities = atoi(value);
+        } else if (strcmp(arg, "-world") == 0) {
+            g_world = (float)atof(value);
+        } else if (strcmp(arg, "-speed") == 0) {
+            g_speed = (float)atof(value);
+        } else if (strcmp(arg, "-duration") == 0) {
+            g_duration = atof(value);
+        } else {
+            return false;
+        }
+    }
+
+    if (g_entities < 2) g_entities = 2;
+    if (g_world < AOI_CELL_SIZE) g_world = AOI_CELL_SIZE;
+    if (g_speed < 0) g_speed = 0;
+    if (g_duration <= 0) g_duration = 0.1;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+
+    if (!ParseArgs(argc, argv)) {
+        printf("사용법: aoi_bench.exe [-entities n] [-world m] [-speed m] [-duration sec]\n");
+        return 1;
+    }
+
+    QueryPerformanceFrequency(&g_qpcFreq);
+
+    int cells = (int)(g_world / AOI_CELL_SIZE) + 1;
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("  [AOI 벤치마크] Grid Interest Management vs Naive Fan-out\n");
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  엔티티: %d | 월드: %.0fm × %.0fm | 칸: %.0fm (%d × %d)\n",
+           g_entities, g_world, g_world, AOI_CELL_SIZE, cells, cells);
+    printf("  이동: 틱당 최대 %.1fm | 방식별 측정: %.1f초 | naive-radius 반경: %.0fm\n",
+           g_speed, g_duration, NAIVE_RADIUS);
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    const ModeInfo modes[] = {
+        { "naive-all",    MODE_NAIVE_ALL },
+        { "naive-radius", MODE_NAIVE_RADIUS },
+        { "grid",         MODE_GRID },
+    };
+
+    std::vector<AoiResult> results;
+    printf("  %-13s %7s %14s %12s %12s %9s\n",
+           "mode", "ticks", "updates/s", "deliv/upd", "enter+leave", "speedup");
+    printf("  ──────────────────────────────────────────────────────────────────────\n");
+
+    for (const ModeInfo& mode : modes) {
+        AoiResult r = RunMode(mode);
+        results.push_back(r);
+
+        double speedup = r.updatesPerSec / results[0].updatesPerSec;
+        SetColor(mode.mode == MODE_GRID ? COLOR_GREEN : COLOR_YELLOW);
+        printf("  %-13s %7d %14.0f %12.1f %12.3f %8.1fx\n",
+               r.mode, r.ticks, r.updatesPerSec, r.deliveriesPerUpdate, r.enterLeavePerUpdate, speedup);
+        SetColor(COLOR_DEFAULT);
+    }
+
+    FILE* fp = NULL;
+    bool written = (fopen_s(&fp, "aoi_report.csv", "w") == 0);
+    if (written) {
+        fprintf(fp, "mode,entities,world_m,cell_m,ticks,seconds,updates_per_sec,"
+                    "deliveries_per_update,enter_leave_per_update\n");
+        for (const AoiResult& r : results) {
+            fprintf(fp, "%s,%d,%.0f,%.0f,%d,%.3f,%.1f,%.3f,%.4f\n",
+                    r.mode, g_entities, g_world, AOI_CELL_SIZE, r.ticks, r.seconds,
+                    r.updatesPerSec, r.deliveriesPerUpdate, r.enterLeavePerUpdate);
+        }
+        fclose(fp);
+    }
+
+    printf("\n");
+    SetColor(written ? COLOR_GREEN : COLOR_RED);
+    printf(written ? "리포트 저장: aoi_report.csv\n" : "리포트 저장 실패\n");
+    SetColor(COLOR_DEFAULT);
+    return written ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/*
+ * ============================================
+ *  격자 기반 AOI (Area of Interest)
+ * ============================================
+ *  - 월드를 cellSize × cellSize 칸으로 나누고, 엔티티는 자기 칸에만 등록
+ *  - "관심 범위" = 자기 칸 + 주변 8칸 (3×3)
+ *    → 브로드캐스트는 이 9칸 안의 엔티티에게만 (전체 N명이 아니라)
+ *  - 이동해서 칸이 바뀔 때만 enter / leave 집합을 계산한다 (증분)
+ *      enter = 새 3×3 에는 있고 옛 3×3 에는 없던 칸의 엔티티
+ *      leave = 옛 3×3 에는 있고 새 3×3 에는 없는 칸의 엔티티
+ *    같은 칸 안에서 움직이면 집합 변화 없음 → O(1)
+ *  - 칸 안 목록은 swap-remove (엔티티가 자기 위치를 기억) → 삭제 O(1)
+ *  - 핸들은 AoiAdd 가 나눠주는 작은 정수 (재사용) → 서버는 핸들로 세션 배열을 찾는다
+ *
+ *  사용처: 04_iocp_server.cpp (-aoi), aoi_bench.cpp
+ * ============================================
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <vector>
+
+#define AOI_CELL_SIZE 50.0f   // 칸 한 변 (m), 관심 반경 ≈ 1~1.5칸
+
+struct AoiGrid {
+    float cellSize;
+    int cols;
+    int rows;
+    std::vector<std::vector<int>> cells;    // 칸마다 엔티티 핸들
+    std::vector<int> entityCell;            // 핸들 → 칸 (-1 = 빈 핸들)
+    std::vector<int> entitySlot;            // 핸들 → 칸 목록 안 위치
+    std::vector<float> entityX;
+    std::vector<float> entityY;
+    std::vector<int> freeHandles;
+};
+
+inline void AoiInit(AoiGrid& grid, float worldWidth, float worldHeight, float cellSize) {
+    grid.cellSize = cellSize;
+    grid.cols = (int)(worldWidth / cellSize) + 1;
+    grid.rows = (int)(worldHeight / cellSize) + 1;
+    grid.cells.assign(grid.cols * grid.rows, std::vector<int>());
+    grid.entityCell.clear();
+    grid.entitySlot.clear();
+    grid.entityX.clear();
+    grid.entityY.clear();
+    grid.freeHandles.clear();
+}
+
+// 월드 밖 좌표는 가장자리 칸으로
+inline int AoiCellOf(const AoiGrid& grid, float x, float y) {
+    int cx = (int)(x / grid.cellSize);
+    int cy = (int)(y / grid.cellSize);
+    if (cx < 0) cx = 0;
+    if (cy < 0) cy = 0;
+    if (cx >= grid.cols) cx = grid.cols - 1;
+    if (cy >= grid.rows) cy = grid.rows - 1;
+    return cy * grid.cols + cx;
+}
+
+inline void AoiCellInsert(AoiGrid& grid, int handle, int cell) {
+    grid.entityCell[handle] = cell;
+    grid.entitySlot[handle] = (int)grid.cells[cell].size();
+    grid.cells[cell].push_back(handle);
+}
+
+inline void AoiCellErase(AoiGrid& grid, int handle) {
+    std::vector<int>& list = grid.cells[grid.entityCell[handle]];
+    int slot = grid.entitySlot[handle];
+    int last = list.back();
+    list[slot] = last;
+    grid.entitySlot[last] = slot;
+    list.pop_back();
+}
+
+// center 칸의 3×3 중에서 exclude 칸의 3×3 에 들어가지 않는 칸의 엔티티를 out 에 추가
+// (exclude < 0 이면 3×3 전부)
+inline void AoiCollectRing(const AoiGrid& grid, int center, int exclude, int self, std::vector<int>& out) {
+    int cx = center % grid.cols;
+    int cy = center / grid.cols;
+    int ex = (exclude >= 0) ? exclude % grid.cols : -100;
+    int ey = (exclude >= 0) ? exclude / grid.cols : -100;
+
+    for (int y = cy - 1; y <= cy + 1; y++) {
+        if (y < 0 || y >= grid.rows) continue;
+        for (int x = cx - 1; x <= cx + 1; x++) {
+            if (x < 0 || x >= grid.cols) continue;
+            if (abs(x - ex) <= 1 && abs(y - ey) <= 1) continue;   // 옛/새 범위가 겹치는 칸
+            for (int other : grid.cells[y * grid.cols + x]) {
+                if (other != self) out.push_back(other);
+            }
+        }
+    }
+}
+
+// 새 엔티티 등록. enter = 처음부터 서로 보이는 엔티티들
+inline int AoiAdd(AoiGrid& grid, float x, float y, std::vector<int>& enter) {
+    int handle;
+    if (!grid.freeHandles.empty()) {
+        handle = grid.freeHandles.back();
+        grid.freeHandles.pop_back();
+    } else {
+        handle = (int)grid.entityCell.size();
+        grid.entityCell.push_back(-1);
+        grid.entitySlot.push_back(0);
+        grid.entityX.push_back(0);
+        grid.entityY.push_back(0);
+    }
+
+    int cell = AoiCellOf(grid, x, y);
+    grid.entityX[handle] = x;
+    grid.entityY[handle] = y;
+    enter.clear();
+    AoiCollectRing(grid, cell, -1, handle, enter);
+    AoiCellInsert(grid, handle, cell);
+    return handle;
+}
+
+// 이동. 칸이 바뀌었을 때만 enter / leave 가 채워진다
+inline void AoiMove(AoiGrid& grid, int handle, float x, float y,
+                    std::vector<int>& enter, std::vector<int>& leave) {
+    enter.clear();
+    leave.clear();
+    grid.entityX[handle] = x;
+    grid.entityY[handle] = y;
+
+    int oldCell = grid.entityCell[handle];
+    int newCell = AoiCellOf(grid, x, y);
+    if (oldCell == newCell) return;
+
+    AoiCollectRing(grid, newCell, oldCell, handle, enter);
+    AoiCollectRing(grid, oldCell, newCell, handle, leave);
+    AoiCellErase(grid, handle);
+    AoiCellInsert(grid, handle, newCell);
+}
+
+// 제거. leave = 이 엔티티를 보고 있던 엔티티들
+inline void AoiRemove(AoiGrid& grid, int handle, std::vector<int>& leave) {
+    leave.clear();
+    int cell = grid.entityCell[handle];
+    if (cell < 0) return;
+
+    AoiCollectRing(grid, cell, -1, handle, leave);
+    AoiCellErase(grid, handle);
+    grid.entityCell[handle] = -1;
+    grid.freeHandles.push_back(handle);
+}
+
+// 브로드캐스트 대상 순회: 3×3 칸 안의 자기 외 모든 엔티티
+template <typename Fn>
+inline void AoiForEachNeighbor(const AoiGrid& grid, int handle, Fn fn) {
+    int cell = grid.entityCell[handle];
+    int cx = cell % grid.cols;
+    int cy = cell / grid.cols;
+
+    for (int y = cy - 1; y <= cy + 1; y++) {
+        if (y < 0 || y >= grid.rows) continue;
+        for (int x = cx - 1; x <= cx + 1; x++) {
+            if (x < 0 || x >= grid.cols) continue;
+            for (int other : grid.cells[y * grid.cols + x]) {
+                if (other != handle) fn(other);
+            }
+        }
+    }
+}
@@ -0,0 +1,818 @@
+/*
+ * ============================================
+ *  소켓 모델 벤치마크 드라이버
+ * ============================================
+ *  서버를 손으로 띄우고 test_client 출력을 눈으로 보는 대신,
+ *  서버 모델을 하나씩 띄워서
+ *    동시접속 수 × 페이로드 크기
+ *  를 스윕하고 결과를 JSON/CSV 리포트 하나로 남긴다.
+ *
+ *  측정 항목 (측정점마다):
+ *  - 처리량 (req/sec), p50/p99/max 지연
+ *  - 서버 CPU 시간 (user/kernel)  : GetProcessTimes
+ *  - 서버 컨텍스트 스위치 횟수     : NtQuerySystemInformation (스레드별 합)
+ *  - 서버 Working Set / Private    : GetProcessMemoryInfo
+ *
+ *  부하 생성기: 논블로킹 소켓 + WSAPoll 스레드 LOAD_THREAD_COUNT개
+ *  → 동시접속 10,000도 클라이언트 스레드 10,000개 없이 만든다.
+ *  측정점마다 서버를 새로 띄워서 이전 과부하의 잔여물을 격리.
+ *
+ *  사용법:
+ *    bench_driver.exe [옵션...]
+ *
+ *  옵션:
+ *    -models list    sync,sync-pool,sync-pool1k,select,overlapped,
+ *                    iocp,iocp-admit,coroutine (기본 전체)
+ *    -conc list      동시접속 수 (기본 1,10,100,1000,10000)
+ *    -payload list   요청 크기 bytes (기본 16,256,1000)
+ *    -duration sec   측정 구간 길이 (기본 5, 앞 1초는 워밍업)
+ *    -timeout ms     요청 타임아웃 (기본 5000)
+ *    -rate rps       open-loop 모드: 응답과 상관없이 초당 rps개 요청 도착
+ *                    (기본 0 = closed-loop, -conc 는 최대 동시 요청 수가 됨)
+ *    -work ms        서버 작업 시간 (기본 0, 서버에 -work 로 전달)
+ *    -server-args s  서버에 추가로 넘길 인자 (예: "-admit")
+ *    -impair s       impair_proxy.exe 를 서버 앞에 띄우고 그쪽으로 부하 (예: "-delay 40")
+ *                    프록시 포트 = 서버 포트 + 100
+ *    -out name       리포트 파일 이름 (기본 bench_report → .json/.csv)
+ *
+ *  서버가 "BUSY"로 응답하면 rejected로 따로 센다 (지연 통계에서 제외).
+ *  select(FD_SETSIZE)와 overlapped(MAXIMUM_WAIT_OBJECTS)는 소켓 64개가
+ *  구조적 한계라, 그보다 큰 동시접속 점은 돌리지 않고 n/a로 남긴다
+ *  (돌리면 모델이 아니라 타임아웃 / 연결 오류를 재게 됨).
+ *
+ *  예:
+ *    bench_driver.exe -models select,iocp -conc 10,100 -payload 64
+ *    bench_driver.exe -models iocp,iocp-admit -work 20 -rate 400 -conc 10000
+ *      (Worker 4개 × 20ms = 200 req/s 용량에 2배 과부하)
+ *    bench_driver.exe -models iocp-admit -impair "-delay 40" -work 20 -rate 50 -conc 100
+ *      (단방향 40ms 망 지연 + 용량의 1/4 부하: busy 는 0 이어야 한다.
+ *       승인 제어가 망 지연까지 큐 대기로 재면 여기서 전부 BUSY 가 됨)
+ * ============================================
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <psapi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <process.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "bench_process.h"
+
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "psapi.lib")
+
+#define LOAD_THREAD_COUNT 4
+#define WARMUP_MS 1000
+#define IMPAIR_PORT_OFFSET 100   // -impair: 프록시는 서버 포트 + 100 에서 받는다 (build.bat 예시와 같음)
+#define MAX_PAYLOAD 1000   // 서버 recv 버퍼(1024)에 한 번에 들어가는 크기까지만
+
+// 콘솔 색상
+void SetColor(int color) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+}
+
+#define COLOR_DEFAULT 7
+#define COLOR_GREEN 10
+#define COLOR_YELLOW 14
+#define COLOR_CYAN 11
+#define COLOR_RED 12
+
+// 서버 모델 테이블
+struct ServerModel {
+    const char* name;
+    const char* exe;
+    int port;
+    const char* args;   // 모델 고유 인자
+    int maxConcurrency; // 모델이 구조적으로 받을 수 있는 최대 동시접속 (0 = 제한 없음)
+    const char* limit;  // 그 제한의 이유 (요약 출력용)
+};
+
+static const ServerModel g_models[] = {
+    { "sync",       "01_sync_server.exe",       9000, "", 0, NULL },
+    { "sync-pool",  "01_sync_server.exe",       9000, "-pool 64 -queue 256", 0, NULL },
+    { "sync-pool1k", "01_sync_server.exe",      9000, "-pool 1024 -queue 1024", 0, NULL },
+    // FD_SETSIZE(64) 중 하나는 리슨 소켓. 넘는 소켓은 FD_SET이 조용히 버립니다
+    { "select",     "02_select_server.exe",     9001, "", FD_SETSIZE - 1, "FD_SETSIZE" },
+    // WaitForMultipleObjects는 핸들 64개(MAXIMUM_WAIT_OBJECTS)까지만 기다립니다
+    { "overlapped", "03_overlapped_server.exe", 9002, "", MAXIMUM_WAIT_OBJECTS, "MAXIMUM_WAIT_OBJECTS" },
+    { "iocp",       "04_iocp_server.exe",       9003, "", 0, NULL },
+    { "iocp-admit", "04_iocp_server.exe",       9003, "-admit", 0, NULL },
+    { "coroutine",  "05_coroutine_server.exe",  9004, "", 0, NULL },
+};
+static const int g_modelCount = sizeof(g_models) / sizeof(g_models[0]);
+
+// 설정
+static std::vector<const ServerModel*> g_selectedModels;
+static std::vector<int> g_concurrencies;
+static std::vector<int> g_payloads;
+static int g_durationSec = 5;
+static int g_timeoutMs = 5000;
+static double g_rate = 0;
+static int g_workMs = 0;
+static std::string g_serverArgs;
+static std::string g_impairArgs;
+static std::string g_outName = "bench_report";
+
+// ============================================
+//  서버 프로세스 측정
+// ============================================
+
+// SYSTEM_PROCESS_INFORMATION / SYSTEM_THREAD_INFORMATION 전체 레이아웃
+// (winternl.h 공개 정의는 Reserved 필드로 가려져 있어서 직접 정의)
+struct NtThreadInfo {
+    LARGE_INTEGER KernelTime;
+    LARGE_INTEGER UserTime;
+    LARGE_INTEGER CreateTime;
+    ULONG WaitTime;
+    PVOID StartAddress;
+    HANDLE UniqueProcess;
+    HANDLE UniqueThread;
+    LONG Priority;
+    LONG BasePriority;
+    ULONG ContextSwitches;
+    ULONG ThreadState;
+    ULONG WaitReason;
+};
+
+struct NtProcessInfo {
+    ULONG NextEntryOffset;
+    ULONG NumberOfThreads;
+    LARGE_INTEGER WorkingSetPrivateSize;
+    ULONG HardFaultCount;
+    ULONG NumberOfThreadsHighWatermark;
+    ULONGLONG CycleTime;
+    LARGE_INTEGER CreateTime;
+    LARGE_INTEGER UserTime;
+    LARGE_INTEGER KernelTime;
+    USHORT ImageNameLength;
+    USHORT ImageNameMaximumLength;
+    PWSTR ImageNameBuffer;
+    LONG BasePriority;
+    HANDLE UniqueProcessId;
+    HANDLE InheritedFromUniqueProcessId;
+    ULONG HandleCount;
+    ULONG SessionId;
+    ULONG_PTR UniqueProcessKey;
+    SIZE_T PeakVirtualSize;
+    SIZE_T VirtualSize;
+    ULONG PageFaultCount;
+    SIZE_T PeakWorkingSetSize;
+    SIZE_T WorkingSetSize;
+    SIZE_T QuotaPeakPagedPoolUsage;
+    SIZE_T QuotaPagedPoolUsage;
+    SIZE_T QuotaPeakNonPagedPoolUsage;
+    SIZE_T QuotaNonPagedPoolUsage;
+    SIZE_T PagefileUsage;
+    SIZE_T PeakPagefileUsage;
+    SIZE_T PrivatePageCount;
+    LARGE_INTEGER ReadOperationCount;
+    LARGE_INTEGER WriteOperationCount;
+    LARGE_INTEGER OtherOperationCount;
+    LARGE_INTEGER ReadTransferCount;
+    LARGE_INTEGER WriteTransferCount;
+    LARGE_INTEGER OtherTransferCount;
+    // NtThreadInfo Threads[NumberOfThreads] 가 바로 뒤에 붙는다
+};
+
+typedef LONG (NTAPI* NtQuerySystemInformationFn)(ULONG, PVOID, ULONG, PULONG);
+#define SYSTEM_PROCESS_INFORMATION_CLASS 5
+#define STATUS_INFO_LENGTH_MISMATCH ((LONG)0xC0000004L)
+
+static NtQuerySystemInformationFn g_ntQuerySystemInformation = NULL;
+static std::vector<BYTE> g_ntBuffer;
+
+// 프로세스의 모든 스레드 컨텍스트 스위치 합
+ULONGLONG SampleContextSwitches(DWORD pid) {
+    if (g_ntQuerySystemInformation == NULL) return 0;
+
+    if (g_ntBuffer.empty()) g_ntBuffer.resize(1 << 20);
+    ULONG needed = 0;
+    LONG status;
+    while ((status = g_ntQuerySystemInformation(SYSTEM_PROCESS_INFORMATION_CLASS,
+                                                g_ntBuffer.data(), (ULONG)g_ntBuffer.size(),
+                                                &needed)) == STATUS_INFO_LENGTH_MISMATCH) {
+        g_ntBuffer.resize(needed + 64 * 1024);
+    }
+    if (status < 0) return 0;
+
+    BYTE* cursor = g_ntBuffer.data();
+    while (1) {
+        NtProcessInfo* proc = (NtProcessInfo*)cursor;
+        if ((DWORD)(ULONG_PTR)proc->UniqueProcessId == pid) {
+            NtThreadInfo* threads = (NtThreadInfo*)(proc + 1);
+            ULONGLONG total = 0;
+            for (ULONG i = 0; i < proc->NumberOfThreads; i++) {
+                total += threads[i].ContextSwitches;
+            }
+            return total;
+        }
+        if (proc->NextEntryOffset == 0) break;
+        cursor += proc->NextEntryOffset;
+    }
+    return 0;
+}
+
+struct ProcessSample {
+    ULONGLONG userUs;
+    ULONGLONG kernelUs;
+    ULONGLONG contextSwitches;
+    SIZE_T workingSet;
+    SIZE_T privateBytes;
+};
+
+ProcessSample SampleProcess(HANDLE process, DWORD pid) {
+    ProcessSample sample;
+    memset(&sample, 0, sizeof(sample));
+
+    SampleCpuUs(process, sample.userUs, sample.kernelUs);
+
+    PROCESS_MEMORY_COUNTERS_EX memory;
+    memset(&memory, 0, sizeof(memory));
+    if (GetProcessMemoryInfo(process, (PROCESS_MEMORY_COUNTERS*)&memory, sizeof(memory))) {
+        sample.workingSet = memory.WorkingSetSize;
+        sample.privateBytes = memory.PrivateUsage;
+    }
+
+    sample.contextSwitches = SampleContextSwitches(pid);
+    return sample;
+}
+
+// ============================================
+//  서버 실행 / 종료
+// ============================================
+
+bool LaunchServer(const ServerModel& model, PROCESS_INFORMATION& pi) {
+    char commandLine[512];
+    sprintf_s(commandLine, "%s -work %d %s %s",
+              model.exe, g_workMs, model.args, g_serverArgs.c_str());
+    return LaunchAndProbe(commandLine, model.port, pi);
+}
+
+// -impair: 서버 앞의 장애 프록시. 프록시를 거쳐 요청이 통하면 준비 완료
+bool LaunchProxy(const ServerModel& model, PROCESS_INFORMATION& pi) {
+    char commandLine[512];
+    sprintf_s(commandLine, "impair_proxy.exe %d %d %s",
+              model.port + IMPAIR_PORT_OFFSET, model.port, g_impairArgs.c_str());
+    return LaunchAndProbe(commandLine, model.port + IMPAIR_PORT_OFFSET, pi);
+}
+
+// ============================================
+//  부하 생성기
+// ============================================
+
+enum SlotState {
+    SLOT_IDLE,
+    SLOT_CONNECTING,
+    SLOT_SENDING,
+    SLOT_RECEIVING
+};
+
+// 동시접속 1개 = 슬롯 1개 (요청 → 응답 → 재연결 반복, closed-loop)
+struct Slot {
+    SOCKET sock;
+    SlotState state;
+    int sent;
+    int received;
+    bool busy;          // 서버가 BUSY로 거절
+    ULONGLONG startUs;
+};
+
+struct LoadThreadArgs {
+    int port;
+    int connections;
+    int payload;
+    double ratePerSec;
+    ULONGLONG measureStartUs;
+    ULONGLONG endUs;
+
+    // 결과
+    std::vector<ULONGLONG> latencies;
+    int errors;
+    int timeouts;
+    int rejected;
+};
+
+void CloseSlot(Slot& slot) {
+    // abortive close: 10,000 동시접속에서 클라이언트 쪽 TIME_WAIT로 포트 고갈 방지
+    linger lg = { 1, 0 };
+    setsockopt(slot.sock, SOL_SOCKET, SO_LINGER, (const char*)&lg, sizeof(lg));
+    closesocket(slot.sock);
+    slot.sock = INVALID_SOCKET;
+    slot.state = SLOT_IDLE;
+}
+
+bool StartRequest(Slot& slot, const sockaddr_in& serverAddr) {
+    slot.sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (slot.sock == INVALID_SOCKET) return false;
+
+    u_long mode = 1;
+    ioctlsocket(slot.sock, FIONBIO, &mode);
+    BOOL noDelay = TRUE;
+    setsockopt(slot.sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+    slot.sent = 0;
+    slot.received = 0;
+    slot.busy = false;
+    slot.startUs = NowUs();
+    if (connect(slot.sock, (const sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR &&
+        WSAGetLastError() != WSAEWOULDBLOCK) {
+        CloseSlot(slot);
+        return false;
+    }
+    slot.state = SLOT_CONNECTING;
+    return true;
+}
+
+unsigned int __stdcall LoadThread(void* arg) {
+    LoadThreadArgs* args = (LoadThreadArgs*)arg;
+
+    sockaddr_in serverAddr;
+    memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(args->port);
+    inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+
+    std::vector<char> payload(args->payload, 'x');
+    std::vector<Slot> slots(args->connections);
+    std::vector<WSAPOLLFD> fds(args->connections);
+    for (auto& slot : slots) {
+        slot.sock = INVALID_SOCKET;
+        slot.state = SLOT_IDLE;
+    }
+
+    ULONGLONG timeoutUs = (ULONGLONG)g_timeoutMs * 1000;
+    char recvBuffer[64];
+
+    // open-loop: 도착 간격마다 새 요청 (응답을 기다리지 않으므로 과부하가 실제로 쌓인다)
+    double arrivalGapUs = (args->ratePerSec > 0) ? 1000000.0 / args->ratePerSec : 0;
+    double nextArrivalUs = (double)NowUs();
+    size_t cursor = 0;
+
+    while (NowUs() < args->endUs) {
+        if (arrivalGapUs > 0) {
+            ULONGLONG now = NowUs();
+            while (nextArrivalUs <= (double)now) {
+                nextArrivalUs += arrivalGapUs;
+
+                size_t scanned = 0;
+                while (scanned < slots.size() && slots[cursor].state != SLOT_IDLE) {
+                    cursor = (cursor + 1) % slots.size();
+                    scanned++;
+                }
+                bool started = (scanned < slots.size()) && StartRequest(slots[cursor], serverAddr);
+                if (!started && now >= args->measureStartUs) args->errors++;  // 슬롯 부족 포함
+            }
+        } else {
+            // closed-loop: 빈 슬롯은 바로 다음 요청 시작
+            for (auto& slot : slots) {
+                if (slot.state == SLOT_IDLE && !StartRequest(slot, serverAddr)) {
+                    if (NowUs() >= args->measureStartUs) args->errors++;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < slots.size(); i++) {
+            fds[i].fd = slots[i].sock;
+            fds[i].revents = 0;
+            switch (slots[i].state) {
+            case SLOT_CONNECTING:
+            case SLOT_SENDING:   fds[i].events = POLLWRNORM; break;
+            case SLOT_RECEIVING: fds[i].events = POLLRDNORM; break;
+            default:             fds[i].fd = INVALID_SOCKET; fds[i].events = 0; break;  // 음수 fd는 무시됨
+            }
+        }
+
+        int pollTimeout = (arrivalGapUs > 0) ? 1 : 10;
+        if (WSAPoll(fds.data(), (ULONG)fds.size(), pollTimeout) == SOCKET_ERROR) {
+            Sleep(1);
+            continue;
+        }
+
+        ULONGLONG now = NowUs();
+        bool measuring = (now >= args->measureStartUs);
+
+        for (size_t i = 0; i < slots.size(); i++) {
+            Slot& slot = slots[i];
+            if (slot.state == SLOT_IDLE) continue;
+
+            short revents = fds[i].revents;
+            bool failed = false;
+            bool done = false;
+
+            if (revents & (POLLERR | POLLNVAL)) {
+                failed = true;
+            } else if (revents != 0) {
+                if (slot.state == SLOT_CONNECTING) {
+                    slot.state = SLOT_SENDING;
+                }
+                if (slot.state == SLOT_SENDING) {
+                    int sent = send(slot.sock, payload.data() + slot.sent,
+                                    args->payload - slot.sent, 0);
+                    if (sent == SOCKET_ERROR) {
+                        failed = (WSAGetLastError() != WSAEWOULDBLOCK);
+                    } else {
+                        slot.sent += sent;
+                        if (slot.sent == args->payload) slot.state = SLOT_RECEIVING;
+                    }
+                } else if (slot.state == SLOT_RECEIVING) {
+                    int received = recv(slot.sock, recvBuffer, sizeof(recvBuffer), 0);
+                    if (received > 0) {
+                        if (slot.received == 0) slot.busy = (recvBuffer[0] == 'B');
+                        slot.received += received;
+                        done = (slot.received >= 2);  // "OK" 또는 "BUSY"
+                    } else if (received == 0) {
+                        failed = true;  // 응답 없이 끊김 (거절/과부하)
+                    } else if (WSAGetLastError() != WSAEWOULDBLOCK) {
+                        failed = true;
+                    }
+                }
+            }
+
+            if (done) {
+                if (measuring && slot.busy) args->rejected++;
+                else if (measuring) args->latencies.push_back(now - slot.startUs);
+                CloseSlot(slot);
+            } else if (failed) {
+                if (measuring) args->errors++;
+                CloseSlot(slot);
+            } else if (now - slot.startUs > timeoutUs) {
+                if (measuring) args->timeouts++;
+                CloseSlot(slot);
+            }
+        }
+    }
+
+    for (auto& slot : slots) {
+        if (slot.state != SLOT_IDLE) CloseSlot(slot);
+    }
+    return 0;
+}
+
+// ============================================
+//  측정점 실행
+// ============================================
+
+struct BenchResult {
+    std::string model;
+    int concurrency;
+    int payload;
+    bool supported;         // false: 모델 한계를 넘는 동시접속이라 측정하지 않음 (n/a)
+    bool serverStarted;
+    size_t requests;
+    int errors;
+    int timeouts;
+    int rejected;
+    double seconds;
+    double throughput;
+    double p50Ms;
+    double p99Ms;
+    double maxMs;
+    double cpuUserMs;
+    double cpuKernelMs;
+    double cpuUsPerRequest;
+    ULONGLONG contextSwitches;
+    SIZE_T workingSetKB;
+    SIZE_T privateKB;
+};
+
+double PercentileMs(std::vector<ULONGLONG>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[index] / 1000.0;
+}
+
+BenchResult RunPoint(const ServerModel& model, int concurrency, int payload) {
+    BenchResult result;
+    result.model = model.name;
+    result.concurrency = concurrency;
+    result.payload = payload;
+    result.supported = (model.maxConcurrency == 0 || concurrency <= model.maxConcurrency);
+    result.serverStarted = false;
+    result.requests = 0;
+    result.errors = 0;
+    result.timeouts = 0;
+    result.rejected = 0;
+    result.seconds = 0;
+    result.throughput = 0;
+    result.p50Ms = result.p99Ms = result.maxMs = 0;
+    result.cpuUserMs = result.cpuKernelMs = result.cpuUsPerRequest = 0;
+    result.contextSwitches = 0;
+    result.workingSetKB = result.privateKB = 0;
+
+    // 한계를 넘는 점은 모델이 아니라 타임아웃 / 연결 오류를 재게 되므로 건너뜀
+    if (!result.supported) return result;
+
+    PROCESS_INFORMATION pi;
+    if (!LaunchServer(model, pi)) return result;
+
+    PROCESS_INFORMATION proxyPi;
+    int loadPort = model.port;
+    if (!g_impairArgs.empty()) {
+        if (!LaunchProxy(model, proxyPi)) {
+            StopServer(pi);
+            return result;
+        }
+        loadPort = model.port + IMPAIR_PORT_OFFSET;
+    }
+    result.serverStarted = true;
+
+    ULONGLONG startUs = NowUs();
+    ULONGLONG measureStartUs = startUs + WARMUP_MS * 1000ULL;
+    ULONGLONG endUs = measureStartUs + g_durationSec * 1000000ULL;
+
+    int threadCount = (concurrency < LOAD_THREAD_COUNT) ? concurrency : LOAD_THREAD_COUNT;
+    std::vector<LoadThreadArgs> args(threadCount);
+    std::vector<HANDLE> threads(threadCount);
+    for (int t = 0; t < threadCount; t++) {
+        args[t].port = loadPort;
+        args[t].connections = concurrency / threadCount + (t < concurrency % threadCount ? 1 : 0);
+        args[t].payload = payload;
+        args[t].ratePerSec = g_rate / threadCount;
+        args[t].measureStartUs = measureStartUs;
+        args[t].endUs = endUs;
+        args[t].errors = 0;
+        args[t].timeouts = 0;
+        args[t].rejected = 0;
+        threads[t] = (HANDLE)_beginthreadex(NULL, 0, LoadThread, &args[t], 0, NULL);
+    }
+
+    // 워밍업 끝난 시점과 측정 끝난 시점의 서버 카운터 차이
+    ULONGLONG now = NowUs();
+    if (measureStartUs > now) Sleep((DWORD)((measureStartUs - now) / 1000));
+    ProcessSample before = SampleProcess(pi.hProcess, pi.dwProcessId);
+
+    WaitForMultipleObjects((DWORD)threadCount, threads.data(), TRUE, INFINITE);
+    ProcessSample after = SampleProcess(pi.hProcess, pi.dwProcessId);
+    ULONGLONG measuredUs = NowUs() - measureStartUs;
+
+    if (!g_impairArgs.empty()) StopServer(proxyPi);
+    StopServer(pi);
+    for (auto thread : threads) CloseHandle(thread);
+
+    std::vector<ULONGLONG> latencies;
+    for (auto& a : args) {
+        latencies.insert(latencies.end(), a.latencies.begin(), a.latencies.end());
+        result.errors += a.errors;
+        result.timeouts += a.timeouts;
+        result.rejected += a.rejected;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    result.requests = latencies.size();
+    result.seconds = measuredUs / 1000000.0;
+    result.throughput = result.requests / result.seconds;
+    result.p50Ms = PercentileMs(latencies, 0.50);
+    result.p99Ms = PercentileMs(latencies, 0.99);
+    result.maxMs = latencies.empty() ? 0 : latencies.back() / 1000.0;
+    result.cpuUserMs = (after.userUs - before.userUs) / 1000.0;
+    result.cpuKernelMs = (after.kernelUs - before.kernelUs) / 1000.0;
+    result.cpuUsPerRequest = result.requests > 0
+        ? (result.cpuUserMs + result.cpuKernelMs) * 1000.0 / result.requests : 0;
+    result.contextSwitches = after.contextSwitches - before.contextSwitches;
+    result.workingSetKB = after.workingSet / 1024;
+    result.privateKB = after.privateBytes / 1024;
+    return result;
+}
+
+// ============================================
+//  리포트
+// ============================================
+
+bool WriteJson(const std::vector<BenchResult>& results, const char* path) {
+    FILE* fp = NULL;
+    if (fopen_s(&fp, path, "w") != 0) return false;
+
+    fprintf(fp, "{\n  \"duration_s\": %d,\n  \"work_ms\": %d,\n  \"rate_rps\": %.1f,\n  \"impair\": \"%s\",\n"
+                "  \"results\": [\n",
+            g_durationSec, g_workMs, g_rate, g_impairArgs.c_str());
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        if (!r.supported) {
+            fprintf(fp, "    {\"model\": \"%s\", \"concurrency\": %d, \"payload\": %d, \"supported\": false}%s\n",
+                    r.model.c_str(), r.concurrency, r.payload, (i + 1 < results.size()) ? "," : "");
+            continue;
+        }
+        fprintf(fp,
+                "    {\"model\": \"%s\", \"concurrency\": %d, \"payload\": %d, \"supported\": true, "
+                "\"server_started\": %s, \"requests\": %zu, \"errors\": %d, \"timeouts\": %d, \"rejected\": %d, "
+                "\"throughput_rps\": %.2f, \"p50_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f, "
+                "\"cpu_user_ms\": %.1f, \"cpu_kernel_ms\": %.1f, \"cpu_us_per_req\": %.2f, "
+                "\"context_switches\": %llu, \"working_set_kb\": %zu, \"private_kb\": %zu}%s\n",
+                r.model.c_str(), r.concurrency, r.payload,
+                r.serverStarted ? "true" : "false", r.requests, r.errors, r.timeouts, r.rejected,
+                r.throughput, r.p50Ms, r.p99Ms, r.maxMs,
+                r.cpuUserMs, r.cpuKernelMs, r.cpuUsPerRequest,
+                r.contextSwitches, r.workingSetKB, r.privateKB,
+                (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+    return true;
+}
+
+bool WriteCsv(const std::vector<BenchResult>& results, const char* path) {
+    FILE* fp = NULL;
+    if (fopen_s(&fp, path, "w") != 0) return false;
+
+    fprintf(fp, "model,concurrency,payload,server_started,requests,errors,timeouts,rejected,"
+                "throughput_rps,p50_ms,p99_ms,max_ms,cpu_user_ms,cpu_kernel_ms,"
+                "cpu_us_per_req,context_switches,working_set_kb,private_kb\n");
+    for (const BenchResult& r : results) {
+        if (!r.supported) {
+            fprintf(fp, "%s,%d,%d,n/a,n/a,n/a,n/a,n/a,n/a,n/a,n/a,n/a,n/a,n/a,n/a,n/a,n/a,n/a\n",
+                    r.model.c_str(), r.concurrency, r.payload);
+            continue;
+        }
+        fprintf(fp, "%s,%d,%d,%d,%zu,%d,%d,%d,%.2f,%.3f,%.3f,%.3f,%.1f,%.1f,%.2f,%llu,%zu,%zu\n",
+                r.model.c_str(), r.concurrency, r.payload, r.serverStarted ? 1 : 0,
+                r.requests, r.errors, r.timeouts, r.rejected,
+                r.throughput, r.p50Ms, r.p99Ms, r.maxMs,
+                r.cpuUserMs, r.cpuKernelMs, r.cpuUsPerRequest,
+                r.contextSwitches, r.workingSetKB, r.privateKB);
+    }
+    fclose(fp);
+    return true;
+}
+
+// ============================================
+//  인자 파싱
+// ============================================
+
+std::vector<int> ParseIntList(const char* text) {
+    std::vector<int> values;
+    const char* cursor = text;
+    while (*cursor) {
+        values.push_back(atoi(cursor));
+        const char* comma = strchr(cursor, ',');
+        if (comma == NULL) break;
+        cursor = comma + 1;
+    }
+    return values;
+}
+
+bool ParseModels(const char* text) {
+    g_selectedModels.clear();
+    std::string list = text;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        std::string name = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+
+        const ServerModel* found = NULL;
+        for (int i = 0; i < g_modelCount; i++) {
+            if (name == g_models[i].name) found = &g_models[i];
+        }
+        if (found == NULL) {
+            SetColor(COLOR_RED);
+            printf("알 수 없는 모델: %s\n", name.c_str());
+            SetColor(COLOR_DEFAULT);
+            return false;
+        }
+        g_selectedModels.push_back(found);
+
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    return true;
+}
+
+bool ParseArgs(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (strcmp(arg, "-models") == 0) {
+            if (!ParseModels(value)) return false;
+        } else if (strcmp(arg, "-conc") == 0) {
+            g_concurrencies = ParseIntList(value);
+        } else if (strcmp(arg, "-payload") == 0) {
+            g_payloads = ParseIntList(value);
+        } else if (strcmp(arg, "-duration") == 0) {
+            g_durationSec = atoi(value);
+        } else if (strcmp(arg, "-timeout") == 0) {
+            g_timeoutMs = atoi(value);
+        } else if (strcmp(arg, "-rate") == 0) {
+            g_rate = atof(value);
+        } else if (strcmp(arg, "-work") == 0) {
+            g_workMs = atoi(value);
+        } else if (strcmp(arg, "-server-args") == 0) {
+            g_serverArgs = value;
+        } else if (strcmp(arg, "-impair") == 0) {
+            g_impairArgs = value;
+        } else if (strcmp(arg, "-out") == 0) {
+            g_outName = value;
+        } else {
+            return false;
+        }
+    }
+
+    for (auto& concurrency : g_concurrencies) {
+        if (concurrency < 1) concurrency = 1;
+    }
+    for (auto& payload : g_payloads) {
+        if (payload < 1) payload = 1;
+        if (payload > MAX_PAYLOAD) payload = MAX_PAYLOAD;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+
+    for (int i = 0; i < g_modelCount; i++) g_selectedModels.push_back(&g_models[i]);
+    g_concurrencies = { 1, 10, 100, 1000, 10000 };
+    g_payloads = { 16, 256, 1000 };
+
+    if (!ParseArgs(argc, argv)) {
+        printf("사용법: bench_driver.exe [-models list] [-conc list] [-payload list] [-duration sec]\n");
+        printf("                         [-timeout ms] [-rate rps] [-work ms] [-server-args s] [-impair s]\n");
+        printf("                         [-out name]\n");
+        return 1;
+    }
+
+    g_ntQuerySystemInformation = (NtQuerySystemInformationFn)GetProcAddress(
+        GetModuleHandleA("ntdll.dll"), "NtQuerySystemInformation");
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("  [벤치마크 드라이버] Socket Model Benchmark\n");
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  모델: %zu개 | 동시접속: %zu단계 | 페이로드: %zu단계\n",
+           g_selectedModels.size(), g_concurrencies.size(), g_payloads.size());
+    printf("  측정 구간: %d초 (+워밍업 %d ms) | 서버 작업: %d ms\n",
+           g_durationSec, WARMUP_MS, g_workMs);
+    if (g_rate > 0) {
+        printf("  부하: open-loop %.0f req/s (최대 동시 요청 = -conc)\n", g_rate);
+    } else {
+        printf("  부하: closed-loop (동시접속마다 응답 후 다음 요청)\n");
+    }
+    if (!g_impairArgs.empty()) {
+        printf("  망 장애: impair_proxy %s (서버 포트 + %d 경유)\n", g_impairArgs.c_str(), IMPAIR_PORT_OFFSET);
+    }
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        SetColor(COLOR_RED);
+        printf("WSAStartup 실패\n");
+        return 1;
+    }
+
+    std::vector<BenchResult> results;
+    printf("  %-11s %6s %6s %10s %9s %9s %7s %7s %7s %9s\n",
+           "model", "conc", "bytes", "req/s", "p50(ms)", "p99(ms)", "busy", "err", "t/o", "ctxsw");
+    printf("  ─────────────────────────────────────────────────────────────────────────────\n");
+
+    for (const ServerModel* model : g_selectedModels) {
+        for (int concurrency : g_concurrencies) {
+            for (int payload : g_payloads) {
+                BenchResult r = RunPoint(*model, concurrency, payload);
+                results.push_back(r);
+
+                if (!r.supported) {
+                    printf("  %-11s %6d %6d %10s  (최대 동시접속 %d: %s)\n",
+                           r.model.c_str(), concurrency, payload, "n/a", model->maxConcurrency, model->limit);
+                    continue;
+                }
+                if (!r.serverStarted) {
+                    SetColor(COLOR_RED);
+                    printf("  %-11s %6d %6d  서버 실행 실패 (%s)\n",
+                           r.model.c_str(), concurrency, payload, model->exe);
+                    SetColor(COLOR_DEFAULT);
+                    continue;
+                }
+
+                SetColor((r.errors + r.timeouts) > 0 ? COLOR_YELLOW : COLOR_GREEN);
+                printf("  %-11s %6d %6d %10.1f %9.2f %9.2f %7d %7d %7d %9llu\n",
+                       r.model.c_str(), concurrency, payload, r.throughput,
+                       r.p50Ms, r.p99Ms, r.rejected, r.errors, r.timeouts, r.contextSwitches);
+                SetColor(COLOR_DEFAULT);
+            }
+        }
+    }
+
+    std::string jsonPath = g_outName + ".json";
+    std::string csvPath = g_outName + ".csv";
+    bool written = WriteJson(results, jsonPath.c_str()) && WriteCsv(results, csvPath.c_str());
+
+    printf("\n");
+    SetColor(written ? COLOR_GREEN : COLOR_RED);
+    if (written) {
+        printf("리포트 저장: %s, %s\n", jsonPath.c_str(), csvPath.c_str());
+    } else {
+        printf("리포트 저장 실패\n");
+    }
+    SetColor(COLOR_DEFAULT);
+
+    WSACleanup();
+    return written ? 0 : 1;
+}
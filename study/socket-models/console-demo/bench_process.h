@@ -0,0 +1,170 @@
+/*
+ * ============================================
+ *  벤치마크 공통: 서버 프로세스 실행 / 준비 확인 / 종료 + 시간·CPU 측정
+ * ============================================
+ *  - 서버는 콘솔 출력을 NUL 로 돌려서 띄운다
+ *      (콘솔 렌더링 / 연결마다 찍는 로그 비용이 측정을 덮지 않도록)
+ *  - 준비 확인 = 프로세스가 살아 있는 동안 probe 가 통할 때까지 100ms 간격으로 재시도
+ *      ProbeServer  : 실제 요청("probe")을 보내고 응답이 오면 준비 완료
+ *                     (빈 연결로 찔러보면 select/overlapped 서버에 유령 클라이언트가 남는다)
+ *      ProbeConnect : 연결만 확인 (TLS / AOI 처럼 평문 한 줄에 답하지 않는 서버용)
+ *  - 준비가 안 되면 프로세스를 끝내고 핸들까지 정리한 뒤 false
+ *
+ *  각 벤치는 서버 명령줄만 만들고 여기 LaunchAndProbe 에 넘긴다.
+ *  NowSec / NowUs 는 처음 부를 때 QPC 주파수를 한 번 읽어 둔다.
+ *
+ *  사용처: bench_driver, tls_bench, busypoll_bench, file_bench, soak_bench, handoff_bench
+ * ============================================
+ */
+
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <string.h>
+
+#ifndef SERVER_READY_TIMEOUT_MS
+#define SERVER_READY_TIMEOUT_MS 10000
+#endif
+#define SERVER_PROBE_TIMEOUT_MS 2000
+
+// ============================================
+//  시간
+// ============================================
+
+inline LONGLONG QpcFrequency() {
+    static LARGE_INTEGER freq = { 0 };
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);   // 값이 늘 같으므로 경합해도 무방
+    return freq.QuadPart;
+}
+
+inline double NowSec() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / QpcFrequency();
+}
+
+inline ULONGLONG NowUs() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (ULONGLONG)(now.QuadPart * 1000000.0 / QpcFrequency());
+}
+
+// ============================================
+//  CPU 시간
+// ============================================
+
+inline ULONGLONG FileTimeToUs(const FILETIME& ft) {
+    ULARGE_INTEGER value;
+    value.LowPart = ft.dwLowDateTime;
+    value.HighPart = ft.dwHighDateTime;
+    return value.QuadPart / 10;  // 100ns 단위 → us
+}
+
+inline void SampleCpuUs(HANDLE process, ULONGLONG& userUs, ULONGLONG& kernelUs) {
+    FILETIME creation, exitTime, kernel, user;
+    userUs = kernelUs = 0;
+    if (!GetProcessTimes(process, &creation, &exitTime, &kernel, &user)) return;
+    userUs = FileTimeToUs(user);
+    kernelUs = FileTimeToUs(kernel);
+}
+
+// user + kernel
+inline ULONGLONG SampleCpuUs(HANDLE process) {
+    ULONGLONG userUs, kernelUs;
+    SampleCpuUs(process, userUs, kernelUs);
+    return userUs + kernelUs;
+}
+
+// ============================================
+//  준비 확인
+// ============================================
+
+typedef bool (*ServerProbe)(int port);
+
+inline bool ConnectLoopback(SOCKET sock, int port) {
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((u_short)port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    return connect(sock, (sockaddr*)&addr, sizeof(addr)) != SOCKET_ERROR;
+}
+
+inline bool ProbeServer(int port) {
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) return false;
+
+    DWORD recvTimeout = SERVER_PROBE_TIMEOUT_MS;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&recvTimeout, sizeof(recvTimeout));
+
+    bool ok = false;
+    if (ConnectLoopback(sock, port)) {
+        const char* probe = "probe";
+        char reply[16];
+        if (send(sock, probe, (int)strlen(probe), 0) != SOCKET_ERROR) {
+            ok = recv(sock, reply, sizeof(reply), 0) > 0;
+        }
+    }
+    closesocket(sock);
+    return ok;
+}
+
+inline bool ProbeConnect(int port) {
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) return false;
+
+    bool connected = ConnectLoopback(sock, port);
+    closesocket(sock);
+    return connected;
+}
+
+// ============================================
+//  실행 / 종료
+// ============================================
+
+// 띄우기만 한다 (준비 확인 없음)
+inline bool SpawnServer(char* commandLine, PROCESS_INFORMATION& pi) {
+    SECURITY_ATTRIBUTES sa = { sizeof(sa), NULL, TRUE };
+    HANDLE nul = CreateFileA("NUL", GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                             &sa, OPEN_EXISTING, 0, NULL);
+
+    STARTUPINFOA si;
+    memset(&si, 0, sizeof(si));
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdOutput = nul;
+    si.hStdError = nul;
+
+    BOOL created = CreateProcessA(NULL, commandLine, NULL, NULL, TRUE,
+                                  CREATE_NO_WINDOW, NULL, NULL, &si, &pi);
+    CloseHandle(nul);
+    return created != FALSE;
+}
+
+inline void StopServer(PROCESS_INFORMATION& pi) {
+    TerminateProcess(pi.hProcess, 0);
+    WaitForSingleObject(pi.hProcess, INFINITE);
+    CloseHandle(pi.hProcess);
+    CloseHandle(pi.hThread);
+}
+
+// 프로세스를 띄우고 probePort 로 probe 가 통할 때까지 기다린다
+inline bool LaunchAndProbe(char* commandLine, int probePort, PROCESS_INFORMATION& pi,
+                           ServerProbe probe = ProbeServer) {
+    if (!SpawnServer(commandLine, pi)) return false;
+
+    ULONGLONG deadline = GetTickCount64() + SERVER_READY_TIMEOUT_MS;
+    while (GetTickCount64() < deadline) {
+        if (WaitForSingleObject(pi.hProcess, 0) == WAIT_OBJECT_0) break;  // 서버가 바로 죽음
+        if (probe(probePort)) return true;
+        Sleep(100);
+    }
+
+    StopServer(pi);
+    return false;
+}
@@ -0,0 +1,66 @@
+/*
+ * ============================================
+ *  수신 버퍼 풀 (연결 상태에서 버퍼 떼어내기)
+ * ============================================
+ *  - 연결 구조체에 버퍼를 박아 두면 아무것도 안 하는 연결도 버퍼 크기만큼 먹는다
+ *      1KB × 100만 연결 = 1GB 가 놀고 있다
+ *  - 연결은 작은 상태(소켓, id, 파이프라인 위치 ...)와 char* 하나만 갖고,
+ *    실제로 읽을 때만 풀에서 버퍼를 빌렸다가 처리가 끝나면 돌려준다
+ *  - 풀은 돌려받은 버퍼를 해제하지 않고 다시 빌려준다
+ *      → 풀 크기 = 동시에 읽고 있는 연결 수의 최대치 (전체 연결 수와 무관)
+ *  - 잘린 요청 조각을 들고 있는 연결(파이프라인)은 다음 recv 까지 버퍼를 쥐고 있는다
+ *
+ *  사용처: 02_select_server.cpp, 04_iocp_server.cpp (soak_bench.cpp 로 연결당 메모리 측정)
+ * ============================================
+ */
+
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <vector>
+
+struct BufferPool {
+    CRITICAL_SECTION cs;
+    int bufferSize;
+    std::vector<char*> free;    // 돌려받은 버퍼 (LIFO → 방금 쓴, 캐시에 남은 버퍼부터)
+    int allocated;              // 지금까지 만든 버퍼 수 (= 풀 전체 크기)
+    int borrowed;               // 지금 빌려 간 수
+    int peakBorrowed;
+};
+
+inline void BufferPoolInit(BufferPool& pool, int bufferSize) {
+    InitializeCriticalSection(&pool.cs);
+    pool.bufferSize = bufferSize;
+    pool.allocated = 0;
+    pool.borrowed = 0;
+    pool.peakBorrowed = 0;
+}
+
+inline char* BufferPoolBorrow(BufferPool& pool) {
+    char* buffer = NULL;
+    EnterCriticalSection(&pool.cs);
+    if (!pool.free.empty()) {
+        buffer = pool.free.back();
+        pool.free.pop_back();
+    } else {
+        pool.allocated++;
+    }
+    pool.borrowed++;
+    if (pool.borrowed > pool.peakBorrowed) pool.peakBorrowed = pool.borrowed;
+    LeaveCriticalSection(&pool.cs);
+
+    // 할당은 락 밖에서
+    if (buffer == NULL) buffer = new char[pool.bufferSize];
+    return buffer;
+}
+
+inline void BufferPoolReturn(BufferPool& pool, char* buffer) {
+    if (buffer == NULL) return;
+    EnterCriticalSection(&pool.cs);
+    pool.free.push_back(buffer);
+    pool.borrowed--;
+    LeaveCriticalSection(&pool.cs);
+}
@@ -13,15 +13,15 @@ if exist "C:\Program Files\Microsoft Visual Studio\2022\Community\VC\Auxiliary\B
     call "C:\Program Files (x86)\Microsoft Visual Studio\2019\Community\VC\Auxiliary\Build\vcvars64.bat" > nul 2>&1
 )
 
-echo [1/5] 동기 서버 빌드중...
-cl /EHsc /Fe:01_sync_server.exe 01_sync_server.cpp ws2_32.lib /nologo > nul 2>&1
+echo [1/16] 동기 서버 빌드중...
+cl /EHsc /Fe:01_sync_server.exe 01_sync_server.cpp ws2_32.lib mswsock.lib /nologo > nul 2>&1
 if %ERRORLEVEL% EQU 0 (
     echo       ✓ 01_sync_server.exe 빌드 완료
 ) else (
     echo       ✗ 빌드 실패
 )
 
-echo [2/5] Select 서버 빌드중...
+echo [2/16] Select 서버 빌드중...
 cl /EHsc /Fe:02_select_server.exe 02_select_server.cpp ws2_32.lib /nologo > nul 2>&1
 if %ERRORLEVEL% EQU 0 (
     echo       ✓ 02_select_server.exe 빌드 완료
@@ -29,7 +29,7 @@ if %ERRORLEVEL% EQU 0 (
     echo       ✗ 빌드 실패
 )
 
-echo [3/5] Overlapped 서버 빌드중...
+echo [3/16] Overlapped 서버 빌드중...
 cl /EHsc /Fe:03_overlapped_server.exe 03_overlapped_server.cpp ws2_32.lib /nologo > nul 2>&1
 if %ERRORLEVEL% EQU 0 (
     echo       ✓ 03_overlapped_server.exe 빌드 완료
@@ -37,15 +37,23 @@ if %ERRORLEVEL% EQU 0 (
     echo       ✗ 빌드 실패
 )
 
-echo [4/5] IOCP 서버 빌드중...
-cl /EHsc /Fe:04_iocp_server.exe 04_iocp_server.cpp ws2_32.lib /nologo > nul 2>&1
+echo [4/16] IOCP 서버 빌드중...
+cl /EHsc /Fe:04_iocp_server.exe 04_iocp_server.cpp ws2_32.lib mswsock.lib secur32.lib crypt32.lib /nologo > nul 2>&1
 if %ERRORLEVEL% EQU 0 (
     echo       ✓ 04_iocp_server.exe 빌드 완료
 ) else (
     echo       ✗ 빌드 실패
 )
 
-echo [5/5] 테스트 클라이언트 빌드중...
+echo [5/16] 코루틴 서버 빌드중...
+cl /std:c++20 /EHsc /Fe:05_coroutine_server.exe 05_coroutine_server.cpp ws2_32.lib /nologo > nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    echo       ✓ 05_coroutine_server.exe 빌드 완료
+) else (
+    echo       ✗ 빌드 실패
+)
+
+echo [6/16] 테스트 클라이언트 빌드중...
 cl /EHsc /Fe:test_client.exe test_client.cpp ws2_32.lib /nologo > nul 2>&1
 if %ERRORLEVEL% EQU 0 (
     echo       ✓ test_client.exe 빌드 완료
@@ -53,6 +61,86 @@ if %ERRORLEVEL% EQU 0 (
     echo       ✗ 빌드 실패
 )
 
+echo [7/16] 장애 프록시 빌드중...
+cl /EHsc /Fe:impair_proxy.exe impair_proxy.cpp ws2_32.lib winmm.lib /nologo > nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    echo       ✓ impair_proxy.exe 빌드 완료
+) else (
+    echo       ✗ 빌드 실패
+)
+
+echo [8/16] 벤치마크 드라이버 빌드중...
+cl /EHsc /O2 /Fe:bench_driver.exe bench_driver.cpp ws2_32.lib psapi.lib /nologo > nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    echo       ✓ bench_driver.exe 빌드 완료
+) else (
+    echo       ✗ 빌드 실패
+)
+
+echo [9/16] TLS 벤치마크 빌드중...
+cl /EHsc /O2 /Fe:tls_bench.exe tls_bench.cpp ws2_32.lib secur32.lib crypt32.lib /nologo > nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    echo       ✓ tls_bench.exe 빌드 완료
+) else (
+    echo       ✗ 빌드 실패
+)
+
+echo [10/16] 핸드오프 벤치마크 빌드중...
+cl /EHsc /O2 /Fe:handoff_bench.exe handoff_bench.cpp ws2_32.lib /nologo > nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    echo       ✓ handoff_bench.exe 빌드 완료
+) else (
+    echo       ✗ 빌드 실패
+)
+
+echo [11/16] 공유 메모리 벤치마크 빌드중...
+cl /EHsc /O2 /Fe:shm_bench.exe shm_bench.cpp ws2_32.lib /nologo > nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    echo       ✓ shm_bench.exe 빌드 완료
+) else (
+    echo       ✗ 빌드 실패
+)
+
+echo [12/16] AOI 벤치마크 빌드중...
+cl /EHsc /O2 /Fe:aoi_bench.exe aoi_bench.cpp /nologo > nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    echo       ✓ aoi_bench.exe 빌드 완료
+) else (
+    echo       ✗ 빌드 실패
+)
+
+echo [13/16] 델타 압축 벤치마크 빌드중...
+cl /EHsc /O2 /Fe:delta_bench.exe delta_bench.cpp /nologo > nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    echo       ✓ delta_bench.exe 빌드 완료
+) else (
+    echo       ✗ 빌드 실패
+)
+
+echo [14/16] 바쁜 폴링 벤치마크 빌드중...
+cl /EHsc /O2 /Fe:busypoll_bench.exe busypoll_bench.cpp ws2_32.lib /nologo > nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    echo       ✓ busypoll_bench.exe 빌드 완료
+) else (
+    echo       ✗ 빌드 실패
+)
+
+echo [15/16] 파일 전송 벤치마크 빌드중...
+cl /EHsc /O2 /Fe:file_bench.exe file_bench.cpp ws2_32.lib /nologo > nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    echo       ✓ file_bench.exe 빌드 완료
+) else (
+    echo       ✗ 빌드 실패
+)
+
+echo [16/16] 소크 테스트 빌드중...
+cl /EHsc /O2 /Fe:soak_bench.exe soak_bench.cpp ws2_32.lib psapi.lib /nologo > nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    echo       ✓ soak_bench.exe 빌드 완료
+) else (
+    echo       ✗ 빌드 실패
+)
+
 REM 임시 파일 정리
 del *.obj > nul 2>&1
 
@@ -64,13 +152,59 @@ echo.
 echo   사용법:
 echo     1. 서버 실행 (터미널 1)
 echo        ^> 01_sync_server.exe       (포트 9000)
+echo        ^> 01_sync_server.exe -pool 64 -queue 256  (스레드 풀 모드)
 echo        ^> 02_select_server.exe     (포트 9001)
 echo        ^> 03_overlapped_server.exe (포트 9002)
 echo        ^> 04_iocp_server.exe       (포트 9003)
+echo        ^> 05_coroutine_server.exe  (포트 9004)
 echo.
 echo     2. 클라이언트 실행 (터미널 2)
-echo        ^> test_client.exe [포트] [클라이언트수]
+echo        ^> test_client.exe [포트] [클라이언트수] [-pipeline n] [-requests m]
 echo        ^> test_client.exe 9000 5   (동기 서버 테스트)
 echo        ^> test_client.exe 9003 5   (IOCP 서버 테스트)
 echo.
+echo     3. WAN 조건 테스트 (장애 프록시 경유)
+echo        ^> impair_proxy.exe 9103 9003 -delay 40 -jitter 5 -loss 1
+echo        ^> test_client.exe 9103 5
+echo.
+echo     4. 전체 모델 벤치마크 (bench_report.json / .csv 생성)
+echo        ^> bench_driver.exe -conc 1,10,100 -payload 16,256
+echo        ^> bench_driver.exe -models iocp,iocp-admit -work 20 -rate 400 -conc 10000
+echo        ^> bench_driver.exe -models iocp-admit -impair "-delay 40" -work 20 -rate 50 -conc 100   (망 지연에도 busy 0)
+echo        ^> bench_driver.exe -models iocp,coroutine -work 0   (콜백 vs 코루틴)
+echo        ^> bench_driver.exe -models sync-pool,sync-pool1k,select,iocp -work 10 -payload 16
+echo.
+echo     5. TLS 비용 측정 (평문 vs Schannel, tls_report.csv 생성)
+echo        ^> tls_bench.exe -threads 4 -duration 5 -bulk 256
+echo.
+echo     6. 무중단 재시작 (실행 중인 Select 서버의 소켓을 새 프로세스가 인수)
+echo        ^> 02_select_server.exe -takeover
+echo        ^> handoff_bench.exe -threads 8 -duration 8 -at 3   (handoff_report.csv)
+echo.
+echo     7. 공유 메모리 전송 vs loopback TCP (shm_report.csv)
+echo        ^> shm_bench.exe -count 100000 -size 64
+echo.
+echo     8. 관심 영역(AOI) 브로드캐스트 (aoi_report.csv)
+echo        ^> aoi_bench.exe -entities 10000 -world 2000
+echo        ^> 04_iocp_server.exe -aoi   (MOVE x y / CHAT text / SYNC ack, 연결 유지)
+echo.
+echo     9. 스냅샷 델타 + LZ4 송신 압축 (delta_report.csv)
+echo        ^> delta_bench.exe -sessions 200 -entities 64 -lag 3 -loss 2
+echo.
+echo     10. 바쁜 폴링 저지연 모드: 지연 p99 vs CPU (busypoll_report.csv)
+echo        ^> 04_iocp_server.exe -busy-poll 100   (Worker 코어 고정 + 100us 스핀)
+echo        ^> busypoll_bench.exe -budgets 0,20,100,500 -think 200
+echo.
+echo     11. 요청 파이프라이닝 (연결 유지, 요청 여러 개 → 응답 묶음 send)
+echo        ^> 04_iocp_server.exe -work 0
+echo        ^> test_client.exe 9003 4 -pipeline 16 -requests 1000
+echo.
+echo     12. 파일 전송: TransmitFile vs ReadFile + send (file_report.csv)
+echo        ^> file_bench.exe -size 512 -clients 2 -repeat 4
+echo        ^> 04_iocp_server.exe -files C:\patches   (FILE 이름 [offset] [length])
+echo.
+echo     13. 유휴 연결 소크: 100만 연결 × 연결당 RSS (soak_report.csv)
+echo        ^> soak_bench.exe -conns 1000000 -ips 64 -active 1000 -seconds 30
+echo        ^> 04_iocp_server.exe -eager-buffer   (연결마다 버퍼, 분리 전 방식과 비교)
+echo.
 pause
@@ -9,7 +9,7 @@ echo.
 echo [빌드 시작]
 echo.
 
-cl /EHsc /Fe:01_sync_server.exe 01_sync_server.cpp ws2_32.lib /nologo
+cl /EHsc /Fe:01_sync_server.exe 01_sync_server.cpp ws2_32.lib mswsock.lib /nologo
 if %ERRORLEVEL% EQU 0 (echo [OK] 01_sync_server.exe) else (echo [FAIL] 01_sync_server)
 
 cl /EHsc /Fe:02_select_server.exe 02_select_server.cpp ws2_32.lib /nologo
@@ -18,12 +18,45 @@ if %ERRORLEVEL% EQU 0 (echo [OK] 02_select_server.exe) else (echo [FAIL] 02_sele
 cl /EHsc /Fe:03_overlapped_server.exe 03_overlapped_server.cpp ws2_32.lib /nologo
 if %ERRORLEVEL% EQU 0 (echo [OK] 03_overlapped_server.exe) else (echo [FAIL] 03_overlapped_server)
 
-cl /EHsc /Fe:04_iocp_server.exe 04_iocp_server.cpp ws2_32.lib /nologo
+cl /EHsc /Fe:04_iocp_server.exe 04_iocp_server.cpp ws2_32.lib mswsock.lib secur32.lib crypt32.lib /nologo
 if %ERRORLEVEL% EQU 0 (echo [OK] 04_iocp_server.exe) else (echo [FAIL] 04_iocp_server)
 
+cl /std:c++20 /EHsc /Fe:05_coroutine_server.exe 05_coroutine_server.cpp ws2_32.lib /nologo
+if %ERRORLEVEL% EQU 0 (echo [OK] 05_coroutine_server.exe) else (echo [FAIL] 05_coroutine_server)
+
 cl /EHsc /Fe:test_client.exe test_client.cpp ws2_32.lib /nologo
 if %ERRORLEVEL% EQU 0 (echo [OK] test_client.exe) else (echo [FAIL] test_client)
 
+cl /EHsc /Fe:impair_proxy.exe impair_proxy.cpp ws2_32.lib winmm.lib /nologo
+if %ERRORLEVEL% EQU 0 (echo [OK] impair_proxy.exe) else (echo [FAIL] impair_proxy)
+
+cl /EHsc /O2 /Fe:bench_driver.exe bench_driver.cpp ws2_32.lib psapi.lib /nologo
+if %ERRORLEVEL% EQU 0 (echo [OK] bench_driver.exe) else (echo [FAIL] bench_driver)
+
+cl /EHsc /O2 /Fe:tls_bench.exe tls_bench.cpp ws2_32.lib secur32.lib crypt32.lib /nologo
+if %ERRORLEVEL% EQU 0 (echo [OK] tls_bench.exe) else (echo [FAIL] tls_bench)
+
+cl /EHsc /O2 /Fe:handoff_bench.exe handoff_bench.cpp ws2_32.lib /nologo
+if %ERRORLEVEL% EQU 0 (echo [OK] handoff_bench.exe) else (echo [FAIL] handoff_bench)
+
+cl /EHsc /O2 /Fe:shm_bench.exe shm_bench.cpp ws2_32.lib /nologo
+if %ERRORLEVEL% EQU 0 (echo [OK] shm_bench.exe) else (echo [FAIL] shm_bench)
+
+cl /EHsc /O2 /Fe:aoi_bench.exe aoi_bench.cpp /nologo
+if %ERRORLEVEL% EQU 0 (echo [OK] aoi_bench.exe) else (echo [FAIL] aoi_bench)
+
+cl /EHsc /O2 /Fe:delta_bench.exe delta_bench.cpp /nologo
+if %ERRORLEVEL% EQU 0 (echo [OK] delta_bench.exe) else (echo [FAIL] delta_bench)
+
+cl /EHsc /O2 /Fe:busypoll_bench.exe busypoll_bench.cpp ws2_32.lib /nologo
+if %ERRORLEVEL% EQU 0 (echo [OK] busypoll_bench.exe) else (echo [FAIL] busypoll_bench)
+
+cl /EHsc /O2 /Fe:file_bench.exe file_bench.cpp ws2_32.lib /nologo
+if %ERRORLEVEL% EQU 0 (echo [OK] file_bench.exe) else (echo [FAIL] file_bench)
+
+cl /EHsc /O2 /Fe:soak_bench.exe soak_bench.cpp ws2_32.lib psapi.lib /nologo
+if %ERRORLEVEL% EQU 0 (echo [OK] soak_bench.exe) else (echo [FAIL] soak_bench)
+
 del *.obj 2>nul
 
 echo.
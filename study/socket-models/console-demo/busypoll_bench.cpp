@@ -0,0 +1,415 @@
+/*
+ * ============================================
+ *  바쁜 폴링(busy-poll) 벤치마크: 지연 p99 vs CPU 소모
+ * ============================================
+ *  서버를 -busy-poll <budget> 으로 budget 마다 다시 띄우고
+ *  적은 수의 클라이언트가 요청 사이에 think 시간을 두며 보낸다.
+ *  (요청이 드문드문 와야 서버 스레드가 잠들고 → 깨우기 비용이 지연에 드러남)
+ *
+ *  budget 이 think 간격보다 짧으면 스핀은 헛돌고 결국 잠든다 (CPU만 더 씀),
+ *  길면 잠들지 않고 받는다 (지연 ↓, 대신 코어 하나가 계속 돈다).
+ *
+ *  모델:
+ *    select     02_select_server  (연결마다 요청 하나)
+ *    iocp       04_iocp_server    (연결마다 요청 하나)
+ *    iocp-aoi   04_iocp_server -aoi (연결 유지, "MOVE x y" 왕복 → 순수 완료 대기 지연)
+ *
+ *  측정: p50 / p99 / p99.9 지연, req/s,
+ *        서버 CPU (GetProcessTimes 증가분 / 경과 시간 = 평균 사용 코어 수)
+ *  Linux 의 SO_BUSY_POLL (드라이버 큐 직접 폴링) 에 해당하는 소켓 옵션은 Windows 에 없다.
+ *  여기서의 바쁜 폴링은 완료 큐 / select 를 timeout 0 으로 도는 사용자 공간 스핀이다.
+ *
+ *  사용법:
+ *    busypoll_bench.exe [-models list] [-budgets list] [-threads n] [-think us] [-duration sec]
+ *
+ *  옵션:
+ *    -models list    select,iocp,iocp-aoi (기본 전부)
+ *    -budgets list   스핀 budget us 목록 (기본 0,20,100,500, 0 = 끔)
+ *    -threads n      클라이언트 스레드 수 (기본 2)
+ *    -think us       요청 사이 간격 (기본 200, 클라이언트 쪽 스핀 대기)
+ *    -duration sec   조합마다 측정 시간 (기본 5)
+ * ============================================
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <process.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "bench_process.h"
+
+#pragma comment(lib, "ws2_32.lib")
+
+#define REQUEST_TIMEOUT_MS 3000
+
+// 콘솔 색상
+void SetColor(int color) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+}
+
+#define COLOR_DEFAULT 7
+#define COLOR_GREEN 10
+#define COLOR_YELLOW 14
+#define COLOR_CYAN 11
+#define COLOR_RED 12
+
+struct PollModel {
+    const char* name;
+    const char* exe;
+    int port;
+    const char* extraArgs;
+    bool persistent;        // 연결 하나로 계속 왕복 (-aoi)
+};
+
+static const PollModel g_models[] = {
+    { "select",   "02_select_server.exe", 9001, "",     false },
+    { "iocp",     "04_iocp_server.exe",   9003, "",     false },
+    { "iocp-aoi", "04_iocp_server.exe",   9003, "-aoi", true },
+};
+static const int g_modelCount = sizeof(g_models) / sizeof(g_models[0]);
+
+// 옵션
+static std::vector<const PollModel*> g_selectedModels;
+static std::vector<int> g_budgets = { 0, 20, 100, 500 };
+static int g_threadCount = 2;
+static int g_thinkUs = 200;
+static int g_durationSec = 5;
+
+// ============================================
+//  서버 프로세스
+// ============================================
+
+SOCKET ConnectServer(int port) {
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) return INVALID_SOCKET;
+
+    DWORD timeout = REQUEST_TIMEOUT_MS;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+    BOOL noDelay = TRUE;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((u_short)port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    if (connect(sock, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) {
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    return sock;
+}
+
+bool LaunchServer(const PollModel& model, int budgetUs, PROCESS_INFORMATION& pi) {
+    char commandLine[256];
+    sprintf_s(commandLine, "%s -work 0 -busy-poll %d %s", model.exe, budgetUs, model.extraArgs);
+    return LaunchAndProbe(commandLine, model.port, pi, ProbeConnect);
+}
+
+// ============================================
+//  클라이언트
+// ============================================
+
+struct ClientArgs {
+    const PollModel* model;
+    int index;
+    ULONGLONG endUs;
+    std::vector<ULONGLONG> latencies;
+    int errors;
+};
+
+// 연결 → "PING" → "OK" → 종료
+bool RequestPerConnection(int port) {
+    SOCKET sock = ConnectServer(port);
+    if (sock == INVALID_SOCKET) return false;
+
+    const char* request = "PING";
+    char response[16];
+    bool ok = false;
+    if (send(sock, request, (int)strlen(request), 0) > 0) {
+        int received = recv(sock, response, sizeof(response), 0);
+        ok = (received >= 2 && response[0] == 'O');
+    }
+    closesocket(sock);
+    return ok;
+}
+
+// 유지된 연결에서 "MOVE x y" → "OK e l\n" 한 줄
+bool RequestMove(SOCKET sock, const char* request) {
+    if (send(sock, request, (int)strlen(request), 0) <= 0) return false;
+
+    char response[64];
+    int total = 0;
+    while (total < (int)sizeof(response)) {
+        int received = recv(sock, response + total, sizeof(response) - total, 0);
+        if (received <= 0) return false;
+        total += received;
+        if (response[total - 1] == '\n') break;
+    }
+    return total >= 2 && response[0] == 'O';
+}
+
+// think 간격은 스핀으로 기다린다 (Sleep 은 ms 단위라 us 간격을 못 만든다)
+void Think(ULONGLONG fromUs) {
+    while (NowUs() - fromUs < (ULONGLONG)g_thinkUs) YieldProcessor();
+}
+
+unsigned int __stdcall ClientThread(void* arg) {
+    ClientArgs* args = (ClientArgs*)arg;
+    const PollModel& model = *args->model;
+
+    // -aoi: 스레드마다 서로 이웃이 아닌 칸에 세워 다른 스레드의 MOVE 가 섞이지 않게
+    SOCKET sock = INVALID_SOCKET;
+    char moveRequest[64];
+    if (model.persistent) {
+        sock = ConnectServer(model.port);
+        if (sock == INVALID_SOCKET) {
+            args->errors++;
+            return 0;
+        }
+        sprintf_s(moveRequest, "MOVE %d %d\n", 25 + (args->index % 9) * 200, 25 + (args->index / 9) * 200);
+    }
+
+    while (NowUs() < args->endUs) {
+        ULONGLONG start = NowUs();
+        bool ok = model.persistent ? RequestMove(sock, moveRequest) : RequestPerConnection(model.port);
+        ULONGLONG end = NowUs();
+
+        if (ok) {
+            args->latencies.push_back(end - start);
+        } else {
+            args->errors++;
+            if (model.persistent) break;
+        }
+        Think(end);
+    }
+
+    if (sock != INVALID_SOCKET) closesocket(sock);
+    return 0;
+}
+
+// ============================================
+//  측정
+// ============================================
+
+struct PollResult {
+    std::string model;
+    int budgetUs;
+    bool serverStarted;
+    int requests;
+    int errors;
+    double requestsPerSec;
+    double p50Us;
+    double p99Us;
+    double p999Us;
+    double serverCores;     // 서버 CPU 시간 / 경과 시간
+};
+
+double PercentileUs(const std::vector<ULONGLONG>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return (double)sorted[index];
+}
+
+PollResult RunOne(const PollModel& model, int budgetUs) {
+    PollResult result;
+    result.model = model.name;
+    result.budgetUs = budgetUs;
+    result.serverStarted = false;
+    result.requests = 0;
+    result.errors = 0;
+    result.requestsPerSec = 0;
+    result.p50Us = 0;
+    result.p99Us = 0;
+    result.p999Us = 0;
+    result.serverCores = 0;
+
+    PROCESS_INFORMATION pi;
+    if (!LaunchServer(model, budgetUs, pi)) return result;
+    result.serverStarted = true;
+
+    std::vector<ClientArgs> args(g_threadCount);
+    std::vector<HANDLE> threads(g_threadCount);
+    ULONGLONG startUs = NowUs();
+    ULONGLONG cpuBefore = SampleCpuUs(pi.hProcess);
+    for (int t = 0; t < g_threadCount; t++) {
+        args[t].model = &model;
+        args[t].index = t;
+        args[t].endUs = startUs + g_durationSec * 1000000ULL;
+        args[t].errors = 0;
+        threads[t] = (HANDLE)_beginthreadex(NULL, 0, ClientThread, &args[t], 0, NULL);
+    }
+    WaitForMultipleObjects((DWORD)threads.size(), threads.data(), TRUE, INFINITE);
+    ULONGLONG elapsedUs = NowUs() - startUs;
+    ULONGLONG cpuAfter = SampleCpuUs(pi.hProcess);
+    StopServer(pi);
+
+    std::vector<ULONGLONG> latencies;
+    for (int t = 0; t < g_threadCount; t++) {
+        CloseHandle(threads[t]);
+        latencies.insert(latencies.end(), args[t].latencies.begin(), args[t].latencies.end());
+        result.errors += args[t].errors;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    result.requests = (int)latencies.size();
+    result.requestsPerSec = result.requests / (elapsedUs / 1000000.0);
+    result.p50Us = PercentileUs(latencies, 0.50);
+    result.p99Us = PercentileUs(latencies, 0.99);
+    result.p999Us = PercentileUs(latencies, 0.999);
+    result.serverCores = (double)(cpuAfter - cpuBefore) / elapsedUs;
+    return result;
+}
+
+bool WriteCsv(const std::vector<PollResult>& results, const char* path) {
+    FILE* fp = NULL;
+    if (fopen_s(&fp, path, "w") != 0) return false;
+
+    fprintf(fp, "model,budget_us,server_started,threads,think_us,requests,errors,req_per_sec,"
+                "p50_us,p99_us,p999_us,server_cpu_cores\n");
+    for (const PollResult& r : results) {
+        fprintf(fp, "%s,%d,%d,%d,%d,%d,%d,%.1f,%.1f,%.1f,%.1f,%.3f\n",
+                r.model.c_str(), r.budgetUs, r.serverStarted ? 1 : 0, g_threadCount, g_thinkUs,
+                r.requests, r.errors, r.requestsPerSec, r.p50Us, r.p99Us, r.p999Us, r.serverCores);
+    }
+    fclose(fp);
+    return true;
+}
+
+std::vector<int> ParseIntList(const char* text) {
+    std::vector<int> values;
+    const char* cursor = text;
+    while (*cursor) {
+        values.push_back(atoi(cursor));
+        const char* comma = strchr(cursor, ',');
+        if (comma == NULL) break;
+        cursor = comma + 1;
+    }
+    return values;
+}
+
+bool ParseModels(const char* text) {
+    g_selectedModels.clear();
+    std::string list = text;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        std::string name = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+
+        const PollModel* found = NULL;
+        for (int i = 0; i < g_modelCount; i++) {
+            if (name == g_models[i].name) found = &g_models[i];
+        }
+        if (found == NULL) {
+            SetColor(COLOR_RED);
+            printf("알 수 없는 모델: %s\n", name.c_str());
+            SetColor(COLOR_DEFAULT);
+            return false;
+        }
+        g_selectedModels.push_back(found);
+
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    return true;
+}
+
+bool ParseArgs(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (strcmp(arg, "-models") == 0) {
+            if (!ParseModels(value)) return false;
+        } else if (strcmp(arg, "-budgets") == 0) {
+            g_budgets = ParseIntList(value);
+        } else if (strcmp(arg, "-threads") == 0) {
+            g_threadCount = atoi(value);
+        } else if (strcmp(arg, "-think") == 0) {
+            g_thinkUs = atoi(value);
+        } else if (strcmp(arg, "-duration") == 0) {
+            g_durationSec = atoi(value);
+        } else {
+            return false;
+        }
+    }
+
+    for (auto& budget : g_budgets) {
+        if (budget < 0) budget = 0;
+    }
+    if (g_threadCount < 1) g_threadCount = 1;
+    if (g_thinkUs < 0) g_thinkUs = 0;
+    if (g_durationSec < 1) g_durationSec = 1;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+
+    for (int i = 0; i < g_modelCount; i++) g_selectedModels.push_back(&g_models[i]);
+    if (!ParseArgs(argc, argv)) {
+        printf("사용법: busypoll_bench.exe [-models list] [-budgets list] [-threads n] [-think us] [-duration sec]\n");
+        return 1;
+    }
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("  [바쁜 폴링 벤치마크] Latency p99 vs CPU Burn\n");
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  클라이언트: %d 스레드, 요청 사이 %d us | 조합마다 %d초\n",
+           g_threadCount, g_thinkUs, g_durationSec);
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        SetColor(COLOR_RED);
+        printf("WSAStartup 실패\n");
+        return 1;
+    }
+
+    std::vector<PollResult> results;
+    printf("  %-9s %8s %10s %10s %10s %10s %10s\n",
+           "model", "budget", "req/s", "p50(us)", "p99(us)", "p99.9(us)", "cpu(core)");
+    printf("  ─────────────────────────────────────────────────────────────────────\n");
+
+    for (const PollModel* model : g_selectedModels) {
+        for (int budget : g_budgets) {
+            PollResult r = RunOne(*model, budget);
+            results.push_back(r);
+
+            if (!r.serverStarted) {
+                SetColor(COLOR_RED);
+                printf("  %-9s %8d  서버 실행 실패 (%s)\n", r.model.c_str(), budget, model->exe);
+                SetColor(COLOR_DEFAULT);
+                continue;
+            }
+
+            SetColor(r.errors > 0 ? COLOR_YELLOW : COLOR_GREEN);
+            printf("  %-9s %8d %10.0f %10.1f %10.1f %10.1f %10.2f",
+                   r.model.c_str(), budget, r.requestsPerSec, r.p50Us, r.p99Us, r.p999Us, r.serverCores);
+            if (r.errors > 0) printf(" (실패 %d)", r.errors);
+            printf("\n");
+            SetColor(COLOR_DEFAULT);
+        }
+    }
+
+    bool written = WriteCsv(results, "busypoll_report.csv");
+
+    printf("\n");
+    SetColor(written ? COLOR_GREEN : COLOR_RED);
+    printf(written ? "리포트 저장: busypoll_report.csv\n" : "리포트 저장 실패\n");
+    SetColor(COLOR_DEFAULT);
+
+    WSACleanup();
+    return written ? 0 : 1;
+}
@@ -0,0 +1,323 @@
+/*
+ * ============================================
+ *  스냅샷 델타 + LZ4 송신 압축 벤치마크
+ * ============================================
+ *  가상의 엔티티 갱신 부하: 세션마다 주변 엔티티 E개의 상태(32바이트 레코드)를
+ *  매 틱 스냅샷으로 보낸다. 틱마다 일부만 움직이고(좌표 cm 단위 소폭 변화),
+ *  나머지 필드(id, 체력, 상태)는 거의 그대로다.
+ *
+ *  ack 는 -lag 틱 뒤에 도착하고, -loss % 의 패킷은 유실(디코드도 ack 도 없음)
+ *  → 기준 스냅샷은 보통 몇 틱 전 것
+ *
+ *  방식 (packet_codec.h 의 단계 조합):
+ *    raw         원본 그대로 (헤더만)
+ *    lz4         원본을 LZ4 로만
+ *    delta       XOR + varint
+ *    delta+lz4   XOR + varint 후 이득이 있으면 LZ4 (서버 기본)
+ *
+ *  측정: 메시지당 바이트(헤더 포함), raw 대비 비율,
+ *        메시지당 인코드/디코드 시간 (Worker 하나 = CodecWorkspace 하나)
+ *  모든 패킷을 디코드해서 원본과 비교 → 불일치 수도 출력
+ *
+ *  사용법:
+ *    delta_bench.exe [-sessions n] [-entities n] [-ticks n] [-move %] [-lag ticks] [-loss %]
+ *
+ *  옵션:
+ *    -sessions n   세션 수 (기본 200)
+ *    -entities n   세션당 보이는 엔티티 수 (기본 64)
+ *    -ticks n      틱 수 (기본 300)
+ *    -move %       틱마다 움직이는 엔티티 비율 (기본 30)
+ *    -lag ticks    ack 가 돌아오기까지 틱 수 (기본 3)
+ *    -loss %       패킷 유실률 (기본 2)
+ * ============================================
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include "packet_codec.h"
+
+// 콘솔 색상
+void SetColor(int color) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+}
+
+#define COLOR_DEFAULT 7
+#define COLOR_GREEN 10
+#define COLOR_YELLOW 14
+#define COLOR_CYAN 11
+#define COLOR_RED 12
+
+// 엔티티 상태 레코드 (32바이트)
+struct EntityState {
+    int32_t id;
+    int32_t xCm;
+    int32_t yCm;
+    int32_t zCm;
+    uint16_t yaw;
+    uint16_t hp;
+    uint32_t flags;
+    uint32_t animation;
+    uint32_t equipment;
+};
+
+struct ModeInfo {
+    const char* name;
+    int stages;         // CODEC_USE_*, 0 = raw
+};
+
+struct DeltaResult {
+    const char* mode;
+    long long messages;
+    long long rawBytes;
+    long long wireBytes;
+    long long fullSnapshots;    // 기준 없이 보낸 수
+    long long lz4Used;
+    long long mismatches;
+    double encodeNsPerMessage;
+    double decodeNsPerMessage;
+};
+
+struct PendingAck {
+    int tick;
+    uint32_t seq;
+};
+
+static int g_sessions = 200;
+static int g_entities = 64;
+static int g_ticks = 300;
+static int g_movePercent = 30;
+static int g_lag = 3;
+static int g_lossPercent = 2;
+static LARGE_INTEGER g_qpcFreq;
+
+// xorshift32: 방식마다 같은 시드 → 같은 부하
+static uint32_t g_rng = 1;
+
+uint32_t Random() {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+int RandomRange(int lo, int hi) {
+    return lo + (int)(Random() % (uint32_t)(hi - lo + 1));
+}
+
+double TicksToNs(LONGLONG ticks) {
+    return ticks * 1000000000.0 / g_qpcFreq.QuadPart;
+}
+
+void InitWorld(std::vector<EntityState>& world, int session) {
+    for (int i = 0; i < g_entities; i++) {
+        EntityState& e = world[i];
+        e.id = session * 1000 + i;
+        e.xCm = RandomRange(0, 200000);
+        e.yCm = RandomRange(0, 200000);
+        e.zCm = RandomRange(0, 2000);
+        e.yaw = (uint16_t)Random();
+        e.hp = 1000;
+        e.flags = 0x11;
+        e.animation = 3;
+        e.equipment = 0x00A0B0C0 + (i % 4);
+    }
+}
+
+void StepWorld(std::vector<EntityState>& world) {
+    for (int i = 0; i < g_entities; i++) {
+        if (RandomRange(0, 99) >= g_movePercent) continue;
+
+        EntityState& e = world[i];
+        e.xCm += RandomRange(-30, 30);
+        e.yCm += RandomRange(-30, 30);
+        e.yaw = (uint16_t)(e.yaw + RandomRange(-200, 200));
+        if (RandomRange(0, 99) < 5) e.animation = RandomRange(0, 7);
+        if (RandomRange(0, 99) < 2) e.hp = (uint16_t)RandomRange(0, 1000);
+    }
+}
+
+DeltaResult RunMode(const ModeInfo& info) {
+    DeltaResult result = {};
+    result.mode = info.name;
+    g_rng = 20240601;
+
+    // Worker 하나가 모든 세션을 인코드 (작업 공간 하나를 재사용)
+    CodecWorkspace* encoder = new CodecWorkspace();
+    CodecWorkspace* decoder = new CodecWorkspace();
+    CodecWorkspaceInit(*encoder);
+    CodecWorkspaceInit(*decoder);
+
+    std::vector<std::vector<EntityState>> worlds(g_sessions, std::vector<EntityState>(g_entities));
+    std::vector<CodecSession> senders(g_sessions);
+    std::vector<CodecSession> receivers(g_sessions);
+    std::vector<std::vector<PendingAck>> acks(g_sessions);
+    for (int s = 0; s < g_sessions; s++) {
+        InitWorld(worlds[s], s);
+        CodecSessionInit(senders[s]);
+        CodecSessionInit(receivers[s]);
+    }
+
+    std::vector<uint8_t> decoded;
+    int snapshotLen = g_entities * (int)sizeof(EntityState);
+    LONGLONG encodeTicks = 0;
+    LONGLONG decodeTicks = 0;
+
+    for (int tick = 0; tick < g_ticks; tick++) {
+        for (int s = 0; s < g_sessions; s++) {
+            StepWorld(worlds[s]);
+
+            // 이번 틱까지 도착한 ack 반영
+            std::vector<PendingAck>& pending = acks[s];
+            size_t kept = 0;
+            for (size_t k = 0; k < pending.size(); k++) {
+                if (pending[k].tick <= tick) CodecAck(senders[s], pending[k].seq);
+                else pending[kept++] = pending[k];
+            }
+            pending.resize(kept);
+
+            const uint8_t* snapshot = (const uint8_t*)worlds[s].data();
+            LARGE_INTEGER t0;
+            LARGE_INTEGER t1;
+            LARGE_INTEGER t2;
+
+            QueryPerformanceCounter(&t0);
+            int packetLen = CodecEncode(*encoder, senders[s], snapshot, snapshotLen, info.stages);
+            QueryPerformanceCounter(&t1);
+            encodeTicks += t1.QuadPart - t0.QuadPart;
+
+            const uint8_t* packet = encoder->packet.data();
+            result.messages++;
+            result.rawBytes += snapshotLen;
+            result.wireBytes += packetLen;
+            if (packet[4] == 0 && packet[5] == 0 && packet[6] == 0 && packet[7] == 0) result.fullSnapshots++;
+            if (packet[10] & CODEC_FLAG_LZ4) result.lz4Used++;
+
+            if (RandomRange(0, 99) < g_lossPercent) continue;
+
+            QueryPerformanceCounter(&t1);
+            uint32_t seq = CodecDecode(*decoder, receivers[s], packet, packetLen, decoded);
+            QueryPerformanceCounter(&t2);
+            decodeTicks += t2.QuadPart - t1.QuadPart;
+
+            if (seq == 0 || memcmp(decoded.data(), snapshot, snapshotLen) != 0) {
+                result.mismatches++;
+                continue;
+            }
+            PendingAck ack = { tick + g_lag, seq };
+            pending.push_back(ack);
+        }
+    }
+
+    result.encodeNsPerMessage = TicksToNs(encodeTicks) / result.messages;
+    result.decodeNsPerMessage = TicksToNs(decodeTicks) / result.messages;
+    delete encoder;
+    delete decoder;
+    return result;
+}
+
+bool ParseArgs(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (strcmp(arg, "-sessions") == 0) {
+            g_sessions = atoi(value);
+        } else if (strcmp(arg, "-entities") == 0) {
+            g_entities = atoi(value);
+        } else if (strcmp(arg, "-ticks") == 0) {
+            g_ticks = atoi(value);
+        } else if (strcmp(arg, "-move") == 0) {
+            g_movePercent = atoi(value);
+        } else if (strcmp(arg, "-lag") == 0) {
+            g_lag = atoi(value);
+        } else if (strcmp(arg, "-loss") == 0) {
+            g_lossPercent = atoi(value);
+        } else {
+            return false;
+        }
+    }
+
+    int maxEntities = CODEC_MAX_SNAPSHOT / (int)sizeof(EntityState);
+    if (g_sessions < 1) g_sessions = 1;
+    if (g_entities < 1) g_entities = 1;
+    if (g_entities > maxEntities) g_entities = maxEntities;
+    if (g_ticks < 1) g_ticks = 1;
+    if (g_lag < 0) g_lag = 0;
+    if (g_lag >= CODEC_HISTORY) g_lag = CODEC_HISTORY - 1;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+
+    if (!ParseArgs(argc, argv)) {
+        printf("사용법: delta_bench.exe [-sessions n] [-entities n] [-ticks n] [-move %%] [-lag ticks] [-loss %%]\n");
+        return 1;
+    }
+
+    QueryPerformanceFrequency(&g_qpcFreq);
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("  [델타 압축 벤치마크] Snapshot Delta (XOR/varint) + LZ4\n");
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  세션: %d × 엔티티 %d (%d bytes/스냅샷) × %d틱\n",
+           g_sessions, g_entities, g_entities * (int)sizeof(EntityState), g_ticks);
+    printf("  이동: %d%%/틱 | ack 지연: %d틱 | 유실: %d%%\n", g_movePercent, g_lag, g_lossPercent);
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    const ModeInfo modes[] = {
+        { "raw",       0 },
+        { "lz4",       CODEC_USE_LZ4 },
+        { "delta",     CODEC_USE_DELTA },
+        { "delta+lz4", CODEC_USE_DELTA | CODEC_USE_LZ4 },
+    };
+
+    std::vector<DeltaResult> results;
+    printf("  %-10s %10s %8s %10s %10s %8s %8s\n",
+           "mode", "bytes/msg", "ratio", "enc ns", "dec ns", "lz4%", "errors");
+    printf("  ──────────────────────────────────────────────────────────────────────\n");
+
+    for (const ModeInfo& mode : modes) {
+        DeltaResult r = RunMode(mode);
+        results.push_back(r);
+
+        double bytesPerMessage = r.wireBytes / (double)r.messages;
+        double ratio = r.wireBytes / (double)results[0].wireBytes;
+        SetColor(r.mismatches > 0 ? COLOR_RED : (mode.stages == 0 ? COLOR_YELLOW : COLOR_GREEN));
+        printf("  %-10s %10.1f %8.3f %10.0f %10.0f %7.1f%% %8lld\n",
+               r.mode, bytesPerMessage, ratio, r.encodeNsPerMessage, r.decodeNsPerMessage,
+               r.lz4Used * 100.0 / r.messages, r.mismatches);
+        SetColor(COLOR_DEFAULT);
+    }
+
+    FILE* fp = NULL;
+    bool written = (fopen_s(&fp, "delta_report.csv", "w") == 0);
+    if (written) {
+        fprintf(fp, "mode,sessions,entities,ticks,move_pct,lag_ticks,loss_pct,messages,raw_bytes,"
+                    "wire_bytes,bytes_per_msg,full_snapshots,lz4_used,encode_ns_per_msg,"
+                    "decode_ns_per_msg,mismatches\n");
+        for (const DeltaResult& r : results) {
+            fprintf(fp, "%s,%d,%d,%d,%d,%d,%d,%lld,%lld,%lld,%.2f,%lld,%lld,%.1f,%.1f,%lld\n",
+                    r.mode, g_sessions, g_entities, g_ticks, g_movePercent, g_lag, g_lossPercent,
+                    r.messages, r.rawBytes, r.wireBytes, r.wireBytes / (double)r.messages,
+                    r.fullSnapshots, r.lz4Used, r.encodeNsPerMessage, r.decodeNsPerMessage,
+                    r.mismatches);
+        }
+        fclose(fp);
+    }
+
+    printf("\n");
+    SetColor(written ? COLOR_GREEN : COLOR_RED);
+    printf(written ? "리포트 저장: delta_report.csv\n" : "리포트 저장 실패\n");
+    SetColor(COLOR_DEFAULT);
+    return written ? 0 : 1;
+}
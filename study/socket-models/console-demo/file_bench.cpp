@@ -0,0 +1,465 @@
+/*
+ * ============================================
+ *  파일 전송 벤치마크: TransmitFile vs ReadFile + send
+ * ============================================
+ *  테스트 파일(file_bench.dat)을 만들고 서버를 -files . 로 띄운 뒤
+ *  같은 파일을 두 경로로 받아서 비교한다 (file_transfer.h).
+ *    transmit   "FILE ..."      커널이 파일 캐시 → 소켓 (사용자 공간 복사 없음)
+ *    copy       "FILECOPY ..."  청크마다 ReadFile(커널 → 사용자) + send(사용자 → 커널)
+ *
+ *  모델:
+ *    iocp       04_iocp_server  (Worker 4개)
+ *    sync-pool  01_sync_server -pool 8
+ *
+ *  측정 (조합마다):
+ *  - GB/s       : 클라이언트 n개가 파일 전체를 repeat 번씩 받는 동안의 합계
+ *  - 서버 CPU   : GetProcessTimes 증가분을 user / kernel 로 나눠서 ms/GB
+ *                 (복사 경로는 user 시간과 kernel 복사 시간이 같이 는다)
+ *  - 범위 요청  : 임의의 offset/length 로 받은 내용을 파일 패턴과 대조 (ok / 실패 수)
+ *  측정 전에 파일을 한 번 받아서 파일 캐시를 데워 둔다 (디스크가 아니라 복사 비용을 잰다).
+ *
+ *  Linux sendfile/splice 는 이 빌드에 없다. Windows 에서 대응하는 TransmitFile 을 쓴다.
+ *  클라이언트 에디션 Windows 는 TransmitFile 동시 실행이 2개로 제한되므로
+ *  -clients 를 늘린 결과는 서버 에디션에서 보는 것이 맞다.
+ *
+ *  사용법:
+ *    file_bench.exe [-models list] [-size MB] [-clients n] [-repeat n] [-ranges n]
+ *
+ *  옵션:
+ *    -models list   iocp,sync-pool (기본 전부)
+ *    -size MB       테스트 파일 크기 (기본 512)
+ *    -clients n     동시 다운로드 수 (기본 2)
+ *    -repeat n      클라이언트마다 전체 파일 받는 횟수 (기본 4)
+ *    -ranges n      조합마다 검증할 범위 요청 수 (기본 32)
+ * ============================================
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <process.h>
+#include <vector>
+#include <string>
+#include "bench_process.h"
+
+#pragma comment(lib, "ws2_32.lib")
+
+#define TEST_FILE_NAME "file_bench.dat"
+#define WRITE_BLOCK_SIZE (1 << 20)
+#define RECV_BUFFER_SIZE (256 * 1024)
+
+// 콘솔 색상
+void SetColor(int color) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+}
+
+#define COLOR_DEFAULT 7
+#define COLOR_GREEN 10
+#define COLOR_YELLOW 14
+#define COLOR_CYAN 11
+#define COLOR_RED 12
+
+struct FileModel {
+    const char* name;
+    const char* exe;
+    int port;
+    const char* extraArgs;
+};
+
+static const FileModel g_models[] = {
+    { "iocp",      "04_iocp_server.exe", 9003, "" },
+    { "sync-pool", "01_sync_server.exe", 9000, "-pool 8" },
+};
+static const int g_modelCount = sizeof(g_models) / sizeof(g_models[0]);
+
+struct SendMode {
+    const char* name;
+    const char* verb;
+};
+
+static const SendMode g_modes[] = {
+    { "transmit", "FILE" },
+    { "copy",     "FILECOPY" },
+};
+
+// 옵션
+static std::vector<const FileModel*> g_selectedModels;
+static int g_sizeMB = 512;
+static int g_clientCount = 2;
+static int g_repeat = 4;
+static int g_rangeChecks = 32;
+
+static long long g_fileSize = 0;
+
+// 파일 내용 = 위치의 함수 → 범위 요청 결과를 파일 없이 대조할 수 있다
+inline unsigned char PatternByte(long long position) {
+    return (unsigned char)((position * 2654435761ULL) >> 24);
+}
+
+// ============================================
+//  테스트 파일
+// ============================================
+
+bool EnsureTestFile() {
+    g_fileSize = (long long)g_sizeMB * 1024 * 1024;
+
+    HANDLE file = CreateFileA(TEST_FILE_NAME, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, 0, NULL);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER size;
+        bool reuse = GetFileSizeEx(file, &size) && size.QuadPart == g_fileSize;
+        CloseHandle(file);
+        if (reuse) return true;
+    }
+
+    file = CreateFileA(TEST_FILE_NAME, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                       FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    std::vector<unsigned char> block(WRITE_BLOCK_SIZE);
+    bool ok = true;
+    for (long long base = 0; ok && base < g_fileSize; base += WRITE_BLOCK_SIZE) {
+        for (int i = 0; i < WRITE_BLOCK_SIZE; i++) block[i] = PatternByte(base + i);
+        DWORD written = 0;
+        ok = WriteFile(file, block.data(), WRITE_BLOCK_SIZE, &written, NULL) && written == WRITE_BLOCK_SIZE;
+    }
+    CloseHandle(file);
+    return ok;
+}
+
+// ============================================
+//  서버 프로세스
+// ============================================
+
+SOCKET ConnectServer(int port) {
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) return INVALID_SOCKET;
+
+    int recvBuffer = RECV_BUFFER_SIZE;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (const char*)&recvBuffer, sizeof(recvBuffer));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((u_short)port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    if (connect(sock, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) {
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    return sock;
+}
+
+bool LaunchServer(const FileModel& model, PROCESS_INFORMATION& pi) {
+    char commandLine[256];
+    sprintf_s(commandLine, "%s -work 0 -files . %s", model.exe, model.extraArgs);
+    return LaunchAndProbe(commandLine, model.port, pi, ProbeConnect);
+}
+
+// ============================================
+//  클라이언트
+// ============================================
+
+// 요청 하나: "FILE <이름> offset length" → "FILE <n>\n" + n 바이트 (서버가 닫으면 끝)
+// verify = 받은 내용을 패턴과 대조. 반환: 받은 본문 바이트, -1 = 실패
+long long FetchRange(int port, const char* verb, long long offset, long long length, bool verify) {
+    SOCKET sock = ConnectServer(port);
+    if (sock == INVALID_SOCKET) return -1;
+
+    char request[128];
+    int requestLen = sprintf_s(request, "%s %s %lld %lld", verb, TEST_FILE_NAME, offset, length);
+    if (send(sock, request, requestLen, 0) == SOCKET_ERROR) {
+        closesocket(sock);
+        return -1;
+    }
+
+    static __declspec(thread) char buffer[RECV_BUFFER_SIZE];
+    long long expected = -1;
+    long long body = 0;
+    int headerLen = 0;
+    char header[64];
+    bool ok = true;
+
+    while (ok) {
+        int received = recv(sock, buffer, sizeof(buffer), 0);
+        if (received <= 0) break;
+
+        int start = 0;
+        if (expected < 0) {
+            // 헤더 줄은 짧아서 대개 첫 recv 안에 있지만, 잘려도 이어 붙인다
+            while (start < received && expected < 0) {
+                char c = buffer[start++];
+                if (c == '\n') {
+                    header[headerLen] = '\0';
+                    if (strncmp(header, "FILE ", 5) != 0) ok = false;
+                    else expected = _atoi64(header + 5);
+                    if (!ok) break;
+                } else if (headerLen < (int)sizeof(header) - 1) {
+                    header[headerLen++] = c;
+                }
+            }
+        }
+
+        int count = received - start;
+        if (verify) {
+            for (int i = 0; i < count && ok; i++) {
+                ok = ((unsigned char)buffer[start + i] == PatternByte(offset + body + i));
+            }
+        }
+        body += count;
+    }
+
+    closesocket(sock);
+    return (ok && expected >= 0 && body == expected) ? body : -1;
+}
+
+struct TransferArgs {
+    const FileModel* model;
+    const SendMode* mode;
+    long long bytes;
+    int errors;
+};
+
+unsigned int __stdcall TransferThread(void* arg) {
+    TransferArgs* args = (TransferArgs*)arg;
+    for (int i = 0; i < g_repeat; i++) {
+        long long received = FetchRange(args->model->port, args->mode->verb, 0, 0, false);
+        if (received == g_fileSize) args->bytes += received;
+        else args->errors++;
+    }
+    return 0;
+}
+
+// ============================================
+//  측정
+// ============================================
+
+struct FileResult {
+    std::string model;
+    std::string mode;
+    bool serverStarted;
+    double gb;
+    double seconds;
+    double gbPerSec;
+    double userMsPerGB;
+    double kernelMsPerGB;
+    double serverCores;
+    int errors;
+    int rangeOk;
+    int rangeFailed;
+};
+
+// xorshift64: 조합마다 같은 범위 목록
+static unsigned long long g_rng = 1;
+
+long long RandomBelow(long long range) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return (long long)(g_rng % (unsigned long long)range);
+}
+
+FileResult RunOne(const FileModel& model, const SendMode& mode) {
+    FileResult result = {};
+    result.model = model.name;
+    result.mode = mode.name;
+
+    PROCESS_INFORMATION pi;
+    if (!LaunchServer(model, pi)) return result;
+    result.serverStarted = true;
+
+    FetchRange(model.port, mode.verb, 0, 0, false);  // 파일 캐시 데우기
+
+    std::vector<TransferArgs> args(g_clientCount);
+    std::vector<HANDLE> threads(g_clientCount);
+    ULONGLONG userBefore, kernelBefore, userAfter, kernelAfter;
+    SampleCpuUs(pi.hProcess, userBefore, kernelBefore);
+    double startSec = NowSec();
+    for (int t = 0; t < g_clientCount; t++) {
+        args[t].model = &model;
+        args[t].mode = &mode;
+        args[t].bytes = 0;
+        args[t].errors = 0;
+        threads[t] = (HANDLE)_beginthreadex(NULL, 0, TransferThread, &args[t], 0, NULL);
+    }
+    WaitForMultipleObjects((DWORD)threads.size(), threads.data(), TRUE, INFINITE);
+    result.seconds = NowSec() - startSec;
+    SampleCpuUs(pi.hProcess, userAfter, kernelAfter);
+
+    long long bytes = 0;
+    for (int t = 0; t < g_clientCount; t++) {
+        CloseHandle(threads[t]);
+        bytes += args[t].bytes;
+        result.errors += args[t].errors;
+    }
+
+    result.gb = bytes / (1024.0 * 1024.0 * 1024.0);
+    result.gbPerSec = result.gb / result.seconds;
+    if (result.gb > 0) {
+        result.userMsPerGB = (userAfter - userBefore) / 1000.0 / result.gb;
+        result.kernelMsPerGB = (kernelAfter - kernelBefore) / 1000.0 / result.gb;
+    }
+    result.serverCores = (userAfter - userBefore + kernelAfter - kernelBefore) / 1000000.0 / result.seconds;
+
+    // 범위 요청: 임의 위치 / 길이 (파일 끝을 넘는 길이는 서버가 잘라서 보낸다)
+    g_rng = 88172645463325252ULL;
+    for (int i = 0; i < g_rangeChecks; i++) {
+        long long offset = RandomBelow(g_fileSize);
+        long long length = 1 + RandomBelow(4 * 1024 * 1024);
+        long long expected = (offset + length <= g_fileSize) ? length : g_fileSize - offset;
+        if (FetchRange(model.port, mode.verb, offset, length, true) == expected) result.rangeOk++;
+        else result.rangeFailed++;
+    }
+
+    StopServer(pi);
+    return result;
+}
+
+bool WriteCsv(const std::vector<FileResult>& results, const char* path) {
+    FILE* fp = NULL;
+    if (fopen_s(&fp, path, "w") != 0) return false;
+
+    fprintf(fp, "model,mode,server_started,file_mb,clients,repeat,gb,seconds,gb_per_sec,"
+                "server_user_ms_per_gb,server_kernel_ms_per_gb,server_cpu_cores,errors,"
+                "range_ok,range_failed\n");
+    for (const FileResult& r : results) {
+        fprintf(fp, "%s,%s,%d,%d,%d,%d,%.3f,%.3f,%.3f,%.1f,%.1f,%.3f,%d,%d,%d\n",
+                r.model.c_str(), r.mode.c_str(), r.serverStarted ? 1 : 0,
+                g_sizeMB, g_clientCount, g_repeat, r.gb, r.seconds, r.gbPerSec,
+                r.userMsPerGB, r.kernelMsPerGB, r.serverCores, r.errors,
+                r.rangeOk, r.rangeFailed);
+    }
+    fclose(fp);
+    return true;
+}
+
+bool ParseModels(const char* text) {
+    g_selectedModels.clear();
+    std::string list = text;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        std::string name = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+
+        const FileModel* found = NULL;
+        for (int i = 0; i < g_modelCount; i++) {
+            if (name == g_models[i].name) found = &g_models[i];
+        }
+        if (found == NULL) {
+            SetColor(COLOR_RED);
+            printf("알 수 없는 모델: %s\n", name.c_str());
+            SetColor(COLOR_DEFAULT);
+            return false;
+        }
+        g_selectedModels.push_back(found);
+
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    return true;
+}
+
+bool ParseArgs(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (strcmp(arg, "-models") == 0) {
+            if (!ParseModels(value)) return false;
+        } else if (strcmp(arg, "-size") == 0) {
+            g_sizeMB = atoi(value);
+        } else if (strcmp(arg, "-clients") == 0) {
+            g_clientCount = atoi(value);
+        } else if (strcmp(arg, "-repeat") == 0) {
+            g_repeat = atoi(value);
+        } else if (strcmp(arg, "-ranges") == 0) {
+            g_rangeChecks = atoi(value);
+        } else {
+            return false;
+        }
+    }
+
+    if (g_sizeMB < 1) g_sizeMB = 1;
+    if (g_clientCount < 1) g_clientCount = 1;
+    if (g_repeat < 1) g_repeat = 1;
+    if (g_rangeChecks < 0) g_rangeChecks = 0;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+
+    for (int i = 0; i < g_modelCount; i++) g_selectedModels.push_back(&g_models[i]);
+    if (!ParseArgs(argc, argv)) {
+        printf("사용법: file_bench.exe [-models list] [-size MB] [-clients n] [-repeat n] [-ranges n]\n");
+        return 1;
+    }
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("  [파일 전송 벤치마크] TransmitFile vs ReadFile + send\n");
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  파일: %s %d MB | 동시 다운로드 %d개 × %d회 | 범위 검증 %d회\n",
+           TEST_FILE_NAME, g_sizeMB, g_clientCount, g_repeat, g_rangeChecks);
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    if (!EnsureTestFile()) {
+        SetColor(COLOR_RED);
+        printf("테스트 파일 생성 실패: %s\n", TEST_FILE_NAME);
+        SetColor(COLOR_DEFAULT);
+        return 1;
+    }
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        SetColor(COLOR_RED);
+        printf("WSAStartup 실패\n");
+        return 1;
+    }
+
+    std::vector<FileResult> results;
+    printf("  %-10s %-9s %8s %12s %14s %10s %10s\n",
+           "model", "mode", "GB/s", "user ms/GB", "kernel ms/GB", "cpu(core)", "range");
+    printf("  ──────────────────────────────────────────────────────────────────────────\n");
+
+    for (const FileModel* model : g_selectedModels) {
+        for (const SendMode& mode : g_modes) {
+            FileResult r = RunOne(*model, mode);
+            results.push_back(r);
+
+            if (!r.serverStarted) {
+                SetColor(COLOR_RED);
+                printf("  %-10s %-9s  서버 실행 실패 (%s)\n", r.model.c_str(), r.mode.c_str(), model->exe);
+                SetColor(COLOR_DEFAULT);
+                continue;
+            }
+
+            bool clean = (r.errors == 0 && r.rangeFailed == 0);
+            SetColor(clean ? COLOR_GREEN : COLOR_YELLOW);
+            printf("  %-10s %-9s %8.2f %12.1f %14.1f %10.2f %6d/%-3d",
+                   r.model.c_str(), r.mode.c_str(), r.gbPerSec, r.userMsPerGB, r.kernelMsPerGB,
+                   r.serverCores, r.rangeOk, g_rangeChecks);
+            if (r.errors > 0) printf(" (전송 실패 %d)", r.errors);
+            printf("\n");
+            SetColor(COLOR_DEFAULT);
+        }
+    }
+
+    bool written = WriteCsv(results, "file_report.csv");
+
+    printf("\n");
+    SetColor(written ? COLOR_GREEN : COLOR_RED);
+    printf(written ? "리포트 저장: file_report.csv\n" : "리포트 저장 실패\n");
+    SetColor(COLOR_DEFAULT);
+
+    WSACleanup();
+    return written ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+/*
+ * ============================================
+ *  파일 대량 전송 (패치 파일 / 리플레이)
+ * ============================================
+ *  요청 (한 연결에 하나, 보내고 나면 서버가 연결을 닫는다):
+ *    "FILE <이름> [offset] [length]"      → TransmitFile
+ *    "FILECOPY <이름> [offset] [length]"  → ReadFile + send 루프 (비교 기준)
+ *    offset/length = 범위 요청. length 생략/0 = offset 부터 파일 끝까지,
+ *    파일 끝을 넘는 length 는 잘라서 보낸다
+ *  응답:
+ *    "FILE <보낼 바이트>\n" + 데이터 / 실패 시 "ERR <이유>\n"
+ *
+ *  - TransmitFile = Linux sendfile/splice 에 해당하는 Windows API
+ *      커널이 파일 캐시 페이지를 바로 소켓으로 넘긴다 (사용자 공간 복사 없음)
+ *      응답 헤더는 TRANSMIT_FILE_BUFFERS 로 같은 호출에 붙인다
+ *  - FILECOPY 는 커널 → 사용자 버퍼 → 커널 복사가 청크마다 두 번
+ *  - TLS 연결은 커널이 암호화를 못 하므로 항상 복사 경로 (kTLS 없음, tls_layer.h)
+ *  - 이름은 파일 루트(-files) 바로 아래 파일만 ('/', '\\', ':', ".." 거부)
+ *  - 클라이언트 에디션 Windows 는 TransmitFile 동시 실행을 2개로 제한한다
+ *    (서버 에디션은 제한 없음) → 동시 전송 수를 늘려 잴 때는 주의
+ *
+ *  사용처: 01_sync_server.cpp, 04_iocp_server.cpp, file_bench.cpp
+ * ============================================
+ */
+
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winsock2.h>
+#include <mswsock.h>
+#include <stdio.h>
+#include <string.h>
+
+#pragma comment(lib, "mswsock.lib")
+
+#define FILE_COPY_CHUNK 65536
+#define FILE_TRANSMIT_CHUNK (1LL << 30)   // TransmitFile 한 번에 보낼 수 있는 상한(2GB - 2) 아래로
+
+enum FileSendMode {
+    FILE_SEND_TRANSMIT,
+    FILE_SEND_COPY
+};
+
+struct FileRequest {
+    FileSendMode mode;
+    char name[MAX_PATH];
+    long long offset;
+    long long length;       // 0 = 끝까지
+};
+
+// "FILE ..." / "FILECOPY ..." 요청이면 true
+inline bool FileParseRequest(const char* request, FileRequest& out) {
+    const char* args;
+    if (strncmp(request, "FILECOPY ", 9) == 0) {
+        out.mode = FILE_SEND_COPY;
+        args = request + 9;
+    } else if (strncmp(request, "FILE ", 5) == 0) {
+        out.mode = FILE_SEND_TRANSMIT;
+        args = request + 5;
+    } else {
+        return false;
+    }
+
+    out.name[0] = '\0';
+    out.offset = 0;
+    out.length = 0;
+    sscanf_s(args, "%259s %lld %lld", out.name, (unsigned)sizeof(out.name), &out.offset, &out.length);
+    return true;
+}
+
+// 루트 밖으로 나가는 이름 거부
+inline bool FileNameIsSafe(const char* name) {
+    if (name[0] == '\0') return false;
+    if (strpbrk(name, "/\\:") != NULL) return false;
+    return strstr(name, "..") == NULL;
+}
+
+// 복사 경로: 청크마다 ReadFile(커널 → 사용자) + send(사용자 → 커널)
+template <typename SendFn>
+inline bool FileCopySend(HANDLE file, long long offset, long long length, SendFn sendFn) {
+    static __declspec(thread) char chunk[FILE_COPY_CHUNK];
+
+    LARGE_INTEGER position;
+    position.QuadPart = offset;
+    if (!SetFilePointerEx(file, position, NULL, FILE_BEGIN)) return false;
+
+    while (length > 0) {
+        DWORD want = (length < FILE_COPY_CHUNK) ? (DWORD)length : FILE_COPY_CHUNK;
+        DWORD read = 0;
+        if (!ReadFile(file, chunk, want, &read, NULL) || read == 0) return false;
+        if (!sendFn(chunk, (int)read)) return false;
+        length -= read;
+    }
+    return true;
+}
+
+// 무복사 경로: 범위는 OVERLAPPED 의 offset 으로 지정하고 완료까지 기다린다.
+// hEvent 하위 비트 1 = 완료 포트에 알리지 않음 (04 처럼 IOCP에 묶인 소켓에서도
+// Worker 가 이 완료를 꺼내 가지 않는다)
+inline bool FileTransmit(SOCKET socket, HANDLE file, long long offset, long long length,
+                         TRANSMIT_FILE_BUFFERS* head) {
+    HANDLE event = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (event == NULL) return false;
+
+    bool ok = true;
+    while (ok && length > 0) {
+        DWORD chunk = (DWORD)((length < FILE_TRANSMIT_CHUNK) ? length : FILE_TRANSMIT_CHUNK);
+
+        OVERLAPPED overlapped;
+        memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = (DWORD)offset;
+        overlapped.OffsetHigh = (DWORD)(offset >> 32);
+        overlapped.hEvent = (HANDLE)((ULONG_PTR)event | 1);
+
+        if (!TransmitFile(socket, file, chunk, 0, &overlapped, head, 0) &&
+            WSAGetLastError() != WSA_IO_PENDING) {
+            ok = false;
+        } else {
+            DWORD sent = 0;
+            DWORD flags = 0;
+            ok = (WSAGetOverlappedResult(socket, &overlapped, &sent, TRUE, &flags) != FALSE);
+        }
+
+        head = NULL;  // 헤더는 첫 청크에만
+        offset += chunk;
+        length -= chunk;
+    }
+
+    CloseHandle(event);
+    return ok;
+}
+
+// 요청 하나 처리 (응답 헤더 + 범위 데이터)
+//  zeroCopy = false 면 FILE 요청도 복사 경로로 (TLS)
+//  sendFn(data, len) → bool : 헤더/에러/복사 경로가 쓰는 전송 함수 (평문 또는 TLS)
+// 반환: 보낸 파일 바이트, -1 = 실패
+template <typename SendFn>
+inline long long FileServe(SOCKET socket, const char* root, const FileRequest& request,
+                           bool zeroCopy, SendFn sendFn) {
+    char path[MAX_PATH];
+    if (!FileNameIsSafe(request.name) || sprintf_s(path, "%s\\%s", root, request.name) < 0) {
+        const char* error = "ERR name\n";
+        sendFn(error, (int)strlen(error));
+        return -1;
+    }
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        const char* error = "ERR not found\n";
+        sendFn(error, (int)strlen(error));
+        return -1;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || request.offset < 0 || request.offset > size.QuadPart ||
+        request.length < 0) {
+        CloseHandle(file);
+        const char* error = "ERR range\n";
+        sendFn(error, (int)strlen(error));
+        return -1;
+    }
+
+    long long available = size.QuadPart - request.offset;
+    long long length = (request.length > 0 && request.length < available) ? request.length : available;
+
+    char header[64];
+    int headerLen = sprintf_s(header, "FILE %lld\n", length);
+
+    bool ok;
+    if (zeroCopy && request.mode == FILE_SEND_TRANSMIT && length > 0) {
+        TRANSMIT_FILE_BUFFERS head = { header, (DWORD)headerLen, NULL, 0 };
+        ok = FileTransmit(socket, file, request.offset, length, &head);
+    } else {
+        ok = sendFn(header, headerLen) && FileCopySend(file, request.offset, length, sendFn);
+    }
+
+    CloseHandle(file);
+    return ok ? length : -1;
+}
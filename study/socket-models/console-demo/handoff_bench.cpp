@@ -0,0 +1,324 @@
+/*
+ * ============================================
+ *  무중단 재시작(핸드오프) 벤치마크
+ * ============================================
+ *  02_select_server를 띄워 부하를 거는 도중에
+ *  "02_select_server.exe -takeover" 를 새로 실행해서
+ *  리슨 소켓 + 대기 중 연결을 넘겨받게 하고,
+ *  그 순간 요청 지연이 얼마나 튀는지(blip) / 실패가 있는지 본다.
+ *
+ *  출력:
+ *  - 100ms 구간별 요청 수 / 실패 수 / 최대 지연 타임라인
+ *  - 핸드오프 전 p99 vs 핸드오프 ±500ms 구간 최대 지연
+ *  - 기존 프로세스가 드레인을 끝내고 종료하기까지 걸린 시간
+ *  - handoff_report.csv (구간별 타임라인)
+ *
+ *  사용법:
+ *    handoff_bench.exe [-threads n] [-duration sec] [-at sec] [-work ms]
+ *
+ *  옵션:
+ *    -threads n      부하 스레드 수 (closed-loop, 기본 8)
+ *    -duration sec   전체 측정 시간 (기본 8)
+ *    -at sec         핸드오프 시작 시각 (기본 3)
+ *    -work ms        서버 작업 시간 (기본 0)
+ * ============================================
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <process.h>
+#include <vector>
+#include <algorithm>
+#include "bench_process.h"
+
+#pragma comment(lib, "ws2_32.lib")
+
+#define SERVER_EXE "02_select_server.exe"
+#define SERVER_PORT 9001
+#define REQUEST_TIMEOUT_MS 3000
+#define BUCKET_MS 100
+#define BLIP_WINDOW_MS 500
+
+// 콘솔 색상
+void SetColor(int color) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+}
+
+#define COLOR_DEFAULT 7
+#define COLOR_GREEN 10
+#define COLOR_YELLOW 14
+#define COLOR_CYAN 11
+#define COLOR_RED 12
+
+// 옵션
+static int g_threadCount = 8;
+static int g_durationSec = 8;
+static int g_handoffAtSec = 3;
+static int g_workMs = 0;
+
+static ULONGLONG g_benchStartUs = 0;
+
+// ============================================
+//  요청 한 번 (연결 → "PING" → "OK" 수신 → 종료)
+// ============================================
+
+bool RunRequest() {
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) return false;
+
+    DWORD timeout = REQUEST_TIMEOUT_MS;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(SERVER_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    bool ok = false;
+    if (connect(sock, (sockaddr*)&addr, sizeof(addr)) == 0) {
+        const char* request = "PING";
+        char response[16];
+        if (send(sock, request, (int)strlen(request), 0) > 0) {
+            int received = recv(sock, response, sizeof(response), 0);
+            ok = (received >= 2 && response[0] == 'O');
+        }
+    }
+    closesocket(sock);
+    return ok;
+}
+
+// ============================================
+//  서버 프로세스
+// ============================================
+
+// waitReady = false: -takeover 는 같은 포트를 이어받으므로 probe 가 통해도 기존 프로세스의 응답일 수 있다
+bool LaunchServer(const char* extraArgs, bool waitReady, PROCESS_INFORMATION& pi) {
+    char commandLine[256];
+    sprintf_s(commandLine, "%s -work %d %s", SERVER_EXE, g_workMs, extraArgs);
+    return waitReady ? LaunchAndProbe(commandLine, SERVER_PORT, pi) : SpawnServer(commandLine, pi);
+}
+
+// ============================================
+//  부하 생성
+// ============================================
+
+struct Sample {
+    ULONGLONG startUs;      // 벤치 시작 기준
+    ULONGLONG latencyUs;
+    bool ok;
+};
+
+struct LoadThreadArgs {
+    ULONGLONG endUs;
+    std::vector<Sample> samples;
+};
+
+unsigned int __stdcall LoadThread(void* arg) {
+    LoadThreadArgs* args = (LoadThreadArgs*)arg;
+    while (1) {
+        ULONGLONG startUs = NowUs();
+        if (startUs >= args->endUs) break;
+
+        bool ok = RunRequest();
+        Sample sample = { startUs - g_benchStartUs, NowUs() - startUs, ok };
+        args->samples.push_back(sample);
+        if (!ok) Sleep(1);  // 연결 거부가 연속될 때 헛돌지 않게
+    }
+    return 0;
+}
+
+struct Bucket {
+    int requests;
+    int errors;
+    ULONGLONG maxUs;
+};
+
+bool ParseArgs(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (strcmp(arg, "-threads") == 0) {
+            g_threadCount = atoi(value);
+        } else if (strcmp(arg, "-duration") == 0) {
+            g_durationSec = atoi(value);
+        } else if (strcmp(arg, "-at") == 0) {
+            g_handoffAtSec = atoi(value);
+        } else if (strcmp(arg, "-work") == 0) {
+            g_workMs = atoi(value);
+        } else {
+            return false;
+        }
+    }
+
+    if (g_threadCount < 1) g_threadCount = 1;
+    if (g_durationSec < 2) g_durationSec = 2;
+    if (g_handoffAtSec < 1 || g_handoffAtSec >= g_durationSec) g_handoffAtSec = g_durationSec / 2;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+
+    if (!ParseArgs(argc, argv)) {
+        printf("사용법: handoff_bench.exe [-threads n] [-duration sec] [-at sec] [-work ms]\n");
+        return 1;
+    }
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("  [핸드오프 벤치마크] Zero-Downtime Restart (%s)\n", SERVER_EXE);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  부하: 스레드 %d개 closed-loop | 측정: %d초 | 핸드오프: %d초 시점\n",
+           g_threadCount, g_durationSec, g_handoffAtSec);
+    printf("  서버 작업: %d ms\n", g_workMs);
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        SetColor(COLOR_RED);
+        printf("WSAStartup 실패\n");
+        return 1;
+    }
+
+    PROCESS_INFORMATION oldServer;
+    if (!LaunchServer("", true, oldServer)) {
+        SetColor(COLOR_RED);
+        printf("서버 실행 실패 (%s)\n", SERVER_EXE);
+        SetColor(COLOR_DEFAULT);
+        WSACleanup();
+        return 1;
+    }
+
+    g_benchStartUs = NowUs();
+    ULONGLONG endUs = g_benchStartUs + g_durationSec * 1000000ULL;
+
+    std::vector<LoadThreadArgs> args(g_threadCount);
+    std::vector<HANDLE> threads(g_threadCount);
+    for (int t = 0; t < g_threadCount; t++) {
+        args[t].endUs = endUs;
+        threads[t] = (HANDLE)_beginthreadex(NULL, 0, LoadThread, &args[t], 0, NULL);
+    }
+
+    // 핸드오프: 새 프로세스를 -takeover 로 실행
+    Sleep(g_handoffAtSec * 1000);
+    ULONGLONG handoffUs = NowUs() - g_benchStartUs;
+    PROCESS_INFORMATION newServer;
+    bool launched = LaunchServer("-takeover", false, newServer);
+
+    // 기존 프로세스는 처리 중인 요청을 끝내고 스스로 종료해야 한다
+    ULONGLONG drainedUs = 0;
+    if (launched) {
+        DWORD waitMs = (DWORD)((endUs - NowUs()) / 1000) + SERVER_READY_TIMEOUT_MS;
+        if (WaitForSingleObject(oldServer.hProcess, waitMs) == WAIT_OBJECT_0) {
+            drainedUs = NowUs() - g_benchStartUs;
+        }
+    }
+
+    WaitForMultipleObjects((DWORD)threads.size(), threads.data(), TRUE, INFINITE);
+    for (HANDLE thread : threads) CloseHandle(thread);
+
+    if (launched) StopServer(newServer);
+    StopServer(oldServer);  // 이미 종료됐으면 핸들만 정리
+
+    // 구간별 집계
+    int bucketCount = (g_durationSec * 1000) / BUCKET_MS + 1;
+    std::vector<Bucket> buckets(bucketCount, Bucket{ 0, 0, 0 });
+    std::vector<ULONGLONG> before;
+    ULONGLONG blipMaxUs = 0;
+    int blipErrors = 0;
+    int totalRequests = 0;
+    int totalErrors = 0;
+
+    for (const LoadThreadArgs& arg : args) {
+        for (const Sample& sample : arg.samples) {
+            int index = (int)(sample.startUs / 1000 / BUCKET_MS);
+            if (index >= bucketCount) index = bucketCount - 1;
+            Bucket& bucket = buckets[index];
+            bucket.requests++;
+            totalRequests++;
+            if (!sample.ok) {
+                bucket.errors++;
+                totalErrors++;
+            }
+            if (sample.latencyUs > bucket.maxUs) bucket.maxUs = sample.latencyUs;
+
+            ULONGLONG endSampleUs = sample.startUs + sample.latencyUs;
+            if (endSampleUs < handoffUs) {
+                if (sample.ok) before.push_back(sample.latencyUs);
+            } else if (sample.startUs < handoffUs + BLIP_WINDOW_MS * 1000ULL) {
+                // 핸드오프 시점에 진행 중이었거나 직후에 시작한 요청
+                if (sample.latencyUs > blipMaxUs) blipMaxUs = sample.latencyUs;
+                if (!sample.ok) blipErrors++;
+            }
+        }
+    }
+
+    std::sort(before.begin(), before.end());
+    double beforeP99Ms = before.empty() ? 0 : before[(size_t)(before.size() * 0.99)] / 1000.0;
+
+    // 타임라인 (핸드오프 구간은 노란색)
+    printf("  %8s %8s %6s %10s\n", "t(ms)", "req", "err", "max(ms)");
+    printf("  ─────────────────────────────────────\n");
+    int handoffBucket = (int)(handoffUs / 1000 / BUCKET_MS);
+    for (int i = 0; i < bucketCount; i++) {
+        const Bucket& bucket = buckets[i];
+        if (bucket.requests == 0 && i != handoffBucket) continue;
+
+        bool nearHandoff = (abs(i - handoffBucket) * BUCKET_MS <= BLIP_WINDOW_MS);
+        SetColor(bucket.errors > 0 ? COLOR_RED : (nearHandoff ? COLOR_YELLOW : COLOR_DEFAULT));
+        printf("  %8d %8d %6d %10.2f%s\n", i * BUCKET_MS, bucket.requests, bucket.errors,
+               bucket.maxUs / 1000.0, (i == handoffBucket) ? "  ← 핸드오프" : "");
+    }
+    SetColor(COLOR_DEFAULT);
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  전체 요청: %d | 실패: %d\n", totalRequests, totalErrors);
+    printf("  핸드오프 전 p99: %.2f ms\n", beforeP99Ms);
+    SetColor(blipErrors > 0 ? COLOR_RED : COLOR_GREEN);
+    printf("  핸드오프 ±%d ms 최대 지연: %.2f ms (실패 %d)\n",
+           BLIP_WINDOW_MS, blipMaxUs / 1000.0, blipErrors);
+    SetColor(COLOR_DEFAULT);
+    if (!launched) {
+        SetColor(COLOR_RED);
+        printf("  새 서버 실행 실패 (%s -takeover)\n", SERVER_EXE);
+    } else if (drainedUs > 0) {
+        printf("  기존 프로세스 드레인 후 종료: 핸드오프 +%.0f ms\n", (drainedUs - handoffUs) / 1000.0);
+    } else {
+        SetColor(COLOR_YELLOW);
+        printf("  기존 프로세스가 종료되지 않음 (핸드오프 실패?)\n");
+    }
+    SetColor(COLOR_DEFAULT);
+
+    // 리포트
+    FILE* fp = NULL;
+    bool written = (fopen_s(&fp, "handoff_report.csv", "w") == 0);
+    if (written) {
+        fprintf(fp, "t_ms,requests,errors,max_ms\n");
+        for (int i = 0; i < bucketCount; i++) {
+            fprintf(fp, "%d,%d,%d,%.3f\n", i * BUCKET_MS, buckets[i].requests,
+                    buckets[i].errors, buckets[i].maxUs / 1000.0);
+        }
+        fclose(fp);
+    }
+
+    printf("\n");
+    SetColor(written ? COLOR_GREEN : COLOR_RED);
+    printf(written ? "리포트 저장: handoff_report.csv\n" : "리포트 저장 실패\n");
+    SetColor(COLOR_DEFAULT);
+
+    WSACleanup();
+    return (launched && drainedUs > 0) ? 0 : 1;
+}
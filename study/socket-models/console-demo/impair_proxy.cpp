@@ -0,0 +1,671 @@
+/*
+ * ============================================
+ *  네트워크 장애 프록시 (Network Impairment Proxy)
+ * ============================================
+ *  127.0.0.1 루프백은 지연이 거의 0이라서
+ *  실제 WAN 환경의 모델 간 차이가 드러나지 않는다.
+ *
+ *    test_client ──▶ [impair_proxy] ──▶ 서버
+ *
+ *  프록시가 중간에서 다음을 주입:
+ *  - 지연 (delay)       : 방향별 고정 지연
+ *  - 지터 (jitter)      : ±jitter 균등 분포
+ *  - 대역폭 (bw)        : 방향별 링크 속도 (직렬화 지연)
+ *  - 손실 (loss)        : TCP → 재전송 지연(RTO)으로 모델링
+ *                         UDP → 데이터그램 드롭
+ *
+ *  단일 스레드 WSAPoll 이벤트 루프 + 방향별 송신 큐.
+ *  TCP는 순서가 보장되므로 앞 조각보다 먼저 나가지 않는다.
+ *  (손실 1건이 뒤 조각까지 막는 Head-of-Line 블로킹 재현)
+ *
+ *  사용법:
+ *    impair_proxy.exe [리슨포트] [서버포트] [옵션...]
+ *
+ *  옵션:
+ *    -host ip     서버 주소 (기본 127.0.0.1)
+ *    -delay ms    단방향 지연 (기본 0)
+ *    -jitter ms   지연 편차 ±ms (기본 0)
+ *    -bw kbps     방향별 대역폭 상한 (기본 0 = 무제한)
+ *    -loss pct    손실률 % (기본 0)
+ *    -rto ms      TCP 손실 시 추가 지연 (기본 200)
+ *    -udp         UDP 모드
+ *    -seed n      난수 시드 (같은 시드 = 같은 지터/손실 패턴)
+ *
+ *  예:
+ *    impair_proxy.exe 9103 9003 -delay 40 -jitter 5 -bw 10000 -loss 1
+ *    test_client.exe 9103 5   (WAN 조건의 IOCP 서버 테스트)
+ * ============================================
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mmsystem.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <deque>
+#include <map>
+
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "winmm.lib")
+
+#define BUFFER_SIZE 16384
+#define MAX_QUEUED_BYTES (4 * 1024 * 1024)  // 방향별 큐 상한 (넘으면 recv 중단 = 백프레셔)
+#define UDP_IDLE_TIMEOUT_MS 30000
+#define STATS_INTERVAL_MS 5000
+
+// 콘솔 색상
+void SetColor(int color) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+}
+
+#define COLOR_DEFAULT 7
+#define COLOR_GREEN 10
+#define COLOR_YELLOW 14
+#define COLOR_CYAN 11
+#define COLOR_RED 12
+#define COLOR_MAGENTA 13
+
+// 설정
+static int g_listenPort = 9100;
+static int g_targetPort = 9000;
+static char g_targetHost[64] = "127.0.0.1";
+static ULONGLONG g_delayUs = 0;
+static ULONGLONG g_jitterUs = 0;
+static double g_bytesPerUs = 0;     // 0 = 무제한
+static double g_lossRate = 0;       // 0.0 ~ 1.0
+static ULONGLONG g_rtoUs = 200000;
+static bool g_udp = false;
+static unsigned long long g_seed = 0x9E3779B97F4A7C15ULL;
+
+// 통계
+static ULONGLONG g_startTick = 0;
+static ULONGLONG g_bytesUp = 0;
+static ULONGLONG g_bytesDown = 0;
+static ULONGLONG g_lossEvents = 0;
+static int g_activeConnections = 0;
+static int g_totalConnections = 0;
+
+static LARGE_INTEGER g_qpcFreq;
+
+ULONGLONG NowUs() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (ULONGLONG)(now.QuadPart * 1000000 / g_qpcFreq.QuadPart);
+}
+
+void PrintTime() {
+    ULONGLONG elapsed = GetTickCount64() - g_startTick;
+    printf("[%02llu:%02llu.%03llu] ",
+           elapsed / 60000,
+           (elapsed / 1000) % 60,
+           elapsed % 1000);
+}
+
+// xorshift64* - 시드가 같으면 같은 장애 패턴 (재현 가능한 벤치마크)
+double NextRandom() {
+    g_seed ^= g_seed >> 12;
+    g_seed ^= g_seed << 25;
+    g_seed ^= g_seed >> 27;
+    return (double)((g_seed * 2685821657736338717ULL) >> 11) / (double)(1ULL << 53);
+}
+
+// 방향 하나의 링크 상태
+struct Link {
+    ULONGLONG linkFreeUs;     // 대역폭: 링크가 다음으로 비는 시각
+    ULONGLONG lastReleaseUs;  // TCP 순서 보장용
+};
+
+// 송신 시각 계산: 직렬화 지연 + 지연 + 지터 (+ 손실 시 RTO)
+// 반환값 0 = 드롭 (UDP 손실)
+ULONGLONG ScheduleRelease(Link& link, size_t bytes, bool ordered) {
+    ULONGLONG now = NowUs();
+    ULONGLONG base = now;
+
+    if (g_bytesPerUs > 0) {
+        ULONGLONG start = (link.linkFreeUs > now) ? link.linkFreeUs : now;
+        link.linkFreeUs = start + (ULONGLONG)(bytes / g_bytesPerUs);
+        base = link.linkFreeUs;
+    }
+
+    long long delay = (long long)g_delayUs;
+    if (g_jitterUs > 0) {
+        delay += (long long)((NextRandom() * 2.0 - 1.0) * (double)g_jitterUs);
+        if (delay < 0) delay = 0;
+    }
+    ULONGLONG release = base + (ULONGLONG)delay;
+
+    if (g_lossRate > 0 && NextRandom() < g_lossRate) {
+        g_lossEvents++;
+        if (!ordered) return 0;
+        release += g_rtoUs;
+    }
+
+    if (ordered) {
+        if (release < link.lastReleaseUs) release = link.lastReleaseUs;
+        link.lastReleaseUs = release;
+    }
+    return release;
+}
+
+// ============================================
+//  TCP 모드
+// ============================================
+
+struct Chunk {
+    ULONGLONG releaseUs;
+    std::vector<char> data;
+    size_t offset;
+};
+
+// 한 방향 (src → dst)
+struct Pipe {
+    std::deque<Chunk> queue;
+    size_t queuedBytes;
+    Link link;
+    bool srcClosed;    // src에서 FIN 수신
+    bool dstShutdown;  // dst로 FIN 전달 완료
+    bool blocked;      // dst 송신 버퍼 가득 (POLLWRNORM 대기)
+};
+
+struct Connection {
+    int id;
+    SOCKET client;
+    SOCKET server;
+    Pipe up;    // client → server
+    Pipe down;  // server → client
+    bool dead;
+};
+
+void InitPipe(Pipe& pipe) {
+    pipe.queuedBytes = 0;
+    pipe.link.linkFreeUs = 0;
+    pipe.link.lastReleaseUs = 0;
+    pipe.srcClosed = false;
+    pipe.dstShutdown = false;
+    pipe.blocked = false;
+}
+
+void SetNonBlocking(SOCKET s) {
+    u_long mode = 1;
+    ioctlsocket(s, FIONBIO, &mode);
+}
+
+// src에서 읽을 수 있는 만큼 읽어서 큐에 넣기
+bool PumpRecv(SOCKET src, Pipe& pipe, ULONGLONG& counter) {
+    char buffer[BUFFER_SIZE];
+    while (pipe.queuedBytes < MAX_QUEUED_BYTES) {
+        int received = recv(src, buffer, BUFFER_SIZE, 0);
+        if (received > 0) {
+            Chunk chunk;
+            chunk.releaseUs = ScheduleRelease(pipe.link, received, true);
+            chunk.data.assign(buffer, buffer + received);
+            chunk.offset = 0;
+            pipe.queue.push_back(chunk);
+            pipe.queuedBytes += received;
+            counter += received;
+        } else if (received == 0) {
+            pipe.srcClosed = true;
+            return true;
+        } else {
+            return WSAGetLastError() == WSAEWOULDBLOCK;
+        }
+    }
+    return true;
+}
+
+// 송신 시각이 된 조각들을 dst로 전달
+bool PumpSend(SOCKET dst, Pipe& pipe, ULONGLONG now) {
+    pipe.blocked = false;
+    while (!pipe.queue.empty() && pipe.queue.front().releaseUs <= now) {
+        Chunk& chunk = pipe.queue.front();
+        int remaining = (int)(chunk.data.size() - chunk.offset);
+        int sent = send(dst, chunk.data.data() + chunk.offset, remaining, 0);
+        if (sent == SOCKET_ERROR) {
+            if (WSAGetLastError() == WSAEWOULDBLOCK) {
+                pipe.blocked = true;
+                return true;
+            }
+            return false;
+        }
+        chunk.offset += sent;
+        pipe.queuedBytes -= sent;
+        if (chunk.offset == chunk.data.size()) {
+            pipe.queue.pop_front();
+        }
+    }
+
+    // src가 닫혔고 큐도 비었으면 FIN 전달
+    if (pipe.srcClosed && pipe.queue.empty() && !pipe.dstShutdown) {
+        shutdown(dst, SD_SEND);
+        pipe.dstShutdown = true;
+    }
+    return true;
+}
+
+ULONGLONG NextDue(const Pipe& pipe, ULONGLONG current) {
+    if (pipe.queue.empty() || pipe.blocked) return current;
+    ULONGLONG due = pipe.queue.front().releaseUs;
+    return (due < current) ? due : current;
+}
+
+void CloseConnection(Connection* conn) {
+    closesocket(conn->client);
+    closesocket(conn->server);
+    g_activeConnections--;
+
+    PrintTime();
+    SetColor(COLOR_RED);
+    printf("Conn %d 종료\n", conn->id);
+    SetColor(COLOR_DEFAULT);
+}
+
+Connection* AcceptConnection(SOCKET listenSocket, const sockaddr_in& targetAddr) {
+    SOCKET clientSocket = accept(listenSocket, NULL, NULL);
+    if (clientSocket == INVALID_SOCKET) return NULL;
+
+    // 루프백 connect는 즉시 끝나므로 블로킹으로 연결 후 논블로킹 전환
+    SOCKET serverSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (serverSocket == INVALID_SOCKET ||
+        connect(serverSocket, (const sockaddr*)&targetAddr, sizeof(targetAddr)) == SOCKET_ERROR) {
+        PrintTime();
+        SetColor(COLOR_RED);
+        printf("서버 연결 실패 (%s:%d)\n", g_targetHost, g_targetPort);
+        SetColor(COLOR_DEFAULT);
+        if (serverSocket != INVALID_SOCKET) closesocket(serverSocket);
+        closesocket(clientSocket);
+        return NULL;
+    }
+
+    BOOL noDelay = TRUE;
+    setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+    setsockopt(serverSocket, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+    SetNonBlocking(clientSocket);
+    SetNonBlocking(serverSocket);
+
+    Connection* conn = new Connection();
+    conn->id = ++g_totalConnections;
+    conn->client = clientSocket;
+    conn->server = serverSocket;
+    conn->dead = false;
+    InitPipe(conn->up);
+    InitPipe(conn->down);
+    g_activeConnections++;
+
+    PrintTime();
+    SetColor(COLOR_CYAN);
+    printf("Conn %d 연결 → %s:%d 중계 시작 (활성 %d)\n",
+           conn->id, g_targetHost, g_targetPort, g_activeConnections);
+    SetColor(COLOR_DEFAULT);
+    return conn;
+}
+
+void PrintStats() {
+    ULONGLONG elapsed = GetTickCount64() - g_startTick;
+    SetColor(COLOR_YELLOW);
+    printf("─────────────────────────────────────────────────────────────\n");
+    printf("  활성: %d | 누적: %d | ↑ %llu B | ↓ %llu B | 손실: %llu | %.1fs\n",
+           g_activeConnections, g_totalConnections,
+           g_bytesUp, g_bytesDown, g_lossEvents, elapsed / 1000.0);
+    printf("─────────────────────────────────────────────────────────────\n");
+    SetColor(COLOR_DEFAULT);
+}
+
+int PollTimeout(ULONGLONG nextDueUs, ULONGLONG now) {
+    if (nextDueUs <= now) return 0;
+    ULONGLONG waitMs = (nextDueUs - now + 999) / 1000;
+    return (waitMs > 100) ? 100 : (int)waitMs;
+}
+
+void RunTcpProxy(SOCKET listenSocket, const sockaddr_in& targetAddr) {
+    std::vector<Connection*> conns;
+    std::vector<WSAPOLLFD> fds;
+    ULONGLONG lastStats = GetTickCount64();
+
+    while (1) {
+        // pollfd 구성: [0] = listen, 이후 연결마다 client/server 2개
+        fds.clear();
+        WSAPOLLFD listenFd = { listenSocket, POLLRDNORM, 0 };
+        fds.push_back(listenFd);
+
+        ULONGLONG now = NowUs();
+        ULONGLONG nextDue = now + 100000;
+        for (auto conn : conns) {
+            WSAPOLLFD clientFd = { conn->client, 0, 0 };
+            WSAPOLLFD serverFd = { conn->server, 0, 0 };
+            if (!conn->up.srcClosed && conn->up.queuedBytes < MAX_QUEUED_BYTES) clientFd.events |= POLLRDNORM;
+            if (!conn->down.srcClosed && conn->down.queuedBytes < MAX_QUEUED_BYTES) serverFd.events |= POLLRDNORM;
+            if (conn->up.blocked) serverFd.events |= POLLWRNORM;
+            if (conn->down.blocked) clientFd.events |= POLLWRNORM;
+            fds.push_back(clientFd);
+            fds.push_back(serverFd);
+            nextDue = NextDue(conn->up, nextDue);
+            nextDue = NextDue(conn->down, nextDue);
+        }
+
+        int result = WSAPoll(fds.data(), (ULONG)fds.size(), PollTimeout(nextDue, now));
+        if (result == SOCKET_ERROR) {
+            SetColor(COLOR_RED);
+            printf("WSAPoll 실패: %d\n", WSAGetLastError());
+            SetColor(COLOR_DEFAULT);
+            return;
+        }
+
+        if (fds[0].revents & POLLRDNORM) {
+            Connection* conn = AcceptConnection(listenSocket, targetAddr);
+            if (conn) conns.push_back(conn);
+        }
+
+        now = NowUs();
+        for (size_t i = 0; i < conns.size(); i++) {
+            Connection* conn = conns[i];
+            // accept로 방금 추가된 연결은 이번 poll 결과가 없음
+            if (1 + i * 2 + 1 >= fds.size()) break;
+            const WSAPOLLFD& clientFd = fds[1 + i * 2];
+            const WSAPOLLFD& serverFd = fds[1 + i * 2 + 1];
+
+            bool ok = true;
+            if (clientFd.revents & (POLLRDNORM | POLLHUP | POLLERR)) ok = ok && PumpRecv(conn->client, conn->up, g_bytesUp);
+            if (serverFd.revents & (POLLRDNORM | POLLHUP | POLLERR)) ok = ok && PumpRecv(conn->server, conn->down, g_bytesDown);
+            ok = ok && PumpSend(conn->server, conn->up, now);
+            ok = ok && PumpSend(conn->client, conn->down, now);
+
+            bool drained = conn->up.dstShutdown && conn->down.dstShutdown;
+            if (!ok || drained) conn->dead = true;
+        }
+
+        for (auto it = conns.begin(); it != conns.end(); ) {
+            if ((*it)->dead) {
+                CloseConnection(*it);
+                delete *it;
+                it = conns.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (GetTickCount64() - lastStats >= STATS_INTERVAL_MS) {
+            lastStats = GetTickCount64();
+            PrintStats();
+        }
+    }
+}
+
+// ============================================
+//  UDP 모드
+// ============================================
+
+// 클라이언트 주소마다 서버 쪽 UDP 소켓을 하나씩 만든다 (NAT 테이블과 같은 구조)
+struct UdpPeer {
+    sockaddr_in clientAddr;
+    SOCKET upstream;
+    Link up;
+    Link down;
+    ULONGLONG lastActive;
+};
+
+struct Datagram {
+    UdpPeer* peer;
+    bool toServer;
+    std::vector<char> data;
+};
+
+void RunUdpProxy(SOCKET listenSocket, const sockaddr_in& targetAddr) {
+    std::map<unsigned long long, UdpPeer*> peers;
+    std::multimap<ULONGLONG, Datagram> pending;  // 지터에 의한 재정렬 허용
+    std::vector<WSAPOLLFD> fds;
+    std::vector<UdpPeer*> fdPeers;
+    ULONGLONG lastStats = GetTickCount64();
+    char buffer[BUFFER_SIZE];
+
+    while (1) {
+        fds.clear();
+        fdPeers.clear();
+        WSAPOLLFD listenFd = { listenSocket, POLLRDNORM, 0 };
+        fds.push_back(listenFd);
+        fdPeers.push_back(NULL);
+        for (auto& entry : peers) {
+            WSAPOLLFD peerFd = { entry.second->upstream, POLLRDNORM, 0 };
+            fds.push_back(peerFd);
+            fdPeers.push_back(entry.second);
+        }
+
+        ULONGLONG now = NowUs();
+        ULONGLONG nextDue = pending.empty() ? now + 100000 : pending.begin()->first;
+        int result = WSAPoll(fds.data(), (ULONG)fds.size(), PollTimeout(nextDue, now));
+        if (result == SOCKET_ERROR) {
+            SetColor(COLOR_RED);
+            printf("WSAPoll 실패: %d\n", WSAGetLastError());
+            SetColor(COLOR_DEFAULT);
+            return;
+        }
+
+        // 클라이언트 → 프록시
+        if (fds[0].revents & POLLRDNORM) {
+            while (1) {
+                sockaddr_in from;
+                int fromLen = sizeof(from);
+                int received = recvfrom(listenSocket, buffer, BUFFER_SIZE, 0, (sockaddr*)&from, &fromLen);
+                if (received == SOCKET_ERROR) break;
+
+                unsigned long long key = ((unsigned long long)from.sin_addr.s_addr << 16) | from.sin_port;
+                UdpPeer* peer = peers[key];
+                if (peer == NULL) {
+                    peer = new UdpPeer();
+                    memset(peer, 0, sizeof(UdpPeer));
+                    peer->clientAddr = from;
+                    peer->upstream = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+                    connect(peer->upstream, (const sockaddr*)&targetAddr, sizeof(targetAddr));
+                    SetNonBlocking(peer->upstream);
+                    peers[key] = peer;
+                    g_totalConnections++;
+                    g_activeConnections++;
+                }
+                peer->lastActive = GetTickCount64();
+                g_bytesUp += received;
+
+                ULONGLONG release = ScheduleRelease(peer->up, received, false);
+                if (release == 0) continue;
+                Datagram dgram;
+                dgram.peer = peer;
+                dgram.toServer = true;
+                dgram.data.assign(buffer, buffer + received);
+                pending.insert(std::make_pair(release, dgram));
+            }
+        }
+
+        // 서버 → 프록시
+        for (size_t i = 1; i < fds.size(); i++) {
+            if (!(fds[i].revents & POLLRDNORM)) continue;
+            UdpPeer* peer = fdPeers[i];
+            while (1) {
+                int received = recv(peer->upstream, buffer, BUFFER_SIZE, 0);
+                if (received == SOCKET_ERROR) break;
+                peer->lastActive = GetTickCount64();
+                g_bytesDown += received;
+
+                ULONGLONG release = ScheduleRelease(peer->down, received, false);
+                if (release == 0) continue;
+                Datagram dgram;
+                dgram.peer = peer;
+                dgram.toServer = false;
+                dgram.data.assign(buffer, buffer + received);
+                pending.insert(std::make_pair(release, dgram));
+            }
+        }
+
+        // 송신 시각이 된 데이터그램 전달
+        now = NowUs();
+        while (!pending.empty() && pending.begin()->first <= now) {
+            Datagram& dgram = pending.begin()->second;
+            if (dgram.toServer) {
+                send(dgram.peer->upstream, dgram.data.data(), (int)dgram.data.size(), 0);
+            } else {
+                sendto(listenSocket, dgram.data.data(), (int)dgram.data.size(), 0,
+                       (const sockaddr*)&dgram.peer->clientAddr, sizeof(dgram.peer->clientAddr));
+            }
+            pending.erase(pending.begin());
+        }
+
+        // 오래 조용한 매핑 정리 (대기 중인 데이터그램이 없는 것만)
+        if (GetTickCount64() - lastStats >= STATS_INTERVAL_MS) {
+            lastStats = GetTickCount64();
+            for (auto it = peers.begin(); it != peers.end(); ) {
+                UdpPeer* peer = it->second;
+                bool referenced = false;
+                for (auto& entry : pending) {
+                    if (entry.second.peer == peer) { referenced = true; break; }
+                }
+                if (!referenced && lastStats - peer->lastActive > UDP_IDLE_TIMEOUT_MS) {
+                    closesocket(peer->upstream);
+                    delete peer;
+                    it = peers.erase(it);
+                    g_activeConnections--;
+                } else {
+                    ++it;
+                }
+            }
+            PrintStats();
+        }
+    }
+}
+
+bool ParseArgs(int argc, char* argv[]) {
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (strcmp(arg, "-udp") == 0) {
+            g_udp = true;
+        } else if (strcmp(arg, "-host") == 0 && hasValue) {
+            strncpy_s(g_targetHost, argv[++i], _TRUNCATE);
+        } else if (strcmp(arg, "-delay") == 0 && hasValue) {
+            g_delayUs = (ULONGLONG)(atof(argv[++i]) * 1000);
+        } else if (strcmp(arg, "-jitter") == 0 && hasValue) {
+            g_jitterUs = (ULONGLONG)(atof(argv[++i]) * 1000);
+        } else if (strcmp(arg, "-bw") == 0 && hasValue) {
+            // kbps → bytes/us
+            g_bytesPerUs = atof(argv[++i]) * 1000.0 / 8.0 / 1000000.0;
+        } else if (strcmp(arg, "-loss") == 0 && hasValue) {
+            g_lossRate = atof(argv[++i]) / 100.0;
+        } else if (strcmp(arg, "-rto") == 0 && hasValue) {
+            g_rtoUs = (ULONGLONG)(atof(argv[++i]) * 1000);
+        } else if (strcmp(arg, "-seed") == 0 && hasValue) {
+            g_seed = _strtoui64(argv[++i], NULL, 10) | 1;
+        } else if (arg[0] != '-' && positional == 0) {
+            g_listenPort = atoi(arg);
+            positional++;
+        } else if (arg[0] != '-' && positional == 1) {
+            g_targetPort = atoi(arg);
+            positional++;
+        } else {
+            return false;
+        }
+    }
+    return positional == 2;
+}
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+
+    if (!ParseArgs(argc, argv)) {
+        printf("사용법: impair_proxy.exe [리슨포트] [서버포트] [-host ip] [-delay ms] [-jitter ms]\n");
+        printf("                         [-bw kbps] [-loss pct] [-rto ms] [-udp] [-seed n]\n");
+        return 1;
+    }
+
+    QueryPerformanceFrequency(&g_qpcFreq);
+    g_startTick = GetTickCount64();
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("  [장애 프록시] Network Impairment Proxy (%s)\n", g_udp ? "UDP" : "TCP");
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  - 리슨: %d → 서버: %s:%d\n", g_listenPort, g_targetHost, g_targetPort);
+    printf("  - 지연: %.1f ms ± %.1f ms\n", g_delayUs / 1000.0, g_jitterUs / 1000.0);
+    if (g_bytesPerUs > 0) {
+        printf("  - 대역폭: %.0f kbps (방향별)\n", g_bytesPerUs * 8.0 * 1000.0);
+    } else {
+        printf("  - 대역폭: 무제한\n");
+    }
+    printf("  - 손실: %.2f%% (%s)\n", g_lossRate * 100.0,
+           g_udp ? "드롭" : "RTO 지연으로 모델링");
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        SetColor(COLOR_RED);
+        printf("WSAStartup 실패\n");
+        return 1;
+    }
+
+    // Sleep/poll 타이머 해상도를 1ms로
+    timeBeginPeriod(1);
+
+    sockaddr_in targetAddr;
+    memset(&targetAddr, 0, sizeof(targetAddr));
+    targetAddr.sin_family = AF_INET;
+    targetAddr.sin_port = htons(g_targetPort);
+    if (inet_pton(AF_INET, g_targetHost, &targetAddr.sin_addr) != 1) {
+        SetColor(COLOR_RED);
+        printf("잘못된 서버 주소: %s\n", g_targetHost);
+        SetColor(COLOR_DEFAULT);
+        WSACleanup();
+        return 1;
+    }
+
+    SOCKET listenSocket = g_udp
+        ? socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)
+        : socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listenSocket == INVALID_SOCKET) {
+        SetColor(COLOR_RED);
+        printf("소켓 생성 실패\n");
+        WSACleanup();
+        return 1;
+    }
+
+    sockaddr_in listenAddr;
+    memset(&listenAddr, 0, sizeof(listenAddr));
+    listenAddr.sin_family = AF_INET;
+    listenAddr.sin_addr.s_addr = INADDR_ANY;
+    listenAddr.sin_port = htons(g_listenPort);
+
+    if (bind(listenSocket, (sockaddr*)&listenAddr, sizeof(listenAddr)) == SOCKET_ERROR) {
+        SetColor(COLOR_RED);
+        printf("바인딩 실패\n");
+        closesocket(listenSocket);
+        WSACleanup();
+        return 1;
+    }
+
+    if (!g_udp && listen(listenSocket, SOMAXCONN) == SOCKET_ERROR) {
+        SetColor(COLOR_RED);
+        printf("리슨 실패\n");
+        closesocket(listenSocket);
+        WSACleanup();
+        return 1;
+    }
+    SetNonBlocking(listenSocket);
+
+    PrintTime();
+    SetColor(COLOR_GREEN);
+    printf("프록시 시작! 클라이언트 대기중...\n");
+    SetColor(COLOR_DEFAULT);
+
+    if (g_udp) {
+        RunUdpProxy(listenSocket, targetAddr);
+    } else {
+        RunTcpProxy(listenSocket, targetAddr);
+    }
+
+    timeEndPeriod(1);
+    closesocket(listenSocket);
+    WSACleanup();
+    return 0;
+}
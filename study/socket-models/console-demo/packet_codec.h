@@ -0,0 +1,364 @@
+/*
+ * ============================================
+ *  송신 패킷 압축: 스냅샷 델타 (XOR + varint) + LZ4
+ * ============================================
+ *  - 세션마다 "보낸 스냅샷"을 번호(seq)와 함께 CODEC_HISTORY개 보관하고,
+ *    클라이언트가 확인(ack)한 가장 최근 스냅샷을 기준(baseline)으로 삼는다
+ *    → 패킷이 유실돼도 기준은 항상 클라이언트가 가진 것 (재전송 불필요)
+ *  - 델타: 스냅샷을 4바이트 워드로 보고 기준과 XOR → varint
+ *      안 바뀐 워드 = 1바이트(0), 조금 바뀐 좌표 = 1~3바이트
+ *  - 그 결과가 CODEC_LZ4_MIN_INPUT 이상이면 LZ4 블록 압축,
+ *    CODEC_LZ4_MIN_GAIN% 이상 줄어들 때만 압축본을 보낸다 ("할 가치가 있을 때만")
+ *  - LZ4 해시 테이블 + 작업 버퍼 = CodecWorkspace → Worker마다 하나 (패킷마다 할당 X)
+ *    해시 테이블은 매번 비우지 않는다: 이전 패킷의 위치가 남아 있어도
+ *    현재 입력 안에서 4바이트 비교로 검증하므로 틀린 후보일 뿐 오류는 아님
+ *
+ *  패킷 = [seq 4][baseSeq 4][rawLen 2][flags 1][본문]
+ *    baseSeq 0 = 기준 없음 (0과 XOR = 전체 스냅샷)
+ *
+ *  사용처: 04_iocp_server.cpp (-aoi 의 SYNC), delta_bench.cpp
+ * ============================================
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#define CODEC_HISTORY 32            // 세션마다 보관하는 스냅샷 수 (ack 왕복 동안 보낸 것)
+#define CODEC_MAX_SNAPSHOT 65535    // rawLen 이 2바이트
+#define CODEC_HEADER_SIZE 11
+#define CODEC_LZ4_MIN_INPUT 64
+#define CODEC_LZ4_MIN_GAIN 10       // %
+
+#define CODEC_FLAG_DELTA 0x01       // 본문 = XOR/varint 델타 (아니면 원본 그대로)
+#define CODEC_FLAG_LZ4 0x02         // 본문이 LZ4 블록으로 압축됨
+
+// 인코더 단계 선택 (벤치마크용, 서버는 둘 다)
+#define CODEC_USE_DELTA 0x01
+#define CODEC_USE_LZ4 0x02
+
+#define LZ4_HASH_LOG 12
+#define LZ4_MIN_MATCH 4
+#define LZ4_LAST_LITERALS 5         // 블록 끝 5바이트는 항상 리터럴
+#define LZ4_MF_LIMIT 12             // 매치는 끝에서 12바이트 전까지만 시작
+#define LZ4_MAX_OFFSET 65535
+#define LZ4_SKIP_TRIGGER 6          // 매치 실패가 2^6번 이어질 때마다 건너뛰는 폭 +1 (압축 안 되는 입력 빨리 통과)
+
+/* ============================================
+ *  LZ4 블록 포맷 (표준 호환: 토큰 / 리터럴 / 2바이트 오프셋 / 매치 길이)
+ * ============================================ */
+
+struct Lz4State {
+    int table[1 << LZ4_HASH_LOG];   // 4바이트 해시 → 입력 위치
+};
+
+inline int Lz4Bound(int len) {
+    return len + len / 255 + 16;
+}
+
+inline uint32_t Lz4Read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint32_t Lz4Hash(uint32_t v) {
+    return (v * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+inline uint8_t* Lz4WriteLength(uint8_t* op, int len) {
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = (uint8_t)len;
+    return op;
+}
+
+// dst 는 Lz4Bound(srcLen) 이상. 반환: 압축 크기
+inline int Lz4Compress(Lz4State& state, const uint8_t* src, int srcLen, uint8_t* dst) {
+    uint8_t* op = dst;
+    int anchor = 0;
+    int i = 0;
+
+    if (srcLen >= LZ4_MF_LIMIT + 1) {
+        int matchLimit = srcLen - LZ4_LAST_LITERALS;
+        int missCount = 1 << LZ4_SKIP_TRIGGER;
+        while (i < srcLen - LZ4_MF_LIMIT) {
+            uint32_t sequence = Lz4Read32(src + i);
+            uint32_t h = Lz4Hash(sequence);
+            int ref = state.table[h];
+            state.table[h] = i;
+
+            if (ref < 0 || ref >= i || i - ref > LZ4_MAX_OFFSET || Lz4Read32(src + ref) != sequence) {
+                i += missCount++ >> LZ4_SKIP_TRIGGER;
+                continue;
+            }
+            missCount = 1 << LZ4_SKIP_TRIGGER;
+
+            int matchLen = LZ4_MIN_MATCH;
+            while (i + matchLen < matchLimit && src[ref + matchLen] == src[i + matchLen]) matchLen++;
+
+            int literalLen = i - anchor;
+            int extraMatch = matchLen - LZ4_MIN_MATCH;
+            uint8_t* token = op++;
+            *token = (uint8_t)(((literalLen < 15) ? literalLen : 15) << 4 | ((extraMatch < 15) ? extraMatch : 15));
+            if (literalLen >= 15) op = Lz4WriteLength(op, literalLen - 15);
+            memcpy(op, src + anchor, literalLen);
+            op += literalLen;
+
+            uint16_t offset = (uint16_t)(i - ref);
+            *op++ = (uint8_t)(offset & 0xFF);
+            *op++ = (uint8_t)(offset >> 8);
+            if (extraMatch >= 15) op = Lz4WriteLength(op, extraMatch - 15);
+
+            i += matchLen;
+            anchor = i;
+        }
+    }
+
+    int literalLen = srcLen - anchor;
+    *op++ = (uint8_t)(((literalLen < 15) ? literalLen : 15) << 4);
+    if (literalLen >= 15) op = Lz4WriteLength(op, literalLen - 15);
+    memcpy(op, src + anchor, literalLen);
+    op += literalLen;
+    return (int)(op - dst);
+}
+
+// 반환: 풀린 크기, 손상된 입력이면 -1
+inline int Lz4Decompress(const uint8_t* src, int srcLen, uint8_t* dst, int dstCap) {
+    const uint8_t* ip = src;
+    const uint8_t* end = src + srcLen;
+    int out = 0;
+
+    while (ip < end) {
+        uint8_t token = *ip++;
+
+        int literalLen = token >> 4;
+        if (literalLen == 15) {
+            uint8_t b;
+            do {
+                if (ip >= end) return -1;
+                b = *ip++;
+                literalLen += b;
+            } while (b == 255);
+        }
+        if (literalLen > end - ip || literalLen > dstCap - out) return -1;
+        memcpy(dst + out, ip, literalLen);
+        ip += literalLen;
+        out += literalLen;
+        if (ip == end) break;   // 마지막 시퀀스는 리터럴만
+
+        if (end - ip < 2) return -1;
+        int offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > out) return -1;
+
+        int matchLen = (token & 0x0F);
+        if (matchLen == 15) {
+            uint8_t b;
+            do {
+                if (ip >= end) return -1;
+                b = *ip++;
+                matchLen += b;
+            } while (b == 255);
+        }
+        matchLen += LZ4_MIN_MATCH;
+        if (matchLen > dstCap - out) return -1;
+
+        // 겹치는 복사 (offset < matchLen) 가 정상이므로 바이트 단위
+        for (int k = 0; k < matchLen; k++) dst[out + k] = dst[out - offset + k];
+        out += matchLen;
+    }
+    return out;
+}
+
+/* ============================================
+ *  XOR + varint 델타
+ * ============================================ */
+
+inline uint32_t CodecWord(const uint8_t* data, int len, int word) {
+    uint32_t v = 0;
+    int offset = word * 4;
+    if (offset + 4 <= len) memcpy(&v, data + offset, 4);     // 상수 크기 → 레지스터 로드 하나
+    else if (offset < len) memcpy(&v, data + offset, len - offset);
+    return v;
+}
+
+// out 은 ((len + 3) / 4) * 5 바이트 이상
+inline int DeltaEncode(const uint8_t* cur, int curLen, const uint8_t* base, int baseLen, uint8_t* out) {
+    uint8_t* op = out;
+    int words = (curLen + 3) / 4;
+    for (int w = 0; w < words; w++) {
+        uint32_t x = CodecWord(cur, curLen, w) ^ CodecWord(base, baseLen, w);
+        while (x >= 0x80) {
+            *op++ = (uint8_t)(x | 0x80);
+            x >>= 7;
+        }
+        *op++ = (uint8_t)x;
+    }
+    return (int)(op - out);
+}
+
+// 반환: 성공 여부. out 은 curLen 바이트
+inline bool DeltaDecode(const uint8_t* src, int srcLen, const uint8_t* base, int baseLen,
+                        uint8_t* out, int curLen) {
+    const uint8_t* ip = src;
+    const uint8_t* end = src + srcLen;
+    int words = (curLen + 3) / 4;
+    for (int w = 0; w < words; w++) {
+        uint32_t x = 0;
+        int shift = 0;
+        while (1) {
+            if (ip >= end || shift > 28) return false;
+            uint8_t b = *ip++;
+            x |= (uint32_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+            shift += 7;
+        }
+        x ^= CodecWord(base, baseLen, w);
+        int offset = w * 4;
+        if (offset + 4 <= curLen) memcpy(out + offset, &x, 4);
+        else memcpy(out + offset, &x, curLen - offset);
+    }
+    return ip == end;
+}
+
+/* ============================================
+ *  세션 기준 스냅샷 관리 + 인코더 / 디코더
+ * ============================================ */
+
+// 보낸 쪽(서버)과 받은 쪽(클라이언트)이 같은 구조로 스냅샷 이력을 가진다
+struct CodecSession {
+    uint32_t nextSeq;                           // 다음에 보낼 번호 (1부터)
+    uint32_t ackedSeq;                          // 클라이언트가 확인한 최신 번호 (0 = 없음)
+    uint32_t historySeq[CODEC_HISTORY];
+    std::vector<uint8_t> history[CODEC_HISTORY];    // seq % CODEC_HISTORY, 용량은 재사용
+};
+
+// Worker마다 하나. 패킷마다 필요한 버퍼는 여기서 재사용
+struct CodecWorkspace {
+    Lz4State lz4;
+    std::vector<uint8_t> delta;
+    std::vector<uint8_t> packet;
+    std::vector<uint8_t> scratch;               // 디코드용
+};
+
+inline void CodecSessionInit(CodecSession& session) {
+    session.nextSeq = 1;
+    session.ackedSeq = 0;
+    for (int i = 0; i < CODEC_HISTORY; i++) {
+        session.historySeq[i] = 0;
+        session.history[i].clear();
+    }
+}
+
+inline void CodecWorkspaceInit(CodecWorkspace& ws) {
+    memset(ws.lz4.table, 0, sizeof(ws.lz4.table));
+}
+
+inline const std::vector<uint8_t>* CodecFind(const CodecSession& session, uint32_t seq) {
+    if (seq == 0) return NULL;
+    int slot = seq % CODEC_HISTORY;
+    return (session.historySeq[slot] == seq) ? &session.history[slot] : NULL;
+}
+
+inline void CodecStore(CodecSession& session, uint32_t seq, const uint8_t* data, int len) {
+    int slot = seq % CODEC_HISTORY;
+    session.historySeq[slot] = seq;
+    session.history[slot].assign(data, data + len);
+}
+
+// 클라이언트 ack: 더 최신이고 아직 이력에 있는 번호만 기준으로 채택
+inline void CodecAck(CodecSession& session, uint32_t seq) {
+    if (seq > session.ackedSeq && seq < session.nextSeq && CodecFind(session, seq) != NULL) {
+        session.ackedSeq = seq;
+    }
+}
+
+// 스냅샷 하나를 패킷으로 → ws.packet (반환: 패킷 크기, 너무 크면 -1)
+inline int CodecEncode(CodecWorkspace& ws, CodecSession& session,
+                       const uint8_t* snapshot, int len, int stages = CODEC_USE_DELTA | CODEC_USE_LZ4) {
+    if (len < 0 || len > CODEC_MAX_SNAPSHOT) return -1;
+
+    uint32_t seq = session.nextSeq++;
+    uint32_t baseSeq = 0;
+    uint8_t flags = 0;
+    const uint8_t* body = snapshot;
+    int bodyLen = len;
+
+    if (stages & CODEC_USE_DELTA) {
+        const std::vector<uint8_t>* base = CodecFind(session, session.ackedSeq);
+        if (base != NULL) baseSeq = session.ackedSeq;
+
+        ws.delta.resize(((len + 3) / 4) * 5);
+        bodyLen = DeltaEncode(snapshot, len, base ? base->data() : NULL, base ? (int)base->size() : 0,
+                              ws.delta.data());
+        body = ws.delta.data();
+        flags |= CODEC_FLAG_DELTA;
+    }
+
+    ws.packet.resize(CODEC_HEADER_SIZE + Lz4Bound(bodyLen));
+    uint8_t* payload = ws.packet.data() + CODEC_HEADER_SIZE;
+    int payloadLen = 0;
+    if ((stages & CODEC_USE_LZ4) && bodyLen >= CODEC_LZ4_MIN_INPUT) {
+        payloadLen = Lz4Compress(ws.lz4, body, bodyLen, payload);
+        if (payloadLen * 100 <= bodyLen * (100 - CODEC_LZ4_MIN_GAIN)) flags |= CODEC_FLAG_LZ4;
+    }
+    if (!(flags & CODEC_FLAG_LZ4)) {
+        memcpy(payload, body, bodyLen);
+        payloadLen = bodyLen;
+    }
+
+    uint16_t rawLen = (uint16_t)len;
+    uint8_t* header = ws.packet.data();
+    memcpy(header, &seq, 4);
+    memcpy(header + 4, &baseSeq, 4);
+    memcpy(header + 8, &rawLen, 2);
+    header[10] = flags;
+
+    CodecStore(session, seq, snapshot, len);
+    return CODEC_HEADER_SIZE + payloadLen;
+}
+
+// 받은 쪽: 패킷 → 스냅샷 (out). 반환: seq (ack 로 돌려보낼 번호), 실패 0
+inline uint32_t CodecDecode(CodecWorkspace& ws, CodecSession& receiver,
+                            const uint8_t* packet, int len, std::vector<uint8_t>& out) {
+    if (len < CODEC_HEADER_SIZE) return 0;
+
+    uint32_t seq;
+    uint32_t baseSeq;
+    uint16_t rawLen;
+    memcpy(&seq, packet, 4);
+    memcpy(&baseSeq, packet + 4, 4);
+    memcpy(&rawLen, packet + 8, 2);
+    uint8_t flags = packet[10];
+
+    const uint8_t* body = packet + CODEC_HEADER_SIZE;
+    int bodyLen = len - CODEC_HEADER_SIZE;
+    if (flags & CODEC_FLAG_LZ4) {
+        int cap = (flags & CODEC_FLAG_DELTA) ? ((rawLen + 3) / 4) * 5 : rawLen;
+        ws.scratch.resize(cap);
+        bodyLen = Lz4Decompress(body, bodyLen, ws.scratch.data(), cap);
+        if (bodyLen < 0) return 0;
+        body = ws.scratch.data();
+    }
+
+    out.resize(rawLen);
+    if (flags & CODEC_FLAG_DELTA) {
+        const std::vector<uint8_t>* base = CodecFind(receiver, baseSeq);
+        if (baseSeq != 0 && base == NULL) return 0;     // 기준이 없음 (보낸 쪽 버그)
+        if (!DeltaDecode(body, bodyLen, base ? base->data() : NULL, base ? (int)base->size() : 0,
+                         out.data(), rawLen)) {
+            return 0;
+        }
+    } else {
+        if (bodyLen != rawLen) return 0;
+        memcpy(out.data(), body, rawLen);
+    }
+
+    CodecStore(receiver, seq, out.data(), rawLen);
+    return seq;
+}
@@ -0,0 +1,83 @@
+/*
+ * ============================================
+ *  요청 파이프라이닝 (모든 서버 공통)
+ * ============================================
+ *  - 요청 끝에 '\n' 이 붙어 있으면 파이프라인 연결로 본다
+ *      클라이언트는 응답을 기다리지 않고 요청을 여러 개 이어서 보낸다
+ *      → recv 한 번에 요청 여러 개 (+ 잘린 마지막 조각) 가 들어온다
+ *  - 서버는 버퍼 안의 완성된 줄을 순서대로 처리하고,
+ *    응답("OK\n" × 처리한 수)을 send 한 번으로 묶어서 보낸다
+ *  - 잘린 조각은 버퍼 앞으로 당겨 두고 다음 recv 를 그 뒤에 이어 받는다
+ *  - 연결은 클라이언트가 닫을 때(recv 0)까지 유지
+ *  - '\n' 없는 요청 = 기존 방식 (요청 하나 → "OK" → 연결 종료)
+ *
+ *  한 번에 묶는 요청 수는 PIPELINE_MAX_BATCH 까지
+ *  (응답 버퍼를 고정 크기로 두기 위해, 남은 줄은 다음 묶음으로)
+ *
+ *  사용처: 01 ~ 05 서버, test_client.cpp (-pipeline)
+ * ============================================
+ */
+
+#pragma once
+
+#include <string.h>
+
+#define PIPELINE_RESPONSE "OK\n"
+#define PIPELINE_RESPONSE_LEN 3
+#define PIPELINE_BUSY "BUSY\n"
+#define PIPELINE_BUSY_LEN 5
+#define PIPELINE_MAX_BATCH 64
+#define PIPELINE_RESPONSE_BUFFER (PIPELINE_MAX_BATCH * PIPELINE_BUSY_LEN)   // 긴 쪽 ("BUSY\n") 기준
+
+struct PipelineBatch {
+    int requests;   // 이번에 처리할 완성된 요청 수
+    int consumed;   // 그 요청들이 차지한 바이트 (마지막 '\n' 까지)
+};
+
+// 첫 recv 로 연결 종류 판별
+inline bool PipelineDetect(const char* data, int length) {
+    return memchr(data, '\n', length) != NULL;
+}
+
+// data[0..length) 앞쪽의 완성된 줄을 최대 maxRequests 개까지
+inline PipelineBatch PipelineScan(const char* data, int length, int maxRequests = PIPELINE_MAX_BATCH) {
+    PipelineBatch batch = { 0, 0 };
+    const char* cursor = data;
+    const char* end = data + length;
+    while (batch.requests < maxRequests && cursor < end) {
+        const char* newline = (const char*)memchr(cursor, '\n', end - cursor);
+        if (newline == NULL) break;
+        cursor = newline + 1;
+        batch.requests++;
+    }
+    batch.consumed = (int)(cursor - data);
+    return batch;
+}
+
+// 처리한 만큼 앞에서 지우고 남은 조각을 버퍼 앞으로. 반환: 남은 길이
+inline int PipelineCompact(char* buffer, int length, int consumed) {
+    int remaining = length - consumed;
+    if (remaining > 0 && consumed > 0) memmove(buffer, buffer + consumed, remaining);
+    return remaining;
+}
+
+// 응답 묶음 ("OK\n" × count). out 은 PIPELINE_RESPONSE_BUFFER 이상. 반환: 길이
+inline int PipelineBuildResponses(char* out, int count) {
+    for (int i = 0; i < count; i++) {
+        memcpy(out + i * PIPELINE_RESPONSE_LEN, PIPELINE_RESPONSE, PIPELINE_RESPONSE_LEN);
+    }
+    return count * PIPELINE_RESPONSE_LEN;
+}
+
+// 거절한 묶음의 응답 ("BUSY\n" × count, 요청마다 하나씩 순서대로). 반환: 길이
+inline int PipelineBuildBusy(char* out, int count) {
+    for (int i = 0; i < count; i++) {
+        memcpy(out + i * PIPELINE_BUSY_LEN, PIPELINE_BUSY, PIPELINE_BUSY_LEN);
+    }
+    return count * PIPELINE_BUSY_LEN;
+}
+
+// 줄 하나가 버퍼보다 길면 더 받을 자리가 없다 → 프로토콜 오류로 연결 종료
+inline bool PipelineOverflow(int length, int bufferSize) {
+    return length >= bufferSize - 1;
+}
@@ -0,0 +1,99 @@
+/*
+ * ============================================
+ *  토큰 버킷 Rate Limiter (연결별 / IP별)
+ * ============================================
+ *  - lazy refill: 타이머 없이, 토큰을 꺼낼 때 경과 시간만큼 채운다 → O(1)
+ *  - 버킷 8바이트, IP 테이블 엔트리 12바이트 (캐시 라인 하나에 5개)
+ *  - IP 테이블은 고정 크기 open addressing (선형 탐사 IP_PROBE_LIMIT칸)
+ *    탐사 구간이 가득 차면 가장 오래 안 쓴 엔트리를 재사용 → 메모리 상한 고정
+ *  - 거절 시 "몇 ms 후에 토큰이 생기는지" 반환
+ *    → 서버는 그동안 그 소켓을 폴링/recv 하지 않는다 (바쁜 읽기 X)
+ *
+ *  사용처: 02_select_server.cpp (recv 경로), 04_iocp_server.cpp (완료 경로)
+ * ============================================
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#define IP_PROBE_LIMIT 8
+
+struct RateLimit {
+    float ratePerSec;   // 0 = 제한 없음
+    float burst;        // 버킷 용량
+};
+
+struct TokenBucket {
+    float tokens;
+    uint32_t lastMs;    // 마지막으로 채운 시각 (32비트, 차이만 쓰므로 wrap 안전)
+};
+
+inline void TokenBucketInit(TokenBucket& bucket, const RateLimit& limit, uint32_t nowMs) {
+    bucket.tokens = limit.burst;
+    bucket.lastMs = nowMs;
+}
+
+// 0 = 통과 (토큰 1개 소비), 그 외 = 토큰이 생길 때까지 기다려야 하는 ms
+inline uint32_t TokenBucketTake(TokenBucket& bucket, const RateLimit& limit, uint32_t nowMs) {
+    if (limit.ratePerSec <= 0) return 0;
+
+    uint32_t elapsed = nowMs - bucket.lastMs;
+    if (elapsed > 0) {
+        float tokens = bucket.tokens + elapsed * limit.ratePerSec / 1000.0f;
+        bucket.tokens = (tokens < limit.burst) ? tokens : limit.burst;
+        bucket.lastMs = nowMs;
+    }
+
+    if (bucket.tokens >= 1.0f) {
+        bucket.tokens -= 1.0f;
+        return 0;
+    }
+    return (uint32_t)((1.0f - bucket.tokens) * 1000.0f / limit.ratePerSec) + 1;
+}
+
+// 두 버킷을 같이 검사할 때, 뒤 버킷이 거절하면 앞 버킷 토큰을 돌려준다
+inline void TokenBucketRefund(TokenBucket& bucket) {
+    bucket.tokens += 1.0f;
+}
+
+// IP별 버킷 테이블
+struct IpRateEntry {
+    uint32_t ip;        // 0 = 빈 칸 (0.0.0.0에서 오는 연결은 없음)
+    TokenBucket bucket;
+};
+
+struct IpRateTable {
+    std::vector<IpRateEntry> entries;
+    uint32_t mask;
+};
+
+inline void IpRateTableInit(IpRateTable& table, uint32_t capacityPow2) {
+    table.entries.assign(capacityPow2, IpRateEntry());
+    for (auto& entry : table.entries) entry.ip = 0;
+    table.mask = capacityPow2 - 1;
+}
+
+inline TokenBucket& IpRateTableLookup(IpRateTable& table, uint32_t ip,
+                                      const RateLimit& limit, uint32_t nowMs) {
+    uint32_t index = (ip * 2654435761u) & table.mask;   // Knuth 곱셈 해시
+    IpRateEntry* stalest = &table.entries[index];
+
+    for (uint32_t probe = 0; probe < IP_PROBE_LIMIT; probe++) {
+        IpRateEntry& entry = table.entries[(index + probe) & table.mask];
+        if (entry.ip == ip) return entry.bucket;
+        if (entry.ip == 0) {
+            entry.ip = ip;
+            TokenBucketInit(entry.bucket, limit, nowMs);
+            return entry.bucket;
+        }
+        if ((int32_t)(entry.bucket.lastMs - stalest->bucket.lastMs) < 0) stalest = &entry;
+    }
+
+    // 탐사 구간이 가득 참: 가장 오래 조용했던 IP를 밀어낸다
+    // (그만큼 오래 조용했다면 버킷은 이미 가득 찬 상태라 잃는 정보가 거의 없다)
+    stalest->ip = ip;
+    TokenBucketInit(stalest->bucket, limit, nowMs);
+    return stalest->bucket;
+}
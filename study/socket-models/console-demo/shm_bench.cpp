@@ -0,0 +1,451 @@
+/*
+ * ============================================
+ *  공유 메모리 전송 vs loopback TCP 벤치마크
+ * ============================================
+ *  console-demo 의 모든 시나리오는 클라이언트와 서버가 같은 호스트.
+ *  그럼 loopback TCP 스택을 거치는 비용 대신 공유 메모리 링
+ *  (shm_transport.h)을 쓰면 얼마나 빨라지는지 본다.
+ *
+ *  자기 자신을 "-serve" 로 한 번 더 실행해서 별도 프로세스의 에코 서버로 쓴다.
+ *  서버 루프는 전송 종류와 상관없이 TransportSend / TransportRecv 만 쓴다.
+ *
+ *  측정 (전송 방식마다):
+ *  - ping-pong : 메시지 하나 보내고 에코 받기 반복 → 왕복 p50/p99, 왕복/s
+ *  - stream    : 한 방향으로 계속 보내기 → msgs/s, MB/s
+ *
+ *  전송 방식:
+ *    tcp        loopback TCP (TCP_NODELAY, 4바이트 길이 프레이밍)
+ *    shm        공유 메모리 링, 스핀 후 이벤트 대기
+ *    shm-event  공유 메모리 링, 스핀 없이 바로 이벤트 대기 (깨우기 비용 확인용)
+ *
+ *  사용법:
+ *    shm_bench.exe [-count n] [-size bytes] [-spin n]
+ *
+ *  옵션:
+ *    -count n     측정 메시지 수 (기본 100000)
+ *    -size bytes  메시지 크기 (기본 64)
+ *    -spin n      shm 모드 스핀 횟수 (기본 4000)
+ * ============================================
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include "shm_transport.h"
+
+#pragma comment(lib, "ws2_32.lib")
+
+#define TCP_PORT 9005
+#define MAX_MESSAGE_SIZE 65536
+#define WARMUP_COUNT 1000
+#define SERVER_READY_TIMEOUT_MS 10000
+
+// 콘솔 색상
+void SetColor(int color) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+}
+
+#define COLOR_DEFAULT 7
+#define COLOR_GREEN 10
+#define COLOR_YELLOW 14
+#define COLOR_CYAN 11
+#define COLOR_RED 12
+
+// 메시지 종류 (첫 바이트)
+#define MSG_PING 'P'      // 에코 요청
+#define MSG_STREAM 'S'    // 응답 없음
+#define MSG_END 'E'       // stream 끝 → 서버가 MSG_DONE 응답
+#define MSG_DONE 'D'
+#define MSG_QUIT 'Q'
+
+// 옵션
+static int g_count = 100000;
+static int g_size = 64;
+static int g_spin = SHM_DEFAULT_SPIN;
+
+static LARGE_INTEGER g_qpcFreq;
+
+LONGLONG NowTicks() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+double TicksToUs(LONGLONG ticks) {
+    return ticks * 1000000.0 / g_qpcFreq.QuadPart;
+}
+
+// ============================================
+//  전송 추상화: 서버/클라이언트 코드는 이것만 쓴다
+// ============================================
+
+struct Transport {
+    SOCKET sock;                // tcp
+    ShmChannel* shm;            // shm (NULL 이면 tcp)
+    std::vector<char> frame;    // tcp 프레임 조립용 (send 한 번에 보내기)
+};
+
+bool RecvAll(SOCKET sock, char* buffer, int len) {
+    while (len > 0) {
+        int received = recv(sock, buffer, len, 0);
+        if (received <= 0) return false;
+        buffer += received;
+        len -= received;
+    }
+    return true;
+}
+
+int TransportSend(Transport& transport, const char* data, int len) {
+    if (transport.shm) return ShmSend(*transport.shm, data, len);
+
+    transport.frame.resize(sizeof(int) + len);
+    memcpy(transport.frame.data(), &len, sizeof(int));
+    memcpy(transport.frame.data() + sizeof(int), data, len);
+
+    const char* cursor = transport.frame.data();
+    int remaining = (int)transport.frame.size();
+    while (remaining > 0) {
+        int sent = send(transport.sock, cursor, remaining, 0);
+        if (sent == SOCKET_ERROR) return -1;
+        cursor += sent;
+        remaining -= sent;
+    }
+    return len;
+}
+
+// 메시지 하나. 닫히면 0
+int TransportRecv(Transport& transport, char* buffer, int len) {
+    if (transport.shm) return ShmRecv(*transport.shm, buffer, len);
+
+    int messageLen = 0;
+    if (!RecvAll(transport.sock, (char*)&messageLen, sizeof(int))) return 0;
+    if (messageLen < 0 || messageLen > len) return -1;
+    if (!RecvAll(transport.sock, buffer, messageLen)) return 0;
+    return messageLen;
+}
+
+// ============================================
+//  에코 서버 (자식 프로세스, -serve)
+// ============================================
+
+void ServeLoop(Transport& transport) {
+    static char buffer[MAX_MESSAGE_SIZE];
+    while (1) {
+        int received = TransportRecv(transport, buffer, sizeof(buffer));
+        if (received <= 0) break;
+
+        char type = buffer[0];
+        if (type == MSG_PING) {
+            TransportSend(transport, buffer, received);
+        } else if (type == MSG_END) {
+            char done = MSG_DONE;
+            TransportSend(transport, &done, 1);
+        } else if (type == MSG_QUIT) {
+            break;
+        }
+        // MSG_STREAM: 읽기만 한다
+    }
+}
+
+int RunServer(const char* mode, const char* shmName) {
+    Transport transport;
+    transport.sock = INVALID_SOCKET;
+    transport.shm = NULL;
+
+    if (strcmp(mode, "tcp") == 0) {
+        SOCKET listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(TCP_PORT);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        if (bind(listenSocket, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR ||
+            listen(listenSocket, 1) == SOCKET_ERROR) {
+            closesocket(listenSocket);
+            return 1;
+        }
+
+        transport.sock = accept(listenSocket, NULL, NULL);
+        closesocket(listenSocket);
+        if (transport.sock == INVALID_SOCKET) return 1;
+
+        BOOL noDelay = TRUE;
+        setsockopt(transport.sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+        ServeLoop(transport);
+        closesocket(transport.sock);
+        return 0;
+    }
+
+    static ShmChannel channel;
+    if (!ShmOpen(channel, shmName, false, g_spin)) {
+        ShmClose(channel);
+        return 1;
+    }
+    transport.shm = &channel;
+    ServeLoop(transport);
+    ShmClose(channel);
+    return 0;
+}
+
+// ============================================
+//  클라이언트 (측정)
+// ============================================
+
+struct TransportMode {
+    const char* name;
+    bool shm;
+    int spinCount;
+};
+
+struct ShmResult {
+    const char* mode;
+    bool ok;
+    double rttP50Us;
+    double rttP99Us;
+    double roundTripsPerSec;
+    double streamMsgsPerSec;
+    double streamMBps;
+};
+
+bool LaunchServer(const char* mode, const char* shmName, int spinCount, PROCESS_INFORMATION& pi) {
+    char exePath[MAX_PATH];
+    GetModuleFileNameA(NULL, exePath, MAX_PATH);
+
+    char commandLine[MAX_PATH + 128];
+    sprintf_s(commandLine, "\"%s\" -serve %s -name %s -spin %d", exePath, mode, shmName, spinCount);
+
+    STARTUPINFOA si;
+    memset(&si, 0, sizeof(si));
+    si.cb = sizeof(si);
+    return CreateProcessA(NULL, commandLine, NULL, NULL, FALSE,
+                          CREATE_NO_WINDOW, NULL, NULL, &si, &pi) != FALSE;
+}
+
+SOCKET ConnectTcp() {
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(TCP_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    ULONGLONG deadline = GetTickCount64() + SERVER_READY_TIMEOUT_MS;
+    while (GetTickCount64() < deadline) {
+        SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (connect(sock, (sockaddr*)&addr, sizeof(addr)) == 0) {
+            BOOL noDelay = TRUE;
+            setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+            return sock;
+        }
+        closesocket(sock);
+        Sleep(50);
+    }
+    return INVALID_SOCKET;
+}
+
+ShmResult RunMode(const TransportMode& mode) {
+    ShmResult result;
+    memset(&result, 0, sizeof(result));
+    result.mode = mode.name;
+
+    char shmName[64];
+    sprintf_s(shmName, "shm_bench_%lu", GetCurrentProcessId());
+
+    // shm: 세그먼트는 클라이언트가 먼저 만들고 서버가 붙는다
+    static ShmChannel channel;
+    Transport transport;
+    transport.sock = INVALID_SOCKET;
+    transport.shm = NULL;
+    if (mode.shm) {
+        if (!ShmOpen(channel, shmName, true, mode.spinCount)) {
+            ShmClose(channel);
+            return result;
+        }
+        transport.shm = &channel;
+    }
+
+    PROCESS_INFORMATION pi;
+    if (!LaunchServer(mode.shm ? "shm" : "tcp", shmName, mode.spinCount, pi)) {
+        if (mode.shm) ShmClose(channel);
+        return result;
+    }
+
+    if (!mode.shm) {
+        transport.sock = ConnectTcp();
+        if (transport.sock == INVALID_SOCKET) {
+            TerminateProcess(pi.hProcess, 1);
+            CloseHandle(pi.hProcess);
+            CloseHandle(pi.hThread);
+            return result;
+        }
+    }
+
+    std::vector<char> message(g_size, 'x');
+    std::vector<char> reply(MAX_MESSAGE_SIZE);
+    bool ok = true;
+
+    // ping-pong
+    message[0] = MSG_PING;
+    std::vector<LONGLONG> rtts;
+    rtts.reserve(g_count);
+    LONGLONG pingStart = 0;
+    for (int i = 0; ok && i < WARMUP_COUNT + g_count; i++) {
+        if (i == WARMUP_COUNT) pingStart = NowTicks();
+        LONGLONG start = NowTicks();
+        ok = TransportSend(transport, message.data(), g_size) == g_size &&
+             TransportRecv(transport, reply.data(), (int)reply.size()) == g_size;
+        if (i >= WARMUP_COUNT) rtts.push_back(NowTicks() - start);
+    }
+    LONGLONG pingTicks = NowTicks() - pingStart;
+
+    // stream
+    message[0] = MSG_STREAM;
+    LONGLONG streamStart = NowTicks();
+    for (int i = 0; ok && i < g_count; i++) {
+        ok = TransportSend(transport, message.data(), g_size) == g_size;
+    }
+    char end = MSG_END;
+    ok = ok && TransportSend(transport, &end, 1) == 1 &&
+         TransportRecv(transport, reply.data(), (int)reply.size()) == 1 && reply[0] == MSG_DONE;
+    LONGLONG streamTicks = NowTicks() - streamStart;
+
+    char quit = MSG_QUIT;
+    TransportSend(transport, &quit, 1);
+    if (WaitForSingleObject(pi.hProcess, 5000) != WAIT_OBJECT_0) TerminateProcess(pi.hProcess, 1);
+    CloseHandle(pi.hProcess);
+    CloseHandle(pi.hThread);
+    if (mode.shm) ShmClose(channel);
+    else closesocket(transport.sock);
+
+    if (!ok || rtts.empty()) return result;
+
+    std::sort(rtts.begin(), rtts.end());
+    result.ok = true;
+    result.rttP50Us = TicksToUs(rtts[rtts.size() / 2]);
+    result.rttP99Us = TicksToUs(rtts[(size_t)(rtts.size() * 0.99)]);
+    result.roundTripsPerSec = g_count / (TicksToUs(pingTicks) / 1000000.0);
+    result.streamMsgsPerSec = g_count / (TicksToUs(streamTicks) / 1000000.0);
+    result.streamMBps = result.streamMsgsPerSec * g_size / (1024.0 * 1024.0);
+    return result;
+}
+
+bool ParseArgs(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (strcmp(arg, "-count") == 0) {
+            g_count = atoi(value);
+        } else if (strcmp(arg, "-size") == 0) {
+            g_size = atoi(value);
+        } else if (strcmp(arg, "-spin") == 0) {
+            g_spin = atoi(value);
+        } else if (strcmp(arg, "-serve") == 0 || strcmp(arg, "-name") == 0) {
+            // 자식 프로세스용 (main 에서 처리)
+        } else {
+            return false;
+        }
+    }
+
+    if (g_count < 1) g_count = 1;
+    if (g_size < 1) g_size = 1;
+    if (g_size > MAX_MESSAGE_SIZE) g_size = MAX_MESSAGE_SIZE;
+    if (g_spin < 0) g_spin = 0;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+
+    const char* serveMode = NULL;
+    const char* shmName = "";
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "-serve") == 0) serveMode = argv[i + 1];
+        else if (strcmp(argv[i], "-name") == 0) shmName = argv[i + 1];
+    }
+
+    if (!ParseArgs(argc, argv)) {
+        printf("사용법: shm_bench.exe [-count n] [-size bytes] [-spin n]\n");
+        return 1;
+    }
+
+    QueryPerformanceFrequency(&g_qpcFreq);
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        SetColor(COLOR_RED);
+        printf("WSAStartup 실패\n");
+        return 1;
+    }
+
+    if (serveMode != NULL) {
+        int exitCode = RunServer(serveMode, shmName);
+        WSACleanup();
+        return exitCode;
+    }
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("  [공유 메모리 벤치마크] SHM Ring vs Loopback TCP\n");
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  메시지: %d개 × %d bytes | 링: %d KB × 2 | 스핀: %d\n",
+           g_count, g_size, SHM_RING_SIZE / 1024, g_spin);
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    const TransportMode modes[] = {
+        { "tcp",       false, 0 },
+        { "shm",       true,  g_spin },
+        { "shm-event", true,  0 },
+    };
+
+    std::vector<ShmResult> results;
+    printf("  %-10s %10s %10s %12s %12s %10s\n",
+           "transport", "p50(us)", "p99(us)", "rtt/s", "stream/s", "MB/s");
+    printf("  ─────────────────────────────────────────────────────────────────────\n");
+
+    for (const TransportMode& mode : modes) {
+        ShmResult r = RunMode(mode);
+        results.push_back(r);
+
+        if (!r.ok) {
+            SetColor(COLOR_RED);
+            printf("  %-10s  측정 실패\n", r.mode);
+            SetColor(COLOR_DEFAULT);
+            continue;
+        }
+
+        SetColor(COLOR_GREEN);
+        printf("  %-10s %10.2f %10.2f %12.0f %12.0f %10.1f\n",
+               r.mode, r.rttP50Us, r.rttP99Us, r.roundTripsPerSec, r.streamMsgsPerSec, r.streamMBps);
+        SetColor(COLOR_DEFAULT);
+    }
+
+    FILE* fp = NULL;
+    bool written = (fopen_s(&fp, "shm_report.csv", "w") == 0);
+    if (written) {
+        fprintf(fp, "transport,ok,size,count,rtt_p50_us,rtt_p99_us,round_trips_per_sec,"
+                    "stream_msgs_per_sec,stream_mbps\n");
+        for (const ShmResult& r : results) {
+            fprintf(fp, "%s,%d,%d,%d,%.3f,%.3f,%.1f,%.1f,%.2f\n",
+                    r.mode, r.ok ? 1 : 0, g_size, g_count, r.rttP50Us, r.rttP99Us,
+                    r.roundTripsPerSec, r.streamMsgsPerSec, r.streamMBps);
+        }
+        fclose(fp);
+    }
+
+    printf("\n");
+    SetColor(written ? COLOR_GREEN : COLOR_RED);
+    printf(written ? "리포트 저장: shm_report.csv\n" : "리포트 저장 실패\n");
+    SetColor(COLOR_DEFAULT);
+
+    WSACleanup();
+    return written ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+/*
+ * ============================================
+ *  공유 메모리 전송 (같은 호스트의 클라이언트 ↔ 서버)
+ * ============================================
+ *  - 이름 있는 파일 매핑(페이지 파일 기반) 하나에 SPSC 링 2개
+ *      ring[0]: 생성한 쪽 → 붙은 쪽,  ring[1]: 붙은 쪽 → 생성한 쪽
+ *  - 메시지 = [길이 4바이트][페이로드], head/tail 은 누적 바이트 수
+ *    생산자만 head를, 소비자만 tail을 쓴다 → 락 없음
+ *  - 깨우기: 먼저 스핀(spinCount) → 그래도 없으면 waiting 플래그를 세우고
+ *    이름 있는 이벤트에서 잠든다. 상대는 플래그가 서 있을 때만 SetEvent
+ *    → 바쁠 때는 커널 호출이 0번 (futex와 같은 아이디어, 프로세스 간이라 이벤트 사용)
+ *  - API는 send/recv 모양 그대로:
+ *      ShmSend(channel, data, len)  → len, 오류 -1
+ *      ShmRecv(channel, buf, len)   → 메시지 하나 (최대 len 바이트), 닫히면 0
+ *
+ *  사용처: shm_bench.cpp (loopback TCP 와 비교)
+ * ============================================
+ */
+
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SHM_RING_SIZE (1 << 20)             // 2의 거듭제곱
+#define SHM_MAX_MESSAGE (SHM_RING_SIZE / 4)
+#define SHM_DEFAULT_SPIN 4000
+#define SHM_CLOSE_POLL_MS 100               // 잠든 동안에도 closed를 이 간격으로 확인
+
+// head / tail / 플래그를 서로 다른 캐시 라인에 (생산자·소비자 false sharing 방지)
+struct ShmRing {
+    volatile LONG64 head;
+    char pad0[64 - sizeof(LONG64)];
+    volatile LONG64 tail;
+    char pad1[64 - sizeof(LONG64)];
+    volatile LONG consumerWaiting;  // 1 = 소비자가 데이터 이벤트에서 잠듦
+    volatile LONG producerWaiting;  // 1 = 링이 가득 차서 생산자가 공간 이벤트에서 잠듦
+    volatile LONG closed;
+    char pad2[64 - 3 * sizeof(LONG)];
+    char data[SHM_RING_SIZE];
+};
+
+struct ShmSegment {
+    ShmRing rings[2];
+};
+
+struct ShmChannel {
+    HANDLE mapping;
+    ShmSegment* segment;
+    ShmRing* tx;
+    ShmRing* rx;
+    HANDLE dataEvents[2];   // ring[i]에 데이터가 들어옴
+    HANDLE spaceEvents[2];  // ring[i]에 공간이 생김
+    int txIndex;
+    int rxIndex;
+    int spinCount;          // 0 = 스핀 없이 바로 이벤트 대기
+};
+
+inline void RingCopyIn(ShmRing* ring, LONG64 pos, const void* src, int len) {
+    size_t offset = (size_t)(pos & (SHM_RING_SIZE - 1));
+    size_t first = ((size_t)len < SHM_RING_SIZE - offset) ? (size_t)len : SHM_RING_SIZE - offset;
+    memcpy(ring->data + offset, src, first);
+    memcpy(ring->data, (const char*)src + first, len - first);
+}
+
+inline void RingCopyOut(ShmRing* ring, LONG64 pos, void* dst, int len) {
+    size_t offset = (size_t)(pos & (SHM_RING_SIZE - 1));
+    size_t first = ((size_t)len < SHM_RING_SIZE - offset) ? (size_t)len : SHM_RING_SIZE - offset;
+    memcpy(dst, ring->data + offset, first);
+    memcpy((char*)dst + first, ring->data, len - first);
+}
+
+// ready()가 참이 될 때까지: 스핀 → 플래그 세우고 재확인 → 이벤트 대기.
+// 플래그 세우기와 상대의 발행이 둘 다 Interlocked(전체 배리어)라서
+// "재확인은 비었는데 상대는 플래그를 못 봄" 이 동시에 일어날 수 없다 (깨우기 유실 없음).
+template <typename Ready>
+inline bool ShmWaitUntil(Ready ready, volatile LONG* waiting, HANDLE event,
+                         int spinCount, volatile LONG* closed) {
+    for (int i = 0; i < spinCount; i++) {
+        if (ready()) return true;
+        YieldProcessor();
+    }
+
+    while (1) {
+        InterlockedExchange(waiting, 1);
+        if (ready()) {
+            InterlockedExchange(waiting, 0);
+            return true;
+        }
+        if (*closed) {
+            InterlockedExchange(waiting, 0);
+            return false;
+        }
+        WaitForSingleObject(event, SHM_CLOSE_POLL_MS);
+        InterlockedExchange(waiting, 0);
+        if (ready()) return true;
+    }
+}
+
+inline void ShmWake(volatile LONG* waiting, HANDLE event) {
+    if (*waiting) SetEvent(event);
+}
+
+inline int ShmSend(ShmChannel& channel, const char* data, int len) {
+    if (len < 0 || len > SHM_MAX_MESSAGE) return -1;
+
+    ShmRing* ring = channel.tx;
+    LONG64 head = ring->head;   // head는 이 쪽만 쓴다
+    int need = (int)sizeof(int) + len;
+
+    auto hasSpace = [&]() { return SHM_RING_SIZE - (head - ring->tail) >= need; };
+    if (!ShmWaitUntil(hasSpace, &ring->producerWaiting, channel.spaceEvents[channel.txIndex],
+                      channel.spinCount, &ring->closed)) {
+        return -1;
+    }
+
+    RingCopyIn(ring, head, &len, sizeof(int));
+    RingCopyIn(ring, head + sizeof(int), data, len);
+    InterlockedExchange64(&ring->head, head + need);   // 발행: 여기서부터 소비자에게 보임
+    ShmWake(&ring->consumerWaiting, channel.dataEvents[channel.txIndex]);
+    return len;
+}
+
+// len보다 긴 메시지는 잘린다 (나머지는 버림)
+inline int ShmRecv(ShmChannel& channel, char* buffer, int len) {
+    ShmRing* ring = channel.rx;
+    LONG64 tail = ring->tail;   // tail은 이 쪽만 쓴다
+
+    auto hasData = [&]() { return ring->head != tail; };
+    if (!ShmWaitUntil(hasData, &ring->consumerWaiting, channel.dataEvents[channel.rxIndex],
+                      channel.spinCount, &ring->closed)) {
+        return 0;
+    }
+
+    int messageLen = 0;
+    RingCopyOut(ring, tail, &messageLen, sizeof(int));
+    int copyLen = (messageLen < len) ? messageLen : len;
+    RingCopyOut(ring, tail + sizeof(int), buffer, copyLen);
+    InterlockedExchange64(&ring->tail, tail + sizeof(int) + messageLen);
+    ShmWake(&ring->producerWaiting, channel.spaceEvents[channel.rxIndex]);
+    return copyLen;
+}
+
+// create = true: 세그먼트/이벤트를 만든다 (tx = ring[0]), false: 붙는다 (tx = ring[1])
+inline bool ShmOpen(ShmChannel& channel, const char* name, bool create, int spinCount) {
+    memset(&channel, 0, sizeof(channel));
+    channel.spinCount = spinCount;
+    channel.txIndex = create ? 0 : 1;
+    channel.rxIndex = create ? 1 : 0;
+
+    char objectName[128];
+    sprintf_s(objectName, "Local\\%s_segment", name);
+    if (create) {
+        channel.mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                             0, sizeof(ShmSegment), objectName);
+    } else {
+        channel.mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, objectName);
+    }
+    if (channel.mapping == NULL) return false;
+
+    // 새 매핑은 0으로 채워져 있으므로 head/tail/플래그 초기화 불필요
+    channel.segment = (ShmSegment*)MapViewOfFile(channel.mapping, FILE_MAP_ALL_ACCESS,
+                                                 0, 0, sizeof(ShmSegment));
+    if (channel.segment == NULL) return false;
+
+    for (int i = 0; i < 2; i++) {
+        char dataName[128];
+        char spaceName[128];
+        sprintf_s(dataName, "Local\\%s_data%d", name, i);
+        sprintf_s(spaceName, "Local\\%s_space%d", name, i);
+        if (create) {
+            channel.dataEvents[i] = CreateEventA(NULL, FALSE, FALSE, dataName);
+            channel.spaceEvents[i] = CreateEventA(NULL, FALSE, FALSE, spaceName);
+        } else {
+            channel.dataEvents[i] = OpenEventA(EVENT_ALL_ACCESS, FALSE, dataName);
+            channel.spaceEvents[i] = OpenEventA(EVENT_ALL_ACCESS, FALSE, spaceName);
+        }
+        if (channel.dataEvents[i] == NULL || channel.spaceEvents[i] == NULL) return false;
+    }
+
+    channel.tx = &channel.segment->rings[channel.txIndex];
+    channel.rx = &channel.segment->rings[channel.rxIndex];
+    return true;
+}
+
+// 양쪽 링을 닫고 잠든 상대를 깨운다 (recv는 남은 메시지를 다 읽은 뒤 0 반환)
+inline void ShmClose(ShmChannel& channel) {
+    if (channel.segment != NULL) {
+        for (int i = 0; i < 2; i++) {
+            InterlockedExchange(&channel.segment->rings[i].closed, 1);
+            SetEvent(channel.dataEvents[i]);
+            SetEvent(channel.spaceEvents[i]);
+        }
+        UnmapViewOfFile(channel.segment);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (channel.dataEvents[i] != NULL) CloseHandle(channel.dataEvents[i]);
+        if (channel.spaceEvents[i] != NULL) CloseHandle(channel.spaceEvents[i]);
+    }
+    if (channel.mapping != NULL) CloseHandle(channel.mapping);
+    memset(&channel, 0, sizeof(channel));
+}
@@ -0,0 +1,414 @@
+/*
+ * ============================================
+ *  연결 유지 소크 테스트: 100만 연결 × 연결당 메모리
+ * ============================================
+ *  IOCP 서버(04)를 띄우고 루프백으로 연결을 잔뜩 맺어 놓은 뒤
+ *  서버 프로세스 메모리를 연결 수로 나눈다. 대부분의 연결은 아무것도 하지 않고,
+ *  일부(-active)만 파이프라인 요청("PING\n")을 계속 보낸다.
+ *
+ *  모드:
+ *    lean    기본 04: 연결 상태만 두고 수신 버퍼는 읽는 동안만 풀에서 (buffer_pool.h)
+ *    eager   04 -eager-buffer: 연결마다 버퍼를 accept 때 붙여서 끝까지 (분리 전 방식)
+ *
+ *  측정 (모드마다):
+ *  - 연결 단계: 맺은 연결 수, 걸린 시간
+ *  - RSS/연결 : (연결 후 WorkingSet - 시작 시 WorkingSet) / 연결 수
+ *               private(커밋) 바이트도 같이 (페이지가 밀려나도 남는 값)
+ *  - 활동 단계: 활동 연결이 요청을 보내는 동안의 RSS/연결, 왕복/s
+ *  커널 쪽 소켓 메모리(non-paged pool)는 서버 프로세스 RSS 에 잡히지 않는다.
+ *
+ *  소스 IP 여러 개:
+ *    목적지(127.0.0.1:9003)가 하나라서 소스 IP 하나로는 임시 포트 수
+ *    (기본 49152~65535 = 16384개)만큼만 연결할 수 있다. 127.0.0.2 부터 -ips 개의
+ *    루프백 주소에 bind 하고 SO_REUSE_UNICASTPORT 로 포트를 주소마다 따로 쓴다.
+ *    100만 = 64개 × 16384. 포트 범위를 넓히면 IP 수를 줄일 수 있다:
+ *      netsh int ipv4 set dynamicport tcp start=10000 num=55535
+ *  클라이언트 소켓 100만 개도 같은 머신의 non-paged pool 을 쓴다 (메모리 넉넉한 머신에서).
+ *
+ *  사용법:
+ *    soak_bench.exe [-modes list] [-conns n] [-ips n] [-active n] [-seconds s]
+ *
+ *  옵션:
+ *    -modes list   lean,eager (기본 전부)
+ *    -conns n      맺을 연결 수 (기본 1000000)
+ *    -ips n        소스 루프백 IP 수 (기본 64)
+ *    -active n     요청을 보내는 연결 수 (기본 1000)
+ *    -seconds s    활동 단계 길이 (기본 30)
+ * ============================================
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <psapi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include "bench_process.h"
+
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "psapi.lib")
+
+#define SERVER_EXE "04_iocp_server.exe"
+#define SERVER_PORT 9003
+#define SETTLE_MS 2000
+#define MAX_CONNECT_FAILURES 1000     // 연속으로 이만큼 실패하면 한계로 보고 멈춘다
+#define PROGRESS_STEP 50000
+
+#ifndef SO_REUSE_UNICASTPORT
+#define SO_REUSE_UNICASTPORT 0x3007
+#endif
+#ifndef SO_PORT_SCALABILITY
+#define SO_PORT_SCALABILITY 0x3006
+#endif
+
+// 콘솔 색상
+void SetColor(int color) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+}
+
+#define COLOR_DEFAULT 7
+#define COLOR_GREEN 10
+#define COLOR_YELLOW 14
+#define COLOR_CYAN 11
+#define COLOR_RED 12
+
+struct SoakMode {
+    const char* name;
+    const char* extraArgs;
+};
+
+static const SoakMode g_modes[] = {
+    { "lean",  "" },
+    { "eager", "-eager-buffer" },
+};
+static const int g_modeCount = sizeof(g_modes) / sizeof(g_modes[0]);
+
+// 옵션
+static std::vector<const SoakMode*> g_selectedModes;
+static int g_connCount = 1000000;
+static int g_ipCount = 64;
+static int g_activeCount = 1000;
+static int g_seconds = 30;
+
+// ============================================
+//  서버 프로세스
+// ============================================
+
+struct MemorySample {
+    double workingSet;      // RSS
+    double privateBytes;    // 커밋
+};
+
+MemorySample SampleMemory(HANDLE process) {
+    MemorySample sample = { 0, 0 };
+    PROCESS_MEMORY_COUNTERS_EX counters;
+    if (GetProcessMemoryInfo(process, (PROCESS_MEMORY_COUNTERS*)&counters, sizeof(counters))) {
+        sample.workingSet = (double)counters.WorkingSetSize;
+        sample.privateBytes = (double)counters.PrivateUsage;
+    }
+    return sample;
+}
+
+// sourceIndex < 0 = 소스 주소 지정 없음
+SOCKET ConnectServer(int sourceIndex) {
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) return INVALID_SOCKET;
+
+    if (sourceIndex >= 0) {
+        // 임시 포트를 소스 주소마다 따로 (없는 버전이면 무시되고 전역 포트를 나눠 쓴다)
+        DWORD enable = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSE_UNICASTPORT, (const char*)&enable, sizeof(enable));
+        setsockopt(sock, SOL_SOCKET, SO_PORT_SCALABILITY, (const char*)&enable, sizeof(enable));
+
+        sockaddr_in local;
+        memset(&local, 0, sizeof(local));
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(0x7F000002 + sourceIndex);   // 127.0.0.2 ~
+        if (bind(sock, (sockaddr*)&local, sizeof(local)) == SOCKET_ERROR) {
+            closesocket(sock);
+            return INVALID_SOCKET;
+        }
+    }
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(SERVER_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    if (connect(sock, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) {
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    return sock;
+}
+
+bool LaunchServer(const SoakMode& mode, PROCESS_INFORMATION& pi) {
+    char commandLine[256];
+    sprintf_s(commandLine, "%s -work 0 %s", SERVER_EXE, mode.extraArgs);
+    return LaunchAndProbe(commandLine, SERVER_PORT, pi, ProbeConnect);
+}
+
+// ============================================
+//  클라이언트
+// ============================================
+
+// 파이프라인 요청 하나 → "OK\n" (연결은 유지)
+bool PingOnce(SOCKET sock) {
+    const char* request = "PING\n";
+    if (send(sock, request, 5, 0) == SOCKET_ERROR) return false;
+
+    char reply[8];
+    int received = 0;
+    while (received < 3) {
+        int n = recv(sock, reply + received, 3 - received, 0);
+        if (n <= 0) return false;
+        received += n;
+    }
+    return memcmp(reply, "OK\n", 3) == 0;
+}
+
+// ============================================
+//  측정
+// ============================================
+
+struct SoakResult {
+    std::string mode;
+    bool serverStarted;
+    int connected;
+    int connectFailures;
+    double connectSeconds;
+    double baseMB;
+    double rssMB;
+    double rssPerConn;
+    double privatePerConn;
+    double activeRssPerConn;
+    double roundTripsPerSec;
+    int pingErrors;
+};
+
+SoakResult RunOne(const SoakMode& mode) {
+    SoakResult result = {};
+    result.mode = mode.name;
+
+    PROCESS_INFORMATION pi;
+    if (!LaunchServer(mode, pi)) return result;
+    result.serverStarted = true;
+
+    Sleep(500);
+    MemorySample base = SampleMemory(pi.hProcess);
+    result.baseMB = base.workingSet / (1024.0 * 1024.0);
+
+    // 연결 단계: 소스 IP 를 돌아가며
+    std::vector<SOCKET> sockets;
+    sockets.reserve(g_connCount);
+    int consecutiveFailures = 0;
+    double startSec = NowSec();
+    for (int i = 0; i < g_connCount && consecutiveFailures < MAX_CONNECT_FAILURES; i++) {
+        SOCKET sock = ConnectServer(i % g_ipCount);
+        if (sock == INVALID_SOCKET) {
+            result.connectFailures++;
+            consecutiveFailures++;
+            continue;
+        }
+        consecutiveFailures = 0;
+        sockets.push_back(sock);
+
+        if (sockets.size() % PROGRESS_STEP == 0) {
+            printf("\r  %-6s 연결 %zu / %d ...", mode.name, sockets.size(), g_connCount);
+            fflush(stdout);
+        }
+    }
+    result.connectSeconds = NowSec() - startSec;
+    result.connected = (int)sockets.size();
+    printf("\r%60s\r", "");
+
+    // 서버가 accept 를 다 따라잡을 때까지
+    Sleep(SETTLE_MS);
+    MemorySample idle = SampleMemory(pi.hProcess);
+    result.rssMB = idle.workingSet / (1024.0 * 1024.0);
+    if (result.connected > 0) {
+        result.rssPerConn = (idle.workingSet - base.workingSet) / result.connected;
+        result.privatePerConn = (idle.privateBytes - base.privateBytes) / result.connected;
+    }
+
+    // 활동 단계: 전체에 고르게 흩어진 연결만 요청을 보낸다
+    int activeCount = (g_activeCount < result.connected) ? g_activeCount : result.connected;
+    if (activeCount > 0) {
+        int stride = result.connected / activeCount;
+        long long roundTrips = 0;
+        double peakWorkingSet = idle.workingSet;
+        double endSec = NowSec() + g_seconds;
+        double nextSample = NowSec() + 1.0;
+        startSec = NowSec();
+
+        while (NowSec() < endSec) {
+            for (int a = 0; a < activeCount; a++) {
+                SOCKET& sock = sockets[(size_t)a * stride];
+                if (sock == INVALID_SOCKET) continue;
+                if (PingOnce(sock)) {
+                    roundTrips++;
+                } else {
+                    result.pingErrors++;
+                    closesocket(sock);
+                    sock = INVALID_SOCKET;
+                }
+            }
+            if (NowSec() >= nextSample) {
+                MemorySample now = SampleMemory(pi.hProcess);
+                if (now.workingSet > peakWorkingSet) peakWorkingSet = now.workingSet;
+                nextSample += 1.0;
+            }
+        }
+
+        result.roundTripsPerSec = roundTrips / (NowSec() - startSec);
+        result.activeRssPerConn = (peakWorkingSet - base.workingSet) / result.connected;
+    }
+
+    for (SOCKET sock : sockets) {
+        if (sock != INVALID_SOCKET) closesocket(sock);
+    }
+    StopServer(pi);
+    return result;
+}
+
+bool WriteCsv(const std::vector<SoakResult>& results, const char* path) {
+    FILE* fp = NULL;
+    if (fopen_s(&fp, path, "w") != 0) return false;
+
+    fprintf(fp, "mode,server_started,target_conns,source_ips,connected,connect_failures,connect_seconds,"
+                "base_mb,rss_mb,rss_bytes_per_conn,private_bytes_per_conn,active_conns,"
+                "active_rss_bytes_per_conn,round_trips_per_sec,ping_errors\n");
+    for (const SoakResult& r : results) {
+        fprintf(fp, "%s,%d,%d,%d,%d,%d,%.2f,%.1f,%.1f,%.1f,%.1f,%d,%.1f,%.1f,%d\n",
+                r.mode.c_str(), r.serverStarted ? 1 : 0, g_connCount, g_ipCount,
+                r.connected, r.connectFailures, r.connectSeconds, r.baseMB, r.rssMB,
+                r.rssPerConn, r.privatePerConn, g_activeCount, r.activeRssPerConn,
+                r.roundTripsPerSec, r.pingErrors);
+    }
+    fclose(fp);
+    return true;
+}
+
+bool ParseModes(const char* text) {
+    g_selectedModes.clear();
+    std::string list = text;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        std::string name = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+
+        const SoakMode* found = NULL;
+        for (int i = 0; i < g_modeCount; i++) {
+            if (name == g_modes[i].name) found = &g_modes[i];
+        }
+        if (found == NULL) {
+            SetColor(COLOR_RED);
+            printf("알 수 없는 모드: %s\n", name.c_str());
+            SetColor(COLOR_DEFAULT);
+            return false;
+        }
+        g_selectedModes.push_back(found);
+
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    return true;
+}
+
+bool ParseArgs(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (strcmp(arg, "-modes") == 0) {
+            if (!ParseModes(value)) return false;
+        } else if (strcmp(arg, "-conns") == 0) {
+            g_connCount = atoi(value);
+        } else if (strcmp(arg, "-ips") == 0) {
+            g_ipCount = atoi(value);
+        } else if (strcmp(arg, "-active") == 0) {
+            g_activeCount = atoi(value);
+        } else if (strcmp(arg, "-seconds") == 0) {
+            g_seconds = atoi(value);
+        } else {
+            return false;
+        }
+    }
+
+    if (g_connCount < 1) g_connCount = 1;
+    if (g_ipCount < 1) g_ipCount = 1;
+    if (g_ipCount > 250) g_ipCount = 250;     // 127.0.0.2 ~ 127.0.0.251
+    if (g_activeCount < 0) g_activeCount = 0;
+    if (g_seconds < 1) g_seconds = 1;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+
+    for (int i = 0; i < g_modeCount; i++) g_selectedModes.push_back(&g_modes[i]);
+    if (!ParseArgs(argc, argv)) {
+        printf("사용법: soak_bench.exe [-modes list] [-conns n] [-ips n] [-active n] [-seconds s]\n");
+        return 1;
+    }
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("  [소크 테스트] 유휴 연결 %d개 × 연결당 서버 메모리\n", g_connCount);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  서버: %s | 소스 IP 127.0.0.2 ~ %d개 | 활동 연결 %d개 × %d초\n",
+           SERVER_EXE, g_ipCount, g_activeCount, g_seconds);
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        SetColor(COLOR_RED);
+        printf("WSAStartup 실패\n");
+        return 1;
+    }
+
+    std::vector<SoakResult> results;
+    printf("  %-6s %9s %8s %9s %10s %12s %12s %10s\n",
+           "mode", "연결", "연결(s)", "RSS MB", "RSS B/연결", "private B/연결", "활동 B/연결", "왕복/s");
+    printf("  ──────────────────────────────────────────────────────────────────────────────────\n");
+
+    for (const SoakMode* mode : g_selectedModes) {
+        SoakResult r = RunOne(*mode);
+        results.push_back(r);
+
+        if (!r.serverStarted) {
+            SetColor(COLOR_RED);
+            printf("  %-6s  서버 실행 실패 (%s)\n", r.mode.c_str(), SERVER_EXE);
+            SetColor(COLOR_DEFAULT);
+            continue;
+        }
+
+        bool complete = (r.connected == g_connCount && r.pingErrors == 0);
+        SetColor(complete ? COLOR_GREEN : COLOR_YELLOW);
+        printf("  %-6s %9d %8.1f %9.1f %10.0f %12.0f %12.0f %10.0f",
+               r.mode.c_str(), r.connected, r.connectSeconds, r.rssMB, r.rssPerConn,
+               r.privatePerConn, r.activeRssPerConn, r.roundTripsPerSec);
+        if (r.connected < g_connCount) printf(" (연결 실패 %d, 포트/메모리 한계?)", r.connectFailures);
+        if (r.pingErrors > 0) printf(" (요청 실패 %d)", r.pingErrors);
+        printf("\n");
+        SetColor(COLOR_DEFAULT);
+    }
+
+    bool written = WriteCsv(results, "soak_report.csv");
+
+    printf("\n");
+    SetColor(written ? COLOR_GREEN : COLOR_RED);
+    printf(written ? "리포트 저장: soak_report.csv\n" : "리포트 저장 실패\n");
+    SetColor(COLOR_DEFAULT);
+
+    WSACleanup();
+    return written ? 0 : 1;
+}
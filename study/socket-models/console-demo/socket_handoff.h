@@ -0,0 +1,138 @@
+/*
+ * ============================================
+ *  Socket handoff between processes (zero-downtime restart)
+ * ============================================
+ *  The running server listens on a named pipe. A new server process
+ *  started with -takeover connects to it and receives:
+ *    - the listen socket
+ *    - every idle established connection + its per-session state
+ *  as WSADuplicateSocket() blobs (the Windows counterpart of SCM_RIGHTS).
+ *
+ *  Protocol (one pipe connection):
+ *    new -> old   HandoffHello  { pid }
+ *    old -> new   server-specific header, listen socket, N x (socket, state)
+ *    new -> old   1-byte ack after WSASocket() has been called for every blob
+ *  Only after the ack may the old process close its handles: the socket
+ *  lives on until the last descriptor is closed, but a blob whose source
+ *  is closed before the target opens it is useless.
+ *
+ *  Used by: 02_select_server.cpp (-takeover)
+ * ============================================
+ */
+
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winsock2.h>
+#include <stdio.h>
+#include <process.h>
+
+#define HANDOFF_PIPE_FORMAT "\\\\.\\pipe\\socket_demo_handoff_%d"
+#define HANDOFF_CONNECT_TIMEOUT_MS 5000
+#define HANDOFF_ACK 'A'
+
+struct HandoffHello {
+    DWORD pid;
+};
+
+// Filled in by the listener thread, polled by the server's main loop
+struct HandoffListener {
+    int port;
+    HANDLE pipe;
+    volatile LONG connected;    // 1 = a new process is waiting on 'pipe'
+};
+
+inline bool PipeWriteAll(HANDLE pipe, const void* data, DWORD len) {
+    const char* cursor = (const char*)data;
+    while (len > 0) {
+        DWORD written = 0;
+        if (!WriteFile(pipe, cursor, len, &written, NULL)) return false;
+        cursor += written;
+        len -= written;
+    }
+    return true;
+}
+
+inline bool PipeReadAll(HANDLE pipe, void* data, DWORD len) {
+    char* cursor = (char*)data;
+    while (len > 0) {
+        DWORD read = 0;
+        if (!ReadFile(pipe, cursor, len, &read, NULL) || read == 0) return false;
+        cursor += read;
+        len -= read;
+    }
+    return true;
+}
+
+inline void HandoffPipeName(char* name, size_t size, int port) {
+    sprintf_s(name, size, HANDOFF_PIPE_FORMAT, port);
+}
+
+// Waits for one takeover request, then hands the pipe to the main loop
+inline unsigned int __stdcall HandoffListenThread(void* arg) {
+    HandoffListener* listener = (HandoffListener*)arg;
+
+    char name[64];
+    HandoffPipeName(name, sizeof(name), listener->port);
+
+    // Unlimited instances: the successor creates its own listener while
+    // this instance may still be open
+    HANDLE pipe = CreateNamedPipeA(name, PIPE_ACCESS_DUPLEX, PIPE_TYPE_BYTE | PIPE_WAIT,
+                                   PIPE_UNLIMITED_INSTANCES, 4096, 4096, 0, NULL);
+    if (pipe == INVALID_HANDLE_VALUE) return 1;
+
+    if (!ConnectNamedPipe(pipe, NULL) && GetLastError() != ERROR_PIPE_CONNECTED) {
+        CloseHandle(pipe);
+        return 1;
+    }
+
+    listener->pipe = pipe;
+    InterlockedExchange(&listener->connected, 1);
+    return 0;
+}
+
+inline bool HandoffStartListener(HandoffListener& listener, int port) {
+    listener.port = port;
+    listener.pipe = INVALID_HANDLE_VALUE;
+    listener.connected = 0;
+
+    HANDLE thread = (HANDLE)_beginthreadex(NULL, 0, HandoffListenThread, &listener, 0, NULL);
+    if (thread == NULL) return false;
+    CloseHandle(thread);
+    return true;
+}
+
+// New process side: connect to the running server's pipe and introduce ourselves
+inline HANDLE HandoffConnect(int port) {
+    char name[64];
+    HandoffPipeName(name, sizeof(name), port);
+
+    ULONGLONG deadline = GetTickCount64() + HANDOFF_CONNECT_TIMEOUT_MS;
+    while (GetTickCount64() < deadline) {
+        HANDLE pipe = CreateFileA(name, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+        if (pipe != INVALID_HANDLE_VALUE) {
+            HandoffHello hello = { GetCurrentProcessId() };
+            if (PipeWriteAll(pipe, &hello, sizeof(hello))) return pipe;
+            CloseHandle(pipe);
+            return INVALID_HANDLE_VALUE;
+        }
+        if (GetLastError() == ERROR_PIPE_BUSY) WaitNamedPipeA(name, 100);
+        else Sleep(50);
+    }
+    return INVALID_HANDLE_VALUE;
+}
+
+inline bool HandoffSendSocket(HANDLE pipe, SOCKET socket, DWORD targetPid) {
+    WSAPROTOCOL_INFOW info;
+    if (WSADuplicateSocketW(socket, targetPid, &info) == SOCKET_ERROR) return false;
+    return PipeWriteAll(pipe, &info, sizeof(info));
+}
+
+inline SOCKET HandoffRecvSocket(HANDLE pipe) {
+    WSAPROTOCOL_INFOW info;
+    if (!PipeReadAll(pipe, &info, sizeof(info))) return INVALID_SOCKET;
+    return WSASocketW(FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, &info, 0, 0);
+}
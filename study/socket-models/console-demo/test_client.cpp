@@ -3,13 +3,20 @@
  *  테스트 클라이언트
  * ============================================
  *  사용법:
- *    test_client.exe [포트] [클라이언트수]
+ *    test_client.exe [포트] [클라이언트수] [-pipeline n] [-requests m]
+ *
+ *  옵션:
+ *    -pipeline n    파이프라인 모드: 연결 하나에 요청을 최대 n개까지 띄워 둔다
+ *                   (응답을 기다리지 않고 이어 보냄, 요청은 '\n' 으로 구분, pipeline.h)
+ *    -requests m    파이프라인 모드에서 연결당 요청 수 (기본 100)
  *
  *  예:
  *    test_client.exe 9000 5   (동기 서버 테스트)
  *    test_client.exe 9001 5   (Select 서버 테스트)
  *    test_client.exe 9002 5   (Overlapped 서버 테스트)
  *    test_client.exe 9003 5   (IOCP 서버 테스트)
+ *    test_client.exe 9003 4 -pipeline 16 -requests 200
+ *      (IOCP 서버 -work 0: 연결 4개 × 요청 200개, 연결마다 16개씩 겹쳐서)
  * ============================================
  */
 
@@ -19,11 +26,14 @@
 #include <ws2tcpip.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <process.h>
 
 #pragma comment(lib, "ws2_32.lib")
 
 #define BUFFER_SIZE 1024
+#define MAX_PIPELINE_DEPTH 256
+#define MAX_REQUEST_LINE 32
 
 // 콘솔 색상
 void SetColor(int color) {
@@ -42,6 +52,12 @@ static CRITICAL_SECTION g_cs;
 static int g_completedCount = 0;
 static int g_totalClients = 0;
 
+// 파이프라인 모드 (-pipeline)
+static int g_pipelineDepth = 0;         // 0 = 기존 방식 (연결당 요청 1개)
+static int g_requestsPerClient = 100;
+static long long g_totalRequests = 0;
+static long long g_totalRecvCalls = 0;
+
 void PrintTime() {
     ULONGLONG elapsed = GetTickCount64() - g_startTick;
     printf("[%02llu:%02llu.%03llu] ",
@@ -50,20 +66,21 @@ void PrintTime() {
            elapsed % 1000);
 }
 
-// 클라이언트 스레드
-unsigned int __stdcall ClientThread(void* arg) {
-    int clientId = (int)(intptr_t)arg;
-    ULONGLONG connectTime = GetTickCount64();
+void PrintClientError(int clientId, const char* message) {
+    EnterCriticalSection(&g_cs);
+    SetColor(COLOR_RED);
+    PrintTime();
+    printf("Client %d: %s\n", clientId, message);
+    SetColor(COLOR_DEFAULT);
+    LeaveCriticalSection(&g_cs);
+}
 
+// 서버 연결 (실패하면 INVALID_SOCKET)
+SOCKET ConnectToServer(int clientId) {
     SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
     if (sock == INVALID_SOCKET) {
-        EnterCriticalSection(&g_cs);
-        SetColor(COLOR_RED);
-        PrintTime();
-        printf("Client %d: 소켓 생성 실패\n", clientId);
-        SetColor(COLOR_DEFAULT);
-        LeaveCriticalSection(&g_cs);
-        return 1;
+        PrintClientError(clientId, "소켓 생성 실패");
+        return INVALID_SOCKET;
     }
 
     sockaddr_in serverAddr;
@@ -73,14 +90,9 @@ unsigned int __stdcall ClientThread(void* arg) {
 
     // 서버에 연결
     if (connect(sock, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
-        EnterCriticalSection(&g_cs);
-        SetColor(COLOR_RED);
-        PrintTime();
-        printf("Client %d: 연결 실패\n", clientId);
-        SetColor(COLOR_DEFAULT);
-        LeaveCriticalSection(&g_cs);
+        PrintClientError(clientId, "연결 실패");
         closesocket(sock);
-        return 1;
+        return INVALID_SOCKET;
     }
 
     EnterCriticalSection(&g_cs);
@@ -89,18 +101,23 @@ unsigned int __stdcall ClientThread(void* arg) {
     printf("Client %d: 서버 연결 성공!\n", clientId);
     SetColor(COLOR_DEFAULT);
     LeaveCriticalSection(&g_cs);
+    return sock;
+}
+
+// 클라이언트 스레드
+unsigned int __stdcall ClientThread(void* arg) {
+    int clientId = (int)(intptr_t)arg;
+    ULONGLONG connectTime = GetTickCount64();
+
+    SOCKET sock = ConnectToServer(clientId);
+    if (sock == INVALID_SOCKET) return 1;
 
     // 데이터 전송
     char sendBuffer[BUFFER_SIZE];
     sprintf_s(sendBuffer, "Hello from Client %d", clientId);
 
     if (send(sock, sendBuffer, (int)strlen(sendBuffer), 0) == SOCKET_ERROR) {
-        EnterCriticalSection(&g_cs);
-        SetColor(COLOR_RED);
-        PrintTime();
-        printf("Client %d: 전송 실패\n", clientId);
-        SetColor(COLOR_DEFAULT);
-        LeaveCriticalSection(&g_cs);
+        PrintClientError(clientId, "전송 실패");
         closesocket(sock);
         return 1;
     }
@@ -141,15 +158,85 @@ unsigned int __stdcall ClientThread(void* arg) {
         }
         LeaveCriticalSection(&g_cs);
     } else {
-        EnterCriticalSection(&g_cs);
-        SetColor(COLOR_RED);
-        PrintTime();
-        printf("Client %d: 응답 수신 실패\n", clientId);
-        SetColor(COLOR_DEFAULT);
-        LeaveCriticalSection(&g_cs);
+        PrintClientError(clientId, "응답 수신 실패");
+    }
+
+    closesocket(sock);
+    return 0;
+}
+
+// 파이프라인 클라이언트: 응답을 기다리지 않고 요청을 g_pipelineDepth 개까지 띄워 둔다.
+// 빈 자리만큼 요청 줄을 모아서 send 한 번 → 서버 recv 버퍼에 요청 여러 개가 한꺼번에 쌓인다.
+// recv 한 번에 받은 응답 수 = 서버가 응답을 얼마나 묶어 보냈는지.
+unsigned int __stdcall PipelinedClientThread(void* arg) {
+    int clientId = (int)(intptr_t)arg;
+    ULONGLONG connectTime = GetTickCount64();
+
+    SOCKET sock = ConnectToServer(clientId);
+    if (sock == INVALID_SOCKET) return 1;
+
+    char sendBuffer[MAX_PIPELINE_DEPTH * MAX_REQUEST_LINE];
+    char recvBuffer[BUFFER_SIZE];
+    int sent = 0;
+    int answered = 0;
+    int recvCalls = 0;
+
+    while (answered < g_requestsPerClient) {
+        int offset = 0;
+        while (sent < g_requestsPerClient && sent - answered < g_pipelineDepth) {
+            sent++;
+            offset += sprintf_s(sendBuffer + offset, sizeof(sendBuffer) - offset,
+                                "Req %d-%d\n", clientId, sent);
+        }
+        if (offset > 0 && send(sock, sendBuffer, offset, 0) == SOCKET_ERROR) {
+            PrintClientError(clientId, "전송 실패");
+            break;
+        }
+
+        int bytesReceived = recv(sock, recvBuffer, BUFFER_SIZE, 0);
+        if (bytesReceived <= 0) {
+            PrintClientError(clientId, "응답 수신 실패");
+            break;
+        }
+        recvCalls++;
+        for (int i = 0; i < bytesReceived; i++) {
+            if (recvBuffer[i] == '\n') answered++;
+        }
     }
 
+    // 보낼 쪽을 닫으면 서버가 recv 0 을 보고 연결을 정리한다
+    shutdown(sock, SD_SEND);
     closesocket(sock);
+
+    if (answered < g_requestsPerClient) return 1;
+
+    ULONGLONG elapsed = GetTickCount64() - connectTime;
+
+    EnterCriticalSection(&g_cs);
+    g_completedCount++;
+    g_totalRequests += answered;
+    g_totalRecvCalls += recvCalls;
+    SetColor(COLOR_GREEN);
+    PrintTime();
+    printf("Client %d: 응답 %d개 수신 (소요시간: %llu ms, recv %d회 → 회당 %.1f개)\n",
+           clientId, answered, elapsed, recvCalls, answered / (double)recvCalls);
+    SetColor(COLOR_DEFAULT);
+
+    // 모두 완료 체크
+    if (g_completedCount == g_totalClients) {
+        ULONGLONG totalElapsed = GetTickCount64() - g_startTick;
+        printf("\n");
+        SetColor(COLOR_YELLOW);
+        printf("═══════════════════════════════════════════════════════════════\n");
+        printf("  모든 클라이언트 처리 완료! (파이프라인 깊이 %d)\n", g_pipelineDepth);
+        printf("  총 요청: %lld (클라이언트 %d × %d)\n", g_totalRequests, g_totalClients, g_requestsPerClient);
+        printf("  총 소요시간: %.2f초\n", totalElapsed / 1000.0);
+        printf("  처리량: %.2f req/sec\n", g_totalRequests * 1000.0 / totalElapsed);
+        printf("  recv 당 응답: %.1f개\n", g_totalRequests / (double)g_totalRecvCalls);
+        printf("═══════════════════════════════════════════════════════════════\n");
+        SetColor(COLOR_DEFAULT);
+    }
+    LeaveCriticalSection(&g_cs);
     return 0;
 }
 
@@ -160,12 +247,22 @@ int main(int argc, char* argv[]) {
     g_port = 9000;
     g_totalClients = 5;
 
-    if (argc >= 2) {
-        g_port = atoi(argv[1]);
-    }
-    if (argc >= 3) {
-        g_totalClients = atoi(argv[2]);
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-pipeline") == 0 && i + 1 < argc) {
+            g_pipelineDepth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-requests") == 0 && i + 1 < argc) {
+            g_requestsPerClient = atoi(argv[++i]);
+        } else if (positional == 0) {
+            g_port = atoi(argv[i]);
+            positional++;
+        } else if (positional == 1) {
+            g_totalClients = atoi(argv[i]);
+            positional++;
+        }
     }
+    if (g_pipelineDepth > MAX_PIPELINE_DEPTH) g_pipelineDepth = MAX_PIPELINE_DEPTH;
+    if (g_requestsPerClient < 1) g_requestsPerClient = 1;
 
     printf("\n");
     SetColor(COLOR_CYAN);
@@ -175,6 +272,9 @@ int main(int argc, char* argv[]) {
     SetColor(COLOR_DEFAULT);
     printf("  서버 포트: %d\n", g_port);
     printf("  클라이언트 수: %d\n", g_totalClients);
+    if (g_pipelineDepth > 0) {
+        printf("  파이프라인: 연결당 요청 %d개, 최대 %d개 동시 진행\n", g_requestsPerClient, g_pipelineDepth);
+    }
     printf("═══════════════════════════════════════════════════════════════\n\n");
 
     InitializeCriticalSection(&g_cs);
@@ -198,7 +298,8 @@ int main(int argc, char* argv[]) {
 
     for (int i = 0; i < g_totalClients; i++) {
         threads[i] = (HANDLE)_beginthreadex(
-            NULL, 0, ClientThread, (void*)(intptr_t)(i + 1), 0, NULL);
+            NULL, 0, (g_pipelineDepth > 0) ? PipelinedClientThread : ClientThread,
+            (void*)(intptr_t)(i + 1), 0, NULL);
 
         // 약간의 딜레이 (동시 접속 시뮬레이션)
         Sleep(50);
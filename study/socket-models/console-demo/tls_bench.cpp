@@ -0,0 +1,356 @@
+/*
+ * ============================================
+ *  TLS 비용 벤치마크 (평문 vs 사용자 공간 TLS)
+ * ============================================
+ *  04_iocp_server를 -tls 없이 / -tls로 각각 띄워서
+ *  암호화가 모델에 얹는 비용을 분리해서 본다.
+ *
+ *  측정 항목 (모드마다):
+ *  1. 연결 처리율   : 연결 → (TLS 핸드셰이크) → 요청 → 응답 → 종료 반복
+ *                     → conn/s, 서버 CPU us/연결 (핸드셰이크 = RSA 서명 + ECDHE)
+ *  2. 대량 전송     : "BULK <bytes>" 한 번 → MB/s, 서버 CPU ms/MB
+ *                     (레코드 단위 EncryptMessage + send 복사)
+ *
+ *  kTLS (커널 TLS + sendfile 오프로드)는 Linux 전용이다.
+ *  Windows 소켓에는 대응하는 오프로드가 없으므로 이 빌드에서는
+ *  "지원 안 함" 행으로만 남긴다 (Schannel도 암호화는 사용자 공간에서 함).
+ *
+ *  사용법:
+ *    tls_bench.exe [-threads n] [-duration sec] [-bulk MB] [-out name]
+ *
+ *  옵션:
+ *    -threads n      연결 처리율 측정 클라이언트 스레드 수 (기본 4)
+ *    -duration sec   연결 처리율 측정 시간 (기본 5)
+ *    -bulk MB        대량 전송 크기 (기본 256)
+ *    -out name       리포트 파일 이름 (기본 tls_report → .csv)
+ * ============================================
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <process.h>
+#include <vector>
+#include <string>
+#include "tls_layer.h"
+#include "bench_process.h"
+
+#pragma comment(lib, "ws2_32.lib")
+
+#define SERVER_EXE "04_iocp_server.exe"
+#define SERVER_PORT 9003
+#define BULK_RECV_SIZE 65536
+
+// 콘솔 색상
+void SetColor(int color) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+}
+
+#define COLOR_DEFAULT 7
+#define COLOR_GREEN 10
+#define COLOR_YELLOW 14
+#define COLOR_CYAN 11
+#define COLOR_RED 12
+
+// 측정 모드 테이블 (serverArgs == NULL → 이 플랫폼에서 지원 안 함)
+struct TlsMode {
+    const char* name;
+    const char* serverArgs;
+    bool tls;
+    const char* note;
+};
+
+static const TlsMode g_modes[] = {
+    { "plain", "",     false, "암호화 없음 (기준선)" },
+    { "tls",   "-tls", true,  "Schannel TLS 1.2, 사용자 공간 암호화" },
+    { "ktls",  NULL,   true,  "Linux 전용 (커널 TLS + sendfile) - Windows 대응 없음" },
+};
+static const int g_modeCount = sizeof(g_modes) / sizeof(g_modes[0]);
+
+// 옵션
+static int g_threadCount = 4;
+static int g_durationSec = 5;
+static int g_bulkMB = 256;
+static std::string g_outName = "tls_report";
+
+static TlsCredentials g_clientCreds;
+
+// ============================================
+//  서버 프로세스
+// ============================================
+
+bool LaunchServer(const TlsMode& mode, PROCESS_INFORMATION& pi) {
+    char commandLine[256];
+    sprintf_s(commandLine, "%s -work 0 %s", SERVER_EXE, mode.serverArgs);
+    return LaunchAndProbe(commandLine, SERVER_PORT, pi, ProbeConnect);  // TLS 서버는 평문 probe 에 답하지 않는다
+}
+
+// ============================================
+//  요청 한 번 (연결 → 핸드셰이크 → 요청 → 서버가 닫을 때까지 수신)
+// ============================================
+
+// 반환: 받은 응답 바이트 수, -1 = 실패
+long long RunRequest(bool tls, const char* request) {
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) return -1;
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(SERVER_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    if (connect(sock, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) {
+        closesocket(sock);
+        return -1;
+    }
+
+    TlsSession session;
+    TlsSessionInit(session);
+    if (tls && !TlsConnect(session, g_clientCreds, sock)) {
+        TlsSessionClose(session);
+        closesocket(sock);
+        return -1;
+    }
+
+    int requestLen = (int)strlen(request);
+    bool sent = tls ? TlsSend(session, sock, request, requestLen) : SendAll(sock, request, requestLen);
+
+    static __declspec(thread) char buffer[BULK_RECV_SIZE];
+    long long total = 0;
+    while (sent) {
+        int received = tls ? TlsRecv(session, sock, buffer, sizeof(buffer))
+                           : recv(sock, buffer, sizeof(buffer), 0);
+        if (received <= 0) break;
+        total += received;
+    }
+
+    TlsSessionClose(session);
+    closesocket(sock);
+    return (sent && total > 0) ? total : -1;
+}
+
+// ============================================
+//  측정
+// ============================================
+
+struct ConnThreadArgs {
+    bool tls;
+    double endSec;
+    int completed;
+    int errors;
+};
+
+unsigned int __stdcall ConnThread(void* arg) {
+    ConnThreadArgs* args = (ConnThreadArgs*)arg;
+    while (NowSec() < args->endSec) {
+        if (RunRequest(args->tls, "PING") > 0) {
+            args->completed++;
+        } else {
+            args->errors++;
+        }
+    }
+    return 0;
+}
+
+struct TlsResult {
+    std::string mode;
+    bool supported;
+    bool serverStarted;
+    int connections;
+    int connErrors;
+    double connPerSec;
+    double cpuUsPerConn;
+    double bulkMB;
+    double bulkMBps;
+    double cpuMsPerMB;
+};
+
+TlsResult RunMode(const TlsMode& mode) {
+    TlsResult result;
+    result.mode = mode.name;
+    result.supported = (mode.serverArgs != NULL);
+    result.serverStarted = false;
+    result.connections = 0;
+    result.connErrors = 0;
+    result.connPerSec = 0;
+    result.cpuUsPerConn = 0;
+    result.bulkMB = 0;
+    result.bulkMBps = 0;
+    result.cpuMsPerMB = 0;
+    if (!result.supported) return result;
+
+    PROCESS_INFORMATION pi;
+    if (!LaunchServer(mode, pi)) return result;
+    result.serverStarted = true;
+
+    // 1. 연결 처리율
+    std::vector<ConnThreadArgs> args(g_threadCount);
+    std::vector<HANDLE> threads(g_threadCount);
+    double startSec = NowSec();
+    ULONGLONG cpuBefore = SampleCpuUs(pi.hProcess);
+    for (int t = 0; t < g_threadCount; t++) {
+        args[t].tls = mode.tls;
+        args[t].endSec = startSec + g_durationSec;
+        args[t].completed = 0;
+        args[t].errors = 0;
+        threads[t] = (HANDLE)_beginthreadex(NULL, 0, ConnThread, &args[t], 0, NULL);
+    }
+    WaitForMultipleObjects((DWORD)threads.size(), threads.data(), TRUE, INFINITE);
+    double elapsed = NowSec() - startSec;
+    ULONGLONG cpuAfter = SampleCpuUs(pi.hProcess);
+
+    for (int t = 0; t < g_threadCount; t++) {
+        CloseHandle(threads[t]);
+        result.connections += args[t].completed;
+        result.connErrors += args[t].errors;
+    }
+    result.connPerSec = result.connections / elapsed;
+    if (result.connections > 0) {
+        result.cpuUsPerConn = (double)(cpuAfter - cpuBefore) / result.connections;
+    }
+
+    // 2. 대량 전송 (연결 1개, 핸드셰이크 비용은 무시할 만한 크기)
+    char request[64];
+    sprintf_s(request, "BULK %lld", (long long)g_bulkMB * 1024 * 1024);
+    cpuBefore = SampleCpuUs(pi.hProcess);
+    startSec = NowSec();
+    long long received = RunRequest(mode.tls, request);
+    elapsed = NowSec() - startSec;
+    cpuAfter = SampleCpuUs(pi.hProcess);
+
+    if (received > 0) {
+        result.bulkMB = received / (1024.0 * 1024.0);
+        result.bulkMBps = result.bulkMB / elapsed;
+        result.cpuMsPerMB = (cpuAfter - cpuBefore) / 1000.0 / result.bulkMB;
+    }
+
+    StopServer(pi);
+    return result;
+}
+
+bool WriteCsv(const std::vector<TlsResult>& results, const char* path) {
+    FILE* fp = NULL;
+    if (fopen_s(&fp, path, "w") != 0) return false;
+
+    fprintf(fp, "mode,supported,server_started,connections,conn_errors,conn_per_sec,"
+                "server_cpu_us_per_conn,bulk_mb,bulk_mbps,server_cpu_ms_per_mb\n");
+    for (const TlsResult& r : results) {
+        fprintf(fp, "%s,%d,%d,%d,%d,%.1f,%.1f,%.1f,%.1f,%.3f\n",
+                r.mode.c_str(), r.supported ? 1 : 0, r.serverStarted ? 1 : 0,
+                r.connections, r.connErrors, r.connPerSec, r.cpuUsPerConn,
+                r.bulkMB, r.bulkMBps, r.cpuMsPerMB);
+    }
+    fclose(fp);
+    return true;
+}
+
+bool ParseArgs(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (strcmp(arg, "-threads") == 0) {
+            g_threadCount = atoi(value);
+        } else if (strcmp(arg, "-duration") == 0) {
+            g_durationSec = atoi(value);
+        } else if (strcmp(arg, "-bulk") == 0) {
+            g_bulkMB = atoi(value);
+        } else if (strcmp(arg, "-out") == 0) {
+            g_outName = value;
+        } else {
+            return false;
+        }
+    }
+
+    if (g_threadCount < 1) g_threadCount = 1;
+    if (g_durationSec < 1) g_durationSec = 1;
+    if (g_bulkMB < 1) g_bulkMB = 1;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+
+    if (!ParseArgs(argc, argv)) {
+        printf("사용법: tls_bench.exe [-threads n] [-duration sec] [-bulk MB] [-out name]\n");
+        return 1;
+    }
+
+    printf("\n");
+    SetColor(COLOR_CYAN);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("  [TLS 벤치마크] 평문 vs 사용자 공간 TLS (%s)\n", SERVER_EXE);
+    printf("═══════════════════════════════════════════════════════════════\n");
+    SetColor(COLOR_DEFAULT);
+    printf("  연결 처리율: 스레드 %d개 × %d초 | 대량 전송: %d MB\n",
+           g_threadCount, g_durationSec, g_bulkMB);
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        SetColor(COLOR_RED);
+        printf("WSAStartup 실패\n");
+        return 1;
+    }
+
+    if (!TlsCreateClientCredentials(g_clientCreds)) {
+        SetColor(COLOR_RED);
+        printf("TLS 클라이언트 자격 증명 생성 실패\n");
+        SetColor(COLOR_DEFAULT);
+        WSACleanup();
+        return 1;
+    }
+
+    std::vector<TlsResult> results;
+    printf("  %-6s %10s %12s %10s %12s   %s\n",
+           "mode", "conn/s", "cpu us/conn", "bulk MB/s", "cpu ms/MB", "비고");
+    printf("  ─────────────────────────────────────────────────────────────────────────────\n");
+
+    for (int i = 0; i < g_modeCount; i++) {
+        const TlsMode& mode = g_modes[i];
+        TlsResult r = RunMode(mode);
+        results.push_back(r);
+
+        if (!r.supported) {
+            SetColor(COLOR_YELLOW);
+            printf("  %-6s %10s %12s %10s %12s   %s\n", r.mode.c_str(), "-", "-", "-", "-", mode.note);
+            SetColor(COLOR_DEFAULT);
+            continue;
+        }
+        if (!r.serverStarted) {
+            SetColor(COLOR_RED);
+            printf("  %-6s  서버 실행 실패 (%s %s)\n", r.mode.c_str(), SERVER_EXE, mode.serverArgs);
+            SetColor(COLOR_DEFAULT);
+            continue;
+        }
+
+        SetColor(r.connErrors > 0 ? COLOR_YELLOW : COLOR_GREEN);
+        printf("  %-6s %10.1f %12.1f %10.1f %12.3f   %s",
+               r.mode.c_str(), r.connPerSec, r.cpuUsPerConn, r.bulkMBps, r.cpuMsPerMB, mode.note);
+        if (r.connErrors > 0) printf(" (연결 실패 %d)", r.connErrors);
+        printf("\n");
+        SetColor(COLOR_DEFAULT);
+    }
+
+    std::string csvPath = g_outName + ".csv";
+    bool written = WriteCsv(results, csvPath.c_str());
+
+    printf("\n");
+    SetColor(written ? COLOR_GREEN : COLOR_RED);
+    if (written) {
+        printf("리포트 저장: %s\n", csvPath.c_str());
+    } else {
+        printf("리포트 저장 실패\n");
+    }
+    SetColor(COLOR_DEFAULT);
+
+    TlsFreeCredentials(g_clientCreds);
+    WSACleanup();
+    return written ? 0 : 1;
+}
@@ -0,0 +1,399 @@
+/*
+ * ============================================
+ *  TLS 레이어 (Schannel, Windows 내장 라이브러리)
+ * ============================================
+ *  - 외부 의존성 없음: OpenSSL 대신 OS에 들어있는 Schannel(SSPI) 사용
+ *  - 서버 인증서: 실행 시 CN=localhost 자체 서명 인증서를 만든다
+ *    (키는 사용자 키 컨테이너 TLS_KEY_CONTAINER 에 보관, 재실행 시 재사용)
+ *  - 클라이언트는 수동 검증 모드 → 자체 서명 인증서를 그대로 받아들인다
+ *  - TLS 1.2 고정 (SCHANNEL_CRED 로 만들 수 있는 최신 버전)
+ *  - 블로킹 소켓 기준 API:
+ *      TlsAccept / TlsConnect : 핸드셰이크
+ *      TlsSend / TlsRecv      : 레코드 암호화/복호화 (사용자 공간 암호화)
+ *
+ *  주의: 커널 TLS(kTLS)는 Linux 전용이라 이 빌드에는 없다.
+ *        암호화는 전부 사용자 공간(Schannel → BCrypt)에서 일어난다.
+ * ============================================
+ */
+
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#define SECURITY_WIN32
+#include <windows.h>
+#include <winsock2.h>
+#include <wincrypt.h>
+#include <security.h>
+#include <schannel.h>
+#include <string.h>
+#include <vector>
+
+#pragma comment(lib, "secur32.lib")
+#pragma comment(lib, "crypt32.lib")
+
+#define TLS_KEY_CONTAINER L"SocketDemoTlsKey"
+#define TLS_SERVER_NAME "localhost"
+#define TLS_RECV_CHUNK 16384
+
+struct TlsCredentials {
+    CredHandle handle;
+    PCCERT_CONTEXT cert;
+    bool valid;
+};
+
+struct TlsSession {
+    CtxtHandle ctx;
+    bool hasContext;
+    SecPkgContext_StreamSizes sizes;
+    std::vector<char> in;       // 아직 처리하지 않은 암호문
+    std::vector<char> plain;    // 복호화했지만 아직 읽지 않은 평문
+    size_t plainPos;
+    std::vector<char> sendBuf;  // 레코드 하나 크기, 세션마다 재사용
+};
+
+inline bool SendAll(SOCKET socket, const char* data, int len) {
+    while (len > 0) {
+        int sent = send(socket, data, len, 0);
+        if (sent == SOCKET_ERROR) return false;
+        data += sent;
+        len -= sent;
+    }
+    return true;
+}
+
+inline bool RecvAppend(SOCKET socket, std::vector<char>& buffer) {
+    size_t oldSize = buffer.size();
+    buffer.resize(oldSize + TLS_RECV_CHUNK);
+    int received = recv(socket, buffer.data() + oldSize, TLS_RECV_CHUNK, 0);
+    if (received <= 0) {
+        buffer.resize(oldSize);
+        return false;
+    }
+    buffer.resize(oldSize + received);
+    return true;
+}
+
+// 핸드셰이크가 넘겨준 SECBUFFER_EXTRA(다음 메시지 앞부분)만 남기기
+inline void KeepExtra(std::vector<char>& in, const SecBuffer& extra) {
+    if (extra.BufferType == SECBUFFER_EXTRA && extra.cbBuffer > 0) {
+        memmove(in.data(), in.data() + in.size() - extra.cbBuffer, extra.cbBuffer);
+        in.resize(extra.cbBuffer);
+    } else {
+        in.clear();
+    }
+}
+
+inline void SendAndFreeToken(SOCKET socket, SecBuffer& token, bool& ok) {
+    if (token.pvBuffer != NULL) {
+        if (token.cbBuffer > 0 && !SendAll(socket, (const char*)token.pvBuffer, (int)token.cbBuffer)) {
+            ok = false;
+        }
+        FreeContextBuffer(token.pvBuffer);
+        token.pvBuffer = NULL;
+    }
+}
+
+// ============================================
+//  인증서 / 자격 증명
+// ============================================
+
+inline PCCERT_CONTEXT TlsCreateSelfSignedCert() {
+    HCRYPTPROV prov = 0;
+    if (!CryptAcquireContextW(&prov, TLS_KEY_CONTAINER, MS_ENH_RSA_AES_PROV_W, PROV_RSA_AES, 0) &&
+        !CryptAcquireContextW(&prov, TLS_KEY_CONTAINER, MS_ENH_RSA_AES_PROV_W, PROV_RSA_AES, CRYPT_NEWKEYSET)) {
+        return NULL;
+    }
+
+    HCRYPTKEY key = 0;
+    if (!CryptGetUserKey(prov, AT_KEYEXCHANGE, &key) &&
+        !CryptGenKey(prov, AT_KEYEXCHANGE, (2048 << 16), &key)) {
+        CryptReleaseContext(prov, 0);
+        return NULL;
+    }
+    CryptDestroyKey(key);
+
+    BYTE nameBlob[256];
+    DWORD nameSize = sizeof(nameBlob);
+    if (!CertStrToNameA(X509_ASN_ENCODING, "CN=" TLS_SERVER_NAME, CERT_X500_NAME_STR,
+                        NULL, nameBlob, &nameSize, NULL)) {
+        CryptReleaseContext(prov, 0);
+        return NULL;
+    }
+    CERT_NAME_BLOB subject = { nameSize, nameBlob };
+
+    // Schannel이 개인 키를 찾을 수 있도록 키 컨테이너 정보를 인증서에 붙인다
+    CRYPT_KEY_PROV_INFO keyProvInfo;
+    memset(&keyProvInfo, 0, sizeof(keyProvInfo));
+    keyProvInfo.pwszContainerName = (LPWSTR)TLS_KEY_CONTAINER;
+    keyProvInfo.pwszProvName = (LPWSTR)MS_ENH_RSA_AES_PROV_W;
+    keyProvInfo.dwProvType = PROV_RSA_AES;
+    keyProvInfo.dwKeySpec = AT_KEYEXCHANGE;
+
+    CRYPT_ALGORITHM_IDENTIFIER signatureAlg;
+    memset(&signatureAlg, 0, sizeof(signatureAlg));
+    signatureAlg.pszObjId = (LPSTR)szOID_RSA_SHA256RSA;
+
+    PCCERT_CONTEXT cert = CertCreateSelfSignCertificate(prov, &subject, 0, &keyProvInfo,
+                                                        &signatureAlg, NULL, NULL, NULL);
+    CryptReleaseContext(prov, 0);
+    return cert;
+}
+
+inline bool TlsCreateServerCredentials(TlsCredentials& creds) {
+    memset(&creds, 0, sizeof(creds));
+    creds.cert = TlsCreateSelfSignedCert();
+    if (creds.cert == NULL) return false;
+
+    SCHANNEL_CRED schannelCred;
+    memset(&schannelCred, 0, sizeof(schannelCred));
+    schannelCred.dwVersion = SCHANNEL_CRED_VERSION;
+    schannelCred.cCreds = 1;
+    schannelCred.paCred = &creds.cert;
+    schannelCred.grbitEnabledProtocols = SP_PROT_TLS1_2_SERVER;
+    schannelCred.dwFlags = SCH_USE_STRONG_CRYPTO;
+
+    TimeStamp expiry;
+    SECURITY_STATUS status = AcquireCredentialsHandleA(
+        NULL, (LPSTR)UNISP_NAME_A, SECPKG_CRED_INBOUND, NULL,
+        &schannelCred, NULL, NULL, &creds.handle, &expiry);
+    creds.valid = (status == SEC_E_OK);
+    return creds.valid;
+}
+
+inline bool TlsCreateClientCredentials(TlsCredentials& creds) {
+    memset(&creds, 0, sizeof(creds));
+
+    SCHANNEL_CRED schannelCred;
+    memset(&schannelCred, 0, sizeof(schannelCred));
+    schannelCred.dwVersion = SCHANNEL_CRED_VERSION;
+    schannelCred.grbitEnabledProtocols = SP_PROT_TLS1_2_CLIENT;
+    schannelCred.dwFlags = SCH_CRED_MANUAL_CRED_VALIDATION | SCH_CRED_NO_DEFAULT_CREDS |
+                           SCH_USE_STRONG_CRYPTO;
+
+    TimeStamp expiry;
+    SECURITY_STATUS status = AcquireCredentialsHandleA(
+        NULL, (LPSTR)UNISP_NAME_A, SECPKG_CRED_OUTBOUND, NULL,
+        &schannelCred, NULL, NULL, &creds.handle, &expiry);
+    creds.valid = (status == SEC_E_OK);
+    return creds.valid;
+}
+
+inline void TlsFreeCredentials(TlsCredentials& creds) {
+    if (creds.valid) FreeCredentialsHandle(&creds.handle);
+    if (creds.cert) CertFreeCertificateContext(creds.cert);
+    creds.valid = false;
+    creds.cert = NULL;
+}
+
+// ============================================
+//  세션
+// ============================================
+
+inline void TlsSessionInit(TlsSession& session) {
+    memset(&session.ctx, 0, sizeof(session.ctx));
+    session.hasContext = false;
+    memset(&session.sizes, 0, sizeof(session.sizes));
+    session.in.clear();
+    session.plain.clear();
+    session.plainPos = 0;
+}
+
+inline void TlsSessionClose(TlsSession& session) {
+    if (session.hasContext) DeleteSecurityContext(&session.ctx);
+    session.hasContext = false;
+}
+
+inline bool TlsFinishHandshake(TlsSession& session) {
+    if (QueryContextAttributesA(&session.ctx, SECPKG_ATTR_STREAM_SIZES, &session.sizes) != SEC_E_OK) {
+        return false;
+    }
+    session.sendBuf.resize(session.sizes.cbHeader + session.sizes.cbMaximumMessage + session.sizes.cbTrailer);
+    return true;
+}
+
+// 서버 핸드셰이크. initial = 이미 받아둔 첫 바이트들 (IOCP 첫 WSARecv 결과)
+inline bool TlsAccept(TlsSession& session, TlsCredentials& creds, SOCKET socket,
+                      const char* initial, int initialLen) {
+    session.in.assign(initial, initial + initialLen);
+    bool needMore = session.in.empty();
+
+    DWORD requestFlags = ASC_REQ_SEQUENCE_DETECT | ASC_REQ_REPLAY_DETECT |
+                         ASC_REQ_CONFIDENTIALITY | ASC_REQ_EXTENDED_ERROR |
+                         ASC_REQ_ALLOCATE_MEMORY | ASC_REQ_STREAM;
+
+    while (1) {
+        if (needMore && !RecvAppend(socket, session.in)) return false;
+        needMore = false;
+
+        SecBuffer inBuffers[2] = {
+            { (unsigned long)session.in.size(), SECBUFFER_TOKEN, session.in.data() },
+            { 0, SECBUFFER_EMPTY, NULL }
+        };
+        SecBufferDesc inDesc = { SECBUFFER_VERSION, 2, inBuffers };
+        SecBuffer outBuffers[1] = { { 0, SECBUFFER_TOKEN, NULL } };
+        SecBufferDesc outDesc = { SECBUFFER_VERSION, 1, outBuffers };
+
+        ULONG contextFlags = 0;
+        TimeStamp expiry;
+        SECURITY_STATUS status = AcceptSecurityContext(
+            &creds.handle, session.hasContext ? &session.ctx : NULL, &inDesc,
+            requestFlags, 0, &session.ctx, &outDesc, &contextFlags, &expiry);
+
+        if (status == SEC_E_INCOMPLETE_MESSAGE) {
+            needMore = true;
+            continue;
+        }
+        if (status == SEC_E_OK || status == SEC_I_CONTINUE_NEEDED) session.hasContext = true;
+
+        bool ok = true;
+        SendAndFreeToken(socket, outBuffers[0], ok);  // 실패 시 alert 토큰도 여기서 전송
+        if (!ok) return false;
+
+        if (status == SEC_E_OK) {
+            KeepExtra(session.in, inBuffers[1]);  // 남은 건 첫 애플리케이션 레코드
+            return TlsFinishHandshake(session);
+        }
+        if (status != SEC_I_CONTINUE_NEEDED) return false;
+
+        KeepExtra(session.in, inBuffers[1]);
+        needMore = session.in.empty();
+    }
+}
+
+// 클라이언트 핸드셰이크
+inline bool TlsConnect(TlsSession& session, TlsCredentials& creds, SOCKET socket) {
+    DWORD requestFlags = ISC_REQ_SEQUENCE_DETECT | ISC_REQ_REPLAY_DETECT |
+                         ISC_REQ_CONFIDENTIALITY | ISC_REQ_EXTENDED_ERROR |
+                         ISC_REQ_ALLOCATE_MEMORY | ISC_REQ_STREAM |
+                         ISC_REQ_MANUAL_CRED_VALIDATION;
+    ULONG contextFlags = 0;
+    TimeStamp expiry;
+
+    // ClientHello
+    SecBuffer helloBuffer = { 0, SECBUFFER_TOKEN, NULL };
+    SecBufferDesc helloDesc = { SECBUFFER_VERSION, 1, &helloBuffer };
+    SECURITY_STATUS status = InitializeSecurityContextA(
+        &creds.handle, NULL, (SEC_CHAR*)TLS_SERVER_NAME, requestFlags, 0, 0,
+        NULL, 0, &session.ctx, &helloDesc, &contextFlags, &expiry);
+    if (status != SEC_I_CONTINUE_NEEDED) return false;
+    session.hasContext = true;
+
+    bool ok = true;
+    SendAndFreeToken(socket, helloBuffer, ok);
+    if (!ok) return false;
+
+    session.in.clear();
+    bool needMore = true;
+    while (1) {
+        if (needMore && !RecvAppend(socket, session.in)) return false;
+        needMore = false;
+
+        SecBuffer inBuffers[2] = {
+            { (unsigned long)session.in.size(), SECBUFFER_TOKEN, session.in.data() },
+            { 0, SECBUFFER_EMPTY, NULL }
+        };
+        SecBufferDesc inDesc = { SECBUFFER_VERSION, 2, inBuffers };
+        SecBuffer outBuffers[1] = { { 0, SECBUFFER_TOKEN, NULL } };
+        SecBufferDesc outDesc = { SECBUFFER_VERSION, 1, outBuffers };
+
+        status = InitializeSecurityContextA(
+            &creds.handle, &session.ctx, (SEC_CHAR*)TLS_SERVER_NAME, requestFlags, 0, 0,
+            &inDesc, 0, &session.ctx, &outDesc, &contextFlags, &expiry);
+
+        if (status == SEC_E_INCOMPLETE_MESSAGE) {
+            needMore = true;
+            continue;
+        }
+
+        SendAndFreeToken(socket, outBuffers[0], ok);
+        if (!ok) return false;
+
+        if (status == SEC_E_OK) {
+            KeepExtra(session.in, inBuffers[1]);
+            return TlsFinishHandshake(session);
+        }
+        if (status != SEC_I_CONTINUE_NEEDED) return false;
+
+        KeepExtra(session.in, inBuffers[1]);
+        needMore = session.in.empty();
+    }
+}
+
+// 평문을 레코드(최대 cbMaximumMessage) 단위로 암호화해서 전송
+inline bool TlsSend(TlsSession& session, SOCKET socket, const char* data, int len) {
+    char* record = session.sendBuf.data();
+    ULONG header = session.sizes.cbHeader;
+    ULONG trailer = session.sizes.cbTrailer;
+
+    while (len > 0) {
+        ULONG chunk = ((ULONG)len < session.sizes.cbMaximumMessage) ? (ULONG)len : session.sizes.cbMaximumMessage;
+        memcpy(record + header, data, chunk);
+
+        SecBuffer buffers[4] = {
+            { header,  SECBUFFER_STREAM_HEADER,  record },
+            { chunk,   SECBUFFER_DATA,           record + header },
+            { trailer, SECBUFFER_STREAM_TRAILER, record + header + chunk },
+            { 0,       SECBUFFER_EMPTY,          NULL }
+        };
+        SecBufferDesc desc = { SECBUFFER_VERSION, 4, buffers };
+        if (EncryptMessage(&session.ctx, 0, &desc, 0) != SEC_E_OK) return false;
+
+        int recordSize = (int)(buffers[0].cbBuffer + buffers[1].cbBuffer + buffers[2].cbBuffer);
+        if (!SendAll(socket, record, recordSize)) return false;
+
+        data += chunk;
+        len -= (int)chunk;
+    }
+    return true;
+}
+
+// 평문을 최대 len 바이트 읽는다. 0 = 상대가 닫음, -1 = 오류
+inline int TlsRecv(TlsSession& session, SOCKET socket, char* out, int len) {
+    while (1) {
+        if (session.plainPos < session.plain.size()) {
+            size_t available = session.plain.size() - session.plainPos;
+            int count = ((size_t)len < available) ? len : (int)available;
+            memcpy(out, session.plain.data() + session.plainPos, count);
+            session.plainPos += count;
+            return count;
+        }
+
+        if (!session.in.empty()) {
+            SecBuffer buffers[4] = {
+                { (unsigned long)session.in.size(), SECBUFFER_DATA, session.in.data() },
+                { 0, SECBUFFER_EMPTY, NULL },
+                { 0, SECBUFFER_EMPTY, NULL },
+                { 0, SECBUFFER_EMPTY, NULL }
+            };
+            SecBufferDesc desc = { SECBUFFER_VERSION, 4, buffers };
+            SECURITY_STATUS status = DecryptMessage(&session.ctx, &desc, 0, NULL);
+
+            if (status == SEC_E_OK) {
+                // 복호화는 in 버퍼 안에서 제자리로 일어난다 → 평문 먼저 복사, 그다음 EXTRA 정리
+                session.plain.clear();
+                session.plainPos = 0;
+                SecBuffer* extra = NULL;
+                for (int i = 1; i < 4; i++) {
+                    if (buffers[i].BufferType == SECBUFFER_DATA) {
+                        const char* p = (const char*)buffers[i].pvBuffer;
+                        session.plain.assign(p, p + buffers[i].cbBuffer);
+                    } else if (buffers[i].BufferType == SECBUFFER_EXTRA) {
+                        extra = &buffers[i];
+                    }
+                }
+                if (extra != NULL) {
+                    KeepExtra(session.in, *extra);
+                } else {
+                    session.in.clear();
+                }
+                continue;
+            }
+            if (status == SEC_I_CONTEXT_EXPIRED) return 0;       // close_notify
+            if (status != SEC_E_INCOMPLETE_MESSAGE) return -1;   // 재협상 등은 지원 안 함
+        }
+
+        if (!RecvAppend(socket, session.in)) return 0;
+    }
+}